@@ -0,0 +1,609 @@
+///
+/// @file
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//
+// Reads StarNEig execution traces (one file per MPI rank), rebuilds the task
+// graph and reports
+//
+//  - the critical path of each phase (interface function call) together with
+//    the gap between the critical path and the makespan,
+//  - worker idle fractions over time, and
+//  - per-codelet execution times and achieved GFLOP/s.
+//
+// Each event records the data handles the task accessed and the access modes.
+// The dependencies are rebuilt in the same way as StarPU derives the implicit
+// dependencies: a read depends on the preceding write and a write depends on
+// the preceding write and on the reads since then. The accesses to the same
+// handle are ordered by their begin times; StarPU executes conflicting
+// accesses in the submission order. The StarPU-MPI tags that are recorded
+// when the distributed tasks are inserted connect the accesses of different
+// ranks. The traces of all ranks are merged to a single task graph and the
+// ranks are aligned with the real-time clocks that were recorded when the
+// tracing began. The clocks of the nodes are assumed to be synchronized.
+//
+
+#define DEFAULT_BINS 20
+
+struct access {
+    std::string key;
+    int mode;
+};
+
+struct event {
+    std::string name;
+    char label;
+    double begin;
+    double end;
+    int rank;
+    int worker;
+    int rbegin;
+    int rend;
+    int cbegin;
+    int cend;
+    double flops;
+    bool has_data;
+    std::vector<std::pair<uintptr_t, int> > data;
+    std::vector<struct access> accesses;
+};
+
+struct phase {
+    std::string name;
+    double begin;
+    double end;
+};
+
+struct data_tag {
+    double time;
+    long long tag;
+};
+
+struct trace {
+    char const *file_name;
+    int rank;
+    unsigned long long epoch;
+    std::vector<struct event> events;
+    std::vector<struct phase> phases;
+    std::map<uintptr_t, std::vector<struct data_tag> > tags;
+};
+
+struct codelet_stats {
+    int count;
+    double time;
+    double flops;
+    bool known;
+    double critical;
+};
+
+//
+// returns the short name of a codelet (drops the starneig_ prefix)
+//
+static std::string short_name(std::string const &name)
+{
+    if (name.compare(0, 9, "starneig_") == 0)
+        return name.substr(9);
+    return name;
+}
+
+//
+// returns the flop count of an event or a negative value if the flop count is
+// not known; the count that was recorded at task insertion takes precedence
+// over the analytic model
+//
+static double flop_count(struct event const &event)
+{
+    if (0.0 < event.flops)
+        return event.flops;
+
+    double r = event.rend - event.rbegin;
+    double c = event.cend - event.cbegin;
+    std::string name = short_name(event.name);
+
+    if (name == "left_gemm_update")
+        return 2.0*r*r*c;
+    if (name == "right_gemm_update")
+        return 2.0*r*c*c;
+    if (name == "schur_small_schur")
+        return 25.0*r*r*r;
+    if (name == "schur_small_hessenberg")
+        return 14.0/3.0*r*r*r;
+    if (name == "combine_transforms" || name == "embed_transform")
+        return 2.0*r*c*c;
+
+    return -1.0;
+}
+
+//
+// parses the "mode:address" pairs of an event
+//
+static void parse_data(char const *str, struct event &event)
+{
+    event.has_data = true;
+    while (*str != '\0' && *str != '"') {
+        char mode[3];
+        uintptr_t address;
+        int len;
+        if (sscanf(str, "%2[RW]:%" SCNxPTR "%n", mode, &address, &len) != 2)
+            break;
+        event.data.push_back(std::make_pair(address,
+            (strchr(mode, 'R') ? 1 : 0) | (strchr(mode, 'W') ? 2 : 0)));
+        str += len;
+        while (*str == ' ')
+            str++;
+    }
+}
+
+//
+// reads the events, the phases and the data tags from a Chrome trace event
+// JSON file that was written by starneig_node_store_trace()
+//
+static bool read_trace(char const *file_name, struct trace &trace)
+{
+    std::ifstream file(file_name);
+    if (!file) {
+        fprintf(stderr, "Cannot open %s.\n", file_name);
+        return false;
+    }
+
+    trace.file_name = file_name;
+    trace.rank = 0;
+    trace.epoch = 0;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        char name[128], cname[64];
+        double ts, dur;
+        int pid, tid, prio;
+        struct event event;
+
+        int ret = sscanf(line.c_str(),
+            "{\"name\":\"%127[^\"]\",\"cat\":\"%c\",\"ph\":\"X\","
+            "\"ts\":%lf,\"dur\":%lf,\"pid\":%d,\"tid\":%d,"
+            "\"cname\":\"%63[^\"]\",\"args\":{\"rows\":[%d,%d],"
+            "\"cols\":[%d,%d],\"prio\":%d,\"flops\":%lf",
+            name, &event.label, &ts, &dur, &pid, &tid, cname,
+            &event.rbegin, &event.rend, &event.cbegin, &event.cend, &prio,
+            &event.flops);
+
+        // traces that were written before the flop counts were recorded
+        // stop after the priority
+        if (ret == 12)
+            event.flops = -1.0;
+
+        if (ret == 12 || ret == 13) {
+            event.name = name;
+            event.begin = ts;
+            event.end = ts + dur;
+            event.rank = pid;
+            event.worker = tid;
+            event.has_data = false;
+            size_t pos = line.find("\"data\":\"");
+            if (pos != std::string::npos)
+                parse_data(line.c_str() + pos + 8, event);
+            trace.rank = pid;
+            trace.events.push_back(event);
+            continue;
+        }
+
+        ret = sscanf(line.c_str(),
+            "{\"name\":\"%127[^\"]\",\"cat\":\"phase\",\"ph\":\"X\","
+            "\"ts\":%lf,\"dur\":%lf,\"pid\":%d",
+            name, &ts, &dur, &pid);
+
+        if (ret == 4) {
+            struct phase phase;
+            phase.name = name;
+            phase.begin = ts;
+            phase.end = ts + dur;
+            trace.rank = pid;
+            trace.phases.push_back(phase);
+            continue;
+        }
+
+        uintptr_t handle;
+        struct data_tag tag;
+        ret = sscanf(line.c_str(),
+            "{\"name\":\"data_tag\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+            "\"args\":{\"handle\":\"%" SCNxPTR "\",\"tag\":%lld,\"ts\":%lf",
+            &pid, &handle, &tag.tag, &tag.time);
+
+        if (ret == 4) {
+            trace.tags[handle].push_back(tag);
+            continue;
+        }
+
+        size_t pos = line.find("\"epoch\":");
+        if (line.find("\"otherData\":") != std::string::npos &&
+        pos != std::string::npos)
+            trace.epoch = strtoull(line.c_str() + pos + 8, NULL, 10);
+    }
+
+    for (auto &tags : trace.tags)
+        std::sort(tags.second.begin(), tags.second.end(),
+            [](struct data_tag const &a, struct data_tag const &b) {
+                return a.time < b.time; });
+
+    //
+    // a handle that had a StarPU-MPI tag when the task was inserted is
+    // identified by the tag, other handles are private to the rank
+    //
+
+    for (auto &event : trace.events) {
+        for (auto const &data : event.data) {
+            struct access access;
+            access.mode = data.second;
+
+            auto tags = trace.tags.find(data.first);
+            long long tag = -1;
+            if (tags != trace.tags.end())
+                for (auto const &iter : tags->second)
+                    if (iter.time <= event.begin)
+                        tag = iter.tag;
+
+            char key[64];
+            if (0 <= tag)
+                snprintf(key, sizeof(key), "tag %lld", tag);
+            else
+                snprintf(key, sizeof(key), "rank %d %" PRIxPTR,
+                    trace.rank, data.first);
+            access.key = key;
+
+            event.accesses.push_back(access);
+        }
+        event.data.clear();
+    }
+
+    return true;
+}
+
+//
+// merges the traces of the ranks; the time stamps of each rank are shifted so
+// that they are relative to the rank that began tracing first
+//
+static void merge_traces(std::vector<struct trace> &traces,
+    std::vector<struct event> &events, std::vector<struct phase> &phases)
+{
+    unsigned long long epoch = 0;
+    for (auto const &trace : traces)
+        if (0 < trace.epoch && (epoch == 0 || trace.epoch < epoch))
+            epoch = trace.epoch;
+
+    for (auto &trace : traces) {
+        double shift = 0 < trace.epoch ? (trace.epoch - epoch) / 1.0E3 : 0.0;
+
+        for (auto event : trace.events) {
+            event.begin += shift;
+            event.end += shift;
+            events.push_back(event);
+        }
+
+        // the interface functions are collective and each rank records the
+        // same sequence of phases
+        for (size_t i = 0; i < trace.phases.size(); i++) {
+            struct phase phase = trace.phases[i];
+            phase.begin += shift;
+            phase.end += shift;
+            if (phases.size() <= i) {
+                phases.push_back(phase);
+            }
+            else {
+                phases[i].begin = std::min(phases[i].begin, phase.begin);
+                phases[i].end = std::max(phases[i].end, phase.end);
+            }
+        }
+    }
+
+    std::sort(events.begin(), events.end(),
+        [](struct event const &a, struct event const &b) {
+            return a.begin < b.begin; });
+
+    if (phases.empty() && !events.empty()) {
+        struct phase phase;
+        phase.name = "(whole trace)";
+        phase.begin = events.front().begin;
+        phase.end = events.front().end;
+        for (auto const &event : events)
+            phase.end = std::max(phase.end, event.end);
+        phases.push_back(phase);
+    }
+}
+
+//
+// rebuilds the dependencies between a set of events (sorted by begin time)
+// from the recorded data accesses; returns the predecessors of each event
+//
+static std::vector<std::vector<int> > build_graph(
+    std::vector<struct event const *> const &events)
+{
+    struct handle_state {
+        int writer = -1;
+        std::vector<int> readers;
+    };
+
+    std::map<std::string, struct handle_state> handles;
+    std::vector<std::vector<int> > preds(events.size());
+
+    for (int i = 0; i < (int) events.size(); i++) {
+        for (auto const &access : events[i]->accesses) {
+            struct handle_state &state = handles[access.key];
+            if (0 <= state.writer)
+                preds[i].push_back(state.writer);
+            if (access.mode & 2) {
+                preds[i].insert(preds[i].end(),
+                    state.readers.begin(), state.readers.end());
+                state.writer = i;
+                state.readers.clear();
+            }
+            else {
+                state.readers.push_back(i);
+            }
+        }
+    }
+
+    return preds;
+}
+
+//
+// computes the critical path through a set of events (sorted by begin time)
+// and returns the indexes of the events that belong to the path
+//
+static std::vector<int> critical_path(
+    std::vector<struct event const *> const &events, double &length)
+{
+    int count = events.size();
+    length = 0.0;
+    if (count == 0)
+        return std::vector<int>();
+
+    std::vector<std::vector<int> > preds = build_graph(events);
+
+    std::vector<double> path(count, 0.0);
+    std::vector<int> pred(count, -1);
+
+    int last = 0;
+    for (int i = 0; i < count; i++) {
+        for (int p : preds[i]) {
+            if (path[i] < path[p]) {
+                path[i] = path[p];
+                pred[i] = p;
+            }
+        }
+
+        path[i] += events[i]->end - events[i]->begin;
+        if (path[last] < path[i])
+            last = i;
+    }
+
+    length = path[last];
+
+    std::vector<int> chain;
+    for (int i = last; 0 <= i; i = pred[i])
+        chain.push_back(i);
+    std::reverse(chain.begin(), chain.end());
+
+    return chain;
+}
+
+static void report_phases(std::vector<struct event> const &all_events,
+    std::vector<struct phase> const &phases, int ranks)
+{
+    printf("\nCritical paths (%d ranks):\n", ranks);
+    printf("  %-16s %8s %12s %12s %12s %7s\n",
+        "phase", "tasks", "makespan", "critical", "gap", "ratio");
+
+    for (auto const &phase : phases) {
+        std::vector<struct event const *> events;
+        int without_data = 0;
+        for (auto const &event : all_events) {
+            if (phase.begin <= event.begin && event.begin < phase.end) {
+                events.push_back(&event);
+                if (!event.has_data)
+                    without_data++;
+            }
+        }
+
+        double length;
+        std::vector<int> chain = critical_path(events, length);
+
+        double makespan = phase.end - phase.begin;
+        printf("  %-16s %8d %10.3f ms %9.3f ms %9.3f ms %6.1f%%\n",
+            phase.name.c_str(), (int) events.size(), makespan/1.0E3,
+            length/1.0E3, (makespan-length)/1.0E3,
+            0.0 < makespan ? 100.0*length/makespan : 0.0);
+
+        std::map<std::string, struct codelet_stats> stats;
+        int crossings = 0;
+        for (size_t i = 0; i < chain.size(); i++) {
+            struct codelet_stats &s = stats[short_name(events[chain[i]]->name)];
+            s.count++;
+            s.critical += events[chain[i]]->end - events[chain[i]]->begin;
+            if (0 < i && events[chain[i-1]]->rank != events[chain[i]]->rank)
+                crossings++;
+        }
+        for (auto const &s : stats)
+            printf("      %-30s %6d tasks %10.3f ms\n",
+                s.first.c_str(), s.second.count, s.second.critical/1.0E3);
+        if (0 < crossings)
+            printf("      %-30s %6d\n", "(rank crossings)", crossings);
+        if (0 < without_data)
+            printf("      %-30s %6d\n", "(tasks without data)", without_data);
+    }
+}
+
+static void report_idle(std::vector<struct event> const &events, int bins)
+{
+    if (events.empty())
+        return;
+
+    int workers = 0;
+    std::map<std::pair<int, int>, int> seen;
+    std::map<int, int> ranks;
+    double begin = events.front().begin, end = begin;
+    for (auto const &event : events) {
+        auto worker = std::make_pair(event.rank, event.worker);
+        if (seen.find(worker) == seen.end())
+            seen[worker] = workers++;
+        ranks[event.rank]++;
+        end = std::max(end, event.end);
+    }
+
+    double width = (end - begin) / bins;
+    if (width <= 0.0)
+        return;
+
+    std::vector<double> busy(bins, 0.0);
+    for (auto const &event : events) {
+        int first = std::min(bins-1, (int) ((event.begin - begin) / width));
+        int last = std::min(bins-1, (int) ((event.end - begin) / width));
+        for (int i = first; i <= last; i++) {
+            double b = std::max(event.begin, begin + i*width);
+            double e = std::min(event.end, begin + (i+1)*width);
+            if (b < e)
+                busy[i] += e - b;
+        }
+    }
+
+    printf("\nWorker idle fractions (%d ranks, %d workers):\n",
+        (int) ranks.size(), workers);
+    double total = 0.0;
+    for (int i = 0; i < bins; i++) {
+        double idle = 1.0 - busy[i] / (workers*width);
+        total += busy[i];
+        int bar = 40.0*idle + 0.5;
+        printf("  %10.3f ms %6.1f%% |%.*s%*s|\n",
+            (i*width)/1.0E3, 100.0*idle, bar,
+            "########################################", 40-bar, "");
+    }
+    printf("  %-13s %6.1f%%\n", "total",
+        100.0*(1.0 - total / (workers*(end-begin))));
+}
+
+static void report_codelets(std::vector<struct event> const &events, int ranks)
+{
+    std::map<std::string, struct codelet_stats> stats;
+    double total = 0.0;
+    for (auto const &event : events) {
+        struct codelet_stats &s = stats[short_name(event.name)];
+        double flops = flop_count(event);
+        s.count++;
+        s.time += event.end - event.begin;
+        if (0.0 <= flops) {
+            s.flops += flops;
+            s.known = true;
+        }
+        total += event.end - event.begin;
+    }
+
+    printf("\nCodelets (%d ranks):\n", ranks);
+    printf("  %-30s %8s %12s %12s %7s %10s\n",
+        "codelet", "count", "total", "mean", "share", "GFLOP/s");
+    for (auto const &s : stats) {
+        printf("  %-30s %8d %9.3f ms %9.3f us %6.1f%% ",
+            s.first.c_str(), s.second.count, s.second.time/1.0E3,
+            s.second.time/s.second.count,
+            0.0 < total ? 100.0*s.second.time/total : 0.0);
+        if (s.second.known && 0.0 < s.second.time)
+            printf("%10.2f\n", s.second.flops/s.second.time/1.0E3);
+        else
+            printf("%10s\n", "n/a");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int bins = DEFAULT_BINS;
+
+    int i = 1;
+    for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+        if (strcmp(argv[i], "--bins") == 0 && i+1 < argc)
+            bins = atoi(argv[++i]);
+        else
+            break;
+    }
+
+    if (argc <= i || bins < 1) {
+        fprintf(stderr,
+            "Usage: %s [--bins (num)] (trace.json) [(trace.json.1) ...]\n",
+            argv[0]);
+        return 1;
+    }
+
+    std::vector<struct trace> traces;
+    for (; i < argc; i++) {
+        struct trace trace;
+        if (!read_trace(argv[i], trace))
+            return 1;
+
+        printf("%s: rank %d, %d events, %d phases\n", argv[i], trace.rank,
+            (int) trace.events.size(), (int) trace.phases.size());
+
+        traces.push_back(trace);
+    }
+
+    std::vector<struct event> events;
+    std::vector<struct phase> phases;
+    merge_traces(traces, events, phases);
+
+    std::vector<struct event const *> all;
+    for (auto const &event : events)
+        all.push_back(&event);
+    std::vector<std::vector<int> > preds = build_graph(all);
+    int edges = 0, remote = 0;
+    for (size_t i = 0; i < preds.size(); i++) {
+        edges += preds[i].size();
+        for (int p : preds[i])
+            if (all[p]->rank != all[i]->rank)
+                remote++;
+    }
+    printf("\nTask graph: %d tasks, %d dependencies (%d between ranks)\n",
+        (int) all.size(), edges, remote);
+
+    report_phases(events, phases, traces.size());
+    report_idle(events, bins);
+    report_codelets(events, traces.size());
+    printf("\n");
+
+    return 0;
+}
@@ -35,6 +35,9 @@
 ///
 
 #include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstring>
 #include <CImg.h>
 using namespace cimg_library;
 
@@ -48,10 +51,14 @@ enum fill { UPPER, FULL };
 
 static const unsigned char gray[] = { 240, 240, 240 };
 
+static const unsigned char blue[] = { 0, 0, 128 };
+static const unsigned char green[] = { 0, 128, 0 };
+static const unsigned char red[] = { 128, 0, 0 };
+
 struct event {
     char label;
-    float begin;
-    float end;
+    double begin;
+    double end;
     int rbegin;
     int rend;
     int cbegin;
@@ -59,6 +66,56 @@ struct event {
     unsigned char color[3];
 };
 
+//
+// reads the complete ("ph":"X") events from a Chrome trace event JSON file
+// that was written by starneig_node_store_trace()
+//
+static std::vector<struct event> read_events(char const *file_name)
+{
+    std::vector<struct event> events;
+
+    FILE *file = fopen(file_name, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s.\n", file_name);
+        return events;
+    }
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char name[128], cname[64];
+        double ts, dur;
+        int pid, tid, prio;
+        struct event event;
+
+        int ret = sscanf(line,
+            "{\"name\":\"%127[^\"]\",\"cat\":\"%c\",\"ph\":\"X\","
+            "\"ts\":%lf,\"dur\":%lf,\"pid\":%d,\"tid\":%d,"
+            "\"cname\":\"%63[^\"]\",\"args\":{\"rows\":[%d,%d],"
+            "\"cols\":[%d,%d],\"prio\":%d}}",
+            name, &event.label, &ts, &dur, &pid, &tid, cname,
+            &event.rbegin, &event.rend, &event.cbegin, &event.cend, &prio);
+
+        if (ret != 12)
+            continue;
+
+        event.begin = ts;
+        event.end = ts + dur;
+
+        unsigned char const *color = blue;
+        if (strcmp(cname, "good") == 0)
+            color = green;
+        if (strcmp(cname, "terrible") == 0)
+            color = red;
+        memcpy(event.color, color, sizeof(event.color));
+
+        events.push_back(event);
+    }
+
+    fclose(file);
+
+    return events;
+}
+
 void draw_window(
     int rbegin, int rend, int cbegin, int cend, int m, int n,
     int f_rbegin, int f_rend, int f_cbegin, int f_cend,
@@ -89,9 +146,9 @@ void draw_between(
             events[i].begin <= t_end) {
 
             float weight =
-                std::max<float>(0.33,
-                    std::min<float>(t_end, events[i].end) -
-                    std::max<float>(t_begin, events[i].begin)
+                std::max<double>(0.33,
+                    std::min<double>(t_end, events[i].end) -
+                    std::max<double>(t_begin, events[i].begin)
                 ) / (t_end-t_begin);
 
             draw_window(
@@ -105,39 +162,45 @@ void draw_between(
 
 int main(int argc, char **argv)
 {
-    FILE *file = fopen(argv[1], "rb");
-    int frames = atoi(argv[2]);
-
-    int n, total_events;
-    float begin, end;
-    fread(&n, sizeof(n), 1, file);
-    fread(&total_events, sizeof(total_events), 1, file);
-    fread(&begin, sizeof(begin), 1, file);
-    fread(&end, sizeof(end), 1, file);
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s (trace.json) (frames)\n", argv[0]);
+        return 1;
+    }
 
-    struct event *events = new struct event[total_events];
-    fread(events, sizeof(struct event), total_events, file);
+    std::vector<struct event> events = read_events(argv[1]);
+    int frames = atoi(argv[2]);
 
-    fclose(file);
+    int total_events = events.size();
+    if (total_events == 0)
+        return 1;
+
+    int n = 0;
+    double begin = events[0].begin, end = events[0].end;
+    for (int i = 0; i < total_events; i++) {
+        if (events[i].label == 'A')
+            n = std::max(n, std::max(events[i].rend, events[i].cend));
+        begin = std::min(begin, events[i].begin);
+        end = std::max(end, events[i].end);
+    }
 
     for (int i = 0; i < frames; i++) {
         CImg<unsigned char> frame(W, H, 1, 3, 255);
 
-        float _begin = begin + i*(end-begin)/frames;
-        float _end = begin + (i+1)*(end-begin)/frames;
+        double _begin = begin + i*(end-begin)/frames;
+        double _end = begin + (i+1)*(end-begin)/frames;
 /*
-        draw_between('A', UPPER, _begin, _end, events, total_events, n, n,
+        draw_between('A', UPPER, _begin, _end, events.data(), total_events, n, n,
             0, H/2-5, 0, W/2-5, frame);
-        draw_between('B', UPPER, _begin, _end, events, total_events, n, n,
+        draw_between('B', UPPER, _begin, _end, events.data(), total_events, n, n,
             H/2+5, H, 0, W/2-5, frame);
-        draw_between('Q', FULL,  _begin, _end, events, total_events, n, n,
+        draw_between('Q', FULL,  _begin, _end, events.data(), total_events, n, n,
             0, H/2-5, W/2+5, W, frame);
-        draw_between('Z', FULL,  _begin, _end, events, total_events, n, n,
+        draw_between('Z', FULL,  _begin, _end, events.data(), total_events, n, n,
             H/2+5, H, W/2+5, W, frame);
 */
-        draw_between('A', UPPER, _begin, _end, events, total_events, n, n,
+        draw_between('A', UPPER, _begin, _end, events.data(), total_events, n, n,
             0, H, 0, W/2-5, frame);
-        draw_between('Q', FULL,  _begin, _end, events, total_events, n, n,
+        draw_between('Q', FULL,  _begin, _end, events.data(), total_events, n, n,
             0, H, W/2+5, W, frame);
 
         char filename[100];
@@ -145,7 +208,5 @@ int main(int argc, char **argv)
         frame.save_png(filename);
     }
 
-    delete events;
-
     return 0;
 }
@@ -0,0 +1,1283 @@
+///
+/// @file
+///
+/// @brief This file contains a microbenchmark that calls the CPU kernels
+/// directly on synthetic inputs.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/node.h>
+#include "../common/common.h"
+#include "../common/node_internal.h"
+#include "../common/tiles.h"
+#include "../common/math.h"
+#include "../common/alloc.h"
+#include "../common/cpu.h"
+#include "../schur/common.h"
+#include "../schur/cpu.h"
+#include "../reorder/common.h"
+#include "../reorder/cpu.h"
+#include "../hessenberg/cpu.h"
+#include "../eigenvectors/standard/cpu.h"
+#include "../eigenvectors/standard/robust.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include <stdint.h>
+#include <starpu.h>
+
+#define DEFAULT_SIZES "64,128,256,512"
+#define DEFAULT_REPEAT 10
+#define DEFAULT_WARMUP 2
+#define DEFAULT_PANEL 32
+#define DEFAULT_SEED 1234
+
+#define MAX_BUFFERS 16
+#define MAX_SIZES 32
+#define MAX_BASELINE 1024
+
+extern void dgeqrf_(int const *, int const *, double *, int const *,
+    double *, double *, int const *, int *);
+
+extern void dorgqr_(int const *, int const *, int const *, double *,
+    int const *, double const *, double *, int const *, int *);
+
+///
+/// @brief Matrix initialization modes.
+///
+enum init_mode {
+    INIT_ZERO,          ///< zero matrix
+    INIT_RANDOM,        ///< random matrix
+    INIT_HESSENBERG,    ///< random upper Hessenberg matrix
+    INIT_TRIANGULAR,    ///< random upper triangular matrix
+    INIT_SCHUR,         ///< upper triangular matrix with distinct diagonal
+    INIT_ORTHOGONAL     ///< random orthogonal matrix
+};
+
+///
+/// @brief Benchmark case. Holds the data interfaces and the packed arguments
+/// of a single kernel invocation together with pristine copies of the data.
+///
+struct bench_case {
+    void *buffers[MAX_BUFFERS];     ///< StarPU data interfaces
+    int buffer_count;               ///< number of data interfaces
+    void *args;                     ///< packed codelet arguments
+    size_t args_size;               ///< size of the packed codelet arguments
+    struct {
+        void *ptr;                  ///< data
+        void *copy;                 ///< pristine copy of the data
+        size_t size;                ///< size of the data in bytes
+        int matrix;                 ///< non-zero if allocated as a matrix
+    } data[MAX_BUFFERS];
+    int data_count;                 ///< number of data regions
+    double flops;                   ///< analytic flop count
+    double bytes;                   ///< size of the kernel operands in bytes
+};
+
+///
+/// @brief Kernel descriptor.
+///
+struct kernel {
+    char const *name;                           ///< kernel name
+    void (*func)(void *[], void *);             ///< CPU kernel
+    void (*setup)(int, int, struct bench_case *); ///< builds the input
+    /// checks the status the kernel returned through its buffers (NULL if the
+    /// kernel does not return a status); returns non-zero on failure
+    int (*check)(int, struct bench_case const *);
+};
+
+///
+/// @brief Benchmark result.
+///
+struct result {
+    char const *kernel;     ///< kernel name
+    int n;                  ///< problem size
+    double flops;           ///< analytic flop count
+    double bytes;           ///< size of the kernel operands in bytes
+    double min;             ///< minimum run time (s)
+    double median;          ///< median run time (s)
+    double mean;            ///< mean run time (s)
+    double stddev;          ///< run time standard deviation (s)
+    double max;             ///< maximum run time (s)
+};
+
+///
+/// @brief Baseline entry.
+///
+struct baseline {
+    char kernel[64];        ///< kernel name
+    int n;                  ///< problem size
+    double median;          ///< median run time (s)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static double get_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0E-9*ts.tv_nsec;
+}
+
+static double random_double()
+{
+    return 2.0*rand()/RAND_MAX - 1.0;
+}
+
+static void init_matrix(enum init_mode mode, int m, int n, size_t ld, double *A)
+{
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+            switch (mode) {
+                case INIT_RANDOM:
+                    A[j*ld+i] = random_double();
+                    break;
+                case INIT_HESSENBERG:
+                    A[j*ld+i] = i <= j+1 ? random_double() : 0.0;
+                    break;
+                case INIT_TRIANGULAR:
+                    A[j*ld+i] = i < j ? random_double() :
+                        i == j ? 2.0 + random_double() : 0.0;
+                    break;
+                case INIT_SCHUR:
+                    A[j*ld+i] = i < j ? random_double() :
+                        i == j ? 1.0 + j : 0.0;
+                    break;
+                default:
+                    A[j*ld+i] = 0.0;
+            }
+        }
+    }
+
+    if (mode == INIT_ORTHOGONAL) {
+        init_matrix(INIT_RANDOM, m, n, ld, A);
+
+        int _ld = ld, info, lwork = -1;
+        double *tau = malloc(n*sizeof(double)), _work;
+        dgeqrf_(&m, &n, A, &_ld, tau, &_work, &lwork, &info);
+        lwork = _work;
+        double *work = malloc(lwork*sizeof(double));
+        dgeqrf_(&m, &n, A, &_ld, tau, work, &lwork, &info);
+        dorgqr_(&m, &n, &n, A, &_ld, tau, work, &lwork, &info);
+        free(work);
+        free(tau);
+    }
+}
+
+static void add_data(void *ptr, size_t size, int matrix, struct bench_case *bcase)
+{
+    int i = bcase->data_count++;
+    bcase->data[i].ptr = ptr;
+    bcase->data[i].copy = NULL;
+    bcase->data[i].size = size;
+    bcase->data[i].matrix = matrix;
+}
+
+static double * add_matrix(
+    enum init_mode mode, int m, int n, struct bench_case *bcase)
+{
+    size_t ld;
+    double *A = starneig_alloc_matrix(m, n, sizeof(double), &ld);
+    init_matrix(mode, m, n, ld, A);
+    add_data(A, ld*n*sizeof(double), 1, bcase);
+
+    struct starpu_matrix_interface *interface =
+        calloc(1, sizeof(struct starpu_matrix_interface));
+    interface->id = STARPU_MATRIX_INTERFACE_ID;
+    interface->ptr = (uintptr_t) A;
+    interface->dev_handle = (uintptr_t) A;
+    interface->nx = m;
+    interface->ny = n;
+    interface->ld = ld;
+    interface->elemsize = sizeof(double);
+    interface->allocsize = ld*n*sizeof(double);
+
+    bcase->buffers[bcase->buffer_count++] = interface;
+    bcase->bytes += (double) m*n*sizeof(double);
+
+    return A;
+}
+
+static void * add_vector(int n, size_t elemsize, struct bench_case *bcase)
+{
+    void *x = calloc(n, elemsize);
+    add_data(x, n*elemsize, 0, bcase);
+
+    struct starpu_vector_interface *interface =
+        calloc(1, sizeof(struct starpu_vector_interface));
+    interface->id = STARPU_VECTOR_INTERFACE_ID;
+    interface->ptr = (uintptr_t) x;
+    interface->dev_handle = (uintptr_t) x;
+    interface->nx = n;
+    interface->elemsize = elemsize;
+    interface->allocsize = n*elemsize;
+
+    bcase->buffers[bcase->buffer_count++] = interface;
+    bcase->bytes += (double) n*elemsize;
+
+    return x;
+}
+
+static void * add_variable(size_t elemsize, struct bench_case *bcase)
+{
+    void *x = calloc(1, elemsize);
+    add_data(x, elemsize, 0, bcase);
+
+    struct starpu_variable_interface *interface =
+        calloc(1, sizeof(struct starpu_variable_interface));
+    interface->id = STARPU_VARIABLE_INTERFACE_ID;
+    interface->ptr = (uintptr_t) x;
+    interface->dev_handle = (uintptr_t) x;
+    interface->elemsize = elemsize;
+
+    bcase->buffers[bcase->buffer_count++] = interface;
+
+    return x;
+}
+
+//
+// packing information that covers a single m-by-n tile
+//
+static void tile_packing_info(int m, int n, struct packing_info *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->flag = PACKING_MODE_DEFAULT;
+    info->elemsize = sizeof(double);
+    info->bm = m;
+    info->bn = n;
+    info->rend = m;
+    info->cend = n;
+    info->m = m;
+    info->n = n;
+    info->handles = 1;
+    info->event_label = 'A';
+}
+
+//
+// range packing information that covers a single vector of length n
+//
+static void range_packing_info(
+    int n, size_t elemsize, struct range_packing_info *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->flag = PACKING_MODE_DEFAULT;
+    info->elemsize = elemsize;
+    info->bm = n;
+    info->end = n;
+    info->m = n;
+    info->handles = 1;
+}
+
+static void snapshot(struct bench_case *bcase)
+{
+    for (int i = 0; i < bcase->data_count; i++) {
+        bcase->data[i].copy = malloc(bcase->data[i].size);
+        memcpy(bcase->data[i].copy, bcase->data[i].ptr, bcase->data[i].size);
+    }
+}
+
+static void restore(struct bench_case *bcase)
+{
+    for (int i = 0; i < bcase->data_count; i++)
+        memcpy(bcase->data[i].ptr, bcase->data[i].copy, bcase->data[i].size);
+}
+
+static void free_case(struct bench_case *bcase)
+{
+    for (int i = 0; i < bcase->data_count; i++) {
+        if (bcase->data[i].matrix)
+            starneig_free_matrix(bcase->data[i].ptr);
+        else
+            free(bcase->data[i].ptr);
+        free(bcase->data[i].copy);
+    }
+    for (int i = 0; i < bcase->buffer_count; i++)
+        free(bcase->buffers[i]);
+    free(bcase->args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// common kernels
+//
+
+static void setup_gemm_update(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_ORTHOGONAL, n, n, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_RANDOM, n, n, bcase);
+
+    struct packing_info pi;
+    tile_packing_info(n, n, &pi);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi, sizeof(pi), 0);
+
+    bcase->flops = 2.0*n*n*n;
+}
+
+//
+// Schur reduction kernels
+//
+
+static void setup_push_bulges(int n, int nb, struct bench_case *bcase)
+{
+    int shifts = 2*MAX(1, n/6);
+
+    double *real = add_vector(shifts, sizeof(double), bcase);
+    add_vector(shifts, sizeof(double), bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_HESSENBERG, n, n, bcase);
+
+    for (int i = 0; i < shifts; i++)
+        real[i] = random_double();
+
+    double thres_a = n*dlamch("Precision"), thres_b = 0.0, thres_inf = 0.0;
+    bulge_chasing_mode_t mode = BULGE_CHASING_MODE_FULL;
+
+    struct range_packing_info pi_real, pi_imag, pi_aftermath;
+    range_packing_info(shifts, sizeof(double), &pi_real);
+    range_packing_info(shifts, sizeof(double), &pi_imag);
+    starneig_init_empty_range_packing_info(&pi_aftermath);
+
+    struct packing_info pi_A, pi_B;
+    tile_packing_info(n, n, &pi_A);
+    starneig_init_empty_packing_info(&pi_B);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &thres_a, sizeof(thres_a),
+        STARPU_VALUE, &thres_b, sizeof(thres_b),
+        STARPU_VALUE, &thres_inf, sizeof(thres_inf),
+        STARPU_VALUE, &pi_real, sizeof(pi_real),
+        STARPU_VALUE, &pi_imag, sizeof(pi_imag),
+        STARPU_VALUE, &pi_aftermath, sizeof(pi_aftermath),
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_B, sizeof(pi_B),
+        STARPU_VALUE, &mode, sizeof(mode), 0);
+
+    // each bulge is chased across the window and each step applies a 3-by-3
+    // reflector to the window and to the local transformation matrix
+    bcase->flops = 9.0*shifts*n*n;
+}
+
+static void setup_aggressively_deflate(int n, int nb, struct bench_case *bcase)
+{
+    add_variable(sizeof(struct aed_status), bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_vector(n, sizeof(double), bcase);
+    add_vector(n, sizeof(double), bcase);
+    add_matrix(INIT_HESSENBERG, n, n, bcase);
+
+    double thres_a = n*dlamch("Precision"), thres_b = 0.0, thres_inf = 0.0;
+
+    struct range_packing_info pi_real, pi_imag;
+    range_packing_info(n, sizeof(double), &pi_real);
+    range_packing_info(n, sizeof(double), &pi_imag);
+
+    struct packing_info pi_A, pi_B;
+    tile_packing_info(n, n, &pi_A);
+    starneig_init_empty_packing_info(&pi_B);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &thres_a, sizeof(thres_a),
+        STARPU_VALUE, &thres_b, sizeof(thres_b),
+        STARPU_VALUE, &thres_inf, sizeof(thres_inf),
+        STARPU_VALUE, &pi_real, sizeof(pi_real),
+        STARPU_VALUE, &pi_imag, sizeof(pi_imag),
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_B, sizeof(pi_B), 0);
+
+    // dominated by the Schur reduction of the AED window
+    bcase->flops = 25.0*n*n*n;
+}
+
+static int check_aggressively_deflate(int n, struct bench_case const *bcase)
+{
+    struct aed_status const *status = bcase->data[0].ptr;
+    return status->status != AED_STATUS_SUCCESS;
+}
+
+static void setup_small_schur(int n, int nb, struct bench_case *bcase)
+{
+    add_variable(sizeof(struct small_schur_status), bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_HESSENBERG, n, n, bcase);
+
+    double thres_a = n*dlamch("Precision"), thres_b = 0.0, thres_inf = 0.0;
+
+    struct packing_info pi_A, pi_B;
+    tile_packing_info(n, n, &pi_A);
+    starneig_init_empty_packing_info(&pi_B);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &thres_a, sizeof(thres_a),
+        STARPU_VALUE, &thres_b, sizeof(thres_b),
+        STARPU_VALUE, &thres_inf, sizeof(thres_inf),
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_B, sizeof(pi_B), 0);
+
+    bcase->flops = 25.0*n*n*n;
+}
+
+static int check_small_schur(int n, struct bench_case const *bcase)
+{
+    struct small_schur_status const *status = bcase->data[0].ptr;
+    return status->converged < n;
+}
+
+static void setup_small_hessenberg(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_RANDOM, n, n, bcase);
+
+    struct packing_info pi_A, pi_B;
+    tile_packing_info(n, n, &pi_A);
+    starneig_init_empty_packing_info(&pi_B);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_B, sizeof(pi_B), 0);
+
+    bcase->flops = 14.0/3.0*n*n*n;
+}
+
+//
+// eigenvalue reordering kernels
+//
+
+static void setup_reorder_window(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    int *selected = add_vector(n, sizeof(int), bcase);
+    add_matrix(INIT_SCHUR, n, n, bcase);
+
+    // select every other eigenvalue
+    int swaps = 0;
+    for (int i = 0; i < n; i++) {
+        selected[i] = i % 2;
+        if (selected[i])
+            swaps += (i+1)/2;
+    }
+
+    int window_size = 64, threshold = 128;
+
+    struct range_packing_info pi_selected;
+    range_packing_info(n, sizeof(int), &pi_selected);
+
+    struct packing_info pi_A, pi_B;
+    tile_packing_info(n, n, &pi_A);
+    starneig_init_empty_packing_info(&pi_B);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_selected, sizeof(pi_selected),
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_B, sizeof(pi_B),
+        STARPU_VALUE, &window_size, sizeof(window_size),
+        STARPU_VALUE, &threshold, sizeof(threshold),
+        STARPU_VALUE, &swaps, sizeof(swaps), 0);
+
+    // each swap applies a rotation to two rows and two columns of the window
+    // and to two columns of the local transformation matrix
+    bcase->flops = 18.0*swaps*n;
+}
+
+static int check_reorder_window(int n, struct bench_case const *bcase)
+{
+    // a failed swap taints the selection bitmap
+    int const *selected = bcase->data[2].ptr;
+    for (int i = 0; i < n; i++)
+        if (selected[i] == TAINTED_SELECTED ||
+        selected[i] == TAINTED_DESELECTED)
+            return 1;
+    return 0;
+}
+
+//
+// Hessenberg reduction kernels
+//
+
+static void setup_prepare_column(int n, int nb, struct bench_case *bcase)
+{
+    int i = nb/2;
+
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    double *V = add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_TRIANGULAR, nb, nb, bcase);
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_vector(n-i, sizeof(double), bcase);
+
+    // unit lower triangular Householder vectors
+    size_t ldV = STARPU_MATRIX_GET_LD(bcase->buffers[1]);
+    for (int j = 0; j < nb; j++) {
+        for (int k = 0; k < j; k++)
+            V[j*ldV+k] = 0.0;
+        V[j*ldV+j] = 1.0;
+    }
+
+    struct range_packing_info pi_v;
+    range_packing_info(n-i, sizeof(double), &pi_v);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &i, sizeof(i),
+        STARPU_VALUE, &pi_v, sizeof(pi_v), 0);
+
+    bcase->flops = 6.0*n*i;
+}
+
+static void setup_compute_column(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_RANDOM, n, n, bcase);
+    double *v = add_vector(n, sizeof(double), bcase);
+    add_vector(n, sizeof(double), bcase);
+
+    for (int i = 0; i < n; i++)
+        v[i] = random_double();
+
+    struct packing_info pi_A;
+    tile_packing_info(n, n, &pi_A);
+
+    struct range_packing_info pi_v, pi_y;
+    range_packing_info(n, sizeof(double), &pi_v);
+    range_packing_info(n, sizeof(double), &pi_y);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_v, sizeof(pi_v),
+        STARPU_VALUE, &pi_y, sizeof(pi_y), 0);
+
+    bcase->flops = 2.0*n*n;
+}
+
+static void setup_finish_column(int n, int nb, struct bench_case *bcase)
+{
+    int i = nb/2;
+
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_TRIANGULAR, nb, nb, bcase);
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    double *y = add_vector(n, sizeof(double), bcase);
+
+    for (int j = 0; j < n; j++)
+        y[j] = random_double();
+
+    struct range_packing_info pi_y;
+    range_packing_info(n, sizeof(double), &pi_y);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &i, sizeof(i),
+        STARPU_VALUE, &pi_y, sizeof(pi_y), 0);
+
+    bcase->flops = 4.0*n*i;
+}
+
+static void setup_update_trail_right(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_RANDOM, n+nb, nb, bcase);
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_RANDOM, n, n, bcase);
+
+    int roffset = 0, coffset = 0;
+
+    struct packing_info pi_A;
+    tile_packing_info(n, n, &pi_A);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &nb, sizeof(nb),
+        STARPU_VALUE, &roffset, sizeof(roffset),
+        STARPU_VALUE, &coffset, sizeof(coffset), 0);
+
+    bcase->flops = 2.0*n*n*nb;
+}
+
+static void setup_update_a(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_TRIANGULAR, nb, nb, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_ZERO, n, nb, bcase);
+    add_matrix(INIT_ZERO, n, nb, bcase);
+    add_matrix(INIT_RANDOM, n, n, bcase);
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+
+    int offset = 0;
+
+    struct packing_info pi_A, pi_W;
+    tile_packing_info(n, n, &pi_A);
+    tile_packing_info(n, nb, &pi_W);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_W, sizeof(pi_W),
+        STARPU_VALUE, &nb, sizeof(nb),
+        STARPU_VALUE, &offset, sizeof(offset), 0);
+
+    bcase->flops = 2.0*n*n*nb + 1.0*n*nb*nb + 1.0*n*nb;
+}
+
+static void setup_update_left_b(int n, int nb, struct bench_case *bcase)
+{
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_ZERO, n, nb, bcase);
+    add_matrix(INIT_ZERO, n, n, bcase);
+    add_matrix(INIT_RANDOM, n, nb, bcase);
+    add_matrix(INIT_RANDOM, n, n, bcase);
+
+    int offset = 0;
+
+    struct packing_info pi_A, pi_W;
+    tile_packing_info(n, n, &pi_A);
+    tile_packing_info(n, nb, &pi_W);
+
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &pi_A, sizeof(pi_A),
+        STARPU_VALUE, &pi_W, sizeof(pi_W),
+        STARPU_VALUE, &nb, sizeof(nb),
+        STARPU_VALUE, &offset, sizeof(offset), 0);
+
+    bcase->flops = 2.0*n*n*nb;
+}
+
+//
+// eigenvector kernels
+//
+
+static void init_norms(
+    int m, int n, size_t ld, double const *X, double *norms)
+{
+    for (int j = 0; j < n; j++) {
+        norms[j] = 0.0;
+        for (int i = 0; i < m; i++)
+            norms[j] = MAX(norms[j], fabs(X[j*ld+i]));
+    }
+}
+
+static void setup_eigvec_solve(int n, int nb, struct bench_case *bcase)
+{
+    double *T = add_matrix(INIT_SCHUR, n, n, bcase);
+    double *ubT = add_variable(sizeof(double), bcase);
+    double *X = add_matrix(INIT_RANDOM, n, n, bcase);
+    scaling_t *scales = add_vector(n, sizeof(scaling_t), bcase);
+    double *norms = add_vector(n, sizeof(double), bcase);
+    double *lambda = add_vector(n, sizeof(double), bcase);
+    add_vector(n, sizeof(int), bcase);
+    int *selected = add_vector(n, sizeof(int), bcase);
+    add_vector(n, sizeof(int), bcase);
+    add_vector(n, sizeof(int), bcase);
+
+    // real eigenvalues that belong to a different diagonal tile
+    for (int i = 0; i < n; i++) {
+        lambda[i] = n + 1.5 + i;
+        selected[i] = 1;
+    }
+
+    double *col_norms = malloc(n*sizeof(double));
+    init_norms(n, n, STARPU_MATRIX_GET_LD(bcase->buffers[0]), T, col_norms);
+    *ubT = 0.0;
+    for (int i = 0; i < n; i++)
+        *ubT = MAX(*ubT, col_norms[i]);
+    free(col_norms);
+
+    starneig_eigvec_std_init_scaling_factor(n, scales);
+    init_norms(n, n, STARPU_MATRIX_GET_LD(bcase->buffers[2]), X, norms);
+
+    double smlnum = DBL_MIN / DBL_EPSILON;
+    starpu_codelet_pack_args(&bcase->args, &bcase->args_size,
+        STARPU_VALUE, &smlnum, sizeof(smlnum), 0);
+
+    // one triangular solve per eigenvalue
+    bcase->flops = 1.0*n*n*n;
+}
+
+static int check_eigvec_solve(int n, struct bench_case const *bcase)
+{
+    // a non-zero info means that a perturbed system was solved
+    int const *infos = bcase->data[9].ptr;
+    for (int i = 0; i < n; i++)
+        if (infos[i] != 0)
+            return 1;
+    return 0;
+}
+
+static void setup_eigvec_update(int n, int nb, struct bench_case *bcase)
+{
+    double *T = add_matrix(INIT_RANDOM, n, n, bcase);
+    double *ubT = add_variable(sizeof(double), bcase);
+    double *X = add_matrix(INIT_RANDOM, n, n, bcase);
+    scaling_t *X_scales = add_vector(n, sizeof(scaling_t), bcase);
+    double *X_norms = add_vector(n, sizeof(double), bcase);
+    double *Y = add_matrix(INIT_RANDOM, n, n, bcase);
+    scaling_t *Y_scales = add_vector(n, sizeof(scaling_t), bcase);
+    double *Y_norms = add_vector(n, sizeof(double), bcase);
+    add_vector(n, sizeof(int), bcase);
+
+    double *col_norms = malloc(n*sizeof(double));
+    init_norms(n, n, STARPU_MATRIX_GET_LD(bcase->buffers[0]), T, col_norms);
+    *ubT = 0.0;
+    for (int i = 0; i < n; i++)
+        *ubT = MAX(*ubT, col_norms[i]);
+    free(col_norms);
+
+    starneig_eigvec_std_init_scaling_factor(n, X_scales);
+    starneig_eigvec_std_init_scaling_factor(n, Y_scales);
+    init_norms(n, n, STARPU_MATRIX_GET_LD(bcase->buffers[2]), X, X_norms);
+    init_norms(n, n, STARPU_MATRIX_GET_LD(bcase->buffers[5]), Y, Y_norms);
+
+    bcase->flops = 2.0*n*n*n;
+}
+
+static struct kernel const kernels[] = {
+    { "left_gemm_update",
+        starneig_cpu_left_gemm_update, setup_gemm_update, NULL },
+    { "right_gemm_update",
+        starneig_cpu_right_gemm_update, setup_gemm_update, NULL },
+    { "push_bulges",
+        starneig_cpu_push_bulges, setup_push_bulges, NULL },
+    { "aggressively_deflate",
+        starneig_cpu_aggressively_deflate, setup_aggressively_deflate,
+        check_aggressively_deflate },
+    { "small_schur",
+        starneig_cpu_small_schur, setup_small_schur, check_small_schur },
+    { "small_hessenberg",
+        starneig_cpu_small_hessenberg, setup_small_hessenberg, NULL },
+    { "reorder_window",
+        starneig_cpu_reorder_window, setup_reorder_window,
+        check_reorder_window },
+    { "hessenberg_prepare_column",
+        starneig_hessenberg_cpu_prepare_column, setup_prepare_column, NULL },
+    { "hessenberg_compute_column",
+        starneig_hessenberg_cpu_compute_column, setup_compute_column, NULL },
+    { "hessenberg_finish_column",
+        starneig_hessenberg_cpu_finish_column, setup_finish_column, NULL },
+    { "hessenberg_update_trail_right",
+        starneig_hessenberg_cpu_update_trail_right, setup_update_trail_right,
+        NULL },
+    { "hessenberg_update_left_a",
+        starneig_hessenberg_cpu_update_left_a, setup_update_a, NULL },
+    { "hessenberg_update_left_b",
+        starneig_hessenberg_cpu_update_left_b, setup_update_left_b, NULL },
+    { "hessenberg_update_right_a",
+        starneig_hessenberg_cpu_update_right_a, setup_update_a, NULL },
+    { "eigvec_solve",
+        starneig_eigvec_std_cpu_solve, setup_eigvec_solve,
+        check_eigvec_solve },
+    { "eigvec_update",
+        starneig_eigvec_std_cpu_update, setup_eigvec_update, NULL }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static int compare_doubles(void const *a, void const *b)
+{
+    double x = *(double const *) a, y = *(double const *) b;
+    return (x > y) - (x < y);
+}
+
+//
+// runs a kernel and returns the number of calls that reported a failure
+//
+static int run_kernel(
+    struct kernel const *kernel, int n, int nb, int warmup, int repeat,
+    struct result *result)
+{
+    struct bench_case bcase;
+    memset(&bcase, 0, sizeof(bcase));
+    kernel->setup(n, MIN(n, nb), &bcase);
+    snapshot(&bcase);
+
+    int failures = 0;
+
+    for (int i = 0; i < warmup; i++) {
+        restore(&bcase);
+        kernel->func(bcase.buffers, bcase.args);
+        if (kernel->check != NULL && kernel->check(n, &bcase))
+            failures++;
+    }
+
+    double *times = malloc(repeat*sizeof(double));
+    for (int i = 0; i < repeat; i++) {
+        restore(&bcase);
+        double begin = get_time();
+        kernel->func(bcase.buffers, bcase.args);
+        times[i] = get_time() - begin;
+        if (kernel->check != NULL && kernel->check(n, &bcase))
+            failures++;
+    }
+
+    qsort(times, repeat, sizeof(double), compare_doubles);
+
+    double sum = 0.0, sq_sum = 0.0;
+    for (int i = 0; i < repeat; i++)
+        sum += times[i];
+    double mean = sum / repeat;
+    for (int i = 0; i < repeat; i++)
+        sq_sum += (times[i] - mean) * (times[i] - mean);
+
+    result->kernel = kernel->name;
+    result->n = n;
+    result->flops = bcase.flops;
+    result->bytes = bcase.bytes;
+    result->min = times[0];
+    result->median = repeat % 2 ? times[repeat/2] :
+        0.5*(times[repeat/2-1] + times[repeat/2]);
+    result->mean = mean;
+    result->stddev = 1 < repeat ? sqrt(sq_sum / (repeat-1)) : 0.0;
+    result->max = times[repeat-1];
+
+    free(times);
+    free_case(&bcase);
+
+    return failures;
+}
+
+//
+// returns a pointer to the value of a key inside a flat JSON object
+//
+static char const * find_key(char const *object, char const *key)
+{
+    size_t len = strlen(key);
+    for (char const *ptr = strchr(object, '"'); ptr != NULL;
+    ptr = strchr(ptr+1, '"')) {
+        if (strncmp(ptr+1, key, len) == 0 && ptr[len+1] == '"') {
+            char const *value = ptr + len + 2;
+            while (*value == ' ')
+                value++;
+            if (*value == ':')
+                return value + 1;
+        }
+    }
+    return NULL;
+}
+
+static int read_baseline(char const *file_name, struct baseline *baseline)
+{
+    FILE *file = fopen(file_name, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s.\n", file_name);
+        return 0;
+    }
+
+    // each result object is on its own line; the keys are looked up
+    // independently so that their order does not matter
+    int count = 0;
+    char line[1024];
+    while (count < MAX_BASELINE && fgets(line, sizeof(line), file) != NULL) {
+        char *end = strchr(line, '}');
+        if (end == NULL)
+            continue;
+        *end = '\0';
+
+        char const *kernel = find_key(line, "kernel");
+        char const *n = find_key(line, "n");
+        char const *median = find_key(line, "median");
+        if (kernel == NULL || n == NULL || median == NULL)
+            continue;
+
+        struct baseline *entry = &baseline[count];
+        if (sscanf(kernel, " \"%63[^\"]\"", entry->kernel) == 1 &&
+        sscanf(n, "%d", &entry->n) == 1 &&
+        sscanf(median, "%lf", &entry->median) == 1)
+            count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+static double find_baseline(
+    struct result const *result, int count, struct baseline const *baseline)
+{
+    for (int i = 0; i < count; i++)
+        if (strcmp(baseline[i].kernel, result->kernel) == 0 &&
+        baseline[i].n == result->n)
+            return baseline[i].median;
+    return 0.0;
+}
+
+static int parse_sizes(char const *str, int *sizes)
+{
+    int count = 0;
+    char *copy = strdup(str), *save = NULL;
+    for (char *token = strtok_r(copy, ",", &save);
+    token != NULL && count < MAX_SIZES; token = strtok_r(NULL, ",", &save)) {
+        int size = atoi(token);
+        if (size < 2) {
+            free(copy);
+            return 0;
+        }
+        sizes[count++] = size;
+    }
+    free(copy);
+    return count;
+}
+
+static int match_kernel(char const *filter, char const *name)
+{
+    if (filter == NULL)
+        return 1;
+
+    int ret = 0;
+    char *copy = strdup(filter), *save = NULL;
+    for (char *token = strtok_r(copy, ",", &save); token != NULL;
+    token = strtok_r(NULL, ",", &save))
+        if (strstr(name, token) != NULL)
+            ret = 1;
+    free(copy);
+    return ret;
+}
+
+///
+/// @brief Returns the number of free explicit huge pages.
+///
+static long get_free_huge_pages()
+{
+    long free_pages = 0;
+    FILE *file = fopen("/proc/meminfo", "r");
+    if (file == NULL)
+        return 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL)
+        if (sscanf(line, "HugePages_Free: %ld", &free_pages) == 1)
+            break;
+    fclose(file);
+    return free_pages;
+}
+
+///
+/// @brief Checks that a buffer is aligned and that its first and last bytes
+/// can be written.
+///
+static int check_buffer(
+    char const *name, void *ptr, size_t size, size_t alignment)
+{
+    if (ptr == NULL) {
+        printf("ALLOC: %s (%zu bytes) FAILED: NULL\n", name, size);
+        return 1;
+    }
+    if ((uintptr_t) ptr % alignment != 0) {
+        printf("ALLOC: %s (%zu bytes) FAILED: not aligned to %zu bytes\n",
+            name, size, alignment);
+        return 1;
+    }
+    ((volatile char *) ptr)[0] = 1;
+    ((volatile char *) ptr)[size-1] = 1;
+    return 0;
+}
+
+///
+/// @brief Checks the leading dimension padding and the alignment of the
+/// workspace and huge page allocations.
+///
+/// @return The number of failed checks.
+///
+static int check_alloc()
+{
+    int failed = 0;
+
+    // leading dimensions
+    size_t const elemsizes[] = { 1, 4, 8, 16, 24 };
+    for (int i = 0; i < sizeof(elemsizes)/sizeof(elemsizes[0]); i++) {
+        size_t elemsize = elemsizes[i];
+        for (int m = 0; m <= 4096; m++) {
+            size_t ld = starneig_alloc_ld(m, elemsize);
+            size_t bytes = ld*elemsize;
+            int ok = MAX(1, m) <= ld;
+            if (STARNEIG_CACHE_LINE_SIZE % elemsize == 0) {
+                size_t lines = bytes / STARNEIG_CACHE_LINE_SIZE;
+                ok = ok && bytes % STARNEIG_CACHE_LINE_SIZE == 0;
+                ok = ok && (bytes < STARNEIG_ALIAS_THRESHOLD || lines % 2);
+                ok = ok && (lines-1)*STARNEIG_CACHE_LINE_SIZE <
+                    MAX(1, m)*elemsize + STARNEIG_CACHE_LINE_SIZE;
+            }
+            else {
+                ok = ok && ld == MAX(1, m);
+            }
+            if (!ok) {
+                printf("ALLOC: ld(%d, %zu) = %zu FAILED\n", m, elemsize, ld);
+                failed++;
+            }
+        }
+    }
+
+    // power-of-two column strides of at least eight cache lines are padded by
+    // one cache line
+    if (starneig_alloc_ld(1024, sizeof(double)) != 1032 ||
+    starneig_alloc_ld(64, sizeof(double)) != 72 ||
+    starneig_alloc_ld(56, sizeof(double)) != 56) {
+        printf("ALLOC: power-of-two padding FAILED\n");
+        failed++;
+    }
+
+    // workspaces
+    size_t const sizes[] = {
+        1, 100, STARNEIG_PAGE_SIZE-1, STARNEIG_PAGE_SIZE, 1000000 };
+    for (int i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++) {
+        void *ptr = starneig_alloc_aligned(sizes[i]);
+        failed += check_buffer("aligned", ptr, sizes[i],
+            STARNEIG_PAGE_SIZE <= sizes[i] ?
+            STARNEIG_PAGE_SIZE : STARNEIG_CACHE_LINE_SIZE);
+        starneig_free_aligned(ptr);
+    }
+
+    // long-lived buffers; the small one comes from the heap
+    starneig_huge_pages_t mode = starneig_alloc_get_huge_pages();
+    size_t huge_alignment = mode == STARNEIG_HUGE_PAGES_NONE ?
+        STARNEIG_PAGE_SIZE : STARNEIG_HUGE_PAGE_SIZE;
+    {
+        void *small = starneig_alloc_huge(STARNEIG_PAGE_SIZE);
+        failed += check_buffer(
+            "huge", small, STARNEIG_PAGE_SIZE, STARNEIG_PAGE_SIZE);
+        size_t size = STARNEIG_HUGE_PAGE_THRESHOLD + 1;
+        void *large = starneig_alloc_huge(size);
+        failed += check_buffer("huge", large, size, huge_alignment);
+        starneig_free_huge(large);
+        starneig_free_huge(small);
+    }
+
+    // a request that exceeds the explicit huge page pool must fall back to
+    // transparent huge pages
+    if (mode == STARNEIG_HUGE_PAGES_EXPLICIT) {
+        size_t size = MAX(STARNEIG_HUGE_PAGE_THRESHOLD,
+            (get_free_huge_pages()+1)*STARNEIG_HUGE_PAGE_SIZE);
+        void *ptr = starneig_alloc_huge(size);
+        failed += check_buffer("fallback", ptr, size, huge_alignment);
+        starneig_free_huge(ptr);
+    }
+
+    printf("ALLOC: %s\n", failed ? "FAILED" : "PASSED");
+
+    return failed;
+}
+
+static void print_usage(char const *name)
+{
+    printf(
+        "Usage: %s [options]\n"
+        "\n"
+        "Calls the CPU kernels directly on synthetic inputs.\n"
+        "\n"
+        "  --kernels (list)  Comma separated list of kernel name filters\n"
+        "  --sizes (list)    Comma separated list of problem sizes [%s]\n"
+        "  --panel (num)     Hessenberg panel width [%d]\n"
+        "  --warmup (num)    Warmup repetitions [%d]\n"
+        "  --repeat (num)    Timed repetitions [%d]\n"
+        "  --seed (num)      Random number generator seed [%d]\n"
+        "  --output (file)   Writes the results to a JSON file\n"
+        "  --baseline (file) Compares the results against an earlier JSON file\n"
+        "  --list            Lists the kernels\n"
+        "  --check-alloc     Checks the memory allocator and exits\n",
+        name, DEFAULT_SIZES, DEFAULT_PANEL, DEFAULT_WARMUP, DEFAULT_REPEAT,
+        DEFAULT_SEED);
+}
+
+int main(int argc, char **argv)
+{
+    char const *filter = NULL;
+    char const *sizes_str = DEFAULT_SIZES;
+    char const *output = NULL;
+    char const *baseline_file = NULL;
+    int panel = DEFAULT_PANEL;
+    int warmup = DEFAULT_WARMUP;
+    int repeat = DEFAULT_REPEAT;
+    int seed = DEFAULT_SEED;
+
+    int kernel_count = sizeof(kernels)/sizeof(kernels[0]);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--kernels") == 0 && i+1 < argc) {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sizes") == 0 && i+1 < argc) {
+            sizes_str = argv[++i];
+        }
+        else if (strcmp(argv[i], "--panel") == 0 && i+1 < argc) {
+            panel = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--warmup") == 0 && i+1 < argc) {
+            warmup = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && i+1 < argc) {
+            repeat = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i+1 < argc) {
+            seed = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i+1 < argc) {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "--baseline") == 0 && i+1 < argc) {
+            baseline_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--check-alloc") == 0) {
+            return check_alloc() ? 1 : 0;
+        }
+        else if (strcmp(argv[i], "--list") == 0) {
+            for (int j = 0; j < kernel_count; j++)
+                printf("%s\n", kernels[j].name);
+            return 0;
+        }
+        else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    int sizes[MAX_SIZES];
+    int size_count = parse_sizes(sizes_str, sizes);
+    if (size_count < 1 || panel < 1 || warmup < 0 || repeat < 1) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    struct baseline *baseline = malloc(MAX_BASELINE*sizeof(struct baseline));
+    int baseline_count = 0;
+    if (baseline_file != NULL) {
+        baseline_count = read_baseline(baseline_file, baseline);
+        if (baseline_count == 0) {
+            free(baseline);
+            return 1;
+        }
+    }
+
+    srand(seed);
+
+    // the kernels are called from the main thread with sequential BLAS
+    starneig_node_init(1, 0, STARNEIG_HINT_SM | STARNEIG_NO_MESSAGES);
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_SEQUENTIAL);
+
+    struct result *results =
+        malloc(kernel_count*size_count*sizeof(struct result));
+    int result_count = 0;
+    int failed = 0;
+
+    printf("%-30s %6s %11s %11s %11s %9s %9s",
+        "kernel", "n", "median [ms]", "min [ms]", "stddev [ms]",
+        "GFLOP/s", "GB/s");
+    if (0 < baseline_count)
+        printf(" %9s", "speedup");
+    printf("\n");
+
+    for (int i = 0; i < kernel_count; i++) {
+        if (!match_kernel(filter, kernels[i].name))
+            continue;
+
+        for (int j = 0; j < size_count; j++) {
+            struct result *result = &results[result_count++];
+            int failures = run_kernel(
+                &kernels[i], sizes[j], panel, warmup, repeat, result);
+
+            printf("%-30s %6d %11.4f %11.4f %11.4f %9.3f %9.3f",
+                result->kernel, result->n, 1.0E3*result->median,
+                1.0E3*result->min, 1.0E3*result->stddev,
+                1.0E-9*result->flops/result->median,
+                1.0E-9*result->bytes/result->median);
+
+            if (0 < baseline_count) {
+                double old = find_baseline(result, baseline_count, baseline);
+                if (0.0 < old)
+                    printf(" %8.3fx", old/result->median);
+                else
+                    printf(" %9s", "n/a");
+            }
+            if (0 < failures) {
+                printf(" FAILED (%d/%d calls)", failures, warmup+repeat);
+                failed++;
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
+    starneig_node_finalize();
+
+    if (output != NULL) {
+        FILE *file = fopen(output, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot open %s.\n", output);
+            free(results);
+            free(baseline);
+            return 1;
+        }
+
+        fprintf(file,
+            "{\"version\":\"%d.%d.%d\",\"warmup\":%d,\"repeat\":%d,"
+            "\"panel\":%d,\"seed\":%d,\n\"results\":[\n",
+            STARNEIG_VERSION_MAJOR, STARNEIG_VERSION_MINOR,
+            STARNEIG_VERSION_PATCH, warmup, repeat, panel, seed);
+
+        for (int i = 0; i < result_count; i++) {
+            struct result const *result = &results[i];
+            fprintf(file,
+                "{\"kernel\":\"%s\",\"n\":%d,\"repeat\":%d,\"flops\":%.6e,"
+                "\"bytes\":%.6e,\"min\":%.6e,\"median\":%.6e,\"mean\":%.6e,"
+                "\"stddev\":%.6e,\"max\":%.6e,\"gflops\":%.6e,"
+                "\"bandwidth\":%.6e}%s\n",
+                result->kernel, result->n, repeat, result->flops,
+                result->bytes, result->min, result->median, result->mean,
+                result->stddev, result->max,
+                1.0E-9*result->flops/result->median,
+                1.0E-9*result->bytes/result->median,
+                i+1 < result_count ? "," : "");
+        }
+
+        fprintf(file, "]}\n");
+        fclose(file);
+    }
+
+    free(results);
+    free(baseline);
+
+    if (0 < failed) {
+        fprintf(stderr, "%d benchmark case(s) reported a failure.\n", failed);
+        return 1;
+    }
+
+    return 0;
+}
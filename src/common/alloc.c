@@ -0,0 +1,239 @@
+///
+/// @file
+///
+/// @brief This file contains the allocator that is used for matrices and
+/// matrix shaped workspaces.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "alloc.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+///
+/// @brief Memory mapped allocation. Only the long-lived allocations that are
+/// made with starneig_alloc_huge() are memory mapped.
+///
+struct mapping {
+    void *addr;             ///< mapping address
+    size_t length;          ///< mapping length
+    struct mapping *next;   ///< next mapping
+};
+
+static struct mapping *mappings = NULL;
+static pthread_mutex_t mappings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static starneig_huge_pages_t huge_pages = STARNEIG_HUGE_PAGES_TRANSPARENT;
+static pthread_once_t huge_pages_once = PTHREAD_ONCE_INIT;
+
+///
+/// @brief Reads the huge page mode from the STARNEIG_HUGE_PAGES environmental
+/// variable.
+///
+static void read_huge_pages()
+{
+    char const *value = getenv("STARNEIG_HUGE_PAGES");
+    if (value == NULL || strcmp(value, "transparent") == 0)
+        huge_pages = STARNEIG_HUGE_PAGES_TRANSPARENT;
+    else if (strcmp(value, "none") == 0)
+        huge_pages = STARNEIG_HUGE_PAGES_NONE;
+    else if (strcmp(value, "explicit") == 0)
+        huge_pages = STARNEIG_HUGE_PAGES_EXPLICIT;
+    else
+        starneig_warning(
+            "Invalid STARNEIG_HUGE_PAGES value %s. Using transparent huge "
+            "pages.", value);
+}
+
+///
+/// @brief Maps an anonymous memory region that is aligned to a huge page
+/// boundary.
+///
+/// @param[in] length
+///         The length of the region. Must be a multiple of the huge page size.
+///
+/// @param[in] mode
+///         The huge page mode.
+///
+/// @return The mapping on success, MAP_FAILED otherwise.
+///
+static void * map_huge(size_t length, starneig_huge_pages_t mode)
+{
+#ifdef MAP_HUGETLB
+    if (mode == STARNEIG_HUGE_PAGES_EXPLICIT) {
+        void *ret = mmap(NULL, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ret != MAP_FAILED)
+            return ret;
+
+        // the huge page pool is most likely empty
+        static int warned = 0;
+        if (!__atomic_exchange_n(&warned, 1, __ATOMIC_RELAXED))
+            starneig_warning(
+                "Failed to allocate explicit huge pages. Using transparent "
+                "huge pages.");
+    }
+#endif
+
+    size_t padded = length + STARNEIG_HUGE_PAGE_SIZE;
+    char *reserved = mmap(NULL, padded, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+        return MAP_FAILED;
+
+    char *aligned = (char *)
+        (((uintptr_t) reserved + STARNEIG_HUGE_PAGE_SIZE - 1) &
+        ~((uintptr_t) STARNEIG_HUGE_PAGE_SIZE - 1));
+
+    // release the unaligned head and the excess tail
+    if (reserved < aligned)
+        munmap(reserved, aligned - reserved);
+    size_t tail = (reserved + padded) - (aligned + length);
+    if (0 < tail)
+        munmap(aligned + length, tail);
+
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+
+    return aligned;
+}
+
+starneig_huge_pages_t starneig_alloc_get_huge_pages()
+{
+    pthread_once(&huge_pages_once, read_huge_pages);
+    return huge_pages;
+}
+
+size_t starneig_alloc_ld(int m, size_t elemsize)
+{
+    // element sizes that do not divide the cache line are left unpadded
+    if (STARNEIG_CACHE_LINE_SIZE % elemsize != 0)
+        return MAX(1, m);
+
+    size_t line = STARNEIG_CACHE_LINE_SIZE / elemsize;
+    size_t lines = divceil(MAX(1, m), line);
+
+    // an odd stride (in cache lines) is coprime with the number of sets
+    if (STARNEIG_ALIAS_THRESHOLD <= lines*STARNEIG_CACHE_LINE_SIZE &&
+    lines % 2 == 0)
+        lines++;
+
+    return lines*line;
+}
+
+void * starneig_alloc_aligned(size_t size)
+{
+    if (size == 0)
+        return NULL;
+
+    size_t alignment = STARNEIG_PAGE_SIZE <= size ?
+        STARNEIG_PAGE_SIZE : STARNEIG_CACHE_LINE_SIZE;
+
+#ifdef ALIGNED_ALLOC_FOUND
+    // aligned_alloc requires that the size is a multiple of the alignment
+    return aligned_alloc(
+        alignment, (size + alignment - 1) / alignment * alignment);
+#else
+    void *ptr;
+    if (posix_memalign(&ptr, alignment, size) != 0)
+        return NULL;
+    return ptr;
+#endif
+}
+
+void starneig_free_aligned(void *ptr)
+{
+    free(ptr);
+}
+
+void * starneig_alloc_huge(size_t size)
+{
+    if (size == 0)
+        return NULL;
+
+    starneig_huge_pages_t mode = starneig_alloc_get_huge_pages();
+
+    if (mode == STARNEIG_HUGE_PAGES_NONE ||
+    size < STARNEIG_HUGE_PAGE_THRESHOLD)
+        return starneig_alloc_aligned(size);
+
+    size_t length = (size + STARNEIG_HUGE_PAGE_SIZE - 1) /
+        STARNEIG_HUGE_PAGE_SIZE * STARNEIG_HUGE_PAGE_SIZE;
+
+    void *addr = map_huge(length, mode);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+    struct mapping *mapping = malloc(sizeof(struct mapping));
+    mapping->addr = addr;
+    mapping->length = length;
+
+    pthread_mutex_lock(&mappings_mutex);
+    mapping->next = mappings;
+    mappings = mapping;
+    pthread_mutex_unlock(&mappings_mutex);
+
+    return addr;
+}
+
+void starneig_free_huge(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    // only large allocations are memory mapped
+    pthread_mutex_lock(&mappings_mutex);
+    struct mapping **iter = &mappings;
+    while (*iter != NULL && (*iter)->addr != ptr)
+        iter = &(*iter)->next;
+    struct mapping *mapping = *iter;
+    if (mapping != NULL)
+        *iter = mapping->next;
+    pthread_mutex_unlock(&mappings_mutex);
+
+    if (mapping != NULL) {
+        munmap(mapping->addr, mapping->length);
+        free(mapping);
+        return;
+    }
+
+    free(ptr);
+}
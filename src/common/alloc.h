@@ -0,0 +1,161 @@
+///
+/// @file
+///
+/// @brief This file contains the allocator that is used for matrices and
+/// matrix shaped workspaces.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_ALLOC_H
+#define STARNEIG_COMMON_ALLOC_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///
+/// @brief Cache line size.
+///
+#define STARNEIG_CACHE_LINE_SIZE 64
+
+///
+/// @brief Page size.
+///
+#define STARNEIG_PAGE_SIZE 4096
+
+///
+/// @brief Huge page size.
+///
+#define STARNEIG_HUGE_PAGE_SIZE (2*1024*1024)
+
+///
+/// @brief Allocations that are made with starneig_alloc_huge() and are at
+/// least this large are backed by huge pages.
+///
+#define STARNEIG_HUGE_PAGE_THRESHOLD (2*STARNEIG_HUGE_PAGE_SIZE)
+
+///
+/// @brief Column strides that are at least this large are padded to an odd
+/// number of cache lines.
+///
+#define STARNEIG_ALIAS_THRESHOLD (8*STARNEIG_CACHE_LINE_SIZE)
+
+///
+/// @brief Huge page modes.
+///
+typedef enum {
+    STARNEIG_HUGE_PAGES_NONE,           ///< regular pages
+    STARNEIG_HUGE_PAGES_TRANSPARENT,    ///< transparent huge pages
+    STARNEIG_HUGE_PAGES_EXPLICIT        ///< explicit huge pages (hugetlbfs)
+} starneig_huge_pages_t;
+
+///
+/// @brief Returns the huge page mode. The mode is read from the
+/// STARNEIG_HUGE_PAGES environmental variable.
+///
+/// @return huge page mode
+///
+starneig_huge_pages_t starneig_alloc_get_huge_pages();
+
+///
+/// @brief Computes a leading dimension for a matrix.
+///
+///  Each column is padded to a full cache line. If the column stride is large
+///  and an even multiple of the cache line size, an extra cache line is added
+///  so that consecutive columns do not map to the same cache and TLB sets.
+///
+/// @param[in] m
+///         The number of rows in the matrix.
+///
+/// @param[in] elemsize
+///         The matrix element size.
+///
+/// @return The leading dimension.
+///
+size_t starneig_alloc_ld(int m, size_t elemsize);
+
+///
+/// @brief Allocates an aligned memory buffer from the heap.
+///
+///  Small buffers are aligned to a cache line and buffers that span several
+///  pages are aligned to a page. Suitable for short-lived buffers such as
+///  codelet workspaces.
+///
+/// @param[in] size
+///         The size of the buffer.
+///
+/// @return Pointer to the allocated buffer, NULL if the allocation failed.
+///
+void * starneig_alloc_aligned(size_t size);
+
+///
+/// @brief Frees a buffer that was allocated with starneig_alloc_aligned().
+///
+/// @param[in] ptr
+///         The buffer.
+///
+void starneig_free_aligned(void *ptr);
+
+///
+/// @brief Allocates a long-lived memory buffer.
+///
+///  Large buffers are aligned to a huge page and backed by huge pages as
+///  dictated by starneig_alloc_get_huge_pages(). Other buffers are allocated
+///  with starneig_alloc_aligned(). Mapping and faulting in the huge pages is
+///  expensive and the function should not be used for per-task workspaces.
+///
+/// @param[in] size
+///         The size of the buffer.
+///
+/// @return Pointer to the allocated buffer, NULL if the allocation failed.
+///
+void * starneig_alloc_huge(size_t size);
+
+///
+/// @brief Frees a buffer that was allocated with starneig_alloc_huge().
+///
+/// @param[in] ptr
+///         The buffer.
+///
+void starneig_free_huge(void *ptr);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif
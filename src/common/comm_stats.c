@@ -0,0 +1,431 @@
+///
+/// @file
+///
+/// @brief This file contains the per-phase accounting of the StarPU-MPI data
+/// transfers and the time that is spent waiting for them. The transfers are
+/// modelled from the task inputs; the actual StarPU-MPI transfers are not
+/// observed.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "comm_stats.h"
+#include "trace.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <starpu_mpi.h>
+#endif
+
+#ifdef STARNEIG_ENABLE_MPI
+
+///
+/// @brief Number of buckets in the cached copy hash table.
+///
+#define COMM_STATS_BUCKETS 1024
+
+///
+/// @brief Communication counters.
+///
+struct counters {
+    long long sent_bytes;
+    long long sent_messages;
+    long long recv_bytes;
+    long long recv_messages;
+};
+
+///
+/// @brief Tracks the MPI ranks that have a valid copy of a data handle.
+///
+struct copy_state {
+    starpu_data_handle_t handle;    ///< data handle
+    int64_t tag;                    ///< StarPU-MPI tag (detects stale entries)
+    char *valid;                    ///< valid copy flag for each MPI rank
+    struct copy_state *next;        ///< next entry in the bucket
+};
+
+static struct {
+    int enabled;                    ///< non-zero if the statistics are enabled
+    int phase;                      ///< current phase
+    int world_size;                 ///< communicator size
+    int rank;                       ///< rank of the calling process
+    struct counters *counters;      ///< [phase][peer] counters
+    double wait[STARNEIG_COMM_PHASE_COUNT]; ///< wait time for each phase
+    struct copy_state *buckets[COMM_STATS_BUCKETS]; ///< cached copies
+} stats = { .phase = STARNEIG_COMM_PHASE_OTHER };
+
+static char const * const phase_names[STARNEIG_COMM_PHASE_COUNT] = {
+    "Hessenberg panel", "Hessenberg update", "AED", "bulges", "reorder",
+    "eigenvalues", "other"
+};
+
+///
+/// @brief Makes sure that the counters are allocated.
+///
+/// @return non-zero if the statistics are being collected
+///
+static int prepare()
+{
+    if (!stats.enabled)
+        return 0;
+
+    if (stats.counters == NULL) {
+        stats.world_size = starneig_mpi_get_comm_size();
+        stats.rank = starneig_mpi_get_comm_rank();
+        stats.counters = calloc(
+            STARNEIG_COMM_PHASE_COUNT*stats.world_size,
+            sizeof(struct counters));
+    }
+
+    return 1;
+}
+
+static unsigned hash(starpu_data_handle_t handle)
+{
+    return ((uintptr_t) handle >> 4) % COMM_STATS_BUCKETS;
+}
+
+///
+/// @brief Returns the copy state of a data handle.
+///
+/// @param[in] handle
+///         data handle
+///
+/// @param[in] owner
+///         owner of the data handle
+///
+/// @return copy state
+///
+static struct copy_state * get_state(starpu_data_handle_t handle, int owner)
+{
+    int64_t tag = starpu_mpi_data_get_tag(handle);
+
+    struct copy_state *iter = stats.buckets[hash(handle)];
+    while (iter != NULL && iter->handle != handle)
+        iter = iter->next;
+
+    if (iter == NULL) {
+        iter = malloc(sizeof(struct copy_state));
+        iter->handle = handle;
+        iter->valid = malloc(stats.world_size);
+        iter->next = stats.buckets[hash(handle)];
+        stats.buckets[hash(handle)] = iter;
+    }
+    else if (iter->tag == tag) {
+        return iter;
+    }
+
+    // a new entry or the data handle address has been reused
+    iter->tag = tag;
+    memset(iter->valid, 0, stats.world_size);
+    iter->valid[owner] = 1;
+
+    return iter;
+}
+
+///
+/// @brief Records a single message.
+///
+/// @param[in] from
+///         sender
+///
+/// @param[in] to
+///         receiver
+///
+/// @param[in] size
+///         message size in bytes
+///
+static void record(int from, int to, size_t size)
+{
+    struct counters *counters =
+        stats.counters + (size_t) stats.phase*stats.world_size;
+
+    if (from == stats.rank) {
+        counters[to].sent_bytes += size;
+        counters[to].sent_messages++;
+    }
+    if (to == stats.rank) {
+        counters[from].recv_bytes += size;
+        counters[from].recv_messages++;
+    }
+}
+
+static void sum_counters(int phase, int peer, struct counters *sum)
+{
+    memset(sum, 0, sizeof(struct counters));
+
+    if (stats.counters == NULL)
+        return;
+
+    for (int i = 0; i < STARNEIG_COMM_PHASE_COUNT; i++) {
+        if (phase != STARNEIG_COMM_PHASE_ALL && phase != i)
+            continue;
+        for (int j = 0; j < stats.world_size; j++) {
+            if (peer != STARNEIG_COMM_PEER_ALL && peer != j)
+                continue;
+            struct counters const *c =
+                &stats.counters[(size_t) i*stats.world_size+j];
+            sum->sent_bytes += c->sent_bytes;
+            sum->sent_messages += c->sent_messages;
+            sum->recv_bytes += c->recv_bytes;
+            sum->recv_messages += c->recv_messages;
+        }
+    }
+}
+
+#endif // STARNEIG_ENABLE_MPI
+
+int starneig_comm_stats_set_phase(int phase)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    int old = stats.phase;
+    stats.phase = phase;
+    return old;
+#else
+    return phase;
+#endif
+}
+
+void starneig_comm_stats_task(
+    int node, struct starpu_data_descr const *descrs, int count)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    // the tags connect the data accesses of the ranks in the trace
+    starneig_trace_data_tags(descrs, count);
+
+    if (!prepare())
+        return;
+
+    for (int i = 0; i < count; i++) {
+        int owner = starpu_mpi_data_get_rank(descrs[i].handle);
+
+        // per-node data and unregistered data do not generate messages
+        if (owner < 0 || stats.world_size <= owner)
+            continue;
+
+        struct copy_state *state = get_state(descrs[i].handle, owner);
+        size_t size = starpu_data_get_size(descrs[i].handle);
+
+        if ((descrs[i].mode & STARPU_R) && !state->valid[node]) {
+            record(owner, node, size);
+            state->valid[node] = 1;
+        }
+
+        if (descrs[i].mode & STARPU_W) {
+            if (node != owner)
+                record(node, owner, size);
+            memset(state->valid, 0, stats.world_size);
+            state->valid[owner] = 1;
+            state->valid[node] = 1;
+        }
+    }
+#endif
+}
+
+void starneig_comm_stats_broadcast(starpu_data_handle_t handle)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (!prepare())
+        return;
+
+    int owner = starpu_mpi_data_get_rank(handle);
+    if (owner < 0 || stats.world_size <= owner)
+        return;
+
+    struct copy_state *state = get_state(handle, owner);
+    size_t size = starpu_data_get_size(handle);
+
+    for (int i = 0; i < stats.world_size; i++) {
+        if (!state->valid[i]) {
+            record(owner, i, size);
+            state->valid[i] = 1;
+        }
+    }
+#endif
+}
+
+void starneig_comm_stats_fetch(starpu_data_handle_t handle, int node)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (!prepare())
+        return;
+
+    int owner = starpu_mpi_data_get_rank(handle);
+    if (owner < 0 || stats.world_size <= owner)
+        return;
+
+    struct copy_state *state = get_state(handle, owner);
+    if (!state->valid[node]) {
+        record(owner, node, starpu_data_get_size(handle));
+        state->valid[node] = 1;
+    }
+#endif
+}
+
+void starneig_comm_stats_acquire(
+    starpu_data_handle_t handle, enum starpu_data_access_mode mode)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (stats.enabled) {
+        double start = MPI_Wtime();
+        starpu_data_acquire(handle, mode);
+        stats.wait[stats.phase] += MPI_Wtime() - start;
+        return;
+    }
+#endif
+
+    starpu_data_acquire(handle, mode);
+}
+
+void starneig_comm_stats_barrier()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    double start = MPI_Wtime();
+    starpu_mpi_barrier(starneig_mpi_get_comm());
+    if (stats.enabled)
+        stats.wait[stats.phase] += MPI_Wtime() - start;
+#endif
+}
+
+void starneig_comm_stats_flush()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    for (int i = 0; i < COMM_STATS_BUCKETS; i++) {
+        while (stats.buckets[i] != NULL) {
+            struct copy_state *state = stats.buckets[i];
+            stats.buckets[i] = state->next;
+            free(state->valid);
+            free(state);
+        }
+    }
+#endif
+}
+
+void starneig_comm_stats_flush_handle(starpu_data_handle_t handle)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    struct copy_state *iter = stats.buckets[hash(handle)];
+    while (iter != NULL && iter->handle != handle)
+        iter = iter->next;
+
+    // only the owner keeps a valid copy
+    if (iter != NULL) {
+        memset(iter->valid, 0, stats.world_size);
+        iter->valid[starpu_mpi_data_get_rank(handle)] = 1;
+    }
+#endif
+}
+
+void starneig_comm_stats_report()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (!prepare())
+        return;
+
+    for (int i = 0; i < STARNEIG_COMM_PHASE_COUNT; i++) {
+        struct counters sum;
+        sum_counters(i, STARNEIG_COMM_PEER_ALL, &sum);
+        if (sum.sent_messages == 0 && sum.recv_messages == 0 &&
+        stats.wait[i] == 0.0)
+            continue;
+        starneig_verbose(
+            "Modelled communication (%s): sent %lld B / %lld msgs, received "
+            "%lld B / %lld msgs, blocked in barriers and acquires %.3f s.",
+            phase_names[i],
+            sum.sent_bytes, sum.sent_messages,
+            sum.recv_bytes, sum.recv_messages, stats.wait[i]);
+    }
+
+    for (int i = 0; i < stats.world_size; i++) {
+        struct counters sum;
+        sum_counters(STARNEIG_COMM_PHASE_ALL, i, &sum);
+        if (sum.sent_messages == 0 && sum.recv_messages == 0)
+            continue;
+        starneig_verbose(
+            "Modelled communication (peer %d): sent %lld B / %lld msgs, "
+            "received "
+            "%lld B / %lld msgs.", i, sum.sent_bytes, sum.sent_messages,
+            sum.recv_bytes, sum.recv_messages);
+    }
+#endif
+}
+
+#ifdef STARNEIG_ENABLE_MPI
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_enable_comm_stats()
+{
+    stats.enabled = 1;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_disable_comm_stats()
+{
+    stats.enabled = 0;
+    starneig_comm_stats_flush();
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_reset_comm_stats()
+{
+    if (stats.counters != NULL)
+        memset(stats.counters, 0,
+            STARNEIG_COMM_PHASE_COUNT*stats.world_size*sizeof(struct counters));
+    memset(stats.wait, 0, sizeof(stats.wait));
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_get_comm_stats(
+    int phase, int peer, struct starneig_comm_stats *comm_stats)
+{
+    struct counters sum;
+    sum_counters(phase, peer, &sum);
+
+    comm_stats->sent_bytes = sum.sent_bytes;
+    comm_stats->sent_messages = sum.sent_messages;
+    comm_stats->recv_bytes = sum.recv_bytes;
+    comm_stats->recv_messages = sum.recv_messages;
+    comm_stats->wait_time = 0.0;
+
+    if (peer == STARNEIG_COMM_PEER_ALL)
+        for (int i = 0; i < STARNEIG_COMM_PHASE_COUNT; i++)
+            if (phase == STARNEIG_COMM_PHASE_ALL || phase == i)
+                comm_stats->wait_time += stats.wait[i];
+}
+
+#endif // STARNEIG_ENABLE_MPI
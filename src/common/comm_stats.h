@@ -0,0 +1,152 @@
+///
+/// @file
+///
+/// @brief This file contains the per-phase accounting of the StarPU-MPI data
+/// transfers and the time that is spent waiting for them.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_COMM_STATS_H
+#define STARNEIG_COMMON_COMM_STATS_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starpu.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#else
+// communication phases (starneig_comm_phase_t) are defined in distr_helpers.h
+#define STARNEIG_COMM_PHASE_HESSENBERG_PANEL    0
+#define STARNEIG_COMM_PHASE_HESSENBERG_UPDATE   1
+#define STARNEIG_COMM_PHASE_AED                 2
+#define STARNEIG_COMM_PHASE_BULGES              3
+#define STARNEIG_COMM_PHASE_REORDER             4
+#define STARNEIG_COMM_PHASE_EIGENVALUES         5
+#define STARNEIG_COMM_PHASE_OTHER               6
+#endif
+
+///
+/// @brief Sets the current communication phase.
+///
+///  The data transfers that are recorded after the call are attributed to the
+///  phase. Does nothing in shared memory builds.
+///
+/// @param[in] phase
+///         communication phase (starneig_comm_phase_t)
+///
+/// @return previous communication phase
+///
+int starneig_comm_stats_set_phase(int phase);
+
+///
+/// @brief Records the data transfers that StarPU-MPI performs when a task is
+/// inserted.
+///
+///  A node that reads a data handle that it does not own receives a copy from
+///  the owner unless it already has a valid cached copy. A node that writes to
+///  a data handle that it does not own sends the data back to the owner and
+///  all other cached copies become invalid.
+///
+/// @param[in] node
+///         MPI rank that executes the task
+///
+/// @param[in] descrs
+///         data handles and access modes
+///
+/// @param[in] count
+///         number of data handles
+///
+void starneig_comm_stats_task(
+    int node, struct starpu_data_descr const *descrs, int count);
+
+///
+/// @brief Records the data transfers of
+/// starpu_mpi_get_data_on_all_nodes_detached().
+///
+/// @param[in] handle
+///         broadcasted data handle
+///
+void starneig_comm_stats_broadcast(starpu_data_handle_t handle);
+
+///
+/// @brief Records the data transfer of starpu_mpi_get_data_on_node_detached().
+///
+/// @param[in] handle
+///         data handle
+///
+/// @param[in] node
+///         receiving MPI rank
+///
+void starneig_comm_stats_fetch(starpu_data_handle_t handle, int node);
+
+///
+/// @brief Acquires a data handle and records the time the calling thread was
+/// blocked.
+///
+/// @param[in] handle
+///         data handle
+///
+/// @param[in] mode
+///         access mode
+///
+void starneig_comm_stats_acquire(
+    starpu_data_handle_t handle, enum starpu_data_access_mode mode);
+
+///
+/// @brief Performs a StarPU-MPI barrier and records the time the calling
+/// thread was blocked.
+///
+void starneig_comm_stats_barrier();
+
+///
+/// @brief Forgets all cached copies. Called when the StarPU-MPI cache is
+/// flushed with starpu_mpi_cache_flush_all_data().
+///
+void starneig_comm_stats_flush();
+
+///
+/// @brief Forgets the cached copies of a data handle. Called when the
+/// StarPU-MPI cache is flushed with starpu_mpi_cache_flush().
+///
+/// @param[in] handle
+///         data handle
+///
+void starneig_comm_stats_flush_handle(starpu_data_handle_t handle);
+
+///
+/// @brief Prints a summary of the communication statistics (verbose mode).
+///
+void starneig_comm_stats_report();
+
+#endif
@@ -41,10 +41,15 @@
 #include <starneig/configuration.h>
 #include "common.h"
 #include "sanity.h"
+#include "alloc.h"
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
 #include <starpu_mpi.h>
 #endif
+#ifdef STARNEIG_ENABLE_SIMGRID
+#include <starpu.h>
+#include <pthread.h>
+#endif
 
 static int messages = 0;
 static int verbose = 0;
@@ -160,12 +165,8 @@ void * starneig_alloc_matrix(int m, int n, size_t elemsize, size_t *ld)
     STARNEIG_ASSERT_MSG(0 < m && 0 < n && 0 < elemsize, "Invalid dimensions.");
     STARNEIG_ASSERT_MSG(ld != NULL, "NULL pointer.");
 
-    *ld = divceil(m, 64/elemsize)*(64/elemsize);
-#ifdef ALIGNED_ALLOC_FOUND
-    void *ptr = aligned_alloc(64, n*(*ld)*elemsize);
-#else
-    void *ptr = malloc(n*(*ld)*elemsize);
-#endif
+    *ld = starneig_alloc_ld(m, elemsize);
+    void *ptr = starneig_alloc_aligned(n*(*ld)*elemsize);
 
     if (ptr == NULL)
         starneig_fatal_error("starneig_alloc_matrix failed.");
@@ -175,18 +176,79 @@ void * starneig_alloc_matrix(int m, int n, size_t elemsize, size_t *ld)
 
 void starneig_free_matrix(void *matrix)
 {
-    free(matrix);
+    starneig_free_aligned(matrix);
+}
+
+#ifdef STARNEIG_ENABLE_SIMGRID
+
+///
+/// @brief A folded allocation. starpu_free_flags() needs the allocation size
+/// and folded memory cannot hold a header.
+///
+struct folded_allocation {
+    void *ptr;
+    size_t size;
+    struct folded_allocation *next;
+};
+
+static struct folded_allocation *folded_allocations = NULL;
+static pthread_mutex_t folded_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void * alloc_folded(size_t size)
+{
+    struct folded_allocation *alloc = malloc(sizeof(struct folded_allocation));
+    alloc->size = size;
+    if (starpu_malloc_flags(
+    &alloc->ptr, size, STARPU_MALLOC_SIMULATION_FOLDED) != 0 ||
+    alloc->ptr == NULL)
+        starneig_fatal_error("starpu_malloc_flags failed.");
+
+    pthread_mutex_lock(&folded_mutex);
+    alloc->next = folded_allocations;
+    folded_allocations = alloc;
+    pthread_mutex_unlock(&folded_mutex);
+
+    return alloc->ptr;
+}
+
+static int free_folded(void *ptr)
+{
+    pthread_mutex_lock(&folded_mutex);
+    struct folded_allocation **iter = &folded_allocations;
+    while (*iter != NULL && (*iter)->ptr != ptr)
+        iter = &(*iter)->next;
+    struct folded_allocation *alloc = *iter;
+    if (alloc != NULL)
+        *iter = alloc->next;
+    pthread_mutex_unlock(&folded_mutex);
+
+    if (alloc == NULL)
+        return 0;
+
+    starpu_free_flags(alloc->ptr, alloc->size, STARPU_MALLOC_SIMULATION_FOLDED);
+    free(alloc);
+    return 1;
 }
 
+#endif
+
 void * starneig_alloc_pinned_matrix(int m, int n, size_t elemsize, size_t *ld)
 {
+#ifdef STARNEIG_ENABLE_SIMGRID
+    // the kernels are not executed during a simulation and the contents of
+    // the matrix do not matter; all pages are folded into a single page
+    STARNEIG_ASSERT_MSG(0 < m && 0 < n && 0 < elemsize, "Invalid dimensions.");
+    STARNEIG_ASSERT_MSG(ld != NULL, "NULL pointer.");
+    *ld = starneig_alloc_ld(m, elemsize);
+    return alloc_folded(n*(*ld)*elemsize);
+#endif
 #ifdef STARNEIG_ENABLE_CUDA
     if (pinning) {
         STARNEIG_ASSERT_MSG(
             0 < m && 0 < n && 0 < elemsize, "Invalid dimensions.");
         STARNEIG_ASSERT_MSG(ld != NULL, "NULL pointer.");
 
-        *ld = divceil(m, 64/elemsize)*(64/elemsize);
+        *ld = starneig_alloc_ld(m, elemsize);
         void *ptr;
         cudaError_t ret =
             cudaHostAlloc(&ptr, n*(*ld)*elemsize, cudaHostRegisterPortable);
@@ -196,18 +258,32 @@ void * starneig_alloc_pinned_matrix(int m, int n, size_t elemsize, size_t *ld)
         return ptr;
     }
 #endif
-    return starneig_alloc_matrix(m, n, elemsize, ld);
+    STARNEIG_ASSERT_MSG(0 < m && 0 < n && 0 < elemsize, "Invalid dimensions.");
+    STARNEIG_ASSERT_MSG(ld != NULL, "NULL pointer.");
+
+    // pinned matrices are long-lived and are backed by huge pages
+    *ld = starneig_alloc_ld(m, elemsize);
+    void *ptr = starneig_alloc_huge(n*(*ld)*elemsize);
+
+    if (ptr == NULL)
+        starneig_fatal_error("starneig_alloc_pinned_matrix failed.");
+
+    return ptr;
 }
 
 void starneig_free_pinned_matrix(void *matrix)
 {
+#ifdef STARNEIG_ENABLE_SIMGRID
+    if (free_folded(matrix))
+        return;
+#endif
 #ifdef STARNEIG_ENABLE_CUDA
     if (pinning) {
         cudaFree(matrix);
         return;
     }
 #endif
-    starneig_free_matrix(matrix);
+    starneig_free_huge(matrix);
 }
 
 void starneig_copy_matrix(
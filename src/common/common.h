@@ -234,6 +234,9 @@ static inline int divfloor(int a, int b)
 ///
 /// @brief Allocates a matrix.
 ///
+///  The leading dimension is computed with starneig_alloc_ld() and the matrix
+///  is allocated with starneig_alloc_aligned().
+///
 /// @param[in] m
 ///         The number of rows in the matrix.
 ///
@@ -259,7 +262,10 @@ void * starneig_alloc_matrix(
 void starneig_free_matrix(void *A);
 
 ///
-/// @brief Allocates a matrix using pinned memory.
+/// @brief Allocates a long-lived matrix using pinned memory.
+///
+///  Without CUDA, large matrices are backed by huge pages (see
+///  starneig_alloc_huge()).
 ///
 /// @param[in] m
 ///         The number of rows in the matrix.
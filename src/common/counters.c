@@ -0,0 +1,563 @@
+///
+/// @file
+///
+/// @brief This file contains the hardware performance counter sampling that
+/// is performed around the computational kernels.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/node.h>
+#include "counters.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <starpu.h>
+#ifdef PERF_EVENT_FOUND
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <mpi.h>
+#endif
+
+///
+/// @brief Number of sampled counters.
+///
+#define COUNTER_COUNT 5
+
+static char const * const counter_names[COUNTER_COUNT] = {
+    "cycles", "instructions", "llc_misses", "dtlb_misses", "stalled_cycles"
+};
+
+#ifdef PERF_EVENT_FOUND
+
+///
+/// @brief perf_event_open() event types and configurations. The first event
+/// is the group leader.
+///
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} counter_events[COUNTER_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND }
+};
+
+#endif
+
+///
+/// @brief Aggregated counts of a codelet and size bucket.
+///
+struct entry {
+    char const *name;                   ///< codelet name
+    int size;                           ///< size bucket (power of two)
+    uint64_t count;                     ///< number of executions
+    uint64_t time;                      ///< total time in nanoseconds
+    uint64_t values[COUNTER_COUNT];     ///< total counts
+};
+
+///
+/// @brief Per-worker counter state. Only the owning worker modifies the
+/// state while counter sampling is enabled.
+///
+struct worker {
+    int generation;                     ///< sampling session
+    int opened;                         ///< 1 if opened, -1 if open failed
+    int fd[COUNTER_COUNT];              ///< event file descriptors
+    int slot[COUNTER_COUNT];            ///< position in a group read or -1
+    int members;                        ///< number of events in the group
+    int active;                         ///< non-zero if sampling is active
+    char const *name;                   ///< codelet name
+    int size;                           ///< size bucket
+    uint64_t begin_time;                ///< begin time in nanoseconds
+    uint64_t begin[3+COUNTER_COUNT];    ///< group read at the beginning
+    struct entry *entries;              ///< aggregated counts
+    int entry_count;                    ///< number of aggregated counts
+    int entry_capacity;                 ///< capacity of the entry array
+};
+
+static struct worker workers[STARPU_NMAXWORKERS];
+
+static struct {
+    int enabled;            ///< non-zero if sampling is enabled
+    int generation;         ///< sampling session counter
+    int available;          ///< bitmask of the counters that could be opened
+    int warned;             ///< non-zero if a warning has been printed
+    char *env_file;         ///< file name from STARNEIG_COUNTERS
+} counters = {
+    .enabled = 0,
+    .generation = 0,
+    .available = 0,
+    .warned = 0,
+    .env_file = NULL
+};
+
+///
+/// @brief Returns the value of the monotonic clock in nanoseconds.
+///
+static inline uint64_t get_time()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+///
+/// @brief Returns the MPI rank of the calling process or 0 if MPI is not in
+/// use.
+///
+static int get_rank()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    int initialized, finalized;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (initialized && !finalized)
+        return starneig_mpi_get_comm_rank();
+#endif
+    return 0;
+}
+
+#ifdef PERF_EVENT_FOUND
+
+///
+/// @brief Opens a counter for the calling thread.
+///
+static int open_counter(int counter, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_events[counter].type;
+    attr.config = counter_events[counter].config;
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP |
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+///
+/// @brief Opens the counter group of the calling worker.
+///
+static void open_worker(struct worker *worker)
+{
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        worker->fd[i] = -1;
+        worker->slot[i] = -1;
+    }
+
+    worker->fd[0] = open_counter(0, -1);
+    if (worker->fd[0] < 0) {
+        worker->opened = -1;
+        if (!__atomic_exchange_n(&counters.warned, 1, __ATOMIC_ACQ_REL))
+            starneig_warning(
+                "Failed to open the hardware performance counters. Check "
+                "/proc/sys/kernel/perf_event_paranoid.");
+        return;
+    }
+
+    worker->slot[0] = 0;
+    worker->members = 1;
+    int available = 0x1;
+
+    // the remaining counters are optional
+    for (int i = 1; i < COUNTER_COUNT; i++) {
+        worker->fd[i] = open_counter(i, worker->fd[0]);
+        if (0 <= worker->fd[i]) {
+            worker->slot[i] = worker->members++;
+            available |= 1 << i;
+        }
+    }
+
+    __atomic_or_fetch(&counters.available, available, __ATOMIC_RELAXED);
+    worker->opened = 1;
+}
+
+///
+/// @brief Reads the counter group of the calling worker.
+///
+static int read_worker(struct worker *worker, uint64_t *values)
+{
+    ssize_t size = (3+worker->members)*sizeof(uint64_t);
+    return read(worker->fd[0], values, size) == size ? 0 : -1;
+}
+
+#endif
+
+///
+/// @brief Closes all counters. The aggregated counts are kept so that they can
+/// be stored after the node has been finalized. The counters are opened again
+/// by the workers of the next node if sampling is still enabled.
+///
+static void close_workers()
+{
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++) {
+#ifdef PERF_EVENT_FOUND
+        if (0 < workers[i].opened)
+            for (int j = COUNTER_COUNT-1; 0 <= j; j--)
+                if (0 <= workers[i].fd[j])
+                    close(workers[i].fd[j]);
+#endif
+        workers[i].opened = 0;
+        workers[i].active = 0;
+    }
+}
+
+void starneig_counters_begin(struct packing_info const *pi)
+{
+    if (!__atomic_load_n(&counters.enabled, __ATOMIC_ACQUIRE))
+        return;
+
+#ifdef PERF_EVENT_FOUND
+    int worker_id = starpu_worker_get_id();
+    if (worker_id < 0)
+        return;
+
+    struct worker *worker = &workers[worker_id];
+
+    // the counters are opened by the worker itself since perf_event_open()
+    // attaches them to the calling thread
+    int generation = __atomic_load_n(&counters.generation, __ATOMIC_ACQUIRE);
+    if (worker->generation != generation) {
+        if (worker->opened == 0)
+            open_worker(worker);
+        if (0 < worker->opened) {
+            ioctl(worker->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(worker->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        worker->entry_count = 0;
+        worker->generation = generation;
+    }
+    else if (worker->opened == 0) {
+        // the counters were closed when the previous node was finalized but
+        // the counts of the sampling session are kept
+        open_worker(worker);
+        if (0 < worker->opened)
+            ioctl(worker->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    if (worker->opened < 0)
+        return;
+
+    struct starpu_task *task = starpu_task_get_current();
+    if (task != NULL && task->cl != NULL && task->cl->name != NULL)
+        worker->name = task->cl->name;
+    else
+        worker->name = "unknown";
+
+    int dim = MAX(pi->rend - pi->rbegin, pi->cend - pi->cbegin);
+    worker->size = 1;
+    while (worker->size < dim)
+        worker->size *= 2;
+
+    worker->begin_time = get_time();
+    worker->active = read_worker(worker, worker->begin) == 0;
+#endif
+}
+
+void starneig_counters_end()
+{
+#ifdef PERF_EVENT_FOUND
+    int worker_id = starpu_worker_get_id();
+    if (worker_id < 0)
+        return;
+
+    struct worker *worker = &workers[worker_id];
+
+    if (!worker->active)
+        return;
+    worker->active = 0;
+
+    uint64_t end[3+COUNTER_COUNT];
+    if (read_worker(worker, end) != 0)
+        return;
+
+    uint64_t time = get_time() - worker->begin_time;
+
+    // scale the counts if the kernel multiplexed the counters
+    uint64_t enabled = end[1] - worker->begin[1];
+    uint64_t running = end[2] - worker->begin[2];
+    double scale = 0 < running ? (double) enabled / running : 0.0;
+
+    struct entry *entry = NULL;
+    for (int i = 0; i < worker->entry_count; i++) {
+        if (worker->entries[i].size == worker->size &&
+        strcmp(worker->entries[i].name, worker->name) == 0) {
+            entry = &worker->entries[i];
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        if (worker->entry_count == worker->entry_capacity) {
+            worker->entry_capacity = MAX(16, 2*worker->entry_capacity);
+            worker->entries = realloc(worker->entries,
+                worker->entry_capacity*sizeof(struct entry));
+        }
+        entry = &worker->entries[worker->entry_count++];
+        memset(entry, 0, sizeof(struct entry));
+        entry->name = worker->name;
+        entry->size = worker->size;
+    }
+
+    entry->count++;
+    entry->time += time;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        int slot = worker->slot[i];
+        if (0 <= slot)
+            entry->values[i] +=
+                scale * (end[3+slot] - worker->begin[3+slot]);
+    }
+#endif
+}
+
+static int compare_entries(void const *a, void const *b)
+{
+    struct entry const *x = a, *y = b;
+    int ret = strcmp(x->name, y->name);
+    if (ret != 0)
+        return ret;
+    return (x->size > y->size) - (x->size < y->size);
+}
+
+///
+/// @brief Merges the aggregated counts of all workers.
+///
+/// @param[out] count
+///         Number of merged entries.
+///
+/// @return Merged entries sorted by codelet name and size bucket.
+///
+static struct entry * merge_entries(int *count)
+{
+    int generation = __atomic_load_n(&counters.generation, __ATOMIC_ACQUIRE);
+
+    int total = 0;
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++)
+        if (workers[i].generation == generation)
+            total += workers[i].entry_count;
+
+    struct entry *merged = malloc(MAX(1, total)*sizeof(struct entry));
+
+    *count = 0;
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++) {
+        if (workers[i].generation != generation)
+            continue;
+        for (int j = 0; j < workers[i].entry_count; j++) {
+            struct entry const *entry = &workers[i].entries[j];
+            int k = 0;
+            while (k < *count && (merged[k].size != entry->size ||
+            strcmp(merged[k].name, entry->name) != 0))
+                k++;
+            if (k == *count) {
+                merged[(*count)++] = *entry;
+            }
+            else {
+                merged[k].count += entry->count;
+                merged[k].time += entry->time;
+                for (int l = 0; l < COUNTER_COUNT; l++)
+                    merged[k].values[l] += entry->values[l];
+            }
+        }
+    }
+
+    qsort(merged, *count, sizeof(struct entry), &compare_entries);
+
+    return merged;
+}
+
+///
+/// @brief Prints a ratio or null if the ratio is not defined.
+///
+static void fprint_ratio(
+    FILE *file, char const *name, int available, double x, double y)
+{
+    if (available && 0.0 < y)
+        fprintf(file, ",\"%s\":%.4f", name, x / y);
+    else
+        fprintf(file, ",\"%s\":null", name);
+}
+
+void starneig_counters_fprint_json(FILE *file)
+{
+    int count;
+    struct entry *entries = merge_entries(&count);
+    int available = counters.available;
+
+    fprintf(file, "[");
+    for (int i = 0; i < count; i++) {
+        struct entry const *entry = &entries[i];
+
+        fprintf(file,
+            "%s\n{\"name\":\"%s\",\"size\":%d,\"count\":%" PRIu64 ","
+            "\"time\":%" PRIu64, i ? "," : "",
+            entry->name, entry->size, entry->count, entry->time);
+
+        for (int j = 0; j < COUNTER_COUNT; j++) {
+            if (available & (1 << j))
+                fprintf(file, ",\"%s\":%" PRIu64,
+                    counter_names[j], entry->values[j]);
+            else
+                fprintf(file, ",\"%s\":null", counter_names[j]);
+        }
+
+        double cycles = entry->values[0];
+        double instructions = entry->values[1];
+
+        fprint_ratio(file, "ipc", (available & 0x3) == 0x3,
+            instructions, cycles);
+        fprint_ratio(file, "llc_mpki", (available & 0x6) == 0x6,
+            1000.0*entry->values[2], instructions);
+        fprint_ratio(file, "dtlb_mpki", (available & 0xa) == 0xa,
+            1000.0*entry->values[3], instructions);
+        fprint_ratio(file, "stalled_fraction", (available & 0x11) == 0x11,
+            entry->values[4], cycles);
+
+        fprintf(file, "}");
+    }
+    fprintf(file, "]");
+
+    free(entries);
+}
+
+int starneig_counters_recorded()
+{
+    int generation = __atomic_load_n(&counters.generation, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++)
+        if (workers[i].generation == generation && 0 < workers[i].entry_count)
+            return 1;
+    return 0;
+}
+
+void starneig_counters_init_from_env()
+{
+    char const *file_name = getenv("STARNEIG_COUNTERS");
+    if (file_name == NULL || strlen(file_name) == 0)
+        return;
+
+    free(counters.env_file);
+    counters.env_file = strdup(file_name);
+
+    starneig_node_enable_counters();
+
+    starneig_verbose(
+        "Hardware performance counters enabled (STARNEIG_COUNTERS=%s).",
+        file_name);
+}
+
+void starneig_counters_finalize_from_env()
+{
+    if (counters.env_file != NULL) {
+        char *file_name = malloc(strlen(counters.env_file)+16);
+        int rank = get_rank();
+        if (0 < rank)
+            sprintf(file_name, "%s.%d", counters.env_file, rank);
+        else
+            strcpy(file_name, counters.env_file);
+        starneig_node_store_counters(file_name);
+        free(file_name);
+
+        free(counters.env_file);
+        counters.env_file = NULL;
+
+        starneig_node_disable_counters();
+    }
+
+    // the worker threads are about to terminate; the counts that were
+    // collected through the interface can still be stored
+    close_workers();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__ ((visibility ("default")))
+void starneig_node_enable_counters()
+{
+#ifdef PERF_EVENT_FOUND
+    __atomic_add_fetch(&counters.generation, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&counters.enabled, 1, __ATOMIC_RELEASE);
+#else
+    starneig_warning(
+        "Hardware performance counters are not supported on this platform.");
+#endif
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_node_disable_counters()
+{
+    __atomic_store_n(&counters.enabled, 0, __ATOMIC_RELEASE);
+
+#ifdef PERF_EVENT_FOUND
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++)
+        if (0 < workers[i].opened)
+            ioctl(workers[i].fd[0], PERF_EVENT_IOC_DISABLE,
+                PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+__attribute__ ((visibility ("default")))
+int starneig_node_store_counters(char const *file_name)
+{
+    FILE *file = fopen(file_name, "w");
+    if (file == NULL) {
+        starneig_warning("Failed to open the counter file %s.", file_name);
+        return -1;
+    }
+
+    fprintf(file, "{\"rank\":%d,\"counters\":", get_rank());
+    starneig_counters_fprint_json(file);
+    fprintf(file, "}\n");
+
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+///
+/// @file
+///
+/// @brief This file contains the hardware performance counter sampling that
+/// is performed around the computational kernels.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_COUNTERS_H
+#define STARNEIG_COMMON_COUNTERS_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "tiles.h"
+#include <stdio.h>
+
+///
+/// @brief Starts sampling the hardware performance counters of the calling
+/// worker. Does nothing if counter sampling is disabled.
+///
+///  The counts are attributed to the codelet of the current task and to a
+///  size bucket that is derived from the dimensions of the window.
+///
+/// @param[in] pi
+///         The packing info that defines the window.
+///
+void starneig_counters_begin(struct packing_info const *pi);
+
+///
+/// @brief Stops sampling and accumulates the counts.
+///
+void starneig_counters_end();
+
+///
+/// @brief Writes the aggregated counts as a JSON array. Writes an empty array
+/// if nothing has been recorded.
+///
+/// @param[in,out] file
+///         Output file.
+///
+void starneig_counters_fprint_json(FILE *file);
+
+///
+/// @brief Returns non-zero if counts have been recorded.
+///
+int starneig_counters_recorded();
+
+///
+/// @brief Enables counter sampling if the STARNEIG_COUNTERS environmental
+/// variable is set. Called when the node is initialized.
+///
+void starneig_counters_init_from_env();
+
+///
+/// @brief Stores the aggregated counts to the file named by the
+/// STARNEIG_COUNTERS environmental variable and closes the counters. Called
+/// when the node is finalized. The aggregated counts are kept.
+///
+void starneig_counters_finalize_from_env();
+
+#endif
@@ -45,6 +45,7 @@
 #include "sanity.h"
 #include "trace.h"
 #include <math.h>
+#include <string.h>
 #include <starpu.h>
 
 extern void dgemm_(char const *, char const *, int const *, int const *,
@@ -248,6 +249,79 @@ void starneig_cpu_copy_matrix(void *buffers[], void *cl_args)
     }
 }
 
+void starneig_cpu_copy_handle(void *buffers[], void *cl_args)
+{
+    int m = STARPU_MATRIX_GET_NX(buffers[0]);
+    int n = STARPU_MATRIX_GET_NY(buffers[0]);
+
+    double const *S = (double const *)STARPU_MATRIX_GET_PTR(buffers[0]);
+    int ldS = STARPU_MATRIX_GET_LD(buffers[0]);
+
+    double *D = (double *)STARPU_MATRIX_GET_PTR(buffers[1]);
+    int ldD = STARPU_MATRIX_GET_LD(buffers[1]);
+
+    for (int i = 0; i < n; i++)
+        memcpy(D+i*ldD, S+i*ldS, m*sizeof(double));
+}
+
+void starneig_cpu_combine_transforms(void *buffers[], void *cl_args)
+{
+    int offset_p, offset_t;
+    starpu_codelet_unpack_args(cl_args, &offset_p, &offset_t);
+
+    int k = 0;
+
+    int n_p = 0, ldP = 0;
+    double const *P = NULL;
+    if (0 <= offset_p) {
+        n_p = STARPU_MATRIX_GET_NX(buffers[k]);
+        P = (double const *)STARPU_MATRIX_GET_PTR(buffers[k]);
+        ldP = STARPU_MATRIX_GET_LD(buffers[k]);
+        k++;
+    }
+
+    int n_t = STARPU_MATRIX_GET_NX(buffers[k]);
+    double const *T = (double const *)STARPU_MATRIX_GET_PTR(buffers[k]);
+    int ldT = STARPU_MATRIX_GET_LD(buffers[k]);
+    k++;
+
+    int n_c = STARPU_MATRIX_GET_NX(buffers[k]);
+    double *C = (double *)STARPU_MATRIX_GET_PTR(buffers[k]);
+    int ldC = STARPU_MATRIX_GET_LD(buffers[k]);
+    k++;
+
+    double *W = (double *)STARPU_MATRIX_GET_PTR(buffers[k]);
+    int ldW = STARPU_MATRIX_GET_LD(buffers[k]);
+
+    // a plain copy
+    if (P == NULL && n_t == n_c) {
+        for (int i = 0; i < n_c; i++)
+            memcpy(C+i*ldC, T+i*ldT, n_c*sizeof(double));
+        return;
+    }
+
+    // C <- I with P embedded to it
+
+    for (int i = 0; i < n_c; i++) {
+        memset(C+i*ldC, 0, n_c*sizeof(double));
+        C[i*ldC+i] = 1.0;
+    }
+
+    for (int i = 0; i < n_p; i++)
+        memcpy(C+(offset_p+i)*ldC+offset_p, P+i*ldP, n_p*sizeof(double));
+
+    // C(:,offset_t:offset_t+n_t) <- C(:,offset_t:offset_t+n_t) * T
+
+    starneig_copy_matrix(
+        n_c, n_t, ldC, ldW, sizeof(double), C+offset_t*ldC, W);
+
+    double one = 1.0;
+    double zero = 0.0;
+
+    dgemm_("N", "N", &n_c, &n_t, &n_t,
+        &one, W, &ldW, T, &ldT, &zero, C+offset_t*ldC, &ldC);
+}
+
 void starneig_cpu_set_to_identity(void *buffers[], void *cl_args)
 {
     struct packing_info packing_info;
@@ -333,8 +407,10 @@ void starneig_cpu_scan_diagonal(void *buffers[], void *cl_args)
 
     void *mask[SCAN_DIAGONAL_MAX_MASKS];
     memset(mask, 0, sizeof(mask));
-    for (int i = 0; i < num_masks; i++)
+    for (int i = 0; i < num_masks; i++) {
         mask[i] = malloc(mask_size*packing_info_mask[i].elemsize);
+        starneig_join_range(&packing_info_mask[i], mask_i[i], mask[i], 0);
+    }
 
     //
     // process
@@ -401,3 +477,32 @@ void starneig_cpu_add_matrices(void *buffers[], void *cl_args)
         for (int j = 0; j < m; j++)
             Y[i*ldY+j] += X[i*ldX+j];
 }
+
+void starneig_cpu_probe_update(void *buffers[], void *cl_args)
+{
+    int trans;
+    double alpha;
+    starpu_codelet_unpack_args(cl_args, &trans, &alpha);
+
+    double const *A = (double const *) STARPU_MATRIX_GET_PTR(buffers[0]);
+    int ldA = STARPU_MATRIX_GET_LD(buffers[0]);
+    int m = STARPU_MATRIX_GET_NX(buffers[0]);
+    int n = STARPU_MATRIX_GET_NY(buffers[0]);
+
+    // the probe vectors are stored row-wise, i.e., each vector element holds
+    // one row of the probe block
+    double const *X = (double const *) STARPU_VECTOR_GET_PTR(buffers[1]);
+    double *Y = (double *) STARPU_VECTOR_GET_PTR(buffers[2]);
+    int p = STARPU_VECTOR_GET_ELEMSIZE(buffers[1]) / sizeof(double);
+
+    double one = 1.0;
+
+    if (trans)
+        // Y^T <- Y^T + alpha * X^T * A
+        dgemm_("N", "N", &p, &n, &m,
+            &alpha, X, &p, A, &ldA, &one, Y, &p);
+    else
+        // Y^T <- Y^T + alpha * X^T * A^T
+        dgemm_("N", "T", &p, &m, &n,
+            &alpha, X, &p, A, &ldA, &one, Y, &p);
+}
@@ -55,6 +55,10 @@ void starneig_cpu_copy_handle_to_matrix(void *buffers[], void *cl_args);
 
 void starneig_cpu_copy_matrix(void *buffers[], void *cl_args);
 
+void starneig_cpu_copy_handle(void *buffers[], void *cl_args);
+
+void starneig_cpu_combine_transforms(void *buffers[], void *cl_args);
+
 void starneig_cpu_set_to_identity(void *buffers[], void *cl_args);
 
 void starneig_cpu_scan_diagonal(void *buffers[], void *cl_args);
@@ -67,4 +71,6 @@ void starneig_cpu_set_matrix_to_zero(void *buffers[], void *cl_args);
 
 void starneig_cpu_add_matrices(void *buffers[], void *cl_args);
 
+void starneig_cpu_probe_update(void *buffers[], void *cl_args);
+
 #endif
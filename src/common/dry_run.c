@@ -0,0 +1,542 @@
+///
+/// @file
+///
+/// @brief This file contains the dry run task graph recorder.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/node.h>
+#include "dry_run.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#if STARPU_MAJOR_VERSION > 1 || \
+    (STARPU_MAJOR_VERSION == 1 && STARPU_MINOR_VERSION >= 3)
+#define DRY_RUN_SUPPORTED
+#endif
+
+///
+/// @brief Recorded task.
+///
+struct dry_run_task {
+    char const *name;   ///< codelet name
+    int prio;           ///< priority
+    double cost;        ///< predicted execution time (seconds)
+    double start;       ///< earliest start time (seconds)
+    int mark;           ///< last successor that was linked to the task
+};
+
+///
+/// @brief Data handle access tracker.
+///
+struct dry_run_tracker {
+    starpu_data_handle_t handle;    ///< data handle
+    int writer;                     ///< last task that wrote to the handle
+    int *readers;                   ///< tasks that read the handle after that
+    int reader_count;               ///< number of readers
+    int reader_size;                ///< size of the reader array
+};
+
+///
+/// @brief Recorder state.
+///
+static struct {
+    int enabled;                        ///< dry runs are enabled
+    int recording;                      ///< tasks are being recorded
+    unsigned generation;                ///< invalidates old trackers
+    char *env_file;                     ///< STARNEIG_DRY_RUN file name
+    struct starpu_perfmodel_arch *arch; ///< architecture used for predictions
+    struct dry_run_task *tasks;         ///< recorded tasks
+    int task_count;                     ///< number of recorded tasks
+    int task_size;                      ///< size of the task array
+    int (*edges)[2];                    ///< recorded dependencies
+    int edge_count;                     ///< number of recorded dependencies
+    int edge_size;                      ///< size of the dependency array
+    struct dry_run_tracker *trackers;   ///< data handle trackers
+    int tracker_count;                  ///< number of trackers
+    int tracker_size;                   ///< size of the tracker array
+    int uncalibrated;                   ///< tasks without a prediction
+} recorder;
+
+///
+/// @brief ASAP schedule event.
+///
+struct dry_run_event {
+    double time;    ///< event time (seconds)
+    int delta;      ///< +1 when a task starts, -1 when a task finishes
+};
+
+///
+/// @brief Grows a dynamic array if necessary.
+///
+/// @param[in,out] ptr
+///         Pointer to the array.
+///
+/// @param[in,out] size
+///         Size of the array.
+///
+/// @param[in] count
+///         Required number of elements.
+///
+/// @param[in] elem_size
+///         Element size.
+///
+static void reserve(void **ptr, int *size, int count, size_t elem_size)
+{
+    if (count <= *size)
+        return;
+    *size = MAX(2*(*size), MAX(count, 64));
+    *ptr = realloc(*ptr, (*size)*elem_size);
+}
+
+///
+/// @brief Discards the recorded task graph.
+///
+static void clear()
+{
+    for (int i = 0; i < recorder.tracker_count; i++)
+        free(recorder.trackers[i].readers);
+    free(recorder.trackers);
+    free(recorder.tasks);
+    free(recorder.edges);
+
+    recorder.tasks = NULL;
+    recorder.task_count = recorder.task_size = 0;
+    recorder.edges = NULL;
+    recorder.edge_count = recorder.edge_size = 0;
+    recorder.trackers = NULL;
+    recorder.tracker_count = recorder.tracker_size = 0;
+    recorder.uncalibrated = 0;
+    recorder.generation++;
+}
+
+///
+/// @brief Returns the tracker that is attached to a data handle. A tracker
+/// is created if the handle has not been seen before.
+///
+///  Trackers are attached to the handles and not looked up by the handle
+///  address because StarPU reuses the memory of unregistered handles.
+///
+/// @param[in] handle
+///         Data handle.
+///
+/// @return Tracker.
+///
+static struct dry_run_tracker * get_tracker(starpu_data_handle_t handle)
+{
+#ifdef DRY_RUN_SUPPORTED
+    uintptr_t tag = (uintptr_t) starpu_data_get_user_data(handle);
+    int idx = (int) (tag & 0xffffffff) - 1;
+    if (tag >> 32 == recorder.generation && 0 <= idx &&
+    idx < recorder.tracker_count && recorder.trackers[idx].handle == handle)
+        return &recorder.trackers[idx];
+
+    reserve((void **) &recorder.trackers, &recorder.tracker_size,
+        recorder.tracker_count+1, sizeof(struct dry_run_tracker));
+
+    idx = recorder.tracker_count++;
+    struct dry_run_tracker *tracker = &recorder.trackers[idx];
+    tracker->handle = handle;
+    tracker->writer = -1;
+    tracker->readers = NULL;
+    tracker->reader_count = tracker->reader_size = 0;
+
+    starpu_data_set_user_data(handle,
+        (void *) (((uintptr_t) recorder.generation << 32) | (idx+1)));
+
+    return tracker;
+#else
+    return NULL;
+#endif
+}
+
+///
+/// @brief Records a dependency.
+///
+/// @param[in] from
+///         Predecessor.
+///
+/// @param[in] to
+///         Successor.
+///
+static void add_edge(int from, int to)
+{
+    if (from < 0 || from == to || recorder.tasks[from].mark == to)
+        return;
+    recorder.tasks[from].mark = to;
+
+    reserve((void **) &recorder.edges, &recorder.edge_size,
+        recorder.edge_count+1, sizeof(recorder.edges[0]));
+    recorder.edges[recorder.edge_count][0] = from;
+    recorder.edges[recorder.edge_count][1] = to;
+    recorder.edge_count++;
+
+    struct dry_run_task *task = &recorder.tasks[to];
+    task->start = MAX(task->start,
+        recorder.tasks[from].start + recorder.tasks[from].cost);
+}
+
+///
+/// @brief Orders events by time. Finish events come before start events.
+///
+static int compare_events(void const *a, void const *b)
+{
+    struct dry_run_event const *x = a, *y = b;
+    if (x->time != y->time)
+        return x->time < y->time ? -1 : 1;
+    return x->delta - y->delta;
+}
+
+///
+/// @brief Computes the task graph metrics.
+///
+/// @param[out] info
+///         Task graph metrics.
+///
+static void compute_info(struct starneig_task_graph_info *info)
+{
+    info->tasks = recorder.task_count;
+    info->edges = recorder.edge_count;
+    info->uncalibrated = recorder.uncalibrated;
+    info->work = 0.0;
+    info->critical_path = 0.0;
+    info->parallelism = 0.0;
+    info->max_parallelism = 0;
+
+    // the earliest start times form an ASAP schedule on an unlimited number
+    // of workers; the peak concurrency is found by sweeping over the events
+
+    struct dry_run_event *events =
+        malloc(2*recorder.task_count*sizeof(struct dry_run_event));
+    int event_count = 0;
+
+    for (int i = 0; i < recorder.task_count; i++) {
+        struct dry_run_task const *task = &recorder.tasks[i];
+        info->work += task->cost;
+        info->critical_path =
+            MAX(info->critical_path, task->start + task->cost);
+        if (0.0 < task->cost) {
+            events[event_count++] =
+                (struct dry_run_event) { task->start, 1 };
+            events[event_count++] =
+                (struct dry_run_event) { task->start + task->cost, -1 };
+        }
+    }
+
+    qsort(events, event_count, sizeof(struct dry_run_event), &compare_events);
+
+    int current = 0;
+    for (int i = 0; i < event_count; i++) {
+        current += events[i].delta;
+        info->max_parallelism = MAX(info->max_parallelism, current);
+    }
+
+    free(events);
+
+    if (0.0 < info->critical_path)
+        info->parallelism = info->work / info->critical_path;
+}
+
+///
+/// @brief Writes the task graph in DOT format.
+///
+/// @param[in,out] file
+///         Output file.
+///
+static void fprint_dot(FILE *file)
+{
+    struct starneig_task_graph_info info;
+    compute_info(&info);
+
+    fprintf(file, "digraph starneig {\n");
+    fprintf(file,
+        "  graph [label=\"tasks %d, work %.6f s, critical path %.6f s, "
+        "parallelism %.2f (max %d)\"];\n",
+        info.tasks, info.work, info.critical_path, info.parallelism,
+        info.max_parallelism);
+    fprintf(file, "  node [shape=box];\n");
+    for (int i = 0; i < recorder.task_count; i++)
+        fprintf(file, "  t%d [label=\"%s\\n%.1f us\"];\n",
+            i, recorder.tasks[i].name, 1.0E6*recorder.tasks[i].cost);
+    for (int i = 0; i < recorder.edge_count; i++)
+        fprintf(file, "  t%d -> t%d;\n",
+            recorder.edges[i][0], recorder.edges[i][1]);
+    fprintf(file, "}\n");
+}
+
+///
+/// @brief Writes the task graph in JSON format.
+///
+/// @param[in,out] file
+///         Output file.
+///
+static void fprint_json(FILE *file)
+{
+    struct starneig_task_graph_info info;
+    compute_info(&info);
+
+    fprintf(file,
+        "{\"summary\":{\"tasks\":%d,\"edges\":%d,\"uncalibrated\":%d,"
+        "\"work\":%.9g,\"critical_path\":%.9g,\"parallelism\":%.9g,"
+        "\"max_parallelism\":%d},\n",
+        info.tasks, info.edges, info.uncalibrated, info.work,
+        info.critical_path, info.parallelism, info.max_parallelism);
+
+    // per-codelet task counts and work
+
+    fprintf(file, "\"codelets\":[");
+    char const **names = malloc(recorder.task_count*sizeof(char const *));
+    int name_count = 0;
+    for (int i = 0; i < recorder.task_count; i++) {
+        int j = 0;
+        while (j < name_count && strcmp(names[j], recorder.tasks[i].name))
+            j++;
+        if (j < name_count)
+            continue;
+        names[name_count++] = recorder.tasks[i].name;
+
+        int count = 0;
+        double work = 0.0;
+        for (int k = i; k < recorder.task_count; k++) {
+            if (strcmp(recorder.tasks[k].name, recorder.tasks[i].name) == 0) {
+                count++;
+                work += recorder.tasks[k].cost;
+            }
+        }
+        fprintf(file, "%s\n{\"name\":\"%s\",\"count\":%d,\"work\":%.9g}",
+            1 < name_count ? "," : "", recorder.tasks[i].name, count, work);
+    }
+    free(names);
+    fprintf(file, "],\n");
+
+    fprintf(file, "\"tasks\":[");
+    for (int i = 0; i < recorder.task_count; i++)
+        fprintf(file,
+            "%s\n{\"id\":%d,\"name\":\"%s\",\"prio\":%d,\"cost\":%.9g,"
+            "\"start\":%.9g}",
+            0 < i ? "," : "", i, recorder.tasks[i].name,
+            recorder.tasks[i].prio, recorder.tasks[i].cost,
+            recorder.tasks[i].start);
+    fprintf(file, "],\n");
+
+    fprintf(file, "\"edges\":[");
+    for (int i = 0; i < recorder.edge_count; i++)
+        fprintf(file, "%s[%d,%d]", 0 < i ? "," : "",
+            recorder.edges[i][0], recorder.edges[i][1]);
+    fprintf(file, "]}\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void starneig_dry_run_begin(mpi_info_t mpi)
+{
+    if (!recorder.enabled)
+        return;
+
+    if (mpi != NULL) {
+        starneig_warning(
+            "Dry runs are supported only in shared memory. "
+            "Executing the tasks.");
+        return;
+    }
+
+    if (recorder.arch == NULL) {
+        int worker = starpu_worker_get_by_type(STARPU_CPU_WORKER, 0);
+        recorder.arch = starpu_worker_get_perf_archtype(MAX(0, worker), 0);
+    }
+
+    recorder.recording = 1;
+}
+
+void starneig_dry_run_end()
+{
+    recorder.recording = 0;
+}
+
+int starneig_dry_run_recording()
+{
+    return recorder.recording;
+}
+
+int starneig_dry_run_record(struct starpu_task *task)
+{
+    reserve((void **) &recorder.tasks, &recorder.task_size,
+        recorder.task_count+1, sizeof(struct dry_run_task));
+
+    int idx = recorder.task_count++;
+    struct dry_run_task *record = &recorder.tasks[idx];
+
+    struct starpu_codelet *cl = task->cl;
+    record->name = "unknown";
+    if (cl->name != NULL)
+        record->name = cl->name;
+    else if (cl->model != NULL && cl->model->symbol != NULL)
+        record->name = cl->model->symbol;
+    record->prio = task->priority;
+    record->start = 0.0;
+    record->mark = -1;
+
+    // predict the execution time
+
+    record->cost = 0.0;
+    if (cl->where != STARPU_NOWHERE && cl->model == NULL) {
+        recorder.uncalibrated++;
+    }
+    else if (cl->where != STARPU_NOWHERE) {
+        double length = starpu_task_expected_length(task, recorder.arch, 0);
+        if (isfinite(length) && 0.0 <= length)
+            record->cost = 1.0E-6*length;
+        else
+            recorder.uncalibrated++;
+    }
+
+    // derive the dependencies from the access modes
+
+    for (unsigned i = 0; i < STARPU_TASK_GET_NBUFFERS(task); i++) {
+        enum starpu_data_access_mode mode = STARPU_TASK_GET_MODE(task, i);
+        if (mode & STARPU_SCRATCH)
+            continue;
+
+        struct dry_run_tracker *tracker =
+            get_tracker(STARPU_TASK_GET_HANDLE(task, i));
+        if (tracker == NULL)
+            continue;
+
+        if (mode == STARPU_R) {
+            add_edge(tracker->writer, idx);
+            reserve((void **) &tracker->readers, &tracker->reader_size,
+                tracker->reader_count+1, sizeof(int));
+            tracker->readers[tracker->reader_count++] = idx;
+        }
+        else {
+            if (0 < tracker->reader_count)
+                for (int j = 0; j < tracker->reader_count; j++)
+                    add_edge(tracker->readers[j], idx);
+            else
+                add_edge(tracker->writer, idx);
+            tracker->writer = idx;
+            tracker->reader_count = 0;
+        }
+    }
+
+    task->destroy = 0;
+    starpu_task_destroy(task);
+
+    return 0;
+}
+
+void starneig_dry_run_init_from_env()
+{
+    char const *file_name = getenv("STARNEIG_DRY_RUN");
+    if (file_name == NULL || strlen(file_name) == 0)
+        return;
+
+    free(recorder.env_file);
+    recorder.env_file = strdup(file_name);
+
+    starneig_node_enable_dry_run();
+
+    starneig_verbose("Dry runs enabled (STARNEIG_DRY_RUN=%s).", file_name);
+}
+
+void starneig_dry_run_finalize_from_env()
+{
+    if (recorder.env_file != NULL) {
+        starneig_node_store_task_graph(recorder.env_file);
+        free(recorder.env_file);
+        recorder.env_file = NULL;
+
+        starneig_node_disable_dry_run();
+        clear();
+    }
+
+    // a task graph that was recorded through the interface can still be
+    // queried and stored; the architecture belongs to the finalized node
+    recorder.recording = 0;
+    recorder.arch = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__ ((visibility ("default")))
+void starneig_node_enable_dry_run()
+{
+#ifdef DRY_RUN_SUPPORTED
+    clear();
+    recorder.enabled = 1;
+#else
+    starneig_warning("Dry runs require StarPU 1.3 or newer.");
+#endif
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_node_disable_dry_run()
+{
+    recorder.enabled = 0;
+    recorder.recording = 0;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_node_get_task_graph_info(struct starneig_task_graph_info *info)
+{
+    compute_info(info);
+}
+
+__attribute__ ((visibility ("default")))
+int starneig_node_store_task_graph(char const *file_name)
+{
+    FILE *file = fopen(file_name, "w");
+    if (file == NULL) {
+        starneig_warning("Failed to open the task graph file %s.", file_name);
+        return -1;
+    }
+
+    size_t length = strlen(file_name);
+    if (4 <= length && strcmp(file_name+length-4, ".dot") == 0)
+        fprint_dot(file);
+    else
+        fprint_json(file);
+
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+///
+/// @file
+///
+/// @brief This file contains the dry run task graph recorder.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_DRY_RUN_H
+#define STARNEIG_COMMON_DRY_RUN_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "common.h"
+#include "progress.h"
+#include <stdio.h>
+#include <starpu.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starpu_mpi.h>
+#endif
+
+///
+/// @brief Inserts a task. During a dry run, the task is recorded to the task
+/// graph instead of being submitted to StarPU. Otherwise, the task is
+/// accounted to the remaining work of the current progress phase.
+///
+///  Takes the same arguments as starpu_task_insert().
+///
+#define starneig_task_insert(cl, ...) \
+    (starneig_dry_run_recording() ? \
+        starneig_dry_run_record(starpu_task_build((cl), __VA_ARGS__)) : \
+        starneig_progress_submit(starpu_task_build((cl), __VA_ARGS__)))
+
+#ifdef STARNEIG_ENABLE_MPI
+
+///
+/// @brief Inserts a task in distributed memory. The task is accounted to the
+/// remaining work of the current progress phase on the MPI rank that executes
+/// it.
+///
+///  Takes the same arguments as starpu_mpi_task_insert(). The arguments are
+///  evaluated twice.
+///
+#define starneig_mpi_task_insert(comm, cl, ...) \
+    (starneig_progress_submit( \
+        starpu_mpi_task_build((comm), (cl), __VA_ARGS__)), \
+    starpu_mpi_task_post_build((comm), (cl), __VA_ARGS__))
+
+#endif
+
+///
+/// @brief Begins a section of code whose tasks are recorded if dry runs are
+/// enabled. Dry runs are supported only in shared memory.
+///
+/// @param[in] mpi
+///         MPI info
+///
+void starneig_dry_run_begin(mpi_info_t mpi);
+
+///
+/// @brief Ends the section that was began last.
+///
+void starneig_dry_run_end();
+
+///
+/// @brief Returns non-zero if tasks are currently being recorded.
+///
+int starneig_dry_run_recording();
+
+///
+/// @brief Records a task to the task graph and destroys the task.
+///
+///  The dependencies are derived from the data handle access modes in the
+///  same way as StarPU derives the implicit dependencies. The cost of the task
+///  is predicted with the performance model of the codelet.
+///
+/// @param[in,out] task
+///         A task that was built with starpu_task_build().
+///
+/// @return Zero.
+///
+int starneig_dry_run_record(struct starpu_task *task);
+
+///
+/// @brief Enables dry runs if the STARNEIG_DRY_RUN environmental variable is
+/// set. Called when the node is initialized.
+///
+void starneig_dry_run_init_from_env();
+
+///
+/// @brief Stores the task graph to the file named by the STARNEIG_DRY_RUN
+/// environmental variable and releases the recorder. Called when the node is
+/// finalized. A task graph that was recorded through the interface is kept.
+///
+void starneig_dry_run_finalize_from_env();
+
+#endif
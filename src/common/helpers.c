@@ -40,8 +40,90 @@
 #include <starneig/sep_sm.h>
 #include "node_internal.h"
 #include "math.h"
+#include "common.h"
+#include "validation.h"
+#include "utils.h"
 #include <stddef.h>
 #include <math.h>
+#include <starpu.h>
+
+static int select_tile_size(int n)
+{
+    int workers = starpu_worker_get_count();
+    return MAX(64, MIN(2048, divceil(n/(4*workers), 8)*8));
+}
+
+static void select_eigenvalues(
+    int n, double const *S, int ldS, double const *T, int ldT,
+    struct starneig_select_predicate const *predicate,
+    int selected[], int *num_selected)
+{
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_SEQUENTIAL);
+    starneig_node_set_mode(STARNEIG_MODE_SM);
+    starneig_node_resume_starpu();
+
+    int tile_size = select_tile_size(n);
+
+    starneig_matrix_t S_d = starneig_matrix_register(
+        MATRIX_TYPE_FULL, n, n, tile_size, tile_size, -1, -1, ldS,
+        sizeof(double), NULL, NULL, (double *) S, NULL);
+    starneig_matrix_t T_d = NULL;
+    if (T != NULL)
+        T_d = starneig_matrix_register(
+            MATRIX_TYPE_FULL, n, n, tile_size, tile_size, -1, -1, ldT,
+            sizeof(double), NULL, NULL, (double *) T, NULL);
+
+    starneig_vector_t selected_d = starneig_init_matching_vector_descr(
+        S_d, sizeof(int), selected, NULL);
+
+    starneig_select_eigenvalues(
+        STARPU_MAX_PRIO, predicate, S_d, T_d, selected_d, NULL);
+
+    starneig_matrix_unregister(S_d);
+    starneig_matrix_unregister(T_d);
+    starneig_vector_unregister(selected_d);
+
+    starneig_matrix_free(S_d);
+    starneig_matrix_free(T_d);
+    starneig_vector_free(selected_d);
+
+    starpu_task_wait_for_all();
+    starneig_node_pause_starpu();
+    starneig_node_set_mode(STARNEIG_MODE_OFF);
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
+
+    int _num_selected = starneig_select_eigenvalues_finalize(n, selected);
+    if (num_selected != NULL)
+        *num_selected = _num_selected;
+}
+
+struct sep_args {
+    int (*predicate)(double real, double imag, void *arg);
+    void *arg;
+};
+
+static void apply_predicate_sep(
+    int count, double const real[], double const imag[], int selected[],
+    void *_arg)
+{
+    struct sep_args const *arg = _arg;
+    for (int i = 0; i < count; i++)
+        selected[i] = arg->predicate(real[i], imag[i], arg->arg);
+}
+
+struct gep_args {
+    int (*predicate)(double real, double imag, double beta, void *arg);
+    void *arg;
+};
+
+static void apply_predicate_gep(
+    int count, double const real[], double const imag[], double const beta[],
+    int selected[], void *_arg)
+{
+    struct gep_args const *arg = _arg;
+    for (int i = 0; i < count; i++)
+        selected[i] = arg->predicate(real[i], imag[i], beta[i], arg->arg);
+}
 
 __attribute__ ((visibility ("default")))
 starneig_error_t starneig_SEP_SM_Select(
@@ -61,40 +143,108 @@ starneig_error_t starneig_SEP_SM_Select(
     if (!starneig_node_initialized())
         return STARNEIG_NOT_INITIALIZED;
 
-    int _num_selected = 0;
-
-    for (int i = 0; i < n; i++) {
-        if (i+1 < n && S[(size_t)i*ldS+i+1] != 0.0) {
-            double real1, imag1, real2, imag2;
-            starneig_compute_complex_eigenvalue(
-                ldS, 0, &S[i*ldS+i], NULL, &real1, &imag1, &real2, &imag2,
-                NULL, NULL);
-
-            if (predicate(real1, imag1, arg)) {
-                selected[i] = 1;
-                selected[i+1] = 1;
-                _num_selected += 2;
-            }
-            else {
-                selected[i] = 0;
-                selected[i+1] = 0;
-            }
-
-            i++;
-        }
-        else {
-            if (predicate(S[(size_t)i*ldS+i], 0.0, arg)) {
-                selected[i] = 1;
-                _num_selected++;
-            }
-            else {
-                selected[i] = 0;
-            }
-        }
-    }
+    struct sep_args args = {
+        .predicate = predicate,
+        .arg = arg
+    };
 
-    if (num_selected != NULL)
-        *num_selected = _num_selected;
+    struct starneig_select_predicate _predicate = {
+        .sep = apply_predicate_sep,
+        .gep = NULL,
+        .arg = &args
+    };
+
+    select_eigenvalues(
+        n, S, ldS, NULL, 0, &_predicate, selected, num_selected);
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_SEP_SM_Select_batched(
+    int n,
+    double S[], int ldS,
+    void (*predicate)(int count, double const real[], double const imag[],
+        int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected)
+{
+    if (n < 1)              return -1;
+    if (S == NULL)          return -2;
+    if (ldS < n)            return -3;
+    if (predicate == NULL)  return -4;
+    if (selected == NULL)   return -6;
+
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
+
+    struct starneig_select_predicate _predicate = {
+        .sep = predicate,
+        .gep = NULL,
+        .arg = arg
+    };
+
+    select_eigenvalues(
+        n, S, ldS, NULL, 0, &_predicate, selected, num_selected);
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_SEP_SM_Validate(
+    int n,
+    double A[], int ldA,
+    double Q[], int ldQ,
+    double S[], int ldS,
+    int probes,
+    double *residual,
+    double *orthogonality)
+{
+    if (n < 1)              return -1;
+    if (A == NULL)          return -2;
+    if (ldA < n)            return -3;
+    if (Q == NULL)          return -4;
+    if (ldQ < n)            return -5;
+    if (S == NULL)          return -6;
+    if (ldS < n)            return -7;
+    if (probes < 1)         return -8;
+
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
+
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_SEQUENTIAL);
+    starneig_node_set_mode(STARNEIG_MODE_SM);
+    starneig_node_resume_starpu();
+
+    int workers = starpu_worker_get_count();
+    int tile_size = MAX(256, MIN(2048, divceil(n/sqrt(4*workers), 8)*8));
+
+    starneig_matrix_t A_d = starneig_matrix_register(
+        MATRIX_TYPE_FULL, n, n, tile_size, tile_size, -1, -1, ldA,
+        sizeof(double), NULL, NULL, A, NULL);
+    starneig_matrix_t Q_d = starneig_matrix_register(
+        MATRIX_TYPE_FULL, n, n, tile_size, tile_size, -1, -1, ldQ,
+        sizeof(double), NULL, NULL, Q, NULL);
+    starneig_matrix_t S_d = starneig_matrix_register(
+        MATRIX_TYPE_FULL, n, n, tile_size, tile_size, -1, -1, ldS,
+        sizeof(double), NULL, NULL, S, NULL);
+
+    starneig_validate_factorization(
+        probes, A_d, Q_d, S_d, NULL, residual, orthogonality);
+
+    starneig_matrix_unregister(A_d);
+    starneig_matrix_unregister(Q_d);
+    starneig_matrix_unregister(S_d);
+
+    starneig_matrix_free(A_d);
+    starneig_matrix_free(Q_d);
+    starneig_matrix_free(S_d);
+
+    starpu_task_wait_for_all();
+    starneig_node_pause_starpu();
+    starneig_node_set_mode(STARNEIG_MODE_OFF);
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
     return STARNEIG_SUCCESS;
 }
@@ -120,40 +270,53 @@ starneig_error_t starneig_GEP_SM_Select(
     if (!starneig_node_initialized())
         return STARNEIG_NOT_INITIALIZED;
 
-    int _num_selected = 0;
-
-    for (int i = 0; i < n; i++) {
-        if (i+1 < n && S[(size_t)i*ldS+i+1] != 0.0) {
-            double real1, imag1, real2, imag2, beta1, beta2;
-            starneig_compute_complex_eigenvalue(
-                ldS, ldT, &S[i*ldS+i], &T[i*ldT+i],
-                &real1, &imag1, &real2, &imag2, &beta1, &beta2);
-
-            if (predicate(real1, imag1, beta1, arg)) {
-                selected[i] = 1;
-                selected[i+1] = 1;
-                _num_selected += 2;
-            }
-            else {
-                selected[i] = 0;
-                selected[i+1] = 0;
-            }
-
-            i++;
-        }
-        else {
-            if (predicate(S[(size_t)i*ldS+i], 0.0, T[(size_t)i*ldT+i], arg)) {
-                selected[i] = 1;
-                _num_selected++;
-            }
-            else {
-                selected[i] = 0;
-            }
-        }
-    }
+    struct gep_args args = {
+        .predicate = predicate,
+        .arg = arg
+    };
 
-    if (num_selected != NULL)
-        *num_selected = _num_selected;
+    struct starneig_select_predicate _predicate = {
+        .sep = NULL,
+        .gep = apply_predicate_gep,
+        .arg = &args
+    };
+
+    select_eigenvalues(
+        n, S, ldS, T, ldT, &_predicate, selected, num_selected);
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_GEP_SM_Select_batched(
+    int n,
+    double S[], int ldS,
+    double T[], int ldT,
+    void (*predicate)(int count, double const real[], double const imag[],
+        double const beta[], int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected)
+{
+    if (n < 1)              return -1;
+    if (S == NULL)          return -2;
+    if (ldS < n)            return -3;
+    if (T == NULL)          return -4;
+    if (ldT < n)            return -5;
+    if (predicate == NULL)  return -6;
+    if (selected == NULL)   return -8;
+
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
+
+    struct starneig_select_predicate _predicate = {
+        .sep = NULL,
+        .gep = predicate,
+        .arg = arg
+    };
+
+    select_eigenvalues(
+        n, S, ldS, T, ldT, &_predicate, selected, num_selected);
 
     return STARNEIG_SUCCESS;
 }
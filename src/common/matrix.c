@@ -42,6 +42,8 @@
 #include "matrix.h"
 #include "common.h"
 #include "tasks.h"
+#include "comm_stats.h"
+#include "dry_run.h"
 
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
@@ -65,12 +67,9 @@ struct starneig_matrix_descr {
     int **owners;                         ///< section owners (MPI ranks)
 #endif
     starpu_data_handle_t **tiles;         ///< tiles
-#ifdef STARNEIG_ENABLE_EVENTS
-    char event_label;
-    int event_enabled;
-    int event_roffset;
-    int event_coffset;
-#endif
+    char event_label;                     ///< trace label
+    int event_roffset;                    ///< trace row offset
+    int event_coffset;                    ///< trace column offset
 };
 
 static void copy_elem(void *buffers[], void *cl_args)
@@ -97,7 +96,7 @@ static void insert_copy_elem(
         .modes = { STARPU_R, STARPU_W }
     };
 
-    starpu_task_insert(
+    starneig_task_insert(
         &copy_elem_cl,
         STARPU_PRIORITY, STARPU_MAX_PRIO,
         STARPU_VALUE, &i, sizeof(i),
@@ -165,12 +164,9 @@ starneig_matrix_t starneig_matrix_init(
     }
 #endif
 
-#ifdef STARNEIG_ENABLE_EVENTS
-    descr->event_enabled = 0;
     descr->event_label = 'X';
     descr->event_roffset = 0;
     descr->event_coffset = 0;
-#endif
 
     return descr;
 }
@@ -501,6 +497,33 @@ int starneig_matrix_involved_with_section(
 #endif
 }
 
+void starneig_matrix_mark_section_owners(
+    int rbegin, int rend, int cbegin, int cend,
+    const starneig_matrix_t descr, char *mask)
+{
+    STARNEIG_ASSERT(descr != NULL);
+    STARNEIG_ASSERT(0 <= rbegin && rend <= STARNEIG_MATRIX_M(descr));
+    STARNEIG_ASSERT(0 <= cbegin && cend <= STARNEIG_MATRIX_N(descr));
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (0 <= descr->tag_offset) {
+        int srbegin = (descr->rbegin + rbegin) / (descr->sbm * descr->bm);
+        int srend = (descr->rbegin + rend-1) / (descr->sbm * descr->bm) + 1;
+
+        int scbegin = (descr->cbegin + cbegin) / (descr->sbn * descr->bn);
+        int scend = (descr->cbegin + cend-1) / (descr->sbn * descr->bn) + 1;
+
+        for (int i = srbegin; i < srend; i++)
+            for (int j = scbegin; j < scend; j++)
+                mask[descr->owners[i][j]] = 1;
+
+        return;
+    }
+#endif
+
+    mask[starneig_mpi_get_comm_rank()] = 1;
+}
+
 void starneig_matrix_flush_section(
     int rbegin, int rend, int cbegin, int cend,
     const starneig_matrix_t descr)
@@ -521,9 +544,11 @@ void starneig_matrix_flush_section(
 
     for (int i = srbegin; i < srend; i++)
         for (int j = scbegin; j < scend; j++)
-            if (descr->tiles[i][j] != NULL)
+            if (descr->tiles[i][j] != NULL) {
                 starpu_mpi_cache_flush(
                     starneig_mpi_get_comm(), descr->tiles[i][j]);
+                starneig_comm_stats_flush_handle(descr->tiles[i][j]);
+            }
 #endif
 }
 
@@ -547,6 +572,34 @@ void starneig_matrix_prefetch_section(
                 starpu_data_prefetch_on_node(descr->tiles[i][j], node, async);
 }
 
+void starneig_matrix_set_event_label(char label, starneig_matrix_t descr)
+{
+    descr->event_label = label;
+}
+
+void starneig_matrix_inherit_event_info(
+    const starneig_matrix_t source, starneig_matrix_t descr)
+{
+    descr->event_label = source->event_label;
+    descr->event_roffset = source->event_roffset;
+    descr->event_coffset = source->event_coffset;
+}
+
+void starneig_matrix_add_event_offset(
+    int roffset, int coffset, starneig_matrix_t descr)
+{
+    descr->event_roffset += roffset;
+    descr->event_coffset += coffset;
+}
+
+void starneig_matrix_get_event_info(
+    const starneig_matrix_t descr, char *label, int *roffset, int *coffset)
+{
+    *label = descr->event_label;
+    *roffset = descr->event_roffset;
+    *coffset = descr->event_coffset;
+}
+
 int STARNEIG_MATRIX_RBEGIN(const starneig_matrix_t descr)
 {
     return descr->rbegin;
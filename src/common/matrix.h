@@ -377,6 +377,33 @@ int starneig_matrix_involved_with_section(
     int rbegin, int rend, int cbegin, int cend,
     const starneig_matrix_t descr);
 
+///
+/// @brief Marks the MPI ranks that own tiles in a section of a distributed
+/// matrix.
+///
+/// @param[in] rbegin
+///         First row that belongs to the section.
+///
+/// @param[in] rend
+///         Last row that belongs to the section + 1.
+///
+/// @param[in] cbegin
+///         First column that belongs to the section.
+///
+/// @param[in] cend
+///         Last column that belongs to the section + 1.
+///
+/// @param[in] descr
+///         Matrix descriptor.
+///
+/// @param[out] mask
+///         Owner mask (one entry per MPI rank). The entries that correspond to
+///         the owners are set to 1. The remaining entries are not touched.
+///
+void starneig_matrix_mark_section_owners(
+    int rbegin, int rend, int cbegin, int cend,
+    const starneig_matrix_t descr, char *mask);
+
 ///
 /// @brief Flushes a section of a distributed matrix.
 ///
@@ -426,6 +453,63 @@ void starneig_matrix_prefetch_section(
     int rbegin, int rend, int cbegin, int cend, int node, int async,
     const starneig_matrix_t descr);
 
+///
+/// @brief Sets the label that identifies the matrix in execution traces.
+///
+/// @param[in] label
+///         Trace label.
+///
+/// @param[in,out] descr
+///         Matrix descriptor.
+///
+void starneig_matrix_set_event_label(char label, starneig_matrix_t descr);
+
+///
+/// @brief Copies the trace label and offsets from an another matrix.
+///
+/// @param[in] source
+///         Source matrix descriptor.
+///
+/// @param[in,out] descr
+///         Matrix descriptor.
+///
+void starneig_matrix_inherit_event_info(
+    const starneig_matrix_t source, starneig_matrix_t descr);
+
+///
+/// @brief Adds to the offsets that are used to position the matrix inside the
+/// labeled matrix in execution traces.
+///
+/// @param[in] roffset
+///         Row offset.
+///
+/// @param[in] coffset
+///         Column offset.
+///
+/// @param[in,out] descr
+///         Matrix descriptor.
+///
+void starneig_matrix_add_event_offset(
+    int roffset, int coffset, starneig_matrix_t descr);
+
+///
+/// @brief Returns the trace label and offsets.
+///
+/// @param[in] descr
+///         Matrix descriptor.
+///
+/// @param[out] label
+///         Trace label.
+///
+/// @param[out] roffset
+///         Row offset.
+///
+/// @param[out] coffset
+///         Column offset.
+///
+void starneig_matrix_get_event_info(
+    const starneig_matrix_t descr, char *label, int *roffset, int *coffset);
+
 ///
 /// @brief Returns the first row that belongs to the (sub)matrix.
 ///
@@ -0,0 +1,318 @@
+///
+/// @file
+///
+/// @brief This file contains functions for memory mapping matrices that are
+/// stored in files.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/matrix_io.h>
+#include "raw_format.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+///
+/// @brief Huge page size.
+///
+#define HUGE_PAGE_SIZE (2*1024*1024)
+
+///
+/// @brief Memory mapped matrix.
+///
+struct mapping {
+    void *addr;             ///< mapping address
+    size_t length;          ///< mapping length
+    struct mapping *next;   ///< next mapping
+};
+
+static struct mapping *mappings = NULL;
+static pthread_mutex_t mappings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+///
+/// @brief Reserves an address range that is aligned to a huge page boundary.
+///
+/// @param[in] length
+///         The length of the address range.
+///
+/// @return An aligned address range on success, MAP_FAILED otherwise.
+///
+static void * reserve_aligned(size_t length)
+{
+    size_t padded = length + HUGE_PAGE_SIZE;
+    char *reserved = mmap(NULL, padded, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED)
+        return MAP_FAILED;
+
+    char *aligned = (char *)
+        (((uintptr_t) reserved + HUGE_PAGE_SIZE - 1) &
+        ~((uintptr_t) HUGE_PAGE_SIZE - 1));
+
+    // release the unaligned head and the excess tail
+    if (reserved < aligned)
+        munmap(reserved, aligned - reserved);
+    size_t tail = (reserved + padded) - (aligned + length);
+    if (0 < tail)
+        munmap(aligned + length, tail);
+
+    return aligned;
+}
+
+///
+/// @brief Maps a file or an anonymous memory region.
+///
+/// @param[in] fd
+///         The file descriptor, -1 for an anonymous memory region.
+///
+/// @param[in] length
+///         The length of the mapping.
+///
+/// @param[in] flags
+///         Mapping flags.
+///
+/// @return The mapping on success, MAP_FAILED otherwise.
+///
+static void * map_region(int fd, size_t length, starneig_map_flag_t flags)
+{
+    int mmap_flags = MAP_PRIVATE | (fd < 0 ? MAP_ANONYMOUS : 0);
+
+    // private file-backed mappings are served from the page cache and
+    // transparent huge pages apply only to anonymous mappings
+    int huge = fd < 0 && (flags & STARNEIG_MAP_HUGE_PAGES);
+
+    void *addr = NULL;
+    if (huge) {
+        addr = reserve_aligned(length);
+        if (addr == MAP_FAILED)
+            return MAP_FAILED;
+        mmap_flags |= MAP_FIXED;
+    }
+
+    void *ret = mmap(addr, length, PROT_READ | PROT_WRITE, mmap_flags, fd, 0);
+    if (ret == MAP_FAILED) {
+        if (addr != NULL)
+            munmap(addr, length);
+        return MAP_FAILED;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge)
+        madvise(ret, length, MADV_HUGEPAGE);
+#endif
+
+    if (0 <= fd && (flags & STARNEIG_MAP_PREFETCH))
+        madvise(ret, length, MADV_WILLNEED);
+
+    return ret;
+}
+
+__attribute__ ((visibility ("default")))
+int starneig_matrix_header(int rows, int cols, char *header)
+{
+    int length = snprintf(header, RAW_HEADER_MAX, RAW_HEADER_FORMAT, rows, cols);
+
+    // pad with spaces (before the new line) so that the first matrix element
+    // becomes aligned
+    int padded = ((length + RAW_DATA_ALIGNMENT - 1) / RAW_DATA_ALIGNMENT) *
+        RAW_DATA_ALIGNMENT;
+    if (padded < RAW_HEADER_MAX) {
+        memset(header + length - 1, ' ', padded - length);
+        header[padded-1] = '\n';
+        header[padded] = '\0';
+        length = padded;
+    }
+
+    return length;
+}
+
+starneig_error_t starneig_raw_parse_header(
+    char const *buffer, size_t length, int *rows, int *cols, size_t *offset)
+{
+    char const *newline = memchr(buffer, '\n', length);
+    if (newline == NULL)
+        return STARNEIG_GENERIC_ERROR;
+
+    // sscanf requires a terminated string
+    char header[RAW_HEADER_MAX+1] = { 0 };
+    memcpy(header, buffer, MIN(RAW_HEADER_MAX, newline - buffer + 1));
+
+    if (sscanf(header, RAW_HEADER_FORMAT, rows, cols) != 2 ||
+    *rows < 1 || *cols < 1)
+        return STARNEIG_GENERIC_ERROR;
+
+    *offset = newline - buffer + 1;
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_matrix_map(
+    char const *filename, starneig_map_flag_t flags, int *rows, int *cols,
+    double **A, int *ldA)
+{
+    if (filename == NULL)   return -1;
+    if (rows == NULL)       return -3;
+    if (cols == NULL)       return -4;
+    if (A == NULL)          return -5;
+    if (ldA == NULL)        return -6;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        starneig_error("Failed to open %s.", filename);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    char buffer[RAW_HEADER_MAX];
+    ssize_t count = pread(fd, buffer, RAW_HEADER_MAX, 0);
+
+    size_t offset;
+    if (count < 1 || starneig_raw_parse_header(
+    buffer, count, rows, cols, &offset) != STARNEIG_SUCCESS) {
+        starneig_error("Invalid file header in %s.", filename);
+        close(fd);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    size_t size = (size_t) *rows * (*cols) * sizeof(double);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < offset + size) {
+        starneig_error("%s is truncated.", filename);
+        close(fd);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    void *addr;
+    size_t length;
+    char *begin;
+
+    if (offset % sizeof(double) == 0) {
+
+        //
+        // zero-copy
+        //
+
+        length = offset + size;
+        addr = map_region(fd, length, flags);
+        begin = (char *) addr + offset;
+    }
+    else {
+
+        //
+        // the matrix elements are misaligned, copy them
+        //
+
+        starneig_warning(
+            "The matrix elements in %s are not aligned. Copying the matrix.",
+            filename);
+
+        length = size;
+        addr = map_region(-1, length, flags);
+        if (addr != MAP_FAILED) {
+            void *file = mmap(
+                NULL, offset + size, PROT_READ, MAP_SHARED, fd, 0);
+            if (file != MAP_FAILED) {
+                madvise(file, offset + size, MADV_SEQUENTIAL);
+                memcpy(addr, (char *) file + offset, size);
+                munmap(file, offset + size);
+            }
+            else {
+                munmap(addr, length);
+                addr = MAP_FAILED;
+            }
+        }
+        begin = addr;
+    }
+
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        starneig_error("Failed to map %s.", filename);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    struct mapping *mapping = malloc(sizeof(struct mapping));
+    mapping->addr = addr;
+    mapping->length = length;
+
+    pthread_mutex_lock(&mappings_mutex);
+    mapping->next = mappings;
+    mappings = mapping;
+    pthread_mutex_unlock(&mappings_mutex);
+
+    *A = (double *) begin;
+    *ldA = *rows;
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_matrix_unmap(double *A)
+{
+    if (A == NULL)
+        return;
+
+    pthread_mutex_lock(&mappings_mutex);
+
+    struct mapping **iter = &mappings;
+    while (*iter != NULL) {
+        char *addr = (*iter)->addr;
+        if (addr <= (char *) A && (char *) A < addr + (*iter)->length)
+            break;
+        iter = &(*iter)->next;
+    }
+
+    struct mapping *mapping = *iter;
+    if (mapping != NULL)
+        *iter = mapping->next;
+
+    pthread_mutex_unlock(&mappings_mutex);
+
+    if (mapping == NULL) {
+        starneig_warning("Trying to unmap an unknown matrix.");
+        return;
+    }
+
+    munmap(mapping->addr, mapping->length);
+    free(mapping);
+}
@@ -0,0 +1,267 @@
+///
+/// @file
+///
+/// @brief This file contains the binomial tree multicast of small data handles
+/// to the MPI ranks that own tiles inside an update window.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "multicast.h"
+#include "cpu.h"
+#include "comm_stats.h"
+#include "dry_run.h"
+#include <stdlib.h>
+#include <stdint.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <starpu_mpi.h>
+#endif
+
+#if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_MULTICAST)
+
+///
+/// @brief copy_handle codelet copies a data handle to an another data handle.
+///
+///  Buffers:
+///   - source handle (STARPU_R)
+///   - destination handle (STARPU_W, same dimensions as the source handle)
+///
+static struct starpu_codelet copy_handle_cl = {
+    .name = "starneig_copy_handle",
+    .cpu_funcs = { starneig_cpu_copy_handle },
+    .cpu_funcs_name = { "starneig_cpu_copy_handle" },
+    .nbuffers = 2,
+    .modes = { STARPU_R, STARPU_W }
+};
+
+#define MULTICAST_BUCKETS 256
+
+///
+/// @brief Multicast tree.
+///
+///  The tree members are stored in the tree order. The parent of the k'th
+///  member is the (k & (k-1))'th member, i.e., the root sends to the members
+///  1, 2, 4, 8, ..., the member 2 sends to the member 3, the member 4 sends to
+///  the members 5 and 6, and so on.
+///
+struct multicast_tree {
+    starpu_data_handle_t handle;     ///< original data handle
+    int64_t tag;                     ///< MPI tag of the original data handle
+    int count;                       ///< number of tree members
+    int *members;                    ///< tree members (MPI ranks)
+    starpu_data_handle_t *replicas;  ///< replicas (indexed by MPI rank)
+    struct multicast_tree *next;     ///< next tree in the same bucket
+};
+
+static struct multicast_tree *trees[MULTICAST_BUCKETS] = { 0 };
+
+static int hash_handle(starpu_data_handle_t handle)
+{
+    return ((uintptr_t) handle >> 4) % MULTICAST_BUCKETS;
+}
+
+///
+/// @brief Detaches a multicast tree from the registry.
+///
+/// @param[in] handle
+///         original data handle
+///
+/// @return detached multicast tree if one exists, NULL otherwise
+///
+static struct multicast_tree * detach_tree(starpu_data_handle_t handle)
+{
+    struct multicast_tree **prev = &trees[hash_handle(handle)];
+    while (*prev != NULL) {
+        struct multicast_tree *tree = *prev;
+        if (tree->handle == handle) {
+            *prev = tree->next;
+            return tree;
+        }
+        prev = &tree->next;
+    }
+    return NULL;
+}
+
+static struct multicast_tree * find_tree(starpu_data_handle_t handle)
+{
+    struct multicast_tree *tree = trees[hash_handle(handle)];
+    while (tree != NULL && tree->handle != handle)
+        tree = tree->next;
+    return tree;
+}
+
+///
+/// @brief Unregisters the replicas and frees a multicast tree.
+///
+/// @param[in,out] tree
+///         multicast tree
+///
+static void free_tree(struct multicast_tree *tree)
+{
+    if (tree == NULL)
+        return;
+
+    // the first member owns the original data handle
+    for (int i = 1; i < tree->count; i++)
+        starpu_data_unregister_submit(tree->replicas[tree->members[i]]);
+
+    free(tree->members);
+    free(tree->replicas);
+    free(tree);
+}
+
+#endif // STARNEIG_ENABLE_MPI && STARNEIG_ENABLE_MULTICAST
+
+void starneig_multicast_extend(
+    int rbegin, int rend, int cbegin, int cend, int prio,
+    starpu_data_handle_t handle, starneig_matrix_t matrix, mpi_info_t mpi)
+{
+#if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_MULTICAST)
+    if (mpi == NULL || handle == NULL || !STARNEIG_MATRIX_DISTRIBUTED(matrix))
+        return;
+
+    int world_size = starneig_mpi_get_comm_size();
+    if (world_size < 3)
+        return;
+
+    //
+    // locate the tree or create a new one
+    //
+
+    int64_t tag = starpu_mpi_data_get_tag(handle);
+
+    struct multicast_tree *tree = find_tree(handle);
+
+    // a stale tree from an earlier data handle that lived at the same address
+    if (tree != NULL && tree->tag != tag) {
+        free_tree(detach_tree(handle));
+        tree = NULL;
+    }
+
+    if (tree == NULL) {
+        tree = malloc(sizeof(struct multicast_tree));
+        tree->handle = handle;
+        tree->tag = tag;
+        tree->count = 1;
+        tree->members = malloc(world_size*sizeof(int));
+        tree->replicas = calloc(world_size, sizeof(starpu_data_handle_t));
+
+        int root = starpu_mpi_data_get_rank(handle);
+        tree->members[0] = root;
+        tree->replicas[root] = handle;
+
+        int bucket = hash_handle(handle);
+        tree->next = trees[bucket];
+        trees[bucket] = tree;
+    }
+
+    if (tree->count == world_size)
+        return;
+
+    //
+    // add missing owners to the tree
+    //
+
+    char *mask = calloc(world_size, sizeof(char));
+    starneig_matrix_mark_section_owners(
+        rbegin, rend, cbegin, cend, matrix, mask);
+
+    for (int rank = 0; rank < world_size; rank++) {
+        if (!mask[rank] || tree->replicas[rank] != NULL)
+            continue;
+
+        int k = tree->count++;
+        tree->members[k] = rank;
+
+        starpu_data_handle_t parent = tree->replicas[tree->members[k & (k-1)]];
+
+        starpu_data_handle_t replica;
+        starpu_matrix_data_register(&replica, -1, 0,
+            starpu_matrix_get_nx(handle), starpu_matrix_get_nx(handle),
+            starpu_matrix_get_ny(handle), starpu_matrix_get_elemsize(handle));
+        starpu_mpi_data_register_comm(
+            replica, mpi->tag_offset++, rank, starneig_mpi_get_comm());
+        tree->replicas[rank] = replica;
+
+        starneig_comm_stats_task(rank, (struct starpu_data_descr[]) {
+            { .handle = parent, .mode = STARPU_R },
+            { .handle = replica, .mode = STARPU_W } }, 2);
+        starneig_mpi_task_insert(
+            starneig_mpi_get_comm(), &copy_handle_cl,
+            STARPU_PRIORITY, prio,
+            STARPU_R, parent, STARPU_W, replica, 0);
+    }
+
+    free(mask);
+#endif
+}
+
+starpu_data_handle_t starneig_multicast_get_replica(
+    starpu_data_handle_t handle, int rank)
+{
+#if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_MULTICAST)
+    struct multicast_tree *tree = find_tree(handle);
+    if (tree != NULL && tree->replicas[rank] != NULL &&
+    tree->tag == starpu_mpi_data_get_tag(handle))
+        return tree->replicas[rank];
+#endif
+    return handle;
+}
+
+void starneig_multicast_unregister_submit(starpu_data_handle_t handle)
+{
+    if (handle == NULL)
+        return;
+
+#if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_MULTICAST)
+    free_tree(detach_tree(handle));
+#endif
+
+    starpu_data_unregister_submit(handle);
+}
+
+void starneig_multicast_clear()
+{
+#if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_MULTICAST)
+    for (int i = 0; i < MULTICAST_BUCKETS; i++) {
+        while (trees[i] != NULL) {
+            struct multicast_tree *tree = trees[i];
+            trees[i] = tree->next;
+            free_tree(tree);
+        }
+    }
+#endif
+}
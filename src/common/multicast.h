@@ -0,0 +1,120 @@
+///
+/// @file
+///
+/// @brief This file contains the binomial tree multicast of small data handles
+/// to the MPI ranks that own tiles inside an update window.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_MULTICAST_H
+#define STARNEIG_COMMON_MULTICAST_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "common.h"
+#include "matrix.h"
+#include <starpu.h>
+
+///
+/// @brief Makes sure that every MPI rank that owns a tile inside an update
+/// window has a local replica of a given (small) data handle.
+///
+///  The replicas form a binomial tree that is rooted at the owner of the
+///  original data handle. A rank that joins the tree receives its replica from
+///  its parent in the tree and not from the owner of the original data handle.
+///  The tree is extended incrementally when the function is called again with
+///  a different update window. All MPI ranks must make the same calls in the
+///  same order.
+///
+/// @param[in] rbegin
+///         first row that belongs to the update window
+///
+/// @param[in] rend
+///         last row that belongs to the update window + 1
+///
+/// @param[in] cbegin
+///         first column that belongs to the update window
+///
+/// @param[in] cend
+///         last column that belongs to the update window + 1
+///
+/// @param[in] prio
+///         StarPU priority
+///
+/// @param[in] handle
+///         data handle to be multicasted
+///
+/// @param[in] matrix
+///         matrix descriptor
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+void starneig_multicast_extend(
+    int rbegin, int rend, int cbegin, int cend, int prio,
+    starpu_data_handle_t handle, starneig_matrix_t matrix, mpi_info_t mpi);
+
+///
+/// @brief Returns the replica of a data handle that is owned by a given MPI
+/// rank.
+///
+/// @param[in] handle
+///         original data handle
+///
+/// @param[in] rank
+///         MPI rank
+///
+/// @return replica if one exists, the original data handle otherwise
+///
+starpu_data_handle_t starneig_multicast_get_replica(
+    starpu_data_handle_t handle, int rank);
+
+///
+/// @brief Unregisters a data handle and all its replicas.
+///
+///  Acts like starpu_data_unregister_submit() when the data handle has not
+///  been multicasted.
+///
+/// @param[in,out] handle
+///         original data handle
+///
+void starneig_multicast_unregister_submit(starpu_data_handle_t handle);
+
+///
+/// @brief Unregisters the replicas of all multicast trees and forgets the
+/// trees. Called before StarPU-MPI is shut down.
+///
+void starneig_multicast_clear();
+
+#endif
@@ -44,6 +44,9 @@
 #endif
 #include "common.h"
 #include "scratch.h"
+#include "trace.h"
+#include "counters.h"
+#include "dry_run.h"
 #include <starneig/node.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -316,12 +319,14 @@ static void node_configure(
     conf.ncuda = state.used_gpus;
     conf.nopencl = 0;
 
+#ifndef STARNEIG_ENABLE_SIMGRID
 //#if 1 < STARPU_MAJOR_VERSION || 2 < STARPU_MINOR_VERSION
     if (getenv("STARPU_WORKERS_CPUID") == NULL)
         conf.use_explicit_workers_bindid = 1;
 //#endif
     memcpy(conf.workers_bindid, state.starpu_workers_bindid,
         sizeof(state.starpu_workers_bindid));
+#endif
 
 #ifdef STARNEIG_ENABLE_CUDA
     if (0 < state.used_gpus)
@@ -572,11 +577,22 @@ void starneig_node_init(int cores, int gpus, starneig_flag_t flags)
         state.avail_cores = MIN(state.avail_cores, num_slurm_cpus);
     }
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    // the simulated platform is described by the SimGrid platform file and
+    // need not match the host the simulation runs on
+    if (0 < num_starpu_cpus)
+        state.avail_cores = num_starpu_cpus;
+#endif
+
     if (state.avail_cores <= 0)
         starneig_fatal_error("Something unexpected happened.");
 
     state.is_init   = true;
 
+    starneig_trace_init_from_env();
+    starneig_counters_init_from_env();
+    starneig_dry_run_init_from_env();
+
     if (state.flags & STARNEIG_HINT_DM)
         CONFIGURE(cores, gpus, STARNEIG_MODE_DM, STARNEIG_BLAS_MODE_SEQUENTIAL);
     else
@@ -596,6 +612,10 @@ void starneig_node_finalize(void)
 
     starneig_verbose("De-initializing node.");
 
+    starneig_trace_finalize_from_env();
+    starneig_counters_finalize_from_env();
+    starneig_dry_run_finalize_from_env();
+
     CONFIGURE(-1, -1, STARNEIG_MODE_OFF, STARNEIG_BLAS_MODE_ORIGINAL);
 
     starneig_set_message_mode(0, 0);
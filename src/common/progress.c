@@ -0,0 +1,413 @@
+///
+/// @file
+///
+/// @brief This file contains the progress reporting that is shared among all
+/// components of the library.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/node.h>
+#include "progress.h"
+#include "dry_run.h"
+#include "comm_stats.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <starpu_mpi.h>
+#endif
+
+///
+/// @brief Progress state.
+///
+static struct {
+    char const *phase;                      ///< current phase or NULL
+    int generation;                         ///< phase counter
+    int done;                               ///< completed units
+    int total;                              ///< total units
+    int64_t pending;                        ///< predicted work of the
+                                            ///< unfinished tasks (ns)
+    int unknown;                            ///< unfinished tasks without a
+                                            ///< prediction
+    struct starpu_perfmodel_arch *arch;     ///< prediction architecture
+    int workers;                            ///< number of workers
+    double begin;                           ///< phase begin time
+    double last;                            ///< last callback time
+    starneig_progress_callback_t callback;  ///< user callback
+    double interval;                        ///< minimum callback interval
+    void *arg;                              ///< callback argument
+    pthread_mutex_t mutex;                  ///< serializes callbacks
+} progress = {
+    .phase = NULL,
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+///
+/// @brief Accounting of a submitted task. Wraps the original callback of the
+/// task.
+///
+struct pending_task {
+    void (*callback)(void *);               ///< original callback
+    void *arg;                              ///< original callback argument
+    int free_arg;                           ///< original callback_arg_free
+    int generation;                         ///< phase of the task
+    int64_t length;                         ///< predicted length (ns) or -1
+};
+
+///
+/// @brief Returns the current time in seconds.
+///
+static double get_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1.0E-9*ts.tv_nsec;
+}
+
+///
+/// @brief Takes a snapshot of the progress state.
+///
+/// @param[out] snapshot
+///         The snapshot.
+///
+static void take_snapshot(struct starneig_progress *snapshot)
+{
+    snapshot->phase = __atomic_load_n(&progress.phase, __ATOMIC_ACQUIRE);
+    snapshot->done = __atomic_load_n(&progress.done, __ATOMIC_RELAXED);
+    snapshot->total = __atomic_load_n(&progress.total, __ATOMIC_RELAXED);
+    snapshot->elapsed = 0.0;
+    snapshot->remaining = -1.0;
+
+    if (snapshot->phase == NULL)
+        return;
+
+    snapshot->elapsed = get_time() - progress.begin;
+
+    if (0 < snapshot->total && snapshot->total <= snapshot->done) {
+        snapshot->remaining = 0.0;
+        return;
+    }
+
+    // the predicted work of the unfinished tasks is assumed to be distributed
+    // evenly among the workers
+    int64_t pending = __atomic_load_n(&progress.pending, __ATOMIC_RELAXED);
+    int unknown = __atomic_load_n(&progress.unknown, __ATOMIC_RELAXED);
+    if (0 < pending && unknown == 0)
+        snapshot->remaining = 1.0E-9 * pending / MAX(1, progress.workers);
+}
+
+///
+/// @brief Calls the user callback if enough time has passed since the last
+/// call.
+///
+/// @param[in] force
+///         If non-zero, the callback is called unconditionally.
+///
+static void report(int force)
+{
+    if (__atomic_load_n(&progress.callback, __ATOMIC_ACQUIRE) == NULL)
+        return;
+
+    double now = get_time();
+    if (!force && now - progress.last < progress.interval)
+        return;
+
+    // workers never wait for each other; the next update tries again
+    if (force)
+        pthread_mutex_lock(&progress.mutex);
+    else if (pthread_mutex_trylock(&progress.mutex) != 0)
+        return;
+
+    starneig_progress_callback_t callback = progress.callback;
+    if (callback != NULL &&
+    (force || progress.interval <= now - progress.last)) {
+        progress.last = now;
+        struct starneig_progress snapshot;
+        take_snapshot(&snapshot);
+        callback(&snapshot, progress.arg);
+    }
+
+    pthread_mutex_unlock(&progress.mutex);
+}
+
+///
+/// @brief Marker task callback.
+///
+/// @param[in] arg
+///         The number of progress units.
+///
+static void marker_callback(void *arg)
+{
+    starneig_progress_add((intptr_t) arg);
+}
+
+///
+/// @brief Task callback that removes the task from the predicted work.
+///
+/// @param[in] arg
+///         The task accounting.
+///
+static void pending_callback(void *arg)
+{
+    struct pending_task *pending = arg;
+
+    if (pending->generation ==
+    __atomic_load_n(&progress.generation, __ATOMIC_RELAXED)) {
+        if (0 <= pending->length)
+            __atomic_sub_fetch(
+                &progress.pending, pending->length, __ATOMIC_RELAXED);
+        else
+            __atomic_sub_fetch(&progress.unknown, 1, __ATOMIC_RELAXED);
+    }
+
+    if (pending->callback != NULL)
+        pending->callback(pending->arg);
+    if (pending->free_arg)
+        free(pending->arg);
+}
+
+///
+/// @brief Marker codelet. The task does not execute anything.
+///
+static struct starpu_codelet marker_cl = {
+    .name = "starneig_progress_marker",
+    .where = STARPU_NOWHERE,
+    .nbuffers = 1,
+    .modes = { STARPU_R }
+};
+
+#ifdef STARNEIG_ENABLE_MPI
+
+///
+/// @brief Writes a progress token.
+///
+static void token_cpu(void *buffers[], void *cl_args)
+{
+    *(int *) STARPU_VARIABLE_GET_PTR(buffers[1]) = 1;
+}
+
+///
+/// @brief Token codelet. The token is written by the owner of the data handle
+/// and then broadcast to the other MPI ranks.
+///
+static struct starpu_codelet token_cl = {
+    .name = "starneig_progress_token",
+    .cpu_funcs = { token_cpu },
+    .nbuffers = 2,
+    .modes = { STARPU_R, STARPU_W }
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void starneig_progress_begin(char const *name)
+{
+    __atomic_store_n(&progress.phase, NULL, __ATOMIC_RELEASE);
+
+    // the tasks of the previous phase no longer update the predicted work
+    __atomic_add_fetch(&progress.generation, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&progress.pending, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&progress.unknown, 0, __ATOMIC_RELAXED);
+
+    int worker = starpu_worker_get_by_type(STARPU_CPU_WORKER, 0);
+    progress.arch = starpu_worker_get_perf_archtype(MAX(0, worker), 0);
+    progress.workers = starpu_worker_get_count();
+
+    progress.begin = get_time();
+    progress.last = progress.begin;
+    __atomic_store_n(&progress.done, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&progress.total, 0, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&progress.phase, name, __ATOMIC_RELEASE);
+    report(1);
+}
+
+void starneig_progress_set_total(int total)
+{
+    __atomic_store_n(&progress.total, total, __ATOMIC_RELAXED);
+}
+
+void starneig_progress_add(int count)
+{
+    __atomic_add_fetch(&progress.done, count, __ATOMIC_RELAXED);
+    report(0);
+}
+
+void starneig_progress_set(int done)
+{
+    __atomic_store_n(&progress.done, done, __ATOMIC_RELAXED);
+    report(0);
+}
+
+void starneig_progress_end()
+{
+    report(1);
+    __atomic_store_n(&progress.phase, NULL, __ATOMIC_RELEASE);
+}
+
+int starneig_progress_submit(struct starpu_task *task)
+{
+    // StarPU-MPI returns NULL when the task is executed by an other MPI rank
+    if (task == NULL)
+        return 0;
+
+    struct starpu_codelet *cl = task->cl;
+    if (__atomic_load_n(&progress.phase, __ATOMIC_ACQUIRE) == NULL ||
+    cl == NULL || cl->where == STARPU_NOWHERE)
+        return starpu_task_submit(task);
+
+    struct pending_task *pending = malloc(sizeof(struct pending_task));
+    pending->callback = task->callback_func;
+    pending->arg = task->callback_arg;
+    pending->free_arg = task->callback_arg_free;
+    pending->generation =
+        __atomic_load_n(&progress.generation, __ATOMIC_RELAXED);
+    pending->length = -1;
+
+    if (cl->model != NULL) {
+        double length =
+            starpu_task_expected_length(task, progress.arch, 0);
+        if (isfinite(length) && 0.0 <= length)
+            pending->length = 1000.0 * length;
+    }
+
+    if (0 <= pending->length)
+        __atomic_add_fetch(
+            &progress.pending, pending->length, __ATOMIC_RELAXED);
+    else
+        __atomic_add_fetch(&progress.unknown, 1, __ATOMIC_RELAXED);
+
+    task->callback_func = &pending_callback;
+    task->callback_arg = pending;
+    task->callback_arg_free = 1;
+
+    int ret = starpu_task_submit(task);
+    if (ret != 0) {
+        // the callback is never called
+        if (0 <= pending->length)
+            __atomic_sub_fetch(
+                &progress.pending, pending->length, __ATOMIC_RELAXED);
+        else
+            __atomic_sub_fetch(&progress.unknown, 1, __ATOMIC_RELAXED);
+        task->callback_func = pending->callback;
+        task->callback_arg = pending->arg;
+        task->callback_arg_free = pending->free_arg;
+        free(pending);
+    }
+
+    return ret;
+}
+
+void starneig_progress_insert_marker(
+    int count, starpu_data_handle_t handle, mpi_info_t mpi)
+{
+    if (count < 1 || handle == NULL)
+        return;
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        // the owner of the data handle writes a token once the earlier tasks
+        // have finished and the token is then broadcast to all MPI ranks so
+        // that every rank counts the progress units
+        int owner = starpu_mpi_data_get_rank(handle);
+
+        starpu_data_handle_t token;
+        starpu_variable_data_register(&token, -1, 0, sizeof(int));
+        starpu_mpi_data_register_comm(
+            token, mpi->tag_offset++, owner, starneig_mpi_get_comm());
+
+        starneig_comm_stats_task(owner, (struct starpu_data_descr[]) {
+            { .handle = handle, .mode = STARPU_R },
+            { .handle = token, .mode = STARPU_W } }, 2);
+        starpu_mpi_task_insert(
+            starneig_mpi_get_comm(),
+            &token_cl,
+            STARPU_EXECUTE_ON_NODE, owner,
+            STARPU_PRIORITY, STARPU_MAX_PRIO,
+            STARPU_R, handle, STARPU_W, token, 0);
+
+        int world_size = starneig_mpi_get_comm_size();
+        for (int rank = 0; rank < world_size; rank++) {
+            starneig_comm_stats_task(rank, (struct starpu_data_descr[]) {
+                { .handle = token, .mode = STARPU_R } }, 1);
+            starpu_mpi_task_insert(
+                starneig_mpi_get_comm(),
+                &marker_cl,
+                STARPU_EXECUTE_ON_NODE, rank,
+                STARPU_PRIORITY, STARPU_MAX_PRIO,
+                STARPU_CALLBACK_WITH_ARG,
+                    &marker_callback, (void *)(intptr_t) count,
+                STARPU_R, token, 0);
+        }
+
+        starpu_data_unregister_submit(token);
+    }
+    else
+#endif
+        starneig_task_insert(
+            &marker_cl,
+            STARPU_PRIORITY, STARPU_MAX_PRIO,
+            STARPU_CALLBACK_WITH_ARG,
+                &marker_callback, (void *)(intptr_t) count,
+            STARPU_R, handle, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__ ((visibility ("default")))
+void starneig_node_get_progress(struct starneig_progress *snapshot)
+{
+    take_snapshot(snapshot);
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_node_set_progress_callback(
+    starneig_progress_callback_t callback, double interval, void *arg)
+{
+    pthread_mutex_lock(&progress.mutex);
+    progress.interval = MAX(0.0, interval);
+    progress.arg = arg;
+    __atomic_store_n(&progress.callback, callback, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&progress.mutex);
+}
@@ -0,0 +1,122 @@
+///
+/// @file
+///
+/// @brief This file contains the progress reporting that is shared among all
+/// components of the library.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_PROGRESS_H
+#define STARNEIG_COMMON_PROGRESS_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "common.h"
+#include <starpu.h>
+
+///
+/// @brief Begins a phase (an interface function). The total number of
+/// progress units can be set later with starneig_progress_set_total().
+///
+/// @param[in] name
+///         The phase name (a string literal).
+///
+void starneig_progress_begin(char const *name);
+
+///
+/// @brief Sets the total number of progress units in the current phase.
+///
+/// @param[in] total
+///         The total number of progress units.
+///
+void starneig_progress_set_total(int total);
+
+///
+/// @brief Marks progress units completed. Can be called from a task callback.
+///
+/// @param[in] count
+///         The number of completed progress units.
+///
+void starneig_progress_add(int count);
+
+///
+/// @brief Sets the number of completed progress units.
+///
+/// @param[in] done
+///         The number of completed progress units.
+///
+void starneig_progress_set(int done);
+
+///
+/// @brief Ends the current phase and reports the final state.
+///
+void starneig_progress_end();
+
+///
+/// @brief Submits a task and adds its predicted execution time to the
+/// remaining work of the current phase until the task has finished.
+///
+///  The prediction is made with the performance model of the codelet. Tasks
+///  that are submitted outside a phase are not accounted.
+///
+/// @param[in,out] task
+///         A task that was built with starpu_task_build() or
+///         starpu_mpi_task_build(). May be NULL.
+///
+/// @return The return value of starpu_task_submit() or zero if the task is
+/// NULL.
+///
+int starneig_progress_submit(struct starpu_task *task);
+
+///
+/// @brief Inserts an empty task that marks progress units completed once all
+/// earlier tasks that modify the given data handle have finished.
+///
+///  In distributed memory, the owner of the data handle notifies all MPI
+///  ranks and every rank counts the progress units. All MPI ranks must make
+///  the same calls in the same order.
+///
+/// @param[in] count
+///         The number of progress units.
+///
+/// @param[in] handle
+///         The data handle.
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+void starneig_progress_insert_marker(
+    int count, starpu_data_handle_t handle, mpi_info_t mpi);
+
+#endif
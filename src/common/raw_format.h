@@ -0,0 +1,89 @@
+///
+/// @file
+///
+/// @brief This file contains the raw matrix file format definitions that are
+/// shared among all components of the library.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_RAW_FORMAT_H
+#define STARNEIG_COMMON_RAW_FORMAT_H
+
+#include <starneig/configuration.h>
+#include <starneig/error.h>
+#include <starneig/matrix_io.h>
+#include <stddef.h>
+
+///
+/// @brief Raw matrix file header format.
+///
+#define RAW_HEADER_FORMAT "STARNEIG RAW REAL DOUBLE M %d N %d\n"
+
+///
+/// @brief Maximum header length.
+///
+#define RAW_HEADER_MAX STARNEIG_MATRIX_HEADER_MAX
+
+///
+/// @brief Alignment of the first matrix element inside a raw matrix file.
+///
+///  The header is padded with spaces so that a memory mapped file can be used
+///  directly as a matrix buffer. Files with unpadded headers remain readable.
+///
+#define RAW_DATA_ALIGNMENT STARNEIG_MATRIX_ALIGNMENT
+
+///
+/// @brief Parses a raw matrix file header.
+///
+/// @param[in] buffer
+///         A buffer that contains the beginning of the file.
+///
+/// @param[in] length
+///         The length of the buffer.
+///
+/// @param[out] rows
+///         Returns the number of rows in the matrix.
+///
+/// @param[out] cols
+///         Returns the number of columns in the matrix.
+///
+/// @param[out] offset
+///         Returns the offset of the first matrix element.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+starneig_error_t starneig_raw_parse_header(
+    char const *buffer, size_t length, int *rows, int *cols, size_t *offset);
+
+#endif
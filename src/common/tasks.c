@@ -45,6 +45,9 @@
 #include "scratch.h"
 #include "math.h"
 #include "cpu.h"
+#include "multicast.h"
+#include "comm_stats.h"
+#include "dry_run.h"
 #ifdef STARNEIG_ENABLE_CUDA
 #include "cuda.h"
 #endif
@@ -304,7 +307,8 @@ static struct starpu_codelet set_to_identity_cl = {
 ///
 /// @brief scan_diagonal_cl codelet scans the diagonal of a matrix pencil (A,B)
 /// using a provided scanning function. The scanning function is expected
-/// to store the outcome of the scan to a mask vector.
+/// to store the outcome of the scan to a mask vector. The mask vectors are
+/// passed to the scanning function with their current contents.
 ///
 ///  Arguments:
 ///   - row offset for the first diagonal element
@@ -417,6 +421,33 @@ static struct starpu_codelet redux_matrix_cl =
 
 ////////////////////////////////////////////////////////////////////////////////
 
+///
+/// @brief probe_update codelet multiplies a block of probe vectors with a
+/// matrix tile.
+///
+///  Arguments:
+///   - non-zero if the matrix tile is transposed
+///   - scalar multiplier
+///
+///  Buffers:
+///   - matrix tile (STARPU_R)
+///   - probe vectors (STARPU_R)
+///   - accumulated product (STARPU_RW)
+///
+static struct starpu_codelet probe_update_cl = {
+    .name = "starneig_probe_update",
+    .cpu_funcs = { starneig_cpu_probe_update },
+    .cpu_funcs_name = { "starneig_cpu_probe_update" },
+    .nbuffers = 3,
+    .modes = { STARPU_R, STARPU_R, STARPU_RW },
+    .model = (struct starpu_perfmodel[]) {{
+        .type = STARPU_REGRESSION_BASED,
+        .symbol = "starneig_probe_update_pm",
+    }}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 void starneig_insert_left_gemm_update(
     int rbegin, int rend, int cbegin, int cend, int splice, int prio,
     starpu_data_handle_t lQ_h, starneig_matrix_t matrix, mpi_info_t mpi)
@@ -429,6 +460,10 @@ void starneig_insert_left_gemm_update(
     cbegin = MAX(0, cbegin);
     cend = MIN(STARNEIG_MATRIX_N(matrix), cend);
 
+    // multicast the local Q matrix to the involved MPI ranks
+    starneig_multicast_extend(
+        rbegin, rend, cbegin, cend, prio, lQ_h, matrix, mpi);
+
 #if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_PRUNING)
     int my_rank = starneig_mpi_get_comm_rank();
     int owner = 0;
@@ -503,8 +538,10 @@ void starneig_insert_left_gemm_update(
 
             struct packing_helper *helper = starneig_init_packing_helper();
 
-            // local Q matrix
-            starneig_pack_handle(STARPU_R, lQ_h, helper, 0);
+            // local Q matrix (replica that is owned by the executing rank)
+            starneig_pack_handle(STARPU_R, starneig_multicast_get_replica(
+                lQ_h, starneig_matrix_get_elem_owner(rbegin, begin, matrix)),
+                helper, 0);
 
             // scratch matrices
             starneig_pack_handle(STARPU_SCRATCH, scratch1_h, helper, 0);
@@ -522,8 +559,11 @@ void starneig_insert_left_gemm_update(
             double flops = 2.0*(end-begin)*(rend-rbegin)*(rend-rbegin);
 
 #ifdef STARNEIG_ENABLE_MPI
-            if (mpi != NULL)
-                starpu_mpi_task_insert(
+            if (mpi != NULL) {
+                starneig_comm_stats_task(
+                    starneig_matrix_get_elem_owner(rbegin, begin, matrix),
+                    helper->descrs, helper->count);
+                starneig_mpi_task_insert(
                     starneig_mpi_get_comm(),
                     &left_gemm_update_cl,
                     STARPU_EXECUTE_ON_NODE,
@@ -532,9 +572,10 @@ void starneig_insert_left_gemm_update(
                     STARPU_FLOPS, flops,
                     STARPU_VALUE, &packing_info, sizeof(packing_info),
                     STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+            }
             else
 #endif
-                starpu_task_insert(
+                starneig_task_insert(
                     &left_gemm_update_cl,
                     STARPU_PRIORITY, prio,
                     STARPU_FLOPS, flops,
@@ -567,6 +608,10 @@ void starneig_insert_right_gemm_update(
         splice = STARNEIG_MATRIX_SM(matrix);
     splice = MAX(bm, (splice/bm)*bm);
 
+    // multicast the local Q matrix to the involved MPI ranks
+    starneig_multicast_extend(
+        rbegin, rend, cbegin, cend, prio, lQ_h, matrix, mpi);
+
 #if defined(STARNEIG_ENABLE_MPI) && defined(STARNEIG_ENABLE_PRUNING)
     int my_rank = starneig_mpi_get_comm_rank();
     int owner = 0;
@@ -634,8 +679,10 @@ void starneig_insert_right_gemm_update(
 
             struct packing_helper *helper = starneig_init_packing_helper();
 
-            // local Q matrix
-            starneig_pack_handle(STARPU_R, lQ_h, helper, 0);
+            // local Q matrix (replica that is owned by the executing rank)
+            starneig_pack_handle(STARPU_R, starneig_multicast_get_replica(
+                lQ_h, starneig_matrix_get_elem_owner(begin, cbegin, matrix)),
+                helper, 0);
 
             // scratch matrices
             starneig_pack_handle(STARPU_SCRATCH, scratch1_h, helper, 0);
@@ -653,8 +700,11 @@ void starneig_insert_right_gemm_update(
             double flops = 2.0*(cend-cbegin)*(end-begin)*(cend-cbegin);
 
 #ifdef STARNEIG_ENABLE_MPI
-            if (mpi != NULL)
-                starpu_mpi_task_insert(
+            if (mpi != NULL) {
+                starneig_comm_stats_task(
+                    starneig_matrix_get_elem_owner(begin, cbegin, matrix),
+                    helper->descrs, helper->count);
+                starneig_mpi_task_insert(
                     starneig_mpi_get_comm(),
                     &right_gemm_update_cl,
                     STARPU_EXECUTE_ON_NODE,
@@ -663,9 +713,10 @@ void starneig_insert_right_gemm_update(
                     STARPU_FLOPS, flops,
                     STARPU_VALUE, &packing_info, sizeof(packing_info),
                     STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+            }
             else
 #endif
-                starpu_task_insert(
+                starneig_task_insert(
                     &right_gemm_update_cl,
                     STARPU_PRIORITY, prio,
                     STARPU_FLOPS, flops,
@@ -753,7 +804,7 @@ void insert_copy_matrix_reverse(
 
                 starneig_pack_handle(STARPU_W, handle, helper, 0);
 
-                starpu_task_insert(
+                starneig_task_insert(
                     &copy_matrix_to_handle_cl,
                     STARPU_PRIORITY, prio,
                     STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -764,9 +815,14 @@ void insert_copy_matrix_reverse(
             }
 
 #ifdef STARNEIG_ENABLE_MPI
-            if (mpi != NULL && (my_rank == source_rank || my_rank == dest_rank))
+            if (mpi != NULL &&
+            (my_rank == source_rank || my_rank == dest_rank)) {
+                starneig_comm_stats_task(dest_rank,
+                    (struct starpu_data_descr[]) {
+                        { .handle = handle, .mode = STARPU_R } }, 1);
                 starpu_mpi_get_data_on_node_detached(
                     starneig_mpi_get_comm(), handle, dest_rank, NULL, NULL);
+            }
 #endif
 
             //
@@ -784,7 +840,7 @@ void insert_copy_matrix_reverse(
                     __rbegin, __rend, __cbegin, __cend,
                     dest, helper, &packing_info, 0);
 
-                starpu_task_insert(
+                starneig_task_insert(
                     &copy_handle_to_matrix_cl,
                     STARPU_PRIORITY, prio,
                     STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -838,7 +894,7 @@ void starneig_insert_copy_matrix(
         // insert task
         //
 
-        starpu_task_insert(
+        starneig_task_insert(
             &copy_matrix_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info_source,
@@ -899,8 +955,10 @@ void starneig_insert_copy_matrix_to_handle(
     starneig_pack_handle(STARPU_W, dest, helper, 0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starpu_mpi_data_get_rank(dest), helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &copy_matrix_to_handle_cl,
             STARPU_EXECUTE_ON_NODE,
@@ -908,9 +966,10 @@ void starneig_insert_copy_matrix_to_handle(
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &copy_matrix_to_handle_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -933,8 +992,10 @@ void starneig_insert_copy_handle_to_matrix(
         STARPU_RW, rbegin, rend, cbegin, cend, dest, helper, &packing_info,0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starpu_mpi_data_get_rank(source), helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &copy_handle_to_matrix_cl,
             STARPU_EXECUTE_ON_NODE,
@@ -942,9 +1003,10 @@ void starneig_insert_copy_handle_to_matrix(
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &copy_handle_to_matrix_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -964,8 +1026,11 @@ void starneig_insert_set_to_identity(
         descr, helper, &packing_info, 0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(0, 0, descr),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &set_to_identity_cl,
             STARPU_EXECUTE_ON_NODE,
@@ -973,9 +1038,10 @@ void starneig_insert_set_to_identity(
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &set_to_identity_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -1073,8 +1139,11 @@ void starneig_insert_scan_diagonal(
         int __cbegin = MIN(left, _cbegin - begin);
 
 #ifdef STARNEIG_ENABLE_MPI
-        if (mpi != NULL)
-            starpu_mpi_task_insert(
+        if (mpi != NULL) {
+            starneig_comm_stats_task(
+                starneig_vector_get_tile_owner(i, first),
+                helper->descrs, helper->count);
+            starneig_mpi_task_insert(
                 starneig_mpi_get_comm(),
                 &scan_diagonal_cl,
                 STARPU_EXECUTE_ON_NODE,
@@ -1090,9 +1159,10 @@ void starneig_insert_scan_diagonal(
                 STARPU_VALUE, packing_info_mask,
                     num_masks*sizeof(packing_info_mask[0]),
                 STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+        }
         else
 #endif
-            starpu_task_insert(
+            starneig_task_insert(
                 &scan_diagonal_cl,
                 STARPU_PRIORITY, prio,
                 STARPU_VALUE, &num_masks, sizeof(num_masks),
@@ -1169,9 +1239,11 @@ void starneig_insert_extract_eigenvalues(
     starneig_vector_t real, starneig_vector_t imag,
     starneig_vector_t beta, mpi_info_t mpi)
 {
+    int phase = starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_EIGENVALUES);
     starneig_insert_scan_diagonal(
         0, STARNEIG_MATRIX_N(A), 0, 1, 1, 1, 1, prio,
         extract_eigenvalues_func, NULL, A, B, mpi, real, imag, beta, NULL);
+    starneig_comm_stats_set_phase(phase);
 }
 
 void starneig_insert_set_vector_to_zero(
@@ -1179,14 +1251,14 @@ void starneig_insert_set_vector_to_zero(
 {
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL)
-        starpu_mpi_task_insert(
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &set_vector_to_zero_cl,
             STARPU_EXECUTE_ON_DATA, tile,
             STARPU_PRIORITY, prio, STARPU_W, tile, 0);
     else
 #endif
-        starpu_task_insert(&set_vector_to_zero_cl,
+        starneig_task_insert(&set_vector_to_zero_cl,
             STARPU_PRIORITY, prio, STARPU_W, tile, 0);
 }
 
@@ -1195,7 +1267,7 @@ void starneig_insert_set_matrix_to_zero(
 {
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL)
-        starpu_mpi_task_insert(
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &set_matrix_to_zero_cl,
             STARPU_EXECUTE_ON_DATA, tile,
@@ -1203,12 +1275,43 @@ void starneig_insert_set_matrix_to_zero(
             STARPU_W, tile, 0);
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &set_matrix_to_zero_cl,
             STARPU_PRIORITY, prio,
             STARPU_W, tile, 0);
 }
 
+void starneig_insert_probe_update(
+    int trans, double alpha, int prio, starpu_data_handle_t A_h,
+    starpu_data_handle_t X_h, starpu_data_handle_t Y_h, mpi_info_t mpi)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        struct starpu_data_descr descrs[] = {
+            { .handle = A_h, .mode = STARPU_R },
+            { .handle = X_h, .mode = STARPU_R },
+            { .handle = Y_h, .mode = STARPU_RW }
+        };
+        starneig_comm_stats_task(starpu_mpi_data_get_rank(A_h), descrs, 3);
+        starneig_mpi_task_insert(
+            starneig_mpi_get_comm(),
+            &probe_update_cl,
+            STARPU_EXECUTE_ON_DATA, A_h,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &trans, sizeof(trans),
+            STARPU_VALUE, &alpha, sizeof(alpha),
+            STARPU_R, A_h, STARPU_R, X_h, STARPU_RW, Y_h, 0);
+    }
+    else
+#endif
+        starneig_task_insert(
+            &probe_update_cl,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &trans, sizeof(trans),
+            STARPU_VALUE, &alpha, sizeof(alpha),
+            STARPU_R, A_h, STARPU_R, X_h, STARPU_RW, Y_h, 0);
+}
+
 void starneig_set_vector_reduction(starpu_data_handle_t handle)
 {
     starpu_data_set_reduction_methods(
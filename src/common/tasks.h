@@ -271,7 +271,9 @@ void starneig_insert_set_to_identity(
 ///          - arg  7: (void const *) optional argument
 ///          - arg  8: (void const *) scanning window from the matrix A
 ///          - arg  9: (void const *) scanning window from the matrix B
-///          - arg 10: (void **) pointers to scanning mask vectors
+///          - arg 10: (void **) pointers to scanning mask vectors (the
+///            buffers hold the current contents of the mask vectors and are
+///            written back after the call)
 ///
 /// @param[in] arg
 ///         Optional argument for the scanning function.
@@ -357,6 +359,37 @@ void starneig_insert_set_vector_to_zero(
 void starneig_insert_set_matrix_to_zero(
     int prio, starpu_data_handle_t handle, mpi_info_t mpi);
 
+///
+/// @brief Inserts a probe_update task.
+///
+///  Computes Y <- Y + alpha * op(A) * X, where the probe vectors X and the
+///  product Y are stored row-wise.
+///
+/// @param[in] trans
+///         non-zero if op(A) = A^T
+///
+/// @param[in] alpha
+///         scalar multiplier
+///
+/// @param[in] prio
+///         StarPU priority
+///
+/// @param[in] A_h
+///         matrix tile
+///
+/// @param[in] X_h
+///         probe vectors
+///
+/// @param[in,out] Y_h
+///         accumulated product
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+void starneig_insert_probe_update(
+    int trans, double alpha, int prio, starpu_data_handle_t A_h,
+    starpu_data_handle_t X_h, starpu_data_handle_t Y_h, mpi_info_t mpi);
+
 ///
 /// @brief Sets vector data handle reduction method.
 ///
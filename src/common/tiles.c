@@ -153,12 +153,8 @@ static void pack_window_full(
     helper->count += k;
     info->handles = k;
 
-#ifdef STARNEIG_ENABLE_EVENTS
-    info->event_label = matrix->event_label;
-    info->event_enabled = matrix->event_enabled;
-    info->event_roffset = matrix->event_roffset;
-    info->event_coffset = matrix->event_coffset;
-#endif
+    starneig_matrix_get_event_info(matrix,
+        &info->event_label, &info->event_roffset, &info->event_coffset);
 }
 
 static void pack_window_upper_hess(
@@ -207,12 +203,8 @@ static void pack_window_upper_hess(
     helper->count += k;
     info->handles = k;
 
-#ifdef STARNEIG_ENABLE_EVENTS
-    info->event_label = matrix->event_label;
-    info->event_enabled = matrix->event_enabled;
-    info->event_roffset = matrix->event_roffset;
-    info->event_coffset = matrix->event_coffset;
-#endif
+    starneig_matrix_get_event_info(matrix,
+        &info->event_label, &info->event_roffset, &info->event_coffset);
 }
 
 static void pack_window_upper_triag(
@@ -261,12 +253,8 @@ static void pack_window_upper_triag(
     helper->count += k;
     info->handles = k;
 
-#ifdef STARNEIG_ENABLE_EVENTS
-    info->event_label = matrix->event_label;
-    info->event_enabled = matrix->event_enabled;
-    info->event_roffset = matrix->event_roffset;
-    info->event_coffset = matrix->event_coffset;
-#endif
+    starneig_matrix_get_event_info(matrix,
+        &info->event_label, &info->event_roffset, &info->event_coffset);
 }
 
 static void join_tiles_full(
@@ -36,137 +36,596 @@
 
 #include <starneig_config.h>
 #include <starneig/configuration.h>
+#include <starneig/node.h>
 #include "trace.h"
 #include "common.h"
-#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
+#include <time.h>
 #include <starpu.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <mpi.h>
+#include <starpu_mpi.h>
+#endif
+
+///
+/// @brief Default ring buffer size (events per worker).
+///
+#define DEFAULT_EVENTS 65536
+
+///
+/// @brief Data access ring buffer size relative to the event ring buffer size.
+///
+#define ACCESSES_PER_EVENT 4
 
-#define MAX_EVENTS 1000000
+///
+/// @brief Number of hash buckets in the data tag table.
+///
+#define TAG_BUCKETS 4096
 
+///
+/// @brief Trace event.
+///
 struct event {
-    char label;
-    float begin;
-    float end;
-    int rbegin;
-    int rend;
-    int cbegin;
-    int cend;
-    unsigned char color[3];
+    uint64_t begin;         ///< begin time in nanoseconds
+    uint64_t end;           ///< end time in nanoseconds
+    char const *name;       ///< codelet name
+    event_color color;      ///< event color
+    int rbegin;             ///< first row
+    int rend;               ///< last row + 1
+    int cbegin;             ///< first column
+    int cend;               ///< last column + 1
+    int prio;               ///< task priority
+    double flops;           ///< task flop count (0 if not known)
+    char label;             ///< matrix label
+    uint64_t first_access;  ///< first data access in the access ring buffer
+    int access_count;       ///< number of data accesses
+};
+
+///
+/// @brief Per-worker ring buffer.
+///
+///  Only the owning worker writes to the ring buffer. The head counter is
+///  published with release semantics once an event is complete and readers
+///  only look at events that precede the head counter. When the buffer is
+///  full, the oldest events are overwritten. The head counter therefore acts
+///  as a sequence number: a reader copies the events and then checks from the
+///  head counter that the writer did not reach the copied slots in the
+///  meantime.
+///
+///  The data accesses of the events are stored to a separate ring buffer. Each
+///  access is a data handle address whose two lowest bits hold the access mode.
+///  The writer reserves the accesses of an event (advances the access head
+///  counter) before writing them.
+///
+struct ring {
+    struct event *events;   ///< event buffer
+    uint64_t mask;          ///< buffer size - 1 (size is a power of two)
+    uint64_t head;          ///< total number of completed events
+    uintptr_t *accesses;    ///< data access buffer
+    uint64_t access_mask;   ///< access buffer size - 1
+    uint64_t access_head;   ///< total number of reserved data accesses
+    int generation;         ///< tracing session the buffer belongs to
+    int active;             ///< non-zero if an event is in progress
+    char name[64];          ///< worker name
+};
+
+static struct ring rings[STARPU_NMAXWORKERS];
+
+///
+/// @brief Data tag table entry. Maps a data handle to the StarPU-MPI tag it
+/// had when a task that accesses it was inserted.
+///
+///  StarPU reuses the memory of unregistered handles and an address can
+///  therefore map to several tags over time. The newest mapping is stored
+///  first.
+///
+struct data_tag {
+    uintptr_t handle;       ///< data handle address
+    int64_t tag;            ///< StarPU-MPI tag
+    uint64_t time;          ///< first insertion time in nanoseconds
+    struct data_tag *next;  ///< next entry in the same bucket
 };
 
-static struct event *events[STARPU_NMAXWORKERS];
-static int event_counts[STARPU_NMAXWORKERS];
-static int event_active[STARPU_NMAXWORKERS];
-static struct timespec event_base;
+static struct data_tag *data_tags[TAG_BUCKETS];
 
-const event_color starneig_event_blue = (unsigned char[]) { 0, 0, 128 };
-const event_color starneig_event_green = (unsigned char[]) { 0, 128, 0 };
-const event_color starneig_event_red = (unsigned char[]) { 128, 0, 0 };
+///
+/// @brief Phase (interface function call).
+///
+struct phase {
+    char const *name;       ///< phase name
+    uint64_t begin;         ///< begin time in nanoseconds
+    uint64_t end;           ///< end time in nanoseconds
+};
+
+static struct {
+    int enabled;            ///< non-zero if tracing is enabled
+    int generation;         ///< tracing session counter
+    uint64_t capacity;      ///< ring buffer size
+    uint64_t base;          ///< session start time in nanoseconds
+    uint64_t epoch;         ///< session start time since the Unix epoch
+    char *env_file;         ///< file name from STARNEIG_TRACE
+    struct phase *phases;   ///< phases
+    int phase_count;        ///< number of phases
+    int phase_capacity;     ///< capacity of the phase array
+    int phase_open;         ///< non-zero if the last phase is open
+} trace = {
+    .enabled = 0,
+    .generation = 0,
+    .capacity = DEFAULT_EVENTS,
+    .base = 0,
+    .epoch = 0,
+    .env_file = NULL,
+    .phases = NULL,
+    .phase_count = 0,
+    .phase_capacity = 0,
+    .phase_open = 0
+};
+
+const event_color starneig_event_blue = "rail_response";
+const event_color starneig_event_green = "good";
+const event_color starneig_event_red = "terrible";
 
-void starneig_event_init()
+///
+/// @brief Returns the value of the monotonic clock in nanoseconds.
+///
+static inline uint64_t get_time()
 {
-    for (int i = 0; i < STARPU_NMAXWORKERS; i++) {
-        free(events[i]);
-        events[i] = NULL;
-        event_counts[i] = 0;
-        event_active[i] = 0;
-    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
 
-    int worker_count = starpu_worker_get_count();
-    for (int i = 0; i < worker_count; i++)
-        events[i] = malloc(MAX_EVENTS*sizeof(struct event));
+///
+/// @brief Returns the value of the real-time clock in nanoseconds since the
+/// Unix epoch.
+///
+static uint64_t get_epoch_time()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
 
-    clock_gettime(CLOCK_REALTIME, &event_base);
+///
+/// @brief Returns the MPI rank of the calling process or 0 if MPI is not in
+/// use.
+///
+static int get_rank()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    int initialized, finalized;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (initialized && !finalized)
+        return starneig_mpi_get_comm_rank();
+#endif
+    return 0;
 }
 
-void starneig_event_free()
+///
+/// @brief Returns the number of MPI ranks or 1 if MPI is not in use.
+///
+static int get_world_size()
+{
+#ifdef STARNEIG_ENABLE_MPI
+    int initialized, finalized;
+    MPI_Initialized(&initialized);
+    MPI_Finalized(&finalized);
+    if (initialized && !finalized)
+        return starneig_mpi_get_comm_size();
+#endif
+    return 1;
+}
+
+///
+/// @brief Frees all ring buffers.
+///
+static void free_rings()
 {
     for (int i = 0; i < STARPU_NMAXWORKERS; i++) {
-        free(events[i]);
-        events[i] = NULL;
+        free(rings[i].events);
+        rings[i].events = NULL;
+        rings[i].head = 0;
+        free(rings[i].accesses);
+        rings[i].accesses = NULL;
+        rings[i].access_head = 0;
+        rings[i].generation = 0;
+        rings[i].active = 0;
+    }
+
+    for (int i = 0; i < TAG_BUCKETS; i++) {
+        while (data_tags[i] != NULL) {
+            struct data_tag *next = data_tags[i]->next;
+            free(data_tags[i]);
+            data_tags[i] = next;
+        }
     }
+
+    free(trace.phases);
+    trace.phases = NULL;
+    trace.phase_count = 0;
+    trace.phase_capacity = 0;
+    trace.phase_open = 0;
 }
 
 void starneig_event_begin(
     struct packing_info const *pi, const event_color color)
 {
-    if (!pi->event_enabled)
+    if (!__atomic_load_n(&trace.enabled, __ATOMIC_ACQUIRE))
         return;
 
     int worker_id = starpu_worker_get_id();
+    if (worker_id < 0)
+        return;
+
+    struct ring *ring = &rings[worker_id];
 
-    if (event_counts[worker_id] + 1 < MAX_EVENTS) {
-        struct event *event = &events[worker_id][event_counts[worker_id]];
+    // the ring buffer is (re)allocated by the worker itself when a new
+    // tracing session begins
+    int generation = __atomic_load_n(&trace.generation, __ATOMIC_ACQUIRE);
+    if (ring->generation != generation) {
+        free(ring->events);
+        ring->events = malloc(trace.capacity*sizeof(struct event));
+        ring->mask = trace.capacity - 1;
+        __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+        free(ring->accesses);
+        ring->accesses = malloc(
+            ACCESSES_PER_EVENT*trace.capacity*sizeof(uintptr_t));
+        ring->access_mask = ACCESSES_PER_EVENT*trace.capacity - 1;
+        __atomic_store_n(&ring->access_head, 0, __ATOMIC_RELEASE);
+        starpu_worker_get_name(worker_id, ring->name, sizeof(ring->name));
+        ring->generation = generation;
+    }
 
-        event->label = pi->event_label;
+    if (ring->events == NULL || ring->accesses == NULL)
+        return;
 
-        struct timespec start;
-        clock_gettime(CLOCK_REALTIME, &start);
-        event->begin =
-            (start.tv_sec-event_base.tv_sec) * 1E+3 +
-            (start.tv_nsec-event_base.tv_nsec) * 1E-6;
+    struct starpu_task *task = starpu_task_get_current();
 
-        event->rbegin = pi->event_roffset + pi->roffset;
-        event->rend = pi->event_roffset + pi->roffset + (pi->rend - pi->rbegin);
-        event->cbegin = pi->event_coffset + pi->coffset;
-        event->cend = pi->event_coffset + pi->coffset + (pi->cend - pi->cbegin);
-        memcpy(event->color, color, 3*sizeof(unsigned char));
+    // reserve the data accesses (scratch and reduction buffers are skipped)
+    int count = 0;
+    if (task != NULL && task->cl != NULL)
+        for (int i = 0; i < (int) STARPU_TASK_GET_NBUFFERS(task); i++)
+            if (STARPU_TASK_GET_MODE(task, i) & STARPU_RW)
+                count++;
+    count = MIN(count, (int) ring->access_mask + 1);
 
-        event_active[worker_id] = 1;
+    uint64_t first_access = ring->access_head;
+    __atomic_store_n(&ring->access_head, first_access+count, __ATOMIC_RELAXED);
+
+    // orders the head counter updates before the slots are overwritten (see
+    // starneig_node_store_trace)
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    struct event *event = &ring->events[ring->head & ring->mask];
+
+    event->first_access = first_access;
+    event->access_count = count;
+    for (int i = 0, j = 0; j < count; i++) {
+        enum starpu_data_access_mode mode =
+            STARPU_TASK_GET_MODE(task, i) & STARPU_RW;
+        if (mode)
+            ring->accesses[(first_access + j++) & ring->access_mask] =
+                (uintptr_t) STARPU_TASK_GET_HANDLE(task, i) | mode;
     }
+    if (task != NULL && task->cl != NULL && task->cl->name != NULL)
+        event->name = task->cl->name;
+    else
+        event->name = "unknown";
+    event->prio = task != NULL ? task->priority : 0;
+    event->flops = task != NULL ? task->flops : 0.0;
+
+    event->color = color;
+    event->label = pi->event_label;
+    event->rbegin = pi->event_roffset + pi->roffset;
+    event->rend = pi->event_roffset + pi->roffset + (pi->rend - pi->rbegin);
+    event->cbegin = pi->event_coffset + pi->coffset;
+    event->cend = pi->event_coffset + pi->coffset + (pi->cend - pi->cbegin);
+
+    ring->active = 1;
+    event->begin = get_time() - trace.base;
 }
 
 void starneig_event_end()
 {
     int worker_id = starpu_worker_get_id();
+    if (worker_id < 0)
+        return;
+
+    struct ring *ring = &rings[worker_id];
 
-    if (!event_active[worker_id])
+    if (!ring->active)
         return;
 
-    if (event_counts[worker_id]+1 < MAX_EVENTS) {
-        struct timespec start;
-        clock_gettime(CLOCK_REALTIME, &start);
-        events[worker_id][event_counts[worker_id]].end =
-            (start.tv_sec-event_base.tv_sec) * 1E+3 +
-            (start.tv_nsec-event_base.tv_nsec) * 1E-6;
-        event_counts[worker_id]++;
+    ring->events[ring->head & ring->mask].end = get_time() - trace.base;
+    __atomic_store_n(&ring->head, ring->head+1, __ATOMIC_RELEASE);
+
+    ring->active = 0;
+}
+
+void starneig_trace_data_tags(
+    struct starpu_data_descr const *descrs, int count)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (!trace.enabled)
+        return;
+
+    for (int i = 0; i < count; i++) {
+        uintptr_t handle = (uintptr_t) descrs[i].handle;
+        int64_t tag = starpu_mpi_data_get_tag(descrs[i].handle);
+
+        int bucket = (handle >> 4) % TAG_BUCKETS;
+        struct data_tag *iter = data_tags[bucket];
+        while (iter != NULL && iter->handle != handle)
+            iter = iter->next;
+
+        if (iter != NULL && iter->tag == tag)
+            continue;
+
+        struct data_tag *entry = malloc(sizeof(struct data_tag));
+        entry->handle = handle;
+        entry->tag = tag;
+        entry->time = get_time() - trace.base;
+        entry->next = data_tags[bucket];
+        data_tags[bucket] = entry;
+    }
+#endif
+}
+
+void starneig_trace_phase_begin(char const *name)
+{
+    if (!trace.enabled)
+        return;
+
+    if (trace.phase_count == trace.phase_capacity) {
+        trace.phase_capacity = MAX(16, 2*trace.phase_capacity);
+        trace.phases = realloc(
+            trace.phases, trace.phase_capacity*sizeof(struct phase));
     }
 
-    event_active[worker_id] = 0;
+    struct phase *phase = &trace.phases[trace.phase_count++];
+    phase->name = name;
+    phase->begin = get_time() - trace.base;
+    phase->end = phase->begin;
+    trace.phase_open = 1;
+}
+
+void starneig_trace_phase_end()
+{
+    if (!trace.phase_open)
+        return;
+
+    trace.phases[trace.phase_count-1].end = get_time() - trace.base;
+    trace.phase_open = 0;
 }
 
-void starneig_event_store(int n, char const *file_name)
+void starneig_trace_init_from_env()
 {
-    int worker_count = starpu_worker_get_count();
+    char const *file_name = getenv("STARNEIG_TRACE");
+    if (file_name == NULL || strlen(file_name) == 0)
+        return;
+
+    free(trace.env_file);
+    trace.env_file = strdup(file_name);
 
-    int total_events = 0;
-    for (int i = 0; i < worker_count; i++)
-        total_events += event_counts[i];
+    char const *events = getenv("STARNEIG_TRACE_EVENTS");
+    starneig_node_enable_tracing(
+        events != NULL ? atoi(events) : STARNEIG_TRACE_DEFAULT_EVENTS);
+
+    starneig_verbose("Tracing enabled (STARNEIG_TRACE=%s).", file_name);
+}
 
-    struct event *_events = malloc(total_events*sizeof(struct event));
+void starneig_trace_finalize_from_env()
+{
+    if (trace.env_file != NULL) {
+        if (1 < get_world_size()) {
+            char *file_name = malloc(strlen(trace.env_file)+16);
+            sprintf(file_name, "%s.%d", trace.env_file, get_rank());
+            starneig_node_store_trace(file_name);
+            free(file_name);
+        }
+        else {
+            starneig_node_store_trace(trace.env_file);
+        }
 
-    int _offset = 0;
-    for (int i = 0; i < worker_count; i++) {
-        memcpy(
-            _events+_offset, events[i], event_counts[i]*sizeof(struct event));
-        _offset += event_counts[i];
+        free(trace.env_file);
+        trace.env_file = NULL;
     }
 
-    float begin = 1.0/0.0, end = 0.0;
-    for (int i = 0; i < total_events; i++) {
-        begin = MIN(begin, _events[i].begin);
-        end = MAX(end, _events[i].end);
+    starneig_node_disable_tracing();
+    free_rings();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__ ((visibility ("default")))
+void starneig_node_enable_tracing(int events)
+{
+    uint64_t capacity = 1;
+    while (capacity < (uint64_t) (0 < events ? events : DEFAULT_EVENTS))
+        capacity *= 2;
+
+    trace.capacity = capacity;
+    trace.base = get_time();
+    trace.epoch = get_epoch_time();
+    trace.phase_count = 0;
+    trace.phase_open = 0;
+    __atomic_add_fetch(&trace.generation, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&trace.enabled, 1, __ATOMIC_RELEASE);
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_node_disable_tracing()
+{
+    __atomic_store_n(&trace.enabled, 0, __ATOMIC_RELEASE);
+}
+
+__attribute__ ((visibility ("default")))
+int starneig_node_store_trace(char const *file_name)
+{
+    FILE *file = fopen(file_name, "w");
+    if (file == NULL) {
+        starneig_warning("Failed to open the trace file %s.", file_name);
+        return -1;
+    }
+
+    int rank = get_rank();
+    int generation = __atomic_load_n(&trace.generation, __ATOMIC_ACQUIRE);
+    uint64_t dropped = 0;
+
+    struct event *copy = NULL;
+    uintptr_t *access_copy = NULL;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file,
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+        "\"args\":{\"name\":\"rank %d\"}}", rank, rank);
+
+    if (0 < trace.phase_count)
+        fprintf(file,
+            ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":-1,\"args\":{\"name\":\"phases\"}}", rank);
+
+    for (int i = 0; i < trace.phase_count; i++) {
+        struct phase const *phase = &trace.phases[i];
+        uint64_t duration = phase->end - phase->begin;
+        fprintf(file,
+            ",\n{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\","
+            "\"ts\":%" PRIu64 ".%03" PRIu64 ","
+            "\"dur\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":-1}",
+            phase->name, phase->begin / 1000, phase->begin % 1000,
+            duration / 1000, duration % 1000, rank);
     }
 
-    FILE *file = fopen(file_name, "wb");
+    for (int i = 0; i < STARPU_NMAXWORKERS; i++) {
+        struct ring const *ring = &rings[i];
+        if (ring->events == NULL || ring->generation != generation)
+            continue;
+
+        //
+        // snapshot the head counter, copy the events and discard the slots
+        // the worker has started to overwrite in the meantime
+        //
+
+        uint64_t capacity = ring->mask + 1;
+        uint64_t access_capacity = ring->access_mask + 1;
+        if (copy == NULL) {
+            copy = malloc(trace.capacity*sizeof(struct event));
+            access_copy = malloc(
+                ACCESSES_PER_EVENT*trace.capacity*sizeof(uintptr_t));
+        }
+
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t access_head =
+            __atomic_load_n(&ring->access_head, __ATOMIC_ACQUIRE);
+        uint64_t first = capacity <= head ? head - capacity : 0;
+        uint64_t first_access = access_capacity <= access_head ?
+            access_head - access_capacity : 0;
+
+        for (uint64_t j = first; j < head; j++)
+            copy[j & ring->mask] = ring->events[j & ring->mask];
+        for (uint64_t j = first_access; j < access_head; j++)
+            access_copy[j & ring->access_mask] =
+                ring->accesses[j & ring->access_mask];
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        // the worker may be writing to the slot of event head_now - capacity
+        uint64_t head_now = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        if (capacity <= head_now)
+            first = MAX(first, head_now - capacity + 1);
+
+        // the reserved accesses may overwrite any access that precedes
+        // access_head_now - access_capacity
+        uint64_t access_head_now =
+            __atomic_load_n(&ring->access_head, __ATOMIC_RELAXED);
+        if (access_capacity <= access_head_now)
+            first_access =
+                MAX(first_access, access_head_now - access_capacity);
+
+        dropped += first;
+
+        fprintf(file,
+            ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":%d,\"args\":{\"name\":\"%s\"}}", rank, i, ring->name);
+
+        for (uint64_t j = first; j < head; j++) {
+            struct event const *event = &copy[j & ring->mask];
+            uint64_t duration = event->end - event->begin;
+            fprintf(file,
+                ",\n{\"name\":\"%s\",\"cat\":\"%c\",\"ph\":\"X\","
+                "\"ts\":%" PRIu64 ".%03" PRIu64 ","
+                "\"dur\":%" PRIu64 ".%03" PRIu64 ","
+                "\"pid\":%d,\"tid\":%d,\"cname\":\"%s\","
+                "\"args\":{\"rows\":[%d,%d],\"cols\":[%d,%d],\"prio\":%d,"
+                "\"flops\":%.0f",
+                event->name, event->label,
+                event->begin / 1000, event->begin % 1000,
+                duration / 1000, duration % 1000,
+                rank, i, event->color,
+                event->rbegin, event->rend, event->cbegin, event->cend,
+                event->prio, event->flops);
+
+            // the data accesses are stored as "mode:address" pairs; they are
+            // left out if they have been overwritten
+            if (first_access <= event->first_access) {
+                fprintf(file, ",\"data\":\"");
+                for (int k = 0; k < event->access_count; k++) {
+                    uintptr_t access = access_copy[
+                        (event->first_access + k) & ring->access_mask];
+                    fprintf(file, "%s%s:%" PRIxPTR, 0 < k ? " " : "",
+                        (access & STARPU_RW) == STARPU_RW ? "RW" :
+                        (access & STARPU_W) ? "W" : "R",
+                        access & ~(uintptr_t) STARPU_RW);
+                }
+                fprintf(file, "\"");
+            }
+
+            fprintf(file, "}}");
+        }
+    }
+
+    //
+    // the StarPU-MPI tags identify the data handles across the ranks
+    //
+
+    for (int i = 0; i < TAG_BUCKETS; i++)
+        for (struct data_tag *iter = data_tags[i];
+        iter != NULL; iter = iter->next)
+            fprintf(file,
+                ",\n{\"name\":\"data_tag\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":0,\"args\":{\"handle\":\"%" PRIxPTR "\","
+                "\"tag\":%" PRId64 ",\"ts\":%" PRIu64 ".%03" PRIu64 "}}",
+                rank, iter->handle, iter->tag,
+                iter->time / 1000, iter->time % 1000);
+
+    fprintf(file,
+        "\n],\n\"displayTimeUnit\":\"ns\",\n"
+        "\"otherData\":{\"rank\":%d,\"dropped\":%" PRIu64
+        ",\"epoch\":%" PRIu64, rank, dropped, trace.epoch);
+
+    if (starneig_counters_recorded()) {
+        fprintf(file, ",\"counters\":");
+        starneig_counters_fprint_json(file);
+    }
+
+    fprintf(file, "}}\n");
 
-    fwrite(&n, sizeof(n), 1, file);
-    fwrite(&total_events, sizeof(total_events), 1, file);
-    fwrite(&begin, sizeof(begin), 1, file);
-    fwrite(&end, sizeof(end), 1, file);
-    fwrite(_events, sizeof(struct event), total_events, file);
     fclose(file);
+    free(copy);
+    free(access_copy);
+
+    if (0 < dropped)
+        starneig_warning(
+            "The trace ring buffers overflowed. %" PRIu64 " oldest events "
+            "were overwritten.", dropped);
 
-    free(_events);
+    return 0;
 }
@@ -39,15 +39,16 @@
 
 #include <starneig_config.h>
 #include <starneig/configuration.h>
-
-#ifdef STARNEIG_ENABLE_EVENTS
-
 #include "tiles.h"
+#include "matrix.h"
+#include "counters.h"
 
 ///
 /// @brief Data type for event color.
 ///
-typedef unsigned char * event_color;
+///  The color is stored to the trace as a Chrome trace event color name.
+///
+typedef char const * event_color;
 
 ///
 /// @brief Blue event color.
@@ -65,17 +66,10 @@ extern const event_color starneig_event_green;
 extern const event_color starneig_event_red;
 
 ///
-/// @brief Initialized event traces.
+/// @brief Begins an event. Does nothing if tracing is disabled.
 ///
-void starneig_event_init();
-
-///
-/// @brief Frees event traces.
-///
-void starneig_event_free();
-
-///
-/// @brief Begins an event.
+///  The event is recorded to the ring buffer of the calling worker. The name
+///  and the priority of the event are taken from the current task.
 ///
 /// @param[in] pi
 ///         The packing info that defines the windows.
@@ -92,55 +86,70 @@ void starneig_event_begin(
 void starneig_event_end();
 
 ///
-/// @brief Stores the trace into a file.
+/// @brief Records the StarPU-MPI tags of the data handles of a task that is
+/// about to be inserted with starpu_mpi_task_insert(). Does nothing if tracing
+/// is disabled. Called from the main thread.
+///
+///  The tags are stored to the trace and they allow the trace analyzer to
+///  connect the data accesses of different ranks.
+///
+/// @param[in] descrs
+///         The data handles and access modes of the task.
+///
+/// @param[in] count
+///         The number of data handles.
+///
+void starneig_trace_data_tags(
+    struct starpu_data_descr const *descrs, int count);
+
+///
+/// @brief Begins a phase (an interface function). Does nothing if tracing is
+/// disabled. Called from the main thread.
+///
+/// @param[in] name
+///         The phase name (a string literal).
 ///
-/// @param[in] n
-///         The matrix dimension.
+void starneig_trace_phase_begin(char const *name);
+
 ///
-/// @param[in] file_name
-///         The file name.
+/// @brief Ends the phase that was began last.
 ///
-void starneig_event_store(int n, char const *file_name);
+void starneig_trace_phase_end();
+
+///
+/// @brief Enables tracing if the STARNEIG_TRACE environmental variable is set.
+/// Called when the node is initialized.
+///
+void starneig_trace_init_from_env();
+
+///
+/// @brief Stores the trace to the file named by the STARNEIG_TRACE
+/// environmental variable and disables tracing. Called when the node is
+/// finalized.
+///
+void starneig_trace_finalize_from_env();
 
-#define STARNEIG_EVENT_INIT() \
-    starneig_event_init()
-#define STARNEIG_EVENT_FREE() \
-    starneig_event_free()
 #define STARNEIG_EVENT_BEGIN(pi, color) \
-    starneig_event_begin(pi, color)
+do { \
+    starneig_event_begin(pi, color); \
+    starneig_counters_begin(pi); \
+} while (0)
 #define STARNEIG_EVENT_END() \
-    starneig_event_end()
-#define STARNEIG_EVENT_STORE(n, filename) \
-    starneig_event_store(n, filename)
+do { \
+    starneig_counters_end(); \
+    starneig_event_end(); \
+} while (0)
 #define STARNEIG_EVENT_SET_LABEL(matrix, label) \
 if (matrix != NULL) { \
-    matrix->event_enabled = 1; \
-    matrix->event_label = label; \
+    starneig_matrix_set_event_label(label, matrix); \
 }
 #define STARNEIG_EVENT_INHERIT(matrix, source) \
 if (matrix != NULL && source != NULL) { \
-    matrix->event_enabled = source->event_enabled; \
-    matrix->event_label = source->event_label; \
-    matrix->event_roffset = source->event_roffset; \
-    matrix->event_coffset = source->event_coffset; \
+    starneig_matrix_inherit_event_info(source, matrix); \
 }
 #define STARNEIG_EVENT_ADD_OFFSET(matrix, roffset, coffset) \
 if (matrix != NULL) { \
-    matrix->event_roffset += roffset; \
-    matrix->event_coffset += coffset; \
+    starneig_matrix_add_event_offset(roffset, coffset, matrix); \
 }
 
-#else
-
-#define STARNEIG_EVENT_INIT() {}
-#define STARNEIG_EVENT_FREE() {}
-#define STARNEIG_EVENT_BEGIN(pi, color)  {}
-#define STARNEIG_EVENT_END() {}
-#define STARNEIG_EVENT_STORE(n, filename) {}
-#define STARNEIG_EVENT_SET_LABEL(matrix, label) {}
-#define STARNEIG_EVENT_INHERIT(matrix, source) {}
-#define STARNEIG_EVENT_ADD_OFFSET(matrix, roffset, coffset) {}
-
-#endif
-
 #endif
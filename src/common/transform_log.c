@@ -0,0 +1,394 @@
+///
+/// @file
+///
+/// @brief This file contains a log that defers the application of local
+/// transformation matrices to the Schur vectors.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "transform_log.h"
+#include "cpu.h"
+#include "tasks.h"
+#include "multicast.h"
+#include "comm_stats.h"
+#include "dry_run.h"
+#include "scratch.h"
+#include <stdlib.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <starpu_mpi.h>
+#endif
+
+///
+/// @brief embed_transform codelet embeds a local transformation matrix into
+/// a larger identity matrix.
+///
+///  Arguments:
+///   - negative integer
+///   - offset of the local transformation matrix
+///
+///  Buffers:
+///   - local transformation matrix (STARPU_R)
+///   - combined matrix (STARPU_W)
+///   - scratch matrix (STARPU_SCRATCH; at least combined matrix rows/columns)
+///
+static struct starpu_codelet embed_transform_cl = {
+    .name = "starneig_embed_transform",
+    .cpu_funcs = { starneig_cpu_combine_transforms },
+    .cpu_funcs_name = { "starneig_cpu_combine_transforms" },
+    .nbuffers = 3,
+    .modes = { STARPU_R, STARPU_W, STARPU_SCRATCH }
+};
+
+///
+/// @brief combine_transforms codelet multiplies two local transformation
+/// matrices together after embedding them into a larger identity matrix.
+///
+///  Arguments:
+///   - offset of the first local transformation matrix
+///   - offset of the second local transformation matrix
+///
+///  Buffers:
+///   - first local transformation matrix (STARPU_R)
+///   - second local transformation matrix (STARPU_R)
+///   - combined matrix (STARPU_W)
+///   - scratch matrix (STARPU_SCRATCH; at least combined matrix rows/columns)
+///
+static struct starpu_codelet combine_transforms_cl = {
+    .name = "starneig_combine_transforms",
+    .cpu_funcs = { starneig_cpu_combine_transforms },
+    .cpu_funcs_name = { "starneig_cpu_combine_transforms" },
+    .nbuffers = 4,
+    .modes = { STARPU_R, STARPU_R, STARPU_W, STARPU_SCRATCH }
+};
+
+///
+/// @brief Transformation log entry.
+///
+struct transform_block {
+    int begin;                   ///< first column the entry acts on
+    int end;                     ///< last column the entry acts on + 1
+    starpu_data_handle_t handle; ///< (combined) transformation matrix
+};
+
+struct transform_log {
+    int height;                      ///< height of a single update task
+    int prio;                        ///< StarPU priority
+    int max_size;                    ///< largest combined column range
+    size_t stored;                   ///< number of stored matrix elements
+    size_t limit;                    ///< flush limit for stored elements
+    int count;                       ///< number of entries
+    int capacity;                    ///< capacity of the entry array
+    struct transform_block *blocks;  ///< entries in application order
+    starneig_matrix_t matrix;        ///< target matrix
+    mpi_info_t mpi;                  ///< MPI info
+};
+
+///
+/// @brief Inserts a task that forms the product of two embedded local
+/// transformation matrices.
+///
+/// @param[in] begin
+///         first column the product acts on
+///
+/// @param[in] end
+///         last column the product acts on + 1
+///
+/// @param[in] p_begin
+///         first column the first matrix acts on
+///
+/// @param[in] p_h
+///         first matrix, NULL if the product consists of the second matrix
+///         only
+///
+/// @param[in] t_begin
+///         first column the second matrix acts on
+///
+/// @param[in] t_h
+///         second matrix
+///
+/// @param[in] prio
+///         StarPU priority
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+/// @return product, owned by the owner of the second matrix
+///
+static starpu_data_handle_t insert_combine(
+    int begin, int end, int p_begin, starpu_data_handle_t p_h,
+    int t_begin, starpu_data_handle_t t_h, int prio, mpi_info_t mpi)
+{
+    int size = end - begin;
+    int offset_p = p_h != NULL ? p_begin - begin : -1;
+    int offset_t = t_begin - begin;
+
+    starpu_data_handle_t handle;
+    starpu_matrix_data_register(
+        &handle, -1, 0, size, size, size, sizeof(double));
+
+    starpu_data_handle_t scratch_h =
+        starneig_scratch_get_matrix(size, size, sizeof(double));
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        int owner = starpu_mpi_data_get_rank(t_h);
+        starpu_mpi_data_register_comm(
+            handle, mpi->tag_offset++, owner, starneig_mpi_get_comm());
+
+        if (p_h != NULL) {
+            starneig_comm_stats_task(owner, (struct starpu_data_descr[]) {
+                { .handle = p_h, .mode = STARPU_R },
+                { .handle = t_h, .mode = STARPU_R },
+                { .handle = handle, .mode = STARPU_W } }, 3);
+            starneig_mpi_task_insert(
+                starneig_mpi_get_comm(), &combine_transforms_cl,
+                STARPU_PRIORITY, prio,
+                STARPU_VALUE, &offset_p, sizeof(offset_p),
+                STARPU_VALUE, &offset_t, sizeof(offset_t),
+                STARPU_R, p_h, STARPU_R, t_h, STARPU_W, handle,
+                STARPU_SCRATCH, scratch_h, 0);
+        }
+        else {
+            starneig_comm_stats_task(owner, (struct starpu_data_descr[]) {
+                { .handle = t_h, .mode = STARPU_R },
+                { .handle = handle, .mode = STARPU_W } }, 2);
+            starneig_mpi_task_insert(
+                starneig_mpi_get_comm(), &embed_transform_cl,
+                STARPU_PRIORITY, prio,
+                STARPU_VALUE, &offset_p, sizeof(offset_p),
+                STARPU_VALUE, &offset_t, sizeof(offset_t),
+                STARPU_R, t_h, STARPU_W, handle,
+                STARPU_SCRATCH, scratch_h, 0);
+        }
+
+        starneig_scratch_flush();
+        return handle;
+    }
+#endif
+
+    if (p_h != NULL)
+        starneig_task_insert(
+            &combine_transforms_cl,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &offset_p, sizeof(offset_p),
+            STARPU_VALUE, &offset_t, sizeof(offset_t),
+            STARPU_R, p_h, STARPU_R, t_h, STARPU_W, handle,
+            STARPU_SCRATCH, scratch_h, 0);
+    else
+        starneig_task_insert(
+            &embed_transform_cl,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &offset_p, sizeof(offset_p),
+            STARPU_VALUE, &offset_t, sizeof(offset_t),
+            STARPU_R, t_h, STARPU_W, handle,
+            STARPU_SCRATCH, scratch_h, 0);
+
+    starneig_scratch_flush();
+    return handle;
+}
+
+///
+/// @brief Checks whether two column ranges overlap.
+///
+static inline int overlaps(
+    struct transform_block const *block, int begin, int end)
+{
+    return begin < block->end && block->begin < end;
+}
+
+///
+/// @brief Replaces a log entry with the product of itself and a transformation
+/// matrix that acts on an overlapping column range.
+///
+static void merge_into(
+    int begin, int end, starpu_data_handle_t handle,
+    struct transform_block *block, struct transform_log *log)
+{
+    int hull_begin = MIN(begin, block->begin);
+    int hull_end = MAX(end, block->end);
+
+    starpu_data_handle_t combined = insert_combine(
+        hull_begin, hull_end, block->begin, block->handle, begin, handle,
+        log->prio, log->mpi);
+
+    starneig_multicast_unregister_submit(block->handle);
+
+    size_t old_size = block->end - block->begin;
+    size_t new_size = hull_end - hull_begin;
+    log->stored += new_size*new_size - old_size*old_size;
+
+    block->begin = hull_begin;
+    block->end = hull_end;
+    block->handle = combined;
+}
+
+///
+/// @brief Combines neighbouring log entries pairwise until no pair can be
+/// combined without exceeding the column range limit.
+///
+///  Each round combines disjoint pairs of neighbouring entries and the
+///  products therefore form a binary tree.
+///
+static void combine_pairwise(struct transform_log *log)
+{
+    int merged;
+    do {
+        merged = 0;
+        int count = 0;
+        int i = 0;
+        while (i < log->count) {
+            struct transform_block *left = &log->blocks[i];
+            struct transform_block *right = &log->blocks[i+1];
+
+            if (i+1 < log->count && overlaps(left, right->begin, right->end) &&
+            MAX(left->end, right->end) - MIN(left->begin, right->begin) <=
+            log->max_size) {
+                size_t size = right->end - right->begin;
+                merge_into(right->begin, right->end, right->handle, left, log);
+                starneig_multicast_unregister_submit(right->handle);
+                log->stored -= size*size;
+                merged = 1;
+                i += 2;
+            }
+            else {
+                i++;
+            }
+
+            log->blocks[count++] = *left;
+        }
+        log->count = count;
+    } while (merged);
+}
+
+struct transform_log * starneig_transform_log_init(
+    int height, int prio, int max_size, starneig_matrix_t matrix,
+    mpi_info_t mpi)
+{
+    struct transform_log *log = malloc(sizeof(struct transform_log));
+
+    size_t m = STARNEIG_MATRIX_M(matrix);
+    size_t n = STARNEIG_MATRIX_N(matrix);
+
+    log->height = height;
+    log->prio = prio;
+    log->max_size = max_size;
+    log->stored = 0;
+    log->limit = MAX(m*n, 4*(size_t)max_size*max_size);
+    log->count = 0;
+    log->capacity = 0;
+    log->blocks = NULL;
+    log->matrix = matrix;
+    log->mpi = mpi;
+
+    return log;
+}
+
+void starneig_transform_log_record(
+    int begin, int end, starpu_data_handle_t lX_h, struct transform_log *log)
+{
+    if (log == NULL || lX_h == NULL || end - begin < 1)
+        return;
+
+    // locate the most recent entry that does not commute with the new
+    // transformation matrix
+    int i = log->count-1;
+    while (0 <= i && !overlaps(&log->blocks[i], begin, end))
+        i--;
+
+    if (0 <= i && MAX(end, log->blocks[i].end) -
+    MIN(begin, log->blocks[i].begin) <= log->max_size) {
+        merge_into(begin, end, lX_h, &log->blocks[i], log);
+    }
+    else {
+        if (log->count == log->capacity) {
+            log->capacity = MAX(16, 2*log->capacity);
+            log->blocks = realloc(
+                log->blocks, log->capacity*sizeof(struct transform_block));
+        }
+
+        struct transform_block *block = &log->blocks[log->count++];
+        block->begin = begin;
+        block->end = end;
+        block->handle = insert_combine(
+            begin, end, 0, NULL, begin, lX_h, log->prio, log->mpi);
+
+        log->stored += (size_t)(end-begin)*(end-begin);
+    }
+
+    if (log->limit < log->stored)
+        starneig_transform_log_flush(log);
+}
+
+void starneig_transform_log_apply(
+    int height, int prio, starneig_matrix_t matrix, struct transform_log *log)
+{
+    if (log == NULL || matrix == NULL)
+        return;
+
+    combine_pairwise(log);
+
+    for (int i = 0; i < log->count; i++)
+        starneig_insert_right_gemm_update(
+            0, STARNEIG_MATRIX_M(matrix),
+            log->blocks[i].begin, log->blocks[i].end, height, prio,
+            log->blocks[i].handle, matrix, log->mpi);
+}
+
+void starneig_transform_log_flush(struct transform_log *log)
+{
+    if (log == NULL)
+        return;
+
+    starneig_transform_log_apply(log->height, log->prio, log->matrix, log);
+
+    for (int i = 0; i < log->count; i++)
+        starneig_multicast_unregister_submit(log->blocks[i].handle);
+
+    log->count = 0;
+    log->stored = 0;
+}
+
+void starneig_transform_log_free(struct transform_log *log)
+{
+    if (log == NULL)
+        return;
+
+    starneig_transform_log_flush(log);
+
+    free(log->blocks);
+    free(log);
+}
@@ -0,0 +1,146 @@
+///
+/// @file
+///
+/// @brief This file contains a log that defers the application of local
+/// transformation matrices to the Schur vectors.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_TRANSFORM_LOG_H
+#define STARNEIG_COMMON_TRANSFORM_LOG_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "common.h"
+#include "matrix.h"
+#include <starpu.h>
+
+///
+/// @brief Transformation log.
+///
+///  The log stores a sequence of local transformation matrices, each of which
+///  acts on a contiguous range of columns. A new transformation matrix is
+///  combined with the most recent overlapping entry as long as the combined
+///  column range does not grow too large. Entries with disjoint column ranges
+///  commute and are therefore skipped over. The log is flushed to a target
+///  matrix when its size exceeds a given limit and when it is freed.
+///
+struct transform_log;
+
+///
+/// @brief Creates an empty transformation log.
+///
+/// @param[in] height
+///         height of a single update task
+///
+/// @param[in] prio
+///         StarPU priority for the combine and update tasks
+///
+/// @param[in] max_size
+///         largest column range that may be formed by combining entries
+///
+/// @param[in,out] matrix
+///         matrix descriptor for the target matrix
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+/// @return transformation log
+///
+struct transform_log * starneig_transform_log_init(
+    int height, int prio, int max_size, starneig_matrix_t matrix,
+    mpi_info_t mpi);
+
+///
+/// @brief Records a local transformation matrix.
+///
+///  The log makes its own copy of the local transformation matrix and the data
+///  handle can therefore be unregistered right after this function returns.
+///
+/// @param[in] begin
+///         first column the local transformation matrix acts on
+///
+/// @param[in] end
+///         last column the local transformation matrix acts on + 1
+///
+/// @param[in] lX_h
+///         local transformation matrix
+///
+/// @param[in,out] log
+///         transformation log
+///
+void starneig_transform_log_record(
+    int begin, int end, starpu_data_handle_t lX_h, struct transform_log *log);
+
+///
+/// @brief Applies the recorded transformations to a matrix from the right.
+///
+///  The log is left intact and the function can be used to apply the
+///  transformations to any matrix that has as many columns as the target
+///  matrix. The log lives only inside the Schur engine; the function is not
+///  part of the public interface.
+///
+/// @param[in] height
+///         height of a single update task
+///
+/// @param[in] prio
+///         StarPU priority
+///
+/// @param[in,out] matrix
+///         matrix descriptor (must have as many columns as the target matrix)
+///
+/// @param[in,out] log
+///         transformation log
+///
+void starneig_transform_log_apply(
+    int height, int prio, starneig_matrix_t matrix, struct transform_log *log);
+
+///
+/// @brief Applies the recorded transformations to the target matrix and
+/// empties the log.
+///
+/// @param[in,out] log
+///         transformation log
+///
+void starneig_transform_log_flush(struct transform_log *log);
+
+///
+/// @brief Flushes and frees a transformation log.
+///
+/// @param[in,out] log
+///         transformation log
+///
+void starneig_transform_log_free(struct transform_log *log);
+
+#endif
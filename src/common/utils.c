@@ -183,3 +183,113 @@ void * starneig_acquire_vector_descr(starneig_vector_t descr)
 
     return ret;
 }
+
+static void select_eigenvalues_func(
+    int size, int rbegin, int cbegin, int m, int n, int ldA, int ldB,
+    void const *arg, void const *_A, void const *_B, void **masks)
+{
+    struct starneig_select_predicate const *predicate = arg;
+
+    double const *A = _A;
+    int *selected = masks[0];
+    double const *real = masks[1];
+    double const *imag = masks[2];
+    double const *beta = masks[3];
+
+    int i = 0;
+
+    // a 2-by-2 block that begins from the previous tile is evaluated there
+    if (0 < rbegin && 0 < cbegin && A[(cbegin-1)*ldA+rbegin] != 0.0)
+        selected[i++] = STARNEIG_SELECT_CARRY;
+
+    if (size <= i)
+        return;
+
+    //
+    // compact the eigenvalues so that each diagonal block contributes one
+    // eigenvalue
+    //
+
+    double *_real = malloc((size_t)size*sizeof(double));
+    double *_imag = malloc((size_t)size*sizeof(double));
+    double *_beta = beta ? malloc((size_t)size*sizeof(double)) : NULL;
+    int *_selected = malloc((size_t)size*sizeof(int));
+    int *_begin = malloc((size_t)size*sizeof(int));
+
+    int count = 0;
+    while (i < size) {
+        int _i = rbegin+i;
+        int _j = cbegin+i;
+
+        _real[count] = real[i];
+        _imag[count] = imag[i];
+        if (_beta)
+            _beta[count] = beta[i];
+        _begin[count++] = i;
+
+        if (_i+1 < m && A[_j*ldA+_i+1] != 0.0)
+            i += 2;
+        else
+            i++;
+    }
+
+    if (predicate->gep != NULL)
+        predicate->gep(
+            count, _real, _imag, _beta, _selected, predicate->arg);
+    else
+        predicate->sep(count, _real, _imag, _selected, predicate->arg);
+
+    //
+    // scatter the selections back to the diagonal entries
+    //
+
+    for (int k = 0; k < count; k++) {
+        int end = k+1 < count ? _begin[k+1] : size;
+        for (int j = _begin[k]; j < end; j++)
+            selected[j] = _selected[k] ? 1 : 0;
+    }
+
+    free(_real);
+    free(_imag);
+    free(_beta);
+    free(_selected);
+    free(_begin);
+}
+
+void starneig_select_eigenvalues(
+    int prio, struct starneig_select_predicate const *predicate,
+    starneig_matrix_t A, starneig_matrix_t B, starneig_vector_t selected,
+    mpi_info_t mpi)
+{
+    starneig_vector_t real = starneig_init_matching_vector_descr(
+        A, sizeof(double), NULL, mpi);
+    starneig_vector_t imag = starneig_init_matching_vector_descr(
+        A, sizeof(double), NULL, mpi);
+    starneig_vector_t beta = NULL;
+    if (B != NULL)
+        beta = starneig_init_matching_vector_descr(
+            A, sizeof(double), NULL, mpi);
+
+    starneig_insert_extract_eigenvalues(prio, A, B, real, imag, beta, mpi);
+
+    starneig_insert_scan_diagonal(
+        0, STARNEIG_MATRIX_N(A), 0, 1, 1, 1, 1, prio,
+        select_eigenvalues_func, predicate, A, B, mpi,
+        selected, real, imag, beta, NULL);
+
+    starneig_vector_free(real);
+    starneig_vector_free(imag);
+    starneig_vector_free(beta);
+}
+
+int starneig_select_eigenvalues_finalize(int n, int selected[])
+{
+    int num_selected = 0;
+    for (int i = 0; i < n; i++) {
+        if (selected[i] == STARNEIG_SELECT_CARRY)
+            selected[i] = 0 < i ? selected[i-1] : 0;
+        if (selected[i])
+            num_selected++;
+    }
+    return num_selected;
+}
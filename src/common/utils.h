@@ -105,4 +105,60 @@ starneig_vector_t starneig_extract_subdiagonals(
 ///
 void * starneig_acquire_vector_descr(starneig_vector_t descr);
 
+///
+/// @brief Selection array entry that is copied from the previous entry by
+/// starneig_select_eigenvalues_finalize().
+///
+#define STARNEIG_SELECT_CARRY -1
+
+///
+/// @brief Batched eigenvalue selection predicate.
+///
+struct starneig_select_predicate {
+    /// standard case predicate (NULL in the generalized case)
+    void (*sep)(int count, double const real[], double const imag[],
+        int selected[], void *arg);
+    /// generalized case predicate (NULL in the standard case)
+    void (*gep)(int count, double const real[], double const imag[],
+        double const beta[], int selected[], void *arg);
+    /// optional predicate argument
+    void *arg;
+};
+
+///
+/// @brief Inserts tasks that evaluate a batched predicate for the eigenvalues
+/// of a (generalized) Schur form.
+///
+///  The eigenvalues are first extracted with
+///  starneig_insert_extract_eigenvalues(). Each diagonal tile then calls the
+///  predicate once with one eigenvalue per diagonal block. For complex
+///  conjugate pairs, the predicate gets the eigenvalue with positive imaginary
+///  part and both diagonal entries receive the same selection. A 2-by-2 block
+///  that crosses a tile boundary is evaluated only by the tile that contains
+///  its first row; the second row is set to @ref STARNEIG_SELECT_CARRY and
+///  must be resolved with starneig_select_eigenvalues_finalize().
+///
+/// @param[in] prio - StarPU priority
+/// @param[in] predicate - predicate; must remain valid until the tasks finish
+/// @param[in] A - Schur matrix descriptor
+/// @param[in] B - upper triangular matrix descriptor or NULL
+/// @param[out] selected - matching selection vector descriptor
+/// @param[in,out] mpi  MPI info
+///
+void starneig_select_eigenvalues(
+    int prio, struct starneig_select_predicate const *predicate,
+    starneig_matrix_t A, starneig_matrix_t B, starneig_vector_t selected,
+    mpi_info_t mpi);
+
+///
+/// @brief Resolves the @ref STARNEIG_SELECT_CARRY entries of a selection array
+/// that was computed by starneig_select_eigenvalues().
+///
+/// @param[in] n - selection array length
+/// @param[in,out] selected - selection array
+///
+/// @return number of selected eigenvalues
+///
+int starneig_select_eigenvalues_finalize(int n, int selected[]);
+
 #endif
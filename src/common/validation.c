@@ -0,0 +1,187 @@
+///
+/// @file
+///
+/// @brief This file contains randomized estimators that validate computed
+/// factorizations.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "validation.h"
+#include "common.h"
+#include "tasks.h"
+#include "utils.h"
+#include "vector.h"
+#include <math.h>
+#include <stdint.h>
+
+///
+/// @brief Returns a random sign for a given probe vector element.
+///
+///  The sign depends only on the row and the probe vector index. Every MPI
+///  rank can therefore generate the same probe vectors independently.
+///
+/// @param[in] row
+///         row index
+///
+/// @param[in] probe
+///         probe vector index
+///
+/// @return -1.0 or 1.0
+///
+static double random_sign(int row, int probe)
+{
+    // splitmix64 finalizer
+    uint64_t z = ((uint64_t) row << 32 | (uint64_t) probe) +
+        0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+    return (z >> 63) ? 1.0 : -1.0;
+}
+
+///
+/// @brief Inserts tasks that compute Y <- Y + op(A) X.
+///
+/// @param[in] trans
+///         non-zero if op(A) = A^T
+///
+/// @param[in] A
+///         matrix descriptor
+///
+/// @param[in] X
+///         probe vectors
+///
+/// @param[in,out] Y
+///         product
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+static void insert_product(
+    int trans, starneig_matrix_t A, starneig_vector_t X, starneig_vector_t Y,
+    mpi_info_t mpi)
+{
+    int tm = divceil(STARNEIG_MATRIX_M(A), STARNEIG_MATRIX_BM(A));
+    int tn = divceil(STARNEIG_MATRIX_N(A), STARNEIG_MATRIX_BN(A));
+
+    // each tile row (column) of the product forms an independent task chain
+    if (trans) {
+        for (int j = 0; j < tn; j++)
+            for (int i = 0; i < tm; i++)
+                starneig_insert_probe_update(1, 1.0, STARPU_DEFAULT_PRIO,
+                    starneig_matrix_get_tile(i, j, A),
+                    starneig_vector_get_tile(i, X),
+                    starneig_vector_get_tile(j, Y), mpi);
+    }
+    else {
+        for (int i = 0; i < tm; i++)
+            for (int j = 0; j < tn; j++)
+                starneig_insert_probe_update(0, 1.0, STARPU_DEFAULT_PRIO,
+                    starneig_matrix_get_tile(i, j, A),
+                    starneig_vector_get_tile(j, X),
+                    starneig_vector_get_tile(i, Y), mpi);
+    }
+}
+
+void starneig_validate_factorization(
+    int probes, starneig_matrix_t A, starneig_matrix_t Q, starneig_matrix_t S,
+    mpi_info_t mpi, double *residual, double *orthogonality)
+{
+    int n = STARNEIG_MATRIX_M(A);
+    size_t elemsize = probes*sizeof(double);
+
+    double *X = malloc(n*elemsize);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < probes; j++)
+            X[(size_t)i*probes+j] = random_sign(i, j);
+
+    starneig_vector_t X_d =
+        starneig_init_matching_vector_descr(A, elemsize, X, mpi);
+
+    starneig_vector_t AX_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+    starneig_vector_t W_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+    starneig_vector_t V_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+    starneig_vector_t U_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+    starneig_vector_t QX_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+    starneig_vector_t O_d =
+        starneig_init_matching_vector_descr(A, elemsize, NULL, mpi);
+
+    // A X and Q S Q^T X
+    insert_product(0, A, X_d, AX_d, mpi);
+    insert_product(1, Q, X_d, W_d, mpi);
+    insert_product(0, S, W_d, V_d, mpi);
+    insert_product(0, Q, V_d, U_d, mpi);
+
+    // Q^T Q X
+    insert_product(0, Q, X_d, QX_d, mpi);
+    insert_product(1, Q, QX_d, O_d, mpi);
+
+    double *AX = starneig_acquire_vector_descr(AX_d);
+    double *U = starneig_acquire_vector_descr(U_d);
+    double *O = starneig_acquire_vector_descr(O_d);
+
+    double norm_a = 0.0, norm_r = 0.0, norm_o = 0.0;
+    for (size_t i = 0; i < (size_t)n*probes; i++) {
+        norm_a += AX[i]*AX[i];
+        norm_r += (AX[i]-U[i])*(AX[i]-U[i]);
+        norm_o += (O[i]-X[i])*(O[i]-X[i]);
+    }
+
+    if (residual != NULL)
+        *residual = 0.0 < norm_a ? sqrt(norm_r/norm_a) : sqrt(norm_r/probes);
+    if (orthogonality != NULL)
+        *orthogonality = sqrt(norm_o/probes);
+
+    free(AX);
+    free(U);
+    free(O);
+
+    starneig_vector_free(O_d);
+    starneig_vector_free(QX_d);
+    starneig_vector_free(U_d);
+    starneig_vector_free(V_d);
+    starneig_vector_free(W_d);
+    starneig_vector_free(AX_d);
+
+    starneig_vector_unregister(X_d);
+    starneig_vector_free(X_d);
+    free(X);
+}
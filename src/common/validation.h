@@ -0,0 +1,81 @@
+///
+/// @file
+///
+/// @brief This file contains randomized estimators that validate computed
+/// factorizations.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_COMMON_VALIDATION_H
+#define STARNEIG_COMMON_VALIDATION_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "matrix.h"
+
+///
+/// @brief Estimates the backward error and the loss of orthogonality of a
+/// factorization A = Q S Q^T.
+///
+///  The Frobenius norms are estimated by multiplying the matrices with a block
+///  of random Rademacher vectors. The expected squared norm of E x is
+///  ||E||_F^2 when the entries of x are independent and have unit variance.
+///  The cost is O(n^2) per probe vector.
+///
+/// @param[in] probes
+///         number of probe vectors
+///
+/// @param[in] A
+///         original matrix
+///
+/// @param[in] Q
+///         orthogonal matrix
+///
+/// @param[in] S
+///         reduced matrix
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+/// @param[out] residual
+///         estimate of ||A - Q S Q^T||_F / ||A||_F
+///
+/// @param[out] orthogonality
+///         estimate of ||Q^T Q - I||_F
+///
+void starneig_validate_factorization(
+    int probes, starneig_matrix_t A, starneig_matrix_t Q, starneig_matrix_t S,
+    mpi_info_t mpi, double *residual, double *orthogonality);
+
+#endif
@@ -39,6 +39,7 @@
 #include "vector.h"
 #include "common.h"
 #include "tasks.h"
+#include "comm_stats.h"
 
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
@@ -301,6 +302,8 @@ void starneig_vector_gather_section(
         if (root == my_rank || descr->owners[i] == my_rank) {
             starpu_data_handle_t handle =
                 starneig_vector_get_tile(i, descr);
+            starneig_comm_stats_task(root, (struct starpu_data_descr[]) {
+                { .handle = handle, .mode = STARPU_R } }, 1);
             starpu_mpi_gather_detached(
                 &handle, 1, root, starneig_mpi_get_comm(),
                 NULL, NULL, NULL, NULL);
@@ -325,6 +328,8 @@ void starneig_vector_scatter_section(
         if (root == my_rank || descr->owners[i] == my_rank) {
             starpu_data_handle_t handle =
                 starneig_vector_get_tile(i, descr);
+            starneig_comm_stats_task(root, (struct starpu_data_descr[]) {
+                { .handle = handle, .mode = STARPU_W } }, 1);
             starpu_mpi_scatter_detached(
                 &handle, 1, root, starneig_mpi_get_comm(),
                 NULL, NULL, NULL, NULL);
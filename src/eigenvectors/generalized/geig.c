@@ -41,6 +41,7 @@
 #include "geig.h"
 #include "common.h"
 #include "tiling.h"
+#include "../../common/alloc.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -239,7 +240,8 @@ int starneig_eigvec_gen_multi_shift_update(
     size_t ldb=2; double b[4]; int ln=2;
 
     // Allocate space for matrix Z: k-by-n matrix
-    size_t ldz=MAX(k,1); double *z=(double *)malloc(ldz*n*sizeof(double));
+    size_t ldz=starneig_alloc_ld(k, sizeof(double));
+    double *z=(double *)starneig_alloc_aligned(ldz*n*sizeof(double));
 
     // Copy X into Z
     starneig_eigvec_gen_dlacpy("A", k, n, x, ldx, z, ldz);
@@ -293,7 +295,7 @@ int starneig_eigvec_gen_multi_shift_update(
 		y, ldy);
 
     // Free the workspace
-    free(z);
+    starneig_free_aligned(z);
 
     // Dummy return code
     return 0;
@@ -312,7 +314,8 @@ double starneig_eigvec_gen_relative_residual(
     double tnorm=starneig_eigvec_gen_dlange("I", m, m, t, ldt, work);
 
     // Allocate space for residual R
-    size_t ldr=m; double* r=(double *)malloc(ldr*n*sizeof(double));
+    size_t ldr=starneig_alloc_ld(m, sizeof(double));
+    double* r=(double *)starneig_alloc_aligned(ldr*n*sizeof(double));
 
     // Copy F into R
     starneig_eigvec_gen_dlacpy("A", m, n, f, ldf, r, ldr);
@@ -348,7 +351,7 @@ double starneig_eigvec_gen_relative_residual(
     }
 
     // free memory
-    free(work); free(r); free(rnorm); free(xnorm); free(fnorm);
+    free(work); starneig_free_aligned(r); free(rnorm); free(xnorm); free(fnorm);
 
     // Return the largest relative residual separately
     return rc;
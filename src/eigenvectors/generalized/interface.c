@@ -40,6 +40,8 @@
 #include "robust.h"
 #include "../common/common.h"
 #include "../common/node_internal.h"
+#include "../common/progress.h"
+#include "../common/trace.h"
 #include <starneig/gep_sm.h>
 #include <cblas.h>
 #include <stdlib.h>
@@ -109,11 +111,16 @@ starneig_error_t starneig_GEP_SM_Eigenvectors_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("eigenvectors");
+    starneig_progress_begin("eigenvectors");
+
     starneig_eigvec_gen_initialize_omega(100);
     int _ret = starneig_eigvec_gen_sinew(n, S, ldS, T, ldT, selected, _X, ld_X,
         conf->tile_size, conf->tile_size);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
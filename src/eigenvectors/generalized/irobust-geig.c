@@ -48,6 +48,7 @@
 #include "robust-geig.h"
 #include "irobust.h"
 #include "irobust-geig.h"
+#include "../../common/alloc.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -513,7 +514,8 @@ int starneig_eigvec_gen_int_robust_multi_shift_update(
     size_t ldb=2; double b[4]; int ln=2; double bnorm;
 
     // Allocate space for matrix Z: k-by-n matrix
-    size_t ldz=MAX(k,1); double *z=(double *)malloc(ldz*n*sizeof(double));
+    size_t ldz=starneig_alloc_ld(k, sizeof(double));
+    double *z=(double *)starneig_alloc_aligned(ldz*n*sizeof(double));
 
     // Norms and scalings of Z
     int *zscal=(int *)malloc(n*sizeof(int));
@@ -566,7 +568,8 @@ int starneig_eigvec_gen_int_robust_multi_shift_update(
     }
 
     // Create matrix which will equal Z*B
-    size_t ldr=k; double *r=(double *)malloc(ldr*n*sizeof(double));
+    size_t ldr=starneig_alloc_ld(k, sizeof(double));
+    double *r=(double *)starneig_alloc_aligned(ldr*n*sizeof(double));
 
     // At this point it is safe to compute R:=0*R+Z*B
     int col=0;
@@ -605,7 +608,8 @@ int starneig_eigvec_gen_int_robust_multi_shift_update(
     starneig_eigvec_gen_mini_block_column_norms(m, n, alphai, y, ldy, ynorm);
 
     // Free the workspace
-    free(z); free(zscal); free(znorm); free(r);
+    starneig_free_aligned(z); free(zscal); free(znorm);
+    starneig_free_aligned(r);
 
     // Dummy return code
     return 0;
@@ -43,6 +43,7 @@
 #include "common.h"
 #include "robust.h"
 #include "irobust.h"
+#include "../../common/alloc.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <stddef.h>
@@ -126,7 +127,8 @@ void starneig_eigvec_gen_int_robust_update(
     // ************************************************************************
 
     // Create a copy Z = X: k by n matrix
-    size_t ldz=MAX(k,1); double *z=malloc(ldz*n*sizeof(double));
+    size_t ldz=starneig_alloc_ld(k, sizeof(double));
+    double *z=starneig_alloc_aligned(ldz*n*sizeof(double));
     starneig_eigvec_gen_dlacpy("A", k, n, x, ldx, z, ldz);
 
     // Copy norms and scalings
@@ -186,7 +188,7 @@ void starneig_eigvec_gen_int_robust_update(
 	 	 double_one, y, ldy);
 
     // Free memory
-    free(z); free(zscal); free(znorm);
+    starneig_free_aligned(z); free(zscal); free(znorm);
 
     // The final computation of the norms is omitted.
     // In general, it depends on the structure imposed on Y.
@@ -49,6 +49,8 @@
 #include "robust-geig.h"
 #include "irobust.h"
 #include "irobust-geig.h"
+#include "../../common/progress.h"
+#include "../../common/dry_run.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -727,7 +729,7 @@ void starneig_ComputeTileNorms(starpu_data_handle_t **a_h,
         for (int j=i; j<M; j++) {
             starpu_data_handle_t aux_h =
   	  	starpu_data_get_sub_data(anorm_h, 2, i, j);
-            starpu_task_insert(&infnorm_cl,
+            starneig_task_insert(&infnorm_cl,
   			   			 STARPU_PRIORITY, STARPU_MAX_PRIO,
   			   			 STARPU_R, a_h[i][j],
   			   			 STARPU_W, aux_h,
@@ -746,7 +748,7 @@ void starneig_eigvec_std_scaleTiles(double alpha, starpu_data_handle_t **a_h, in
     // Insert tasks which scales each tile by alpha
     for (int i=0; i<M; i++)
         for (int j=i; j<M; j++)
-            starpu_task_insert(&scale_cl,
+            starneig_task_insert(&scale_cl,
 			 			 STARPU_PRIORITY, STARPU_MAX_PRIO,
 			 			 STARPU_VALUE, &alpha, sizeof(double),
 			 			 STARPU_RW, a_h[i][j],
@@ -936,7 +938,7 @@ int starneig_eigvec_gen_sinew(int m,
     }
     // Insert tasks which process diagonal tiles
     for (int i=0; i<numRows; i++)
-        starpu_task_insert(&ProcessDiagonalTile_cl,
+        starneig_task_insert(&ProcessDiagonalTile_cl,
   		         		       STARPU_PRIORITY, STARPU_MAX_PRIO,
   		         		       STARPU_R, s_h[i][i],
   		         		       STARPU_R, t_h[i][i],
@@ -982,7 +984,7 @@ int starneig_eigvec_gen_sinew(int m,
         int ln=bp[i+1]-bp[i];
         // Only insert non-trivial tasks
         if (ln>0)
-            starpu_task_insert(&ComputeEigenvalues_cl,
+            starneig_task_insert(&ComputeEigenvalues_cl,
 			 			 STARPU_PRIORITY, STARPU_MAX_PRIO,
 			 			 STARPU_R, s_h[i][i],
 			 			 STARPU_R, t_h[i][i],
@@ -1030,7 +1032,7 @@ int starneig_eigvec_gen_sinew(int m,
     // Nullify Y in using task
     for (int i=0; i<numRows; i++)
         for (int j=0; j<numCols; j++)
-            starpu_task_insert(&sZeros_cl,
+            starneig_task_insert(&sZeros_cl,
 			 			 STARPU_PRIORITY, STARPU_MAX_PRIO,
 			 			 STARPU_W, y_h[i][j],
 			 			 0);
@@ -1055,7 +1057,7 @@ int starneig_eigvec_gen_sinew(int m,
             if (bp[i]<cp[j+1]) {
 
 		// Insert solve task
-		starpu_task_insert(&solve_cl,
+		starneig_task_insert(&solve_cl,
 			   			   STARPU_PRIORITY, STARPU_MAX_PRIO,
 			   			   STARPU_R, s_h[i][i], STARPU_R, cs_h[i],
 			   			   STARPU_R, t_h[i][i], STARPU_R, ct_h[i],
@@ -1086,7 +1088,7 @@ int starneig_eigvec_gen_sinew(int m,
 	  	  // ****************************************************************
 
 	  	  // Insert update task
-	  	  starpu_task_insert(&update2_cl,
+	  	  starneig_task_insert(&update2_cl,
 			     			     STARPU_PRIORITY,
 			     			     MAX(STARPU_MIN_PRIO, STARPU_MAX_PRIO+k-i),
 			     			     STARPU_R, s_h[k][i],
@@ -1114,6 +1116,11 @@ int starneig_eigvec_gen_sinew(int m,
 
 
 
+    // the last task that modifies Y(0,j) completes the tile column j
+    starneig_progress_set_total(n);
+    for (int j=0; j<numCols; j++)
+        starneig_progress_insert_marker(cp[j+1]-cp[j], y_h[0][j], NULL);
+
     // **********************************************************************
     //   Unregistration follows below.
     // **********************************************************************
@@ -1187,7 +1194,7 @@ int starneig_eigvec_gen_sinew(int m,
     // Insert tasks which enforce consistent scaling upon Y
     for (int i=0; i<numRows; i++) {
         for (int j=0; j<numCols; j++) {
-            starpu_task_insert(&sIntConsistentScaling_cl,
+            starneig_task_insert(&sIntConsistentScaling_cl,
 			 			 STARPU_PRIORITY, STARPU_MAX_PRIO,
 			 			 STARPU_RW, y_h[i][j],
 			 			 STARPU_R, zscal_h[j],
@@ -37,6 +37,7 @@
 #include <starneig_config.h>
 #include <starneig/configuration.h>
 #include "../../common/tasks.h"
+#include "../../common/dry_run.h"
 #include "core.h"
 #include "cpu.h"
 
@@ -105,13 +106,13 @@ starneig_error_t starneig_eigvec_std_insert_backsolve_tasks(
     //
 
     for (int i = 0; i < num_tiles; i++) {
-        starpu_task_insert(
+        starneig_task_insert(
             &bound_cl,
             STARPU_PRIORITY, critical_prio,
             STARPU_R, S_tiles[i][i],
             STARPU_W, S_tiles_norms[i][i], 0);
         for (int j = i+1; j < num_tiles; j++) {
-            starpu_task_insert(
+            starneig_task_insert(
                 &bound_cl,
                 STARPU_PRIORITY, critical_prio,
                 STARPU_R, S_tiles[i][j],
@@ -131,7 +132,7 @@ starneig_error_t starneig_eigvec_std_insert_backsolve_tasks(
         for (int j = k; j >= 0; j--) {
             if (k == j) {
                 // Form initial right-hand sides and backsolve.
-                starpu_task_insert(
+                starneig_task_insert(
                     &backsolve_cl,
                     STARPU_PRIORITY, critical_prio,
                     STARPU_R, S_tiles[k][k],
@@ -146,7 +147,7 @@ starneig_error_t starneig_eigvec_std_insert_backsolve_tasks(
             }
             else { // k != j
                 // Multi-shift solve.
-                starpu_task_insert(
+                starneig_task_insert(
                     &solve_cl,
                     STARPU_PRIORITY, critical_prio,
                     STARPU_R, S_tiles[j][j],
@@ -164,7 +165,7 @@ starneig_error_t starneig_eigvec_std_insert_backsolve_tasks(
 
             for (int i = j-1; i >= 0; i--) {
                 // Linear update.
-                starpu_task_insert(
+                starneig_task_insert(
                     &update_cl,
                     STARPU_PRIORITY, update_prio,
                     STARPU_R, S_tiles[i][j],
@@ -193,7 +194,7 @@ starneig_error_t starneig_eigvec_std_insert_backtransform_tasks(
     for (int j = num_tiles-1; j >= 0; j--) {
         for (int i = num_tiles-1; i >= 0; i--) {
             int num_inner = first_row[j+1]-first_row[0];
-            starpu_task_insert(
+            starneig_task_insert(
                 &backtransform_cl,
                 STARPU_R, Q_tiles[i][0],
                 STARPU_R, X_tiles[0][j],
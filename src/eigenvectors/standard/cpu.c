@@ -43,6 +43,7 @@
 #include "robust.h"
 
 #include "../../common/common.h"
+#include "../../common/alloc.h"
 #include "../../common/tiles.h"
 #include <starpu.h>
 #include <cblas.h>
@@ -1087,7 +1088,8 @@ void starneig_eigvec_std_cpu_update(void *buffers[], void *cl_args)
 
     // If X has to be rescaled, take a copy of X and do scaling on the copy.
     if (rescale_X) {
-        X = (double *) malloc((size_t)ldX * num_rhs * sizeof(double));
+        X = (double *)
+            starneig_alloc_aligned((size_t)ldX * num_rhs * sizeof(double));
 
         for (int k = 0; k < num_rhs; k++) {
             if (Yscales[k] < Xscales[k]) {
@@ -1195,7 +1197,7 @@ void starneig_eigvec_std_cpu_update(void *buffers[], void *cl_args)
     //
 
     if (rescale_X)
-        free(X);
+        starneig_free_aligned(X);
 
     if (rescale_xnorms)
         free(Xnorms);
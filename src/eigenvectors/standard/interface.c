@@ -44,8 +44,11 @@
 #include "cpu.h"
 #include "partition.h"
 #include "../../common/common.h"
+#include "../../common/alloc.h"
 #include "../../common/node_internal.h"
+#include "../../common/progress.h"
 #include "../../common/matrix.h"
+#include "../../common/trace.h"
 #include <starneig/sep_sm.h>
 #include <cblas.h>
 #include <stdlib.h>
@@ -223,8 +226,9 @@ static starneig_error_t eigenvectors(
     // workspace
     //
 
-    int ldX = ldY;
-    double *X = (double *) malloc((size_t)ldX*num_selected*sizeof(double));
+    int ldX = starneig_alloc_ld(n, sizeof(double));
+    double *X = (double *)
+        starneig_alloc_aligned((size_t)ldX*num_selected*sizeof(double));
 
     size_t num_segments = (size_t) num_tiles*num_selected;
 
@@ -396,6 +400,12 @@ static starneig_error_t eigenvectors(
         selected_lambda_type_tiles, info_tiles, smlnum,
         STARPU_MAX_PRIO, STARPU_DEFAULT_PRIO);
 
+    // the last task that modifies X_tiles[0][k] completes the block column k
+    starneig_progress_set_total(num_selected);
+    for (int k = 0; k < num_tiles; k++)
+        starneig_progress_insert_marker(
+            first_col[k+1]-first_col[k], X_tiles[0][k], NULL);
+
     starpu_task_wait_for_all();
 
     starneig_eigvec_std_unify_scaling(num_tiles, first_row, first_col, scales, X, ldX,
@@ -460,7 +470,7 @@ static starneig_error_t eigenvectors(
     free(lambda_type_tiles);
     free(selected_lambda_type_tiles);
     free(info_tiles);
-    free(X);
+    starneig_free_aligned(X);
     free(Xnorms);
     free(Snorms);
     free(info);
@@ -509,10 +519,15 @@ int starneig_SEP_SM_Eigenvectors_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("eigenvectors");
+    starneig_progress_begin("eigenvectors");
+
     starneig_error_t ret = eigenvectors(
         conf, n, selected, S, ldS, Q, ldQ, X, ldX);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_mode(STARNEIG_MODE_OFF);
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
@@ -40,6 +40,8 @@
 #include "tasks.h"
 #include "../common/scratch.h"
 #include "../common/tasks.h"
+#include "../common/comm_stats.h"
+#include "../common/progress.h"
 
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
@@ -392,6 +394,11 @@ starneig_error_t starneig_hessenberg_insert_tasks(
     struct update *updates = NULL;
     struct update *tail = NULL;
 
+    int phase = starneig_comm_stats_set_phase(
+        STARNEIG_COMM_PHASE_HESSENBERG_PANEL);
+
+    starneig_progress_set_total(MAX(0, end-begin-1));
+
     //
     // loop over panels
     //
@@ -448,6 +455,8 @@ starneig_error_t starneig_hessenberg_insert_tasks(
         }
 #endif
 
+        starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_HESSENBERG_PANEL);
+
         starneig_insert_copy_matrix_to_handle(i+1, end, i, i+nb,
             critical_prio, matrix_a, P_h, mpi);
 
@@ -511,6 +520,7 @@ starneig_error_t starneig_hessenberg_insert_tasks(
 
             starneig_hessenberg_insert_finish_column(
                 critical_prio, j, i+1, end, V_h, T_h, Y_h, y, mpi);
+            starneig_progress_insert_marker(1, T_h, mpi);
 
             starneig_vector_free(v);
             starneig_vector_free(y);
@@ -520,6 +530,8 @@ starneig_error_t starneig_hessenberg_insert_tasks(
         // update the trailing matrix from the right
         //
 
+        starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_HESSENBERG_UPDATE);
+
         {
             int _cbegin = i+nb;
             while (_cbegin < end) {
@@ -595,5 +607,7 @@ starneig_error_t starneig_hessenberg_insert_tasks(
         panel_width, begin, end, critical_prio, update_prio, misc_prio,
         matrix_q, matrix_a, &updates, mpi);
 
+    starneig_comm_stats_set_phase(phase);
+
     return STARNEIG_SUCCESS;
 }
@@ -396,7 +396,7 @@ void starneig_hessenberg_cpu_update_left_b(
     int nb, offset;
     starpu_codelet_unpack_args(cl_args, &A_pi, &W_pi, &nb, &offset);
 
-    STARNEIG_EVENT_BEGIN(&packing_info, starneig_event_green);
+    STARNEIG_EVENT_BEGIN(&A_pi, starneig_event_green);
 
     int m = A_pi.rend - A_pi.rbegin;
     int n = A_pi.cend - A_pi.cbegin;
@@ -447,7 +447,7 @@ void starneig_hessenberg_cpu_update_right_a(
     int nb, offset;
     starpu_codelet_unpack_args(cl_args, &A_pi, &W_pi, &nb, &offset);
 
-    STARNEIG_EVENT_BEGIN(&packing_info, starneig_event_blue);
+    STARNEIG_EVENT_BEGIN(&A_pi, starneig_event_blue);
 
     int m = A_pi.rend - A_pi.rbegin;
     int n = A_pi.cend - A_pi.cbegin;
@@ -515,7 +515,7 @@ void starneig_hessenberg_cpu_update_right_b(
     int nb, offset;
     starpu_codelet_unpack_args(cl_args, &A_pi, &W_pi, &nb, &offset);
 
-    STARNEIG_EVENT_BEGIN(&packing_info, starneig_event_blue);
+    STARNEIG_EVENT_BEGIN(&A_pi, starneig_event_blue);
 
     int m = A_pi.rend - A_pi.rbegin;
     int n = A_pi.cend - A_pi.cbegin;
@@ -39,6 +39,8 @@
 #include <starneig/sep_sm.h>
 #include "../common/node_internal.h"
 #include "../common/trace.h"
+#include "../common/progress.h"
+#include "../common/dry_run.h"
 #include "core.h"
 #include <math.h>
 
@@ -101,13 +103,15 @@ static starneig_error_t hessenberg(
     // insert tasks
     //
 
-    STARNEIG_EVENT_INIT();
+    starneig_dry_run_begin(NULL);
 
     starneig_error_t ret = starneig_hessenberg_insert_tasks(
         conf->panel_width, begin, end,
         STARPU_MAX_PRIO, STARPU_DEFAULT_PRIO, STARPU_MIN_PRIO,
         matrix_q, matrix_a, true, NULL);
 
+    starneig_dry_run_end();
+
     //
     // finalize
     //
@@ -118,9 +122,6 @@ static starneig_error_t hessenberg(
     starneig_matrix_free(matrix_a);
     starneig_matrix_free(matrix_q);
 
-    STARNEIG_EVENT_STORE(n, "trace.dat");
-    STARNEIG_EVENT_FREE();
-
     return ret;
 }
 
@@ -156,9 +157,14 @@ starneig_error_t starneig_SEP_SM_Hessenberg_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("hessenberg");
+    starneig_progress_begin("hessenberg");
+
     starneig_error_t ret = hessenberg(conf, n, begin, end, ldQ, ldA, Q, A);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_mode(STARNEIG_MODE_OFF);
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
@@ -44,6 +44,8 @@
 #endif
 #include "../common/common.h"
 #include "../common/tiles.h"
+#include "../common/comm_stats.h"
+#include "../common/dry_run.h"
 #include <limits.h>
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
@@ -333,8 +335,11 @@ void starneig_hessenberg_insert_prepare_column(
     starneig_pack_range(STARPU_W, begin+i, end, v, helper, &v_pi, 0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_vector_get_elem_owner(0, v),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &prepare_column_cl,
             STARPU_PRIORITY, prio,
@@ -343,9 +348,10 @@ void starneig_hessenberg_insert_prepare_column(
             STARPU_VALUE, &i, sizeof(i),
             STARPU_VALUE, &v_pi, sizeof(v_pi),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &prepare_column_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &i, sizeof(i),
@@ -373,23 +379,31 @@ void starneig_hessenberg_insert_compute_column(
     starneig_pack_range(
         STARPU_RW | STARPU_COMMUTE, rbegin, rend, y, helper, &y_pi, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin);
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, matrix_a),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &compute_column_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_EXECUTE_ON_NODE,
                 starneig_matrix_get_elem_owner(rbegin, cbegin, matrix_a),
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &v_pi, sizeof(v_pi),
             STARPU_VALUE, &y_pi, sizeof(y_pi),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &compute_column_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &v_pi, sizeof(v_pi),
             STARPU_VALUE, &y_pi, sizeof(y_pi),
@@ -416,8 +430,11 @@ void starneig_hessenberg_insert_finish_column(
     starneig_pack_range(STARPU_R, begin, end, y, helper, &y_pi, 0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_vector_get_elem_owner(0, y),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &finish_column_cl,
             STARPU_PRIORITY, prio,
@@ -426,9 +443,10 @@ void starneig_hessenberg_insert_finish_column(
             STARPU_VALUE, &i, sizeof(i),
             STARPU_VALUE, &y_pi, sizeof(y_pi),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &finish_column_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &i, sizeof(i),
@@ -459,24 +477,32 @@ void starneig_hessenberg_insert_update_trail_right(
     starneig_pack_window(STARPU_RW, rbegin, rend, cbegin, cend,
         matrix_a, helper, &packing_info, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin)*nb;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, matrix_a),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &update_trail_right_cl,
             STARPU_EXECUTE_ON_NODE,
             starneig_matrix_get_elem_owner(rbegin, cbegin, matrix_a),
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &roffset, sizeof(roffset),
             STARPU_VALUE, &coffset, sizeof(coffset),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &update_trail_right_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &packing_info, sizeof(packing_info),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &roffset, sizeof(roffset),
@@ -514,24 +540,32 @@ void starneig_hessenberg_insert_update_left_a(
     starneig_pack_window(
         STARPU_RW | STARPU_COMMUTE, cbegin, cend, 0, nb, W, helper, &W_pi, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin)*nb;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, A),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &update_left_a_cl,
             STARPU_EXECUTE_ON_NODE,
             starneig_matrix_get_elem_owner(rbegin, cbegin, A),
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &offset, sizeof(offset),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &update_left_a_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
@@ -566,24 +600,32 @@ void starneig_hessenberg_insert_update_left_b(
     starneig_pack_window(
         STARPU_RW, rbegin, rend, cbegin, cend, A, helper, &A_pi, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin)*nb;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, A),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &update_left_b_cl,
             STARPU_EXECUTE_ON_NODE,
             starneig_matrix_get_elem_owner(rbegin, cbegin, A),
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &offset, sizeof(offset),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &update_left_b_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
@@ -621,24 +663,32 @@ void starneig_hessenberg_insert_update_right_a(
     starneig_pack_window(
         STARPU_RW | STARPU_COMMUTE, rbegin, rend, 0, nb, W, helper, &W_pi, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin)*nb;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, A),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &update_right_a_cl,
             STARPU_EXECUTE_ON_NODE,
             starneig_matrix_get_elem_owner(rbegin, cbegin, A),
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &offset, sizeof(offset),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &update_right_a_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
@@ -673,24 +723,32 @@ void starneig_hessenberg_insert_update_right_b(
     starneig_pack_window(
         STARPU_RW, rbegin, rend, cbegin, cend, A, helper, &A_pi, 0);
 
+    double flops = 2.0*(rend-rbegin)*(cend-cbegin)*nb;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_matrix_get_elem_owner(rbegin, cbegin, A),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &update_right_b_cl,
             STARPU_EXECUTE_ON_NODE,
             starneig_matrix_get_elem_owner(rbegin, cbegin, A),
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
             STARPU_VALUE, &offset, sizeof(offset),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &update_right_b_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &A_pi, sizeof(A_pi),
             STARPU_VALUE, &W_pi, sizeof(W_pi),
             STARPU_VALUE, &nb, sizeof(nb),
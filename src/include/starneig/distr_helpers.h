@@ -86,6 +86,176 @@ MPI_Comm starneig_mpi_get_comm();
 /// @}
 ///
 
+///
+/// @name Shared memory
+/// @{
+///
+
+///
+/// @brief Allocates the local buffers of subsequently created distributed
+/// matrices from node-local shared memory (MPI-3 shared memory windows).
+///
+/// When enabled, starneig_distr_matrix_copy() and
+/// starneig_distr_matrix_copy_region() copy the blocks between ranks that are
+/// located on the same node directly from the source buffers without MPI
+/// messages. The tile transfers inside the solvers are not affected and still
+/// go through StarPU-MPI. Note that starneig_distr_matrix_destroy() becomes
+/// collective over the co-located ranks for the affected matrices.
+///
+/// Disabled by default.
+///
+void starneig_mpi_enable_shared_memory();
+
+///
+/// @brief Allocates the local buffers of subsequently created distributed
+/// matrices from private memory.
+///
+void starneig_mpi_disable_shared_memory();
+
+///
+/// @}
+///
+
+///
+/// @name Descriptor cache
+/// @{
+///
+
+///
+/// @brief Sets a memory limit for the descriptor cache.
+///
+/// The library keeps the tiled views of distributed matrices registered
+/// between interface function calls when StarPU-MPI is kept awake (see
+/// #STARNEIG_AWAKE_MPI_WORKER). Several views (tile sizes) of the same matrix
+/// can be cached at the same time. The least recently used views are
+/// unregistered when the estimated memory footprint of the cache exceeds the
+/// limit. The footprint of a view covers the bookkeeping of its tiles and the
+/// tile-sized replicas of the remote tiles. Must be called with the same
+/// argument on all MPI ranks.
+///
+/// @param[in] limit
+///         The memory limit in bytes (1 GB by default).
+///
+void starneig_mpi_set_descr_cache_limit(size_t limit);
+
+///
+/// @brief Descriptor cache statistics.
+///
+struct starneig_descr_cache_stats {
+    long long hits;         ///< number of tiled views found from the cache
+    long long misses;       ///< number of tiled views created
+    long long evictions;    ///< number of tiled views evicted
+    size_t footprint;       ///< current estimated memory footprint in bytes
+};
+
+///
+/// @brief Returns the descriptor cache statistics of the calling rank.
+///
+/// The ranks make identical caching decisions and the counters are therefore
+/// the same on all ranks.
+///
+/// @param[out] stats
+///         Returns the statistics.
+///
+void starneig_mpi_get_descr_cache_stats(
+    struct starneig_descr_cache_stats *stats);
+
+///
+/// @}
+///
+
+///
+/// @name Communication statistics
+/// @{
+///
+
+///
+/// @brief Communication phase enumerator.
+///
+typedef enum {
+    STARNEIG_COMM_PHASE_HESSENBERG_PANEL,   ///< Hessenberg panel reduction
+    STARNEIG_COMM_PHASE_HESSENBERG_UPDATE,  ///< Hessenberg trailing updates
+    STARNEIG_COMM_PHASE_AED,                ///< aggressive early deflation
+    STARNEIG_COMM_PHASE_BULGES,             ///< bulge chasing and updates
+    STARNEIG_COMM_PHASE_REORDER,            ///< eigenvalue reordering windows
+    STARNEIG_COMM_PHASE_EIGENVALUES,        ///< eigenvalue gathers
+    STARNEIG_COMM_PHASE_OTHER,              ///< everything else
+    STARNEIG_COMM_PHASE_COUNT               ///< number of phases
+} starneig_comm_phase_t;
+
+///
+/// @brief Selects all communication phases in
+/// starneig_mpi_get_comm_stats().
+///
+#define STARNEIG_COMM_PHASE_ALL -1
+
+///
+/// @brief Selects all peers in starneig_mpi_get_comm_stats().
+///
+#define STARNEIG_COMM_PEER_ALL -1
+
+///
+/// @brief Communication statistics structure.
+///
+struct starneig_comm_stats {
+    long long sent_bytes;       ///< modelled number of bytes sent
+    long long sent_messages;    ///< modelled number of messages sent
+    long long recv_bytes;       ///< modelled number of bytes received
+    long long recv_messages;    ///< modelled number of messages received
+    /// Time (in seconds) the calling rank was blocked in StarPU-MPI barriers
+    /// and in data acquires (broadcasted status data). Time spent waiting for
+    /// transfers inside tasks is not included. Reported only when all peers
+    /// are selected.
+    double wait_time;
+};
+
+///
+/// @brief Enables the communication statistics.
+///
+/// The library then records the data transfers that StarPU-MPI performs on
+/// behalf of the distributed memory interface functions. The transfers are
+/// modelled from the task inputs during task insertion: a transfer is counted
+/// when a task reads a tile that has no valid copy on the executing rank. The
+/// actual StarPU-MPI transfers are not observed and the counts may therefore
+/// differ from them, e.g., when StarPU-MPI caching is disabled. The transfers
+/// are attributed to the algorithm phase that inserted the task and to the
+/// peer rank. A summary is
+/// printed after each interface function call when the verbose output is
+/// enabled. Must be called on all MPI ranks.
+///
+/// Disabled by default.
+///
+void starneig_mpi_enable_comm_stats();
+
+///
+/// @brief Disables the communication statistics.
+///
+void starneig_mpi_disable_comm_stats();
+
+///
+/// @brief Resets the communication statistics.
+///
+void starneig_mpi_reset_comm_stats();
+
+///
+/// @brief Returns the communication statistics of the calling rank.
+///
+/// @param[in] phase
+///         The phase to query or #STARNEIG_COMM_PHASE_ALL.
+///
+/// @param[in] peer
+///         The peer rank to query or #STARNEIG_COMM_PEER_ALL.
+///
+/// @param[out] stats
+///         Returns the communication statistics.
+///
+void starneig_mpi_get_comm_stats(
+    int phase, int peer, struct starneig_comm_stats *stats);
+
+///
+/// @}
+///
+
 ///
 /// @name Broadcast
 /// @{
@@ -50,6 +50,7 @@ extern "C" {
 #error "This header should be included only when STARNEIG_ENABLE_MPI is defined."
 #endif
 
+#include <starneig/error.h>
 #include <stddef.h>
 
 ///
@@ -353,6 +354,125 @@ void starneig_distr_matrix_copy_region(
 /// @}
 ///
 
+///
+/// @name Input and output
+/// @{
+///
+/// The matrices are stored in a raw format: a single line text header
+/// `STARNEIG RAW REAL DOUBLE M <rows> N <cols>` followed by the matrix elements
+/// in column-major order. The test program uses the same format.
+///
+
+///
+/// @brief Default value for the MPI-IO hints. The MPI implementation decides.
+///
+#define STARNEIG_IO_DEFAULT_HINT -1
+
+///
+/// @brief MPI-IO configuration structure.
+///
+struct starneig_io_conf {
+
+    /// Collective buffering (`romio_cb_read` / `romio_cb_write`). Non-zero
+    /// enables and zero disables the collective buffering.
+    /// The default value is #STARNEIG_IO_DEFAULT_HINT.
+    int collective_buffering;
+
+    /// The number of I/O aggregators (`cb_nodes`).
+    /// The default value is #STARNEIG_IO_DEFAULT_HINT.
+    int cb_nodes;
+
+    /// The collective buffer size in bytes (`cb_buffer_size`).
+    /// The default value is #STARNEIG_IO_DEFAULT_HINT.
+    int cb_buffer_size;
+
+    /// The number of file system stripes (`striping_factor`). Affects only
+    /// newly created files.
+    /// The default value is #STARNEIG_IO_DEFAULT_HINT.
+    int striping_factor;
+
+    /// The stripe size in bytes (`striping_unit`). Affects only newly
+    /// created files.
+    /// The default value is #STARNEIG_IO_DEFAULT_HINT.
+    int striping_unit;
+};
+
+///
+/// @brief Initializes an MPI-IO configuration structure with default
+/// parameter values.
+///
+/// @param[out] conf
+///         The MPI-IO configuration structure.
+///
+void starneig_io_init_conf(struct starneig_io_conf *conf);
+
+///
+/// @brief Reads the dimensions of a matrix that is stored in a file.
+///
+/// The first rank reads the header and broadcasts the dimensions.
+///
+/// @param[in] filename
+///         The file name.
+///
+/// @param[out] rows
+///         Returns the number of rows in the matrix.
+///
+/// @param[out] cols
+///         Returns the number of columns in the matrix.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+starneig_error_t starneig_distr_matrix_read_dimensions(
+    char const *filename, int *rows, int *cols);
+
+///
+/// @brief Reads a distributed matrix from a file using collective MPI-IO.
+///
+/// Each rank reads its own distributed blocks directly from the file. The
+/// dimensions of the distributed matrix must match the dimensions of the
+/// stored matrix.
+///
+/// @param[in] filename
+///         The file name.
+///
+/// @param[in] conf
+///         The MPI-IO configuration structure. If NULL, a default
+///         configuration is used.
+///
+/// @param[out] matrix
+///         The distributed matrix.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+starneig_error_t starneig_distr_matrix_read(
+    char const *filename, struct starneig_io_conf const *conf,
+    starneig_distr_matrix_t matrix);
+
+///
+/// @brief Writes a distributed matrix to a file using collective MPI-IO.
+///
+/// Each rank writes its own distributed blocks directly to the file.
+///
+/// @param[in] filename
+///         The file name.
+///
+/// @param[in] conf
+///         The MPI-IO configuration structure. If NULL, a default
+///         configuration is used.
+///
+/// @param[in] matrix
+///         The distributed matrix.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+starneig_error_t starneig_distr_matrix_write(
+    char const *filename, struct starneig_io_conf const *conf,
+    starneig_distr_matrix_t matrix);
+
+///
+/// @}
+///
+
 ///
 /// @name Query functions
 /// @{
@@ -126,6 +126,17 @@ typedef int starneig_error_t;
 ///
 #define STARNEIG_CLOSE_EIGENVALUES                  8
 
+///
+/// @brief Partial Schur form.
+///
+/// The interface function left parts of the matrix unreduced because they
+/// contain no eigenvalues in the requested region of the spectrum. Some
+/// diagonal blocks of the Schur form may not be in upper quasi-triangular
+/// form. The @ref starneig_schur_conf::region_final "region_final" array
+/// tells which diagonal entries are final.
+///
+#define STARNEIG_PARTIAL_SCHUR                      9
+
 ///
 /// @}
 ///
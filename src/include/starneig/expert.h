@@ -192,6 +192,21 @@ void starneig_hessenberg_init_conf(struct starneig_hessenberg_conf *conf);
 ///
 #define STARNEIG_SCHUR_LAPACK_THRESHOLD                -3
 
+///
+/// @brief Apply the local transformations to the Schur vectors immediately.
+///
+#define STARNEIG_SCHUR_DEFAULT_DEFER_TRANSFORMS        0
+
+///
+/// @brief Default checkpoint interval.
+///
+#define STARNEIG_SCHUR_DEFAULT_CHECKPOINT_INTERVAL     -1
+
+///
+/// @brief Default region patience.
+///
+#define STARNEIG_SCHUR_DEFAULT_REGION_PATIENCE         -1
+
 ///
 /// @brief Schur reduction configuration structure.
 ///
@@ -358,6 +373,91 @@ struct starneig_schur_conf {
     /// use the threshold \f$u |R|_F\f$, where \f$u\f$ is the unit roundoff and
     /// \f$|R|_F\f$ is the Frobenius norm of the matrix \f$R\f$.
     double inf_threshold;
+
+    /// By default, the local transformations that are produced by the
+    /// diagonal computation windows are applied to the matrices \f$Q\f$ and
+    /// \f$Z\f$ as soon as they become available. If this parameter is
+    /// non-zero, then the local transformations are recorded instead and
+    /// combined to larger blocks before they are applied to the matrices
+    /// \f$Q\f$ and \f$Z\f$. This reduces the number of update tasks and, in
+    /// the distributed memory case, moves the related communication away from
+    /// the critical path. The recorded transformations are applied when the
+    /// reduction finishes or when they would occupy more memory than the
+    /// matrix \f$Q\f$. If the parameter is set to
+    /// @ref STARNEIG_SCHUR_DEFAULT_DEFER_TRANSFORMS, then the transformations
+    /// are applied immediately.
+    int defer_transforms;
+
+    /// If this parameter is not NULL, then the implementation periodically
+    /// writes a checkpoint (the state of the QR/QZ algorithm and the matrices
+    /// \f$A\f$, \f$B\f$, \f$Q\f$ and \f$Z\f$) to the given file. The
+    /// matrices are written asynchronously tile by tile while the computation
+    /// continues. In distributed memory, each MPI rank writes a file of its
+    /// own (`checkpoint_file.rank`). A complete checkpoint replaces the
+    /// previous one and the previous checkpoint is kept in a file with the
+    /// suffix `.prev`.
+    char const *checkpoint_file;
+
+    /// This parameter defines the number of QR/QZ iterations between two
+    /// checkpoints. A checkpoint is written at the first segment list boundary
+    /// at which the algorithm can be restarted after the interval has been
+    /// reached. If the parameter is set to
+    /// @ref STARNEIG_SCHUR_DEFAULT_CHECKPOINT_INTERVAL, then the implementation
+    /// will determine a suitable interval automatically.
+    int checkpoint_interval;
+
+    /// If this parameter is non-zero, then the implementation restores the
+    /// matrices \f$A\f$, \f$B\f$, \f$Q\f$ and \f$Z\f$ from the latest
+    /// complete checkpoint in @ref checkpoint_file and resumes the QR/QZ
+    /// algorithm from there instead of the Hessenberg(-triangular) form. The
+    /// input matrices must have the same dimensions (and the same distribution
+    /// and tile size) as the checkpointed matrices and their contents are
+    /// overwritten.
+    int restart;
+
+    /// If this parameter is not NULL, then the implementation may leave parts
+    /// of the matrix unreduced when they contain no eigenvalues that satisfy
+    /// the given region predicate, e.g., the eigenvalues with the largest real
+    /// parts. The predicate is called with the real part, the imaginary part
+    /// and the scaling factor (1.0 in the standard case) of an eigenvalue
+    /// estimate and it should return a non-zero value if the eigenvalue
+    /// belongs to the region. The eigenvalues are estimated using the shifts
+    /// that are computed during each aggressive early deflation (AED) step.
+    /// Once the shifts of a segment of the matrix have all fallen outside the
+    /// region during @ref region_patience consecutive AED steps, the
+    /// implementation encloses the eigenvalues of the segment in a disc and
+    /// leaves the segment unreduced only if @ref region_disc confirms that
+    /// the disc does not intersect the region. The interface function then
+    /// returns @ref STARNEIG_PARTIAL_SCHUR and the eigenvalues that are
+    /// returned for the unreduced diagonal blocks are undefined.
+    int (*region)(double real, double imag, double beta, void *arg);
+
+    /// A conservative counterpart of the region predicate. The function is
+    /// called with the center (the real and imaginary parts) and the radius
+    /// of a disc and it must return a non-zero value if the disc may
+    /// intersect the region. If this parameter is NULL, then the matrix is
+    /// always reduced in full. The parameter is ignored in the generalized
+    /// case.
+    int (*region_disc)(double real, double imag, double radius, void *arg);
+
+    /// An optional argument for the region predicate and the region disc
+    /// test.
+    void *region_arg;
+
+    /// This parameter defines the number of consecutive AED steps whose
+    /// shifts must fall outside the region before the eigenvalues of a
+    /// segment are tested with @ref region_disc. If the parameter is set to
+    /// @ref STARNEIG_SCHUR_DEFAULT_REGION_PATIENCE, then the implementation
+    /// will determine a suitable value automatically.
+    int region_patience;
+
+    /// If this parameter and @ref region are not NULL, then the
+    /// implementation stores to this array (of length \f$n\f$) a non-zero
+    /// value for each diagonal entry that belongs to a final (converged)
+    /// diagonal block and a zero for each diagonal entry that belongs to an
+    /// unreduced diagonal block. In distributed memory, every MPI rank must
+    /// supply the array and receives the same values.
+    int *region_final;
 };
 
 ///
@@ -365,6 +365,54 @@ starneig_error_t starneig_GEP_DM_Select(
     int selected[],
     int *num_selected);
 
+///
+/// @brief Generates a selection array for a Schur-triangular matrix pencil
+/// using a user-supplied batched predicate function.
+///
+///  The generalized eigenvalues are extracted and the predicate is evaluated
+///  in parallel in diagonal tiles on the MPI ranks that own them. Each call
+///  covers one tile, so the predicate may be called concurrently from several
+///  threads. The selection array is distributed to all MPI ranks with a single
+///  collective operation.
+///
+/// @param[in] S
+///         The Schur matrix \f$S\f$.
+///
+/// @param[in] T
+///         The upper triangular matrix \f$T\f$.
+///
+/// @param[in] predicate
+///         A function that takes `count` (complex) generalized eigenvalues as
+///         input and sets `selected[i]` non-zero if the i'th generalized
+///         eigenvalue should be selected. For complex conjugate pairs of
+///         generalized eigenvalues, only the generalized eigenvalue with
+///         positive imaginary part is passed to the predicate and the
+///         corresponding \f$2 \times 2\f$ block is either selected or
+///         deselected.
+///
+/// @param[in] arg
+///         An optional argument for the predicate function.
+///
+/// @param[out] selected
+///         The selection array. Both elements of a selected complex conjugate
+///         pair are set to 1.
+///
+/// @param[out] num_selected
+///         The number of selected generalized eigenvalues (a complex conjugate
+///         pair is counted as two selected generalized eigenvalues).
+///
+/// @return @ref STARNEIG_SUCCESS (0) on success. Negative integer -i when i'th
+/// argument is invalid. Positive error code otherwise.
+///
+starneig_error_t starneig_GEP_DM_Select_batched(
+    starneig_distr_matrix_t S,
+    starneig_distr_matrix_t T,
+    void (*predicate)(int count, double const real[], double const imag[],
+        double const beta[], int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected);
+
 ///
 /// @}
 ///
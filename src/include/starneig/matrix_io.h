@@ -0,0 +1,198 @@
+///
+/// @file
+///
+/// @brief This file contains functions for memory mapping matrices that are
+/// stored in files.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_MATRIX_IO_H
+#define STARNEIG_MATRIX_IO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <starneig/configuration.h>
+#include <starneig/error.h>
+
+///
+/// @defgroup starneig_matrix_io Memory mapped matrices
+///
+/// @brief Functions for memory mapping matrices that are stored in files.
+///
+/// @{
+///
+
+///
+/// @name Mapping flags
+/// @{
+///
+
+///
+/// @brief Mapping flag data type.
+///
+typedef unsigned starneig_map_flag_t;
+
+///
+/// @brief Default mode.
+///
+#define STARNEIG_MAP_DEFAULT            0x0
+
+///
+/// @brief Prefetch mode.
+///
+/// Advises the kernel to start reading the whole file into the page cache
+/// immediately (MADV_WILLNEED).
+///
+#define STARNEIG_MAP_PREFETCH           0x1
+
+///
+/// @brief Huge page mode.
+///
+/// Backs an anonymous mapping with transparent huge pages (MADV_HUGEPAGE).
+/// The flag has an effect only when the matrix elements must be copied to an
+/// anonymous mapping. Private file-backed mappings are served from the page
+/// cache and use normal pages.
+///
+#define STARNEIG_MAP_HUGE_PAGES         0x2
+
+///
+/// @}
+///
+
+///
+/// @name Raw matrix files
+/// @{
+///
+
+///
+/// @brief Maximum length of a raw matrix file header.
+///
+#define STARNEIG_MATRIX_HEADER_MAX      128
+
+///
+/// @brief Alignment (in bytes) of the first matrix element inside a raw
+/// matrix file.
+///
+#define STARNEIG_MATRIX_ALIGNMENT       64
+
+///
+/// @}
+///
+
+///
+/// @brief Forms a raw matrix file header.
+///
+/// A raw matrix file consists of the header and the matrix elements in
+/// column-major order (leading dimension equals the number of rows). The
+/// header is padded with spaces so that the first matrix element is aligned
+/// to STARNEIG_MATRIX_ALIGNMENT bytes and the file can be mapped with
+/// starneig_matrix_map() without copying.
+///
+/// @param[in] rows
+///         The number of rows in the matrix.
+///
+/// @param[in] cols
+///         The number of columns in the matrix.
+///
+/// @param[out] header
+///         Returns the null-terminated header. Must be at least
+///         STARNEIG_MATRIX_HEADER_MAX bytes long.
+///
+/// @return The length of the header (the offset of the first matrix element).
+///
+int starneig_matrix_header(int rows, int cols, char *header);
+
+///
+/// @brief Maps a matrix that is stored in a raw matrix file to memory.
+///
+/// The file is mapped privately (copy-on-write). The returned buffer can be
+/// passed directly to the shared memory interface functions and modifications
+/// are never written back to the file. Pages that are not modified are shared
+/// through the page cache with all other processes that map the same file.
+///
+/// If the matrix elements are not suitably aligned inside the file (files
+/// written by older versions of the library), the matrix is copied to an
+/// anonymous mapping instead.
+///
+/// @code{.c}
+/// int n, m, ldA;
+/// double *A;
+/// starneig_matrix_map("A.dat", STARNEIG_MAP_PREFETCH, &m, &n, &A, &ldA);
+/// starneig_SEP_SM_Hessenberg(n, A, ldA, Q, ldQ);
+/// starneig_matrix_unmap(A);
+/// @endcode
+///
+/// @param[in] filename
+///         The file name.
+///
+/// @param[in] flags
+///         Mapping flags.
+///
+/// @param[out] rows
+///         Returns the number of rows in the matrix.
+///
+/// @param[out] cols
+///         Returns the number of columns in the matrix.
+///
+/// @param[out] A
+///         Returns a pointer to the first matrix element.
+///
+/// @param[out] ldA
+///         Returns the leading dimension of the matrix.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+starneig_error_t starneig_matrix_map(
+    char const *filename, starneig_map_flag_t flags, int *rows, int *cols,
+    double **A, int *ldA);
+
+///
+/// @brief Unmaps a matrix that was mapped with starneig_matrix_map().
+///
+/// @param[in] A
+///         A pointer to any matrix element inside the mapped matrix.
+///
+void starneig_matrix_unmap(double *A);
+
+///
+/// @}
+///
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STARNEIG_MATRIX_IO_H
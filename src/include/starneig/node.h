@@ -219,6 +219,283 @@ void starneig_node_set_gpus(int gpus);
 ///
 void starneig_node_finalize();
 
+///
+/// @name Execution traces
+/// @{
+///
+
+///
+/// @brief Default execution trace ring buffer size.
+///
+#define STARNEIG_TRACE_DEFAULT_EVENTS -1
+
+///
+/// @brief Starts recording an execution trace.
+///
+///  Each worker records the computational kernels it executes to a private
+///  ring buffer. Each event contains the codelet name, the task priority, the
+///  affected matrix rows and columns, and begin and end times from a monotonic
+///  clock. When a ring buffer becomes full, the oldest events are overwritten.
+///  Any previously recorded events are discarded.
+///
+///  Tracing can also be enabled by setting the `STARNEIG_TRACE` environmental
+///  variable to a file name before the library is initialized. The trace is
+///  then stored automatically when starneig_node_finalize() is called. In
+///  distributed memory, the MPI rank is appended to the file name. The
+///  `STARNEIG_TRACE_EVENTS` environmental variable sets the ring buffer size.
+///
+/// @param[in] events
+///         Ring buffer size (events per worker). If the parameter is set to
+///         @ref STARNEIG_TRACE_DEFAULT_EVENTS, then the implementation will
+///         use 65536 events per worker.
+///
+void starneig_node_enable_tracing(int events);
+
+///
+/// @brief Stops recording the execution trace. The recorded events are kept.
+///
+void starneig_node_disable_tracing();
+
+///
+/// @brief Stores the recorded execution trace to a file.
+///
+///  The file uses the Chrome trace event JSON format and can be opened with
+///  Perfetto (https://ui.perfetto.dev) or chrome://tracing. Each MPI rank is
+///  shown as a process and each worker as a thread. Should be called when no
+///  tasks are executing and before starneig_node_finalize().
+///
+/// @param[in] file_name
+///         File name.
+///
+/// @return Zero if the trace was stored successfully, non-zero otherwise.
+///
+int starneig_node_store_trace(char const *file_name);
+
+///
+/// @}
+///
+
+///
+/// @name Hardware performance counters
+/// @{
+///
+
+///
+/// @brief Starts sampling hardware performance counters around the
+/// computational kernels.
+///
+///  Each worker opens a perf_event_open() counter group for cycles,
+///  instructions, last level cache misses, data TLB misses and stalled
+///  (backend) cycles. The counts are aggregated by codelet and by a size
+///  bucket (the window dimension rounded up to a power of two). Counters that
+///  the hardware does not support are reported as null. Any previously
+///  aggregated counts are discarded. When sampling is disabled, the kernels do
+///  not touch the counters.
+///
+///  Sampling can also be enabled by setting the `STARNEIG_COUNTERS`
+///  environmental variable to a file name before the library is initialized.
+///  The counts are then stored automatically when starneig_node_finalize() is
+///  called. In distributed memory, the MPI rank is appended to the file name.
+///  The counts are also included in the execution trace.
+///
+///  Requires Linux. The `/proc/sys/kernel/perf_event_paranoid` setting must
+///  allow user space measurements (2 or less).
+///
+void starneig_node_enable_counters();
+
+///
+/// @brief Stops sampling the hardware performance counters. The aggregated
+/// counts are kept.
+///
+void starneig_node_disable_counters();
+
+///
+/// @brief Stores the aggregated hardware performance counter counts to a file
+/// in JSON format.
+///
+///  Each entry contains the codelet name, the size bucket, the number of
+///  executions, the total time in nanoseconds, the total counts, the number of
+///  instructions per cycle, the cache and TLB misses per thousand instructions
+///  and the fraction of stalled cycles. Should be called when no tasks are
+///  executing. The counts are kept when the node is finalized and can
+///  therefore be stored after starneig_node_finalize() has been called.
+///
+/// @param[in] file_name
+///         File name.
+///
+/// @return Zero if the counts were stored successfully, non-zero otherwise.
+///
+int starneig_node_store_counters(char const *file_name);
+
+///
+/// @}
+///
+
+///
+/// @name Progress reporting
+/// @{
+///
+
+///
+/// @brief Progress report.
+///
+///  The progress units depend on the phase:
+///   - `hessenberg`: reduced columns,
+///   - `schur`: deflated eigenvalues,
+///   - `reorder`: finished reordering windows out of planned windows,
+///   - `eigenvectors`: computed eigenvectors (before the back transformation).
+///
+///  The remaining time is predicted from the calibrated StarPU performance
+///  models of the tasks that have been submitted but have not finished yet.
+///  The predicted work is assumed to be distributed evenly among the workers.
+///  Phases that submit their tasks gradually (e.g. `schur`) report only the
+///  work that has been submitted so far. In distributed memory, each MPI rank
+///  predicts the time of its own tasks.
+///
+struct starneig_progress {
+    /// The current phase (an interface function) or NULL if no phase is
+    /// active.
+    char const *phase;
+    /// The number of completed progress units.
+    int done;
+    /// The total number of progress units or zero if not yet known.
+    int total;
+    /// Seconds elapsed since the phase began.
+    double elapsed;
+    /// Predicted seconds remaining in the phase or a negative value if no
+    /// prediction is available.
+    double remaining;
+};
+
+///
+/// @brief Progress callback function type.
+///
+/// @param[in] progress
+///         Progress report.
+///
+/// @param[in,out] arg
+///         The argument that was given to starneig_node_set_progress_callback().
+///
+typedef void (*starneig_progress_callback_t)(
+    struct starneig_progress const *progress, void *arg);
+
+///
+/// @brief Returns the current progress. Can be called from any thread while
+/// an interface function is executing.
+///
+///  In distributed memory, the Hessenberg, reordering and eigenvector phases
+///  count only the units that were completed by the calling MPI rank. The
+///  done counts must be summed over all ranks.
+///
+/// @param[out] progress
+///         Progress report.
+///
+void starneig_node_get_progress(struct starneig_progress *progress);
+
+///
+/// @brief Sets a progress callback function.
+///
+///  The callback is called when a phase begins, when a phase ends and when
+///  progress is made, but not more often than once per interval. The callback
+///  may be called from a StarPU worker thread and it should therefore return
+///  quickly.
+///
+/// @param[in] callback
+///         Callback function or NULL to disable the callback.
+///
+/// @param[in] interval
+///         Minimum interval between two calls in seconds.
+///
+/// @param[in,out] arg
+///         An argument that is passed to the callback function.
+///
+void starneig_node_set_progress_callback(
+    starneig_progress_callback_t callback, double interval, void *arg);
+
+///
+/// @}
+///
+
+///
+/// @name Task graph dry runs
+/// @{
+///
+
+///
+/// @brief Task graph metrics.
+///
+///  The execution times are predicted with the StarPU performance models of a
+///  CPU worker. Tasks whose codelet has not been calibrated are assumed to
+///  take no time.
+///
+struct starneig_task_graph_info {
+    /// The number of recorded tasks.
+    int tasks;
+    /// The number of dependencies between the recorded tasks.
+    int edges;
+    /// The number of tasks without a calibrated performance model.
+    int uncalibrated;
+    /// The total predicted execution time in seconds.
+    double work;
+    /// The predicted length of the critical path in seconds.
+    double critical_path;
+    /// The average parallelism (work divided by the critical path length).
+    double parallelism;
+    /// The peak number of concurrent tasks when every task starts as early as
+    /// possible.
+    int max_parallelism;
+};
+
+///
+/// @brief Enables dry runs and discards the previously recorded task graph.
+///
+///  During a dry run, the Hessenberg reduction and eigenvalue reordering
+///  engines record their tasks to a task graph instead of executing them. The
+///  matrices are not modified and the other outputs are undefined. Other
+///  computations are executed normally. Dry runs are supported only in shared
+///  memory and require StarPU 1.3 or newer.
+///
+///  Dry runs can also be enabled by setting the `STARNEIG_DRY_RUN`
+///  environmental variable to a file name before the library is initialized.
+///  The task graph is then stored automatically when starneig_node_finalize()
+///  is called.
+///
+void starneig_node_enable_dry_run();
+
+///
+/// @brief Disables dry runs. The recorded task graph is kept.
+///
+void starneig_node_disable_dry_run();
+
+///
+/// @brief Computes the metrics of the recorded task graph.
+///
+/// @param[out] info
+///         Task graph metrics.
+///
+void starneig_node_get_task_graph_info(struct starneig_task_graph_info *info);
+
+///
+/// @brief Stores the recorded task graph to a file.
+///
+///  The graph is stored in DOT format if the file name ends with `.dot`. In
+///  all other cases, the graph is stored in JSON format together with the
+///  metrics and the per-codelet task counts.
+///  The recorded task graph is kept when the node is finalized and can
+///  therefore be stored after starneig_node_finalize() has been called.
+///
+/// @param[in] file_name
+///         File name.
+///
+/// @return Zero if the task graph was stored successfully, non-zero
+/// otherwise.
+///
+int starneig_node_store_task_graph(char const *file_name);
+
+///
+/// @}
+///
+
 #ifdef STARNEIG_ENABLE_CUDA
 
 ///
@@ -281,6 +281,89 @@ starneig_error_t starneig_SEP_DM_Select(
     int selected[],
     int *num_selected);
 
+///
+/// @brief Generates a selection array for a Schur matrix using a user-supplied
+/// batched predicate function.
+///
+///  The eigenvalues are extracted and the predicate is evaluated in parallel
+///  in diagonal tiles on the MPI ranks that own them. Each call covers one
+///  tile, so the predicate may be called concurrently from several threads.
+///  The selection array is distributed to all MPI ranks with a single
+///  collective operation.
+///
+/// @param[in] S
+///         The Schur matrix \f$S\f$.
+///
+/// @param[in] predicate
+///         A function that takes `count` (complex) eigenvalues as input and
+///         sets `selected[i]` non-zero if the i'th eigenvalue should be
+///         selected. For complex conjugate pairs of eigenvalues, only the
+///         eigenvalue with positive imaginary part is passed to the predicate
+///         and the corresponding \f$2 \times 2\f$ block is either selected or
+///         deselected.
+///
+/// @param[in] arg
+///         An optional argument for the predicate function.
+///
+/// @param[out] selected
+///         The selection array. Both elements of a selected complex conjugate
+///         pair are set to 1.
+///
+/// @param[out] num_selected
+///         The (global) number of selected eigenvalues (a complex conjugate
+///         pair is counted as two selected eigenvalues).
+///
+/// @return @ref STARNEIG_SUCCESS (0) on success. Negative integer -i when i'th
+/// argument is invalid. Positive error code otherwise.
+///
+starneig_error_t starneig_SEP_DM_Select_batched(
+    starneig_distr_matrix_t S,
+    void (*predicate)(int count, double const real[], double const imag[],
+        int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected);
+
+///
+/// @brief Estimates the backward error and the loss of orthogonality of a
+/// computed decomposition \f$A = Q S Q^T\f$.
+///
+///  The Frobenius norms are estimated by multiplying the matrices with a few
+///  random vectors. The cost is \f$O(n^2)\f$ per probe vector and the
+///  matrices are not gathered to a single MPI rank. All MPI ranks receive the
+///  same estimates.
+///
+/// @param[in] A
+///         The original matrix \f$A\f$.
+///
+/// @param[in] Q
+///         The orthogonal matrix \f$Q\f$.
+///
+/// @param[in] S
+///         The reduced matrix \f$S\f$ (Hessenberg or Schur).
+///
+/// @param[in] probes
+///         The number of random probe vectors.
+///
+/// @param[out] residual
+///         An estimate of \f$\|A - Q S Q^T\|_F / \|A\|_F\f$.
+///
+/// @param[out] orthogonality
+///         An estimate of \f$\|Q^T Q - I\|_F\f$.
+///
+/// @return @ref STARNEIG_SUCCESS (0) on success. Negative integer -i when i'th
+/// argument is invalid. Positive error code otherwise.
+///
+/// @see starneig_SEP_SM_Validate
+///
+starneig_error_t starneig_SEP_DM_Validate(
+    starneig_distr_matrix_t A,
+    starneig_distr_matrix_t Q,
+    starneig_distr_matrix_t S,
+    int probes,
+    double *residual,
+    double *orthogonality);
+
 ///
 /// @}
 ///
@@ -332,6 +332,106 @@ starneig_error_t starneig_SEP_SM_Select(
     int selected[],
     int *num_selected);
 
+///
+/// @brief Generates a selection array for a Schur matrix using a user-supplied
+/// batched predicate function.
+///
+///  The eigenvalues are extracted and the predicate is evaluated in parallel
+///  in diagonal tiles. Each call covers one tile, so the predicate may be
+///  called concurrently from several threads.
+///
+/// @param[in] n
+///         The order of \f$S\f$.
+///
+/// @param[in] S
+///         The Schur matrix \f$S\f$.
+///
+/// @param[in] ldS
+///         The leading dimension of \f$S\f$.
+///
+/// @param[in] predicate
+///         A function that takes `count` (complex) eigenvalues as input and
+///         sets `selected[i]` non-zero if the i'th eigenvalue should be
+///         selected. For complex conjugate pairs of eigenvalues, only the
+///         eigenvalue with positive imaginary part is passed to the predicate
+///         and the corresponding \f$2 \times 2\f$ block is either selected or
+///         deselected.
+///
+/// @param[in] arg
+///         An optional argument for the predicate function.
+///
+/// @param[out] selected
+///         The selection array. Both elements of a selected complex conjugate
+///         pair are set to 1.
+///
+/// @param[out] num_selected
+///         The number of selected eigenvalues (a complex conjugate pair is
+///         counted as two selected eigenvalues).
+///
+/// @return @ref STARNEIG_SUCCESS (0) on success. Negative integer -i when i'th
+/// argument is invalid. Positive error code otherwise.
+///
+starneig_error_t starneig_SEP_SM_Select_batched(
+    int n,
+    double S[], int ldS,
+    void (*predicate)(int count, double const real[], double const imag[],
+        int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected);
+
+///
+/// @brief Estimates the backward error and the loss of orthogonality of a
+/// computed decomposition \f$A = Q S Q^T\f$.
+///
+///  The Frobenius norms are estimated by multiplying the matrices with a few
+///  random vectors. The cost is \f$O(n^2)\f$ per probe vector, which is
+///  small compared to the cost of the decomposition. The estimates are
+///  unbiased in the squared norm; a few probe vectors give estimates that are
+///  accurate to within a small factor with high probability.
+///
+/// @param[in] n
+///         The order of \f$A\f$, \f$Q\f$ and \f$S\f$.
+///
+/// @param[in] A
+///         The original matrix \f$A\f$.
+///
+/// @param[in] ldA
+///         The leading dimension of \f$A\f$.
+///
+/// @param[in] Q
+///         The orthogonal matrix \f$Q\f$.
+///
+/// @param[in] ldQ
+///         The leading dimension of \f$Q\f$.
+///
+/// @param[in] S
+///         The reduced matrix \f$S\f$ (Hessenberg or Schur).
+///
+/// @param[in] ldS
+///         The leading dimension of \f$S\f$.
+///
+/// @param[in] probes
+///         The number of random probe vectors.
+///
+/// @param[out] residual
+///         An estimate of \f$\|A - Q S Q^T\|_F / \|A\|_F\f$.
+///
+/// @param[out] orthogonality
+///         An estimate of \f$\|Q^T Q - I\|_F\f$.
+///
+/// @return @ref STARNEIG_SUCCESS (0) on success. Negative integer -i when i'th
+/// argument is invalid. Positive error code otherwise.
+///
+starneig_error_t starneig_SEP_SM_Validate(
+    int n,
+    double A[], int ldA,
+    double Q[], int ldQ,
+    double S[], int ldS,
+    int probes,
+    double *residual,
+    double *orthogonality);
+
 ///
 /// @}
 ///
@@ -190,7 +190,10 @@ starneig_distr_matrix_t starneig_blacs_descr_to_distr_matrix(
     }
 
     matrix->free_ptr = 0;
+    matrix->shared = NULL;
+    matrix->block_slots = NULL;
     matrix->datatype = type;
+    matrix->descr = DESCR_CACHE_EMPTY;
 
     return matrix;
 }
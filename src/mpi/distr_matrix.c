@@ -42,24 +42,200 @@
 #include "distr_matrix_internal.h"
 #include "node_internal.h"
 #include "utils.h"
+#include "shared_memory.h"
 #include "../common/common.h"
 #include "../common/node_internal.h"
 #include "../common/tasks.h"
+#include "../common/comm_stats.h"
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <malloc.h>
 #include <mpi.h>
 #include <starpu.h>
 #include <starpu_mpi.h>
 
-#define DESCR_CACHE_SIZE 100
+///
+/// @brief A rough estimate of the bookkeeping memory StarPU and StarPU-MPI need
+/// for each registered tile.
+///
+#define DESCR_CACHE_TILE_OVERHEAD 1024
+
+///
+/// @brief Default memory limit for the descriptor cache.
+///
+#define DESCR_CACHE_DEFAULT_LIMIT ((size_t) 1024*1024*1024)
 
+///
+/// @brief Descriptor cache entry. Each entry is a tiled view of a distributed
+/// matrix.
+///
+///  An entry is idle when its data handles have been acquired. This is the
+///  case between interface function calls. Only the idle entries can be
+///  evicted.
+///
 struct descr_cache_entry {
-    int in_use;
-    starneig_matrix_t descr;
+    starneig_distr_matrix_t matrix;     ///< distributed matrix
+    int bm;                             ///< tile height
+    int bn;                             ///< tile width
+    enum starneig_matrix_type fill;     ///< fill mode
+    starneig_matrix_t descr;            ///< matrix descriptor
+    size_t footprint;                   ///< estimated memory footprint
+    unsigned long last_use;             ///< time stamp of the latest use
+    struct descr_cache_entry *next;     ///< next entry of the same matrix
+    struct descr_cache_entry *lru_prev; ///< more recently used entry
+    struct descr_cache_entry *lru_next; ///< less recently used entry
+};
+
+static struct {
+    struct descr_cache_entry *lru_head; ///< most recently used entry
+    struct descr_cache_entry *lru_tail; ///< least recently used entry
+    size_t footprint;                   ///< total estimated memory footprint
+    size_t limit;                       ///< memory limit
+    unsigned long clock;                ///< time stamp counter
+    unsigned long idle_since;           ///< entries used after this are busy
+    long long hits;                     ///< number of cache hits
+    long long misses;                   ///< number of cache misses
+    long long evictions;                ///< number of evicted entries
+} descr_cache = {
+    .lru_head = NULL,
+    .lru_tail = NULL,
+    .footprint = 0,
+    .limit = DESCR_CACHE_DEFAULT_LIMIT,
+    .clock = 0,
+    .idle_since = 0,
+    .hits = 0,
+    .misses = 0,
+    .evictions = 0
 };
 
-static struct descr_cache_entry descr_cache[DESCR_CACHE_SIZE] = { 0 };
+static int entry_is_busy(struct descr_cache_entry const *entry)
+{
+    return descr_cache.idle_since < entry->last_use;
+}
+
+static void lru_unlink(struct descr_cache_entry *entry)
+{
+    if (entry->lru_prev != NULL)
+        entry->lru_prev->lru_next = entry->lru_next;
+    else
+        descr_cache.lru_head = entry->lru_next;
+
+    if (entry->lru_next != NULL)
+        entry->lru_next->lru_prev = entry->lru_prev;
+    else
+        descr_cache.lru_tail = entry->lru_prev;
+
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void lru_push_front(struct descr_cache_entry *entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = descr_cache.lru_head;
+    if (descr_cache.lru_head != NULL)
+        descr_cache.lru_head->lru_prev = entry;
+    else
+        descr_cache.lru_tail = entry;
+    descr_cache.lru_head = entry;
+}
+
+static void touch_entry(struct descr_cache_entry *entry)
+{
+    entry->last_use = ++descr_cache.clock;
+    lru_unlink(entry);
+    lru_push_front(entry);
+}
+
+///
+/// @brief Unregisters an idle cache entry and removes it from the cache.
+///
+/// @param[in,out] entry
+///         The cache entry.
+///
+static void destroy_entry(struct descr_cache_entry *entry)
+{
+    starneig_matrix_release(entry->descr);
+    starneig_matrix_unregister(entry->descr);
+    starneig_matrix_free(entry->descr);
+
+    struct descr_cache_entry **prev = &entry->matrix->descr;
+    while (*prev != entry)
+        prev = &(*prev)->next;
+    *prev = entry->next;
+
+    lru_unlink(entry);
+    descr_cache.footprint -= entry->footprint;
+
+    free(entry);
+}
+
+///
+/// @brief Evicts least recently used idle entries until the cache fits inside
+/// the memory limit.
+///
+static void evict_entries()
+{
+    struct descr_cache_entry *entry = descr_cache.lru_tail;
+    while (descr_cache.limit < descr_cache.footprint && entry != NULL) {
+        struct descr_cache_entry *prev = entry->lru_prev;
+        if (!entry_is_busy(entry)) {
+            starneig_verbose(
+                "Evicting a %d x %d tiled view from the descriptor cache.",
+                entry->bm, entry->bn);
+            destroy_entry(entry);
+            descr_cache.evictions++;
+        }
+        entry = prev;
+    }
+}
+
+///
+/// @brief Estimates the memory footprint of a tiled view.
+///
+///  Each registered tile carries a fixed bookkeeping overhead. In addition,
+///  StarPU-MPI allocates a bm x bn replica for each remote tile a rank
+///  touches. The replicas are bounded from above by the largest number of
+///  tiles some rank does not own. The estimate is therefore the same on all
+///  ranks and all ranks make identical eviction decisions.
+///
+/// @param[in] descr
+///         The matrix descriptor.
+///
+/// @param[in] bm
+///         The tile height.
+///
+/// @param[in] bn
+///         The tile width.
+///
+/// @param[in] elemsize
+///         The matrix element size.
+///
+/// @return The estimated memory footprint in bytes.
+///
+static size_t estimate_footprint(
+    starneig_matrix_t descr, int bm, int bn, size_t elemsize)
+{
+    int world_size;
+    MPI_Comm_size(starneig_mpi_get_comm(), &world_size);
+
+    int tile_rows = divceil(STARNEIG_MATRIX_M(descr), bm);
+    int tile_cols = divceil(STARNEIG_MATRIX_N(descr), bn);
+
+    int *owned = calloc(world_size, sizeof(int));
+    for (int i = 0; i < tile_rows; i++)
+        for (int j = 0; j < tile_cols; j++)
+            owned[starneig_matrix_get_tile_owner(i, j, descr)]++;
+
+    int min_owned = owned[0];
+    for (int i = 1; i < world_size; i++)
+        min_owned = MIN(min_owned, owned[i]);
+    free(owned);
+
+    size_t tiles = (size_t) tile_rows * tile_cols;
+    return tiles * DESCR_CACHE_TILE_OVERHEAD +
+        (tiles - min_owned) * bm * bn * elemsize;
+}
 
 struct block_cyclic_arg {
     int rows;
@@ -83,6 +259,79 @@ static int single_owner_func(int i, int j, void *arg)
     return * (int *) arg;
 }
 
+///
+/// @brief Allocates a local buffer for a distributed matrix.
+///
+/// @param[in] m
+///         The number of rows in the local buffer.
+///
+/// @param[in] n
+///         The number of columns in the local buffer.
+///
+/// @param[in] elemsize
+///         The matrix element size.
+///
+/// @param[in,out] matrix
+///         The distributed matrix. The fields ld and shared are set.
+///
+/// @return A pointer to the local buffer.
+///
+static void * alloc_local_buffer(
+    int m, int n, size_t elemsize, struct starneig_distr_matrix *matrix)
+{
+    matrix->shared = NULL;
+    if (starneig_mpi_shared_memory_enabled())
+        return starneig_mpi_alloc_shared_matrix(
+            m, n, elemsize, &matrix->ld, &matrix->shared);
+    return starneig_alloc_pinned_matrix(m, n, elemsize, &matrix->ld);
+}
+
+///
+/// @brief Returns a pointer to a distributed block that is owned either by the
+/// calling rank or by a co-located rank.
+///
+/// @param[in] i
+///         The block row index.
+///
+/// @param[in] j
+///         The block column index.
+///
+/// @param[in] owner
+///         The owner of the block.
+///
+/// @param[in] matrix
+///         The distributed matrix.
+///
+/// @param[out] ld
+///         Returns the leading dimension of the block.
+///
+/// @return A pointer to the block.
+///
+static double * get_block_ptr(
+    int i, int j, int owner, struct starneig_distr_matrix const *matrix,
+    size_t *ld)
+{
+    double *base;
+    if (owner == starneig_mpi_get_comm_rank()) {
+        base = matrix->ptr;
+        *ld = matrix->ld;
+    }
+    else {
+        base = starneig_mpi_shared_get_base(owner, matrix->shared, ld);
+    }
+
+    struct starneig_distr const *distr = matrix->distr;
+
+    if (distr->type == STARNEIG_DISTR_TYPE_2DBC_ROW ||
+    distr->type == STARNEIG_DISTR_TYPE_2DBC_COL)
+        return base + (j/distr->cols)*matrix->col_blksz*(*ld) +
+            (i/distr->rows)*matrix->row_blksz;
+
+    int block_cols = divceil(matrix->cols, matrix->col_blksz);
+    return base +
+        matrix->block_slots[i*block_cols+j]*matrix->col_blksz*(*ld);
+}
+
 starneig_matrix_t starneig_mpi_cache_convert(
     int bm, int bn, enum starneig_matrix_type fill,
     starneig_distr_matrix_t matrix, mpi_info_t mpi)
@@ -98,18 +347,48 @@ starneig_matrix_t starneig_mpi_cache_convert_and_release(
     int bm, int bn, enum starneig_matrix_type fill,
     starneig_distr_matrix_t matrix, mpi_info_t mpi)
 {
-    if (matrix->descr != DESCR_CACHE_EMPTY &&
-    descr_cache[matrix->descr].descr != NULL) {
-        struct descr_cache_entry *entry = &descr_cache[matrix->descr];
-        int _bm = STARNEIG_MATRIX_BM(entry->descr);
-        int _bn = STARNEIG_MATRIX_BN(entry->descr);
-        if (bm == _bm && bn == _bn) {
-            starneig_matrix_release(entry->descr);
+    //
+    // look for a matching tiled view
+    //
+
+    for (struct descr_cache_entry *entry = matrix->descr;
+    entry != NULL; entry = entry->next) {
+        // a FULL view registers all tiles with the matrix contents and would
+        // expose the lower part of an UPPER_* matrix as it is; the fill
+        // modes must therefore match exactly
+        if (entry->bm == bm && entry->bn == bn && entry->fill == fill) {
+            // the data handles are already released if the view is in use
+            if (!entry_is_busy(entry))
+                starneig_matrix_release(entry->descr);
+            touch_entry(entry);
+            descr_cache.hits++;
             return entry->descr;
         }
-        starneig_mpi_cache_remove(matrix);
     }
 
+    descr_cache.misses++;
+
+    struct descr_cache_entry *entry = matrix->descr;
+    while (entry != NULL) {
+        struct descr_cache_entry *next = entry->next;
+
+        // StarPU does not know that the views alias each other
+        if (entry_is_busy(entry))
+            starneig_fatal_error(
+                "A distributed matrix cannot be used with two different tile "
+                "sizes at the same time.");
+
+        // a view with the same tile size but a different fill mode is replaced
+        if (entry->bm == bm && entry->bn == bn)
+            destroy_entry(entry);
+
+        entry = next;
+    }
+
+    //
+    // create a new tiled view
+    //
+
     starneig_matrix_t descr = starneig_matrix_init(
         matrix->rows, matrix->cols, bm, bn,
         matrix->row_blksz / bm, matrix->col_blksz / bn,
@@ -124,52 +403,62 @@ starneig_matrix_t starneig_mpi_cache_convert_and_release(
             matrix->blocks[i].glo_col / matrix->col_blksz,
             matrix->blocks[i].ld, matrix->blocks[i].ptr, descr);
 
-    if (matrix->descr != DESCR_CACHE_EMPTY) {
-        descr_cache[matrix->descr].descr = descr;
-        return descr;
-    }
-    else {
-        for (int i = 0; i < DESCR_CACHE_SIZE; i++) {
-            if (!descr_cache[i].in_use) {
-                descr_cache[i].in_use = 1;
-                descr_cache[i].descr = descr;
-                matrix->descr = i;
-                return descr;
-            }
-        }
-    }
+    entry = malloc(sizeof(struct descr_cache_entry));
+    entry->matrix = matrix;
+    entry->bm = bm;
+    entry->bn = bn;
+    entry->fill = fill;
+    entry->descr = descr;
+    entry->footprint = estimate_footprint(
+        descr, bm, bn, starneig_distr_matrix_get_elemsize(matrix));
+    entry->lru_prev = entry->lru_next = NULL;
+
+    entry->next = matrix->descr;
+    matrix->descr = entry;
 
-    starneig_fatal_error(
-        "Maximum number of concurrent distributed matrices reached.");
-    return NULL;
+    lru_push_front(entry);
+    entry->last_use = ++descr_cache.clock;
+    descr_cache.footprint += entry->footprint;
+
+    evict_entries();
+
+    return descr;
 }
 
 void starneig_mpi_cache_remove(starneig_distr_matrix_t matrix)
 {
-    if (matrix->descr == DESCR_CACHE_EMPTY)
-        return;
-
-    if (descr_cache[matrix->descr].descr != NULL) {
-        starneig_matrix_release(descr_cache[matrix->descr].descr);
-        starneig_matrix_unregister(descr_cache[matrix->descr].descr);
-        starneig_matrix_free(descr_cache[matrix->descr].descr);
-    }
-    descr_cache[matrix->descr].in_use = 0;
-    descr_cache[matrix->descr].descr = NULL;
+    while (matrix->descr != DESCR_CACHE_EMPTY)
+        destroy_entry(matrix->descr);
+}
 
-    matrix->descr = DESCR_CACHE_EMPTY;
+void starneig_mpi_cache_trim()
+{
+    // the interface functions have acquired their descriptors by now
+    descr_cache.idle_since = descr_cache.clock;
+    evict_entries();
 }
 
 void starneig_mpi_cache_clear()
 {
-    for (int i = 0; i < DESCR_CACHE_SIZE; i++) {
-        if (descr_cache[i].in_use && descr_cache[i].descr != NULL) {
-            starneig_matrix_release(descr_cache[i].descr);
-            starneig_matrix_unregister(descr_cache[i].descr);
-            starneig_matrix_free(descr_cache[i].descr);
-        }
-        descr_cache[i].descr = NULL;
-    }
+    while (descr_cache.lru_head != NULL)
+        destroy_entry(descr_cache.lru_head);
+    descr_cache.idle_since = descr_cache.clock;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_set_descr_cache_limit(size_t limit)
+{
+    descr_cache.limit = limit;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_get_descr_cache_stats(
+    struct starneig_descr_cache_stats *stats)
+{
+    stats->hits = descr_cache.hits;
+    stats->misses = descr_cache.misses;
+    stats->evictions = descr_cache.evictions;
+    stats->footprint = descr_cache.footprint;
 }
 
 __attribute__ ((visibility ("default")))
@@ -304,6 +593,7 @@ starneig_distr_matrix_t starneig_distr_matrix_create(
 
     matrix->row_blksz = row_blksz;
     matrix->col_blksz = col_blksz;
+    matrix->block_slots = NULL;
 
     if (distr->type == STARNEIG_DISTR_TYPE_2DBC_ROW ||
     distr->type == STARNEIG_DISTR_TYPE_2DBC_COL) {
@@ -332,10 +622,10 @@ starneig_distr_matrix_t starneig_distr_matrix_create(
             1.0E-6 * local_block_rows*row_blksz *
             local_block_cols*col_blksz * elemsize);
 
-        matrix->ptr = starneig_alloc_pinned_matrix(
+        matrix->ptr = alloc_local_buffer(
             local_block_rows*row_blksz,
             local_block_cols*col_blksz,
-            elemsize, &matrix->ld);
+            elemsize, matrix);
 
         starneig_verbose("Allocated %.0f MB for a local buffer.",
             1.0E-6 * matrix->ld*local_block_cols*col_blksz*elemsize);
@@ -374,8 +664,18 @@ starneig_distr_matrix_t starneig_distr_matrix_create(
         matrix->blocks =
             malloc(block_count*sizeof(struct starneig_distr_block));
 
-        matrix->ptr = starneig_alloc_pinned_matrix(
-            row_blksz, block_count*col_blksz, elemsize, &matrix->ld);
+        matrix->ptr = alloc_local_buffer(
+            row_blksz, block_count*col_blksz, elemsize, matrix);
+
+        // the blocks of each rank are stored in row-major order; the block
+        // slots allow the co-located ranks to locate each other's blocks
+        int *counts = calloc(world_size, sizeof(int));
+        matrix->block_slots = malloc(block_rows*block_cols*sizeof(int));
+        for (int i = 0; i < block_rows; i++)
+            for (int j = 0; j < block_cols; j++)
+                matrix->block_slots[i*block_cols+j] =
+                    counts[distr->func(i, j, distr->arg)]++;
+        free(counts);
 
         int k = 0;
         for (int i = 0; i < block_rows; i++) {
@@ -428,6 +728,8 @@ starneig_distr_matrix_t starneig_distr_matrix_create_local(
     matrix->ptr = A;
     matrix->ld = ldA;
     matrix->free_ptr = 0;
+    matrix->shared = NULL;
+    matrix->block_slots = calloc(1, sizeof(int));
     matrix->datatype = type;
     matrix->descr = DESCR_CACHE_EMPTY;
 
@@ -444,7 +746,10 @@ void starneig_distr_matrix_destroy(starneig_distr_matrix_t matrix)
 
     starneig_distr_destroy(matrix->distr);
     free(matrix->blocks);
-    if (matrix->free_ptr)
+    free(matrix->block_slots);
+    if (matrix->shared != NULL)
+        starneig_mpi_free_shared_matrix(matrix->shared);
+    else if (matrix->free_ptr)
         starneig_free_pinned_matrix(matrix->ptr);
     free(matrix);
 }
@@ -460,6 +765,90 @@ void starneig_distr_matrix_copy(
         source, dest);
 }
 
+///
+/// @brief Processes a region copy block-by-block.
+///
+///  The region is split into pieces that fall within a single source block
+///  and a single destination block. If the owners of a piece are not
+///  co-located, the piece is copied with StarPU tasks. Otherwise, the owner of
+///  the destination block copies the piece directly from the source block.
+///
+/// @param[in] sr, sc, dr, dc, rows, cols
+///         The region (see starneig_distr_matrix_copy_region()).
+///
+/// @param[in] colocated
+///         If zero, StarPU tasks are inserted for the pieces that have
+///         non-co-located owners. If non-zero, the pieces that have
+///         co-located owners are copied directly.
+///
+/// @param[in] source, dest
+///         The source and destination matrices.
+///
+/// @param[in,out] source_descr, dest_descr
+///         The source and destination matrix descriptors.
+///
+/// @param[in,out] mpi
+///         MPI info.
+///
+static void process_copy_pieces(
+    int sr, int sc, int dr, int dc, int rows, int cols, int colocated,
+    starneig_distr_matrix_t source, starneig_distr_matrix_t dest,
+    starneig_matrix_t source_descr, starneig_matrix_t dest_descr,
+    mpi_info_t mpi)
+{
+    int my_rank = starneig_mpi_get_comm_rank();
+    size_t elemsize = starneig_distr_matrix_get_elemsize(dest);
+
+    for (int i = 0; i < rows; ) {
+        int sbi = (sr+i) / source->row_blksz;
+        int dbi = (dr+i) / dest->row_blksz;
+        int height = MIN(rows-i, MIN(
+            (sbi+1)*source->row_blksz - (sr+i),
+            (dbi+1)*dest->row_blksz - (dr+i)));
+
+        for (int j = 0; j < cols; ) {
+            int sbj = (sc+j) / source->col_blksz;
+            int dbj = (dc+j) / dest->col_blksz;
+            int width = MIN(cols-j, MIN(
+                (sbj+1)*source->col_blksz - (sc+j),
+                (dbj+1)*dest->col_blksz - (dc+j)));
+
+            int source_owner =
+                source->distr->func(sbi, sbj, source->distr->arg);
+            int dest_owner =
+                dest->distr->func(dbi, dbj, dest->distr->arg);
+
+            int is_colocated = starneig_mpi_shared_colocated(
+                source_owner, dest_owner, source->shared);
+
+            if (!colocated && !is_colocated) {
+                starneig_insert_copy_matrix(
+                    sr+i, sc+j, dr+i, dc+j, height, width,
+                    STARPU_MAX_PRIO, source_descr, dest_descr, mpi);
+            }
+
+            if (colocated && is_colocated && dest_owner == my_rank) {
+                size_t lds, ldd;
+                double const *S =
+                    get_block_ptr(sbi, sbj, source_owner, source, &lds);
+                double *D = get_block_ptr(dbi, dbj, dest_owner, dest, &ldd);
+
+                S += (sc+j - sbj*source->col_blksz)*lds +
+                    sr+i - sbi*source->row_blksz;
+                D += (dc+j - dbj*dest->col_blksz)*ldd +
+                    dr+i - dbi*dest->row_blksz;
+
+                for (int k = 0; k < width; k++)
+                    memcpy(D+k*ldd, S+k*lds, height*elemsize);
+            }
+
+            j += width;
+        }
+
+        i += height;
+    }
+}
+
 __attribute__ ((visibility ("default")))
 void starneig_distr_matrix_copy_region(
     int sr, int sc, int dr, int dc, int rows, int cols,
@@ -488,6 +877,10 @@ void starneig_distr_matrix_copy_region(
             source_tile_size, source_tile_size, MATRIX_TYPE_FULL,
             source, mpi);
 
+    // the co-located ranks can copy the blocks directly if the source matrix
+    // resides in a shared memory window
+    int shared = source != dest && source->shared != NULL;
+
     // A machine may run out of memory when copying a large matrix. This should
     // keep things under control.
     int splice = divceil(8192, dest->col_blksz)*dest->col_blksz;
@@ -495,20 +888,33 @@ void starneig_distr_matrix_copy_region(
         int begin = MAX(dc, i);
         int end = MIN(dc+cols, i+splice);
 
-        starneig_insert_copy_matrix(
-            sr, begin + sc - dc, dr, begin, rows, end-begin,
-            STARPU_MAX_PRIO, source_descr, dest_descr, mpi);
+        if (shared)
+            process_copy_pieces(
+                sr, begin + sc - dc, dr, begin, rows, end-begin, 0,
+                source, dest, source_descr, dest_descr, mpi);
+        else
+            starneig_insert_copy_matrix(
+                sr, begin + sc - dc, dr, begin, rows, end-begin,
+                STARPU_MAX_PRIO, source_descr, dest_descr, mpi);
 
         starpu_task_wait_for_all();
-        starpu_mpi_barrier(starneig_mpi_get_comm());
+        starneig_comm_stats_barrier();
     }
 
     starneig_matrix_acquire(dest_descr);
     starneig_matrix_acquire(source_descr);
 
     starpu_task_wait_for_all();
+
+    if (shared) {
+        // all co-located ranks must have acquired the source matrix
+        starneig_mpi_shared_sync(source->shared);
+        process_copy_pieces(sr, sc, dr, dc, rows, cols, 1,
+            source, dest, source_descr, dest_descr, mpi);
+    }
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -42,14 +42,15 @@
 #include <starneig/configuration.h>
 #include <starneig/distr_matrix.h>
 #include "../common/matrix.h"
+#include "shared_memory.h"
 #include <stddef.h>
 
 ///
-/// @brief Descriptor cache entry index.
+/// @brief Descriptor cache entry list (one entry per tile size).
 ///
-typedef int descr_cache_entry_t;
+typedef struct descr_cache_entry * descr_cache_entry_t;
 
-#define DESCR_CACHE_EMPTY -1
+#define DESCR_CACHE_EMPTY NULL
 
 ///
 /// @brief Data distribution structure
@@ -100,9 +101,14 @@ struct starneig_distr_matrix {
     size_t ld;
     /// If non-zero, the local buffer gets freed when the matrix is destroyed.
     int free_ptr;
+    /// The shared memory segment the local buffer belongs to (or NULL).
+    struct starneig_shared_segment *shared;
+    /// The position of each distributed block (row-major order) inside the
+    /// local buffer of its owner (function-based distributions only).
+    int *block_slots;
     /// The matrix element data type.
     starneig_datatype_t datatype;
-    /// Descriptor cache entry.
+    /// Descriptor cache entries.
     descr_cache_entry_t descr;
 };
 
@@ -177,6 +183,13 @@ starneig_matrix_t starneig_mpi_cache_convert_and_release(
 ///
 void starneig_mpi_cache_remove(starneig_distr_matrix_t matrix);
 
+///
+/// @brief Marks all cache entries idle and evicts the least recently used
+/// entries until the cache fits inside the memory limit. Should be called only
+/// when all cached descriptors have been acquired.
+///
+void starneig_mpi_cache_trim();
+
 ///
 /// @brief Clears the descriptor cache.
 ///
@@ -45,131 +45,103 @@
 #include "../common/utils.h"
 #include "../common/tasks.h"
 #include "../common/node_internal.h"
+#include "../common/comm_stats.h"
+#include "../common/validation.h"
 #include <starpu_mpi.h>
 #include <stddef.h>
+#include <limits.h>
 #include <math.h>
 
-#define SELECT(val,i) { if (0 <= (i) && (i) < size) selected[i] = val; }
+static void select_eigenvalues(
+    starneig_distr_matrix_t S, starneig_distr_matrix_t T,
+    struct starneig_select_predicate const *predicate,
+    int selected[], int *num_selected)
+{
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_SEQUENTIAL);
+    starneig_node_set_mode(STARNEIG_MODE_DM);
+    starneig_mpi_start_starpumpi();
+    starneig_node_resume_starpu();
+
+    int m = starneig_distr_matrix_get_rows(S);
+
+    mpi_info_t mpi = starneig_mpi_get_info();
+
+    int tile_size = starneig_mpi_find_valid_tile_size(128, S, T, NULL, NULL);
+
+    starneig_matrix_t S_d = starneig_mpi_cache_convert_and_release(
+        tile_size, tile_size, MATRIX_TYPE_UPPER_HESSENBERG, S, mpi);
+
+    starneig_matrix_t T_d = NULL;
+    if (T != NULL)
+        T_d = starneig_mpi_cache_convert_and_release(
+            tile_size, tile_size, MATRIX_TYPE_UPPER_TRIANGULAR, T, mpi);
+
+    starneig_vector_t selected_d = starneig_init_matching_vector_descr(
+        S_d, sizeof(int), selected, mpi);
+
+    starneig_select_eigenvalues(
+        STARPU_MAX_PRIO, predicate, S_d, T_d, selected_d, mpi);
+
+    starneig_matrix_acquire(S_d);
+    starneig_matrix_acquire(T_d);
+
+    // the locally owned tiles are written back to the selection array
+    starneig_vector_unregister(selected_d);
+
+    // mask the tiles that are owned by other MPI ranks
+    int my_rank = starneig_mpi_get_comm_rank();
+    int bm = starneig_vector_get_tile_size(selected_d);
+    for (int i = 0; i < divceil(m, bm); i++)
+        if (starneig_vector_get_tile_owner(i, selected_d) != my_rank)
+            for (int j = i*bm; j < MIN(m, (i+1)*bm); j++)
+                selected[j] = INT_MIN;
+
+    starneig_vector_free(selected_d);
+
+    starpu_task_wait_for_all();
+    starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
+
+    starneig_node_pause_starpu();
+    starneig_mpi_stop_starpumpi();
+    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
-typedef int (*sep_func_t)(double real, double imag, void *arg);
+    // distribute the selection array with a single collective operation
+    MPI_Allreduce(
+        MPI_IN_PLACE, selected, m, MPI_INT, MPI_MAX, starneig_mpi_get_comm());
+
+    int _num_selected = starneig_select_eigenvalues_finalize(m, selected);
+    if (num_selected != NULL)
+        *num_selected = _num_selected;
+}
 
 struct sep_args {
-    sep_func_t predicate;
+    int (*predicate)(double real, double imag, void *arg);
     void *arg;
 };
 
 static void apply_predicate_sep(
-    int size, int rbegin, int cbegin, int m, int n, int ldS, int ldT,
-    void const *_arg, void const *_S, void const *_T, void **masks)
+    int count, double const real[], double const imag[], int selected[],
+    void *_arg)
 {
-    struct sep_args const *predicate_arg = _arg;
-    sep_func_t predicate = predicate_arg->predicate;
-    void *arg = predicate_arg->arg;
-
-    double const *S = _S;
-    int *selected = masks[0];
-
-    int begin = 0 < rbegin && 0 < cbegin ? -1 : 0;
-    int end = rbegin+size < m && cbegin+size < n ? size+1 : size;
-
-    for (int i = begin; i < end; i++) {
-
-        //
-        // 2-by-2 block
-        //
-        if (i+1 < m && i+1 < n && S[(size_t)(cbegin+i)*ldS+rbegin+i+1] != 0.0) {
-            double real1, imag1, real2, imag2;
-            starneig_compute_complex_eigenvalue(
-                ldS, 0, &S[(cbegin+i)*ldS + rbegin+i], NULL,
-                &real1, &imag1, &real2, &imag2,
-                NULL, NULL);
-
-            if (predicate(real1, imag1, arg)) {
-                SELECT(1, i);
-                SELECT(1, i+1);
-            }
-            else {
-                SELECT(0, i);
-                SELECT(0, i+1);
-            }
-
-            i++;
-        }
-
-        //
-        // 1-by-1 block
-        //
-        else {
-            double __S = S[(size_t)(cbegin+i)*ldS+rbegin+i];
-            if (predicate(__S, 0.0, arg)) {
-                SELECT(1, i);
-            }
-            else {
-                SELECT(0, i);
-            }
-        }
-    }
+    struct sep_args const *arg = _arg;
+    for (int i = 0; i < count; i++)
+        selected[i] = arg->predicate(real[i], imag[i], arg->arg);
 }
 
-typedef int (*gep_func_t)(double real, double imag, double beta, void *arg);
-
 struct gep_args {
-    gep_func_t predicate;
+    int (*predicate)(double real, double imag, double beta, void *arg);
     void *arg;
 };
 
 static void apply_predicate_gep(
-    int size, int rbegin, int cbegin, int m, int n, int ldS, int ldT,
-    void const *_arg, void const *_S, void const *_T, void **masks)
+    int count, double const real[], double const imag[], double const beta[],
+    int selected[], void *_arg)
 {
-    struct gep_args const *predicate_arg = _arg;
-    gep_func_t predicate = predicate_arg->predicate;
-    void *arg = predicate_arg->arg;
-
-    double const *S = _S;
-    double const *T = _T;
-    int *selected = masks[0];
-
-    int begin = 0 < rbegin && 0 < cbegin ? -1 : 0;
-    int end = rbegin+size < m && cbegin+size < n ? size+1 : size;
-
-    for (int i = begin; i < end; i++) {
-
-        //
-        // 2-by-2 block
-        //
-        if (i+1 < m && i+1 < n && S[(size_t)(cbegin+i)*ldS+rbegin+i+1] != 0.0) {
-            double real1, imag1, real2, imag2, beta1, beta2;
-            starneig_compute_complex_eigenvalue(ldS, ldT,
-                &S[(cbegin+i)*ldS + rbegin+i], &T[(cbegin+i)*ldT + rbegin+i],
-                &real1, &imag1, &real2, &imag2, &beta1, &beta2);
-
-            if (predicate(real1, imag1, beta1, arg)) {
-                SELECT(1, i);
-                SELECT(1, i+1);
-            }
-            else {
-                SELECT(0, i);
-                SELECT(0, i+1);
-            }
-
-            i++;
-        }
-
-        //
-        // 1-by-1 block
-        //
-        else {
-            double __S = S[(size_t)(cbegin+i)*ldS+rbegin+i];
-            double __T = T[(size_t)(cbegin+i)*ldT+rbegin+i];
-            if (predicate(__S, 0.0, __T, arg)) {
-                SELECT(1, i);
-            }
-            else {
-                SELECT(0, i);
-            }
-        }
-    }
+    struct gep_args const *arg = _arg;
+    for (int i = 0; i < count; i++)
+        selected[i] = arg->predicate(real[i], imag[i], beta[i], arg->arg);
 }
 
 __attribute__ ((visibility ("default")))
@@ -183,6 +155,65 @@ starneig_error_t starneig_SEP_DM_Select(
     if (S == NULL)          return -1;
     if (predicate == NULL)  return -2;
 
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
+
+    struct sep_args args = {
+        .predicate = predicate,
+        .arg = arg
+    };
+
+    struct starneig_select_predicate _predicate = {
+        .sep = apply_predicate_sep,
+        .gep = NULL,
+        .arg = &args
+    };
+
+    select_eigenvalues(S, NULL, &_predicate, selected, num_selected);
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_SEP_DM_Select_batched(
+    starneig_distr_matrix_t S,
+    void (*predicate)(int count, double const real[], double const imag[],
+        int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected)
+{
+    if (S == NULL)          return -1;
+    if (predicate == NULL)  return -2;
+
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
+
+    struct starneig_select_predicate _predicate = {
+        .sep = predicate,
+        .gep = NULL,
+        .arg = arg
+    };
+
+    select_eigenvalues(S, NULL, &_predicate, selected, num_selected);
+
+    return STARNEIG_SUCCESS;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_SEP_DM_Validate(
+    starneig_distr_matrix_t A,
+    starneig_distr_matrix_t Q,
+    starneig_distr_matrix_t S,
+    int probes,
+    double *residual,
+    double *orthogonality)
+{
+    if (A == NULL)          return -1;
+    if (Q == NULL)          return -2;
+    if (S == NULL)          return -3;
+    if (probes < 1)         return -4;
+
     if (!starneig_node_initialized())
         return STARNEIG_NOT_INITIALIZED;
 
@@ -191,49 +222,40 @@ starneig_error_t starneig_SEP_DM_Select(
     starneig_mpi_start_starpumpi();
     starneig_node_resume_starpu();
 
-    int m = starneig_distr_matrix_get_rows(S);
-
     mpi_info_t mpi = starneig_mpi_get_info();
 
-    int tile_size = starneig_mpi_find_valid_tile_size(128, S, NULL, NULL, NULL);
-    starneig_matrix_t S_d = starneig_mpi_cache_convert_and_release(
-        tile_size, tile_size, MATRIX_TYPE_UPPER_HESSENBERG, S, mpi);
-
-    starneig_vector_t selected_d = starneig_init_matching_vector_descr(
-        S_d, sizeof(int), selected, mpi);
-
-    struct sep_args args = {
-        .predicate = predicate,
-        .arg = arg,
-    };
+    int tile_size = starneig_mpi_find_valid_tile_size(512, A, S, Q, NULL);
+    if (tile_size < 8) {
+        starneig_error("Cannot find a valid tile size. Exiting...");
+        starneig_node_pause_starpu();
+        starneig_mpi_stop_starpumpi();
+        starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
+        return STARNEIG_INVALID_DISTR_MATRIX;
+    }
 
-    starneig_insert_scan_diagonal(
-        0, m, 0, 1, 1, 1, 1, STARPU_MAX_PRIO, apply_predicate_sep,
-        &args, S_d, NULL, mpi, selected_d, NULL);
+    starneig_matrix_t A_d = starneig_mpi_cache_convert_and_release(
+        tile_size, tile_size, MATRIX_TYPE_FULL, A, mpi);
+    starneig_matrix_t Q_d = starneig_mpi_cache_convert_and_release(
+        tile_size, tile_size, MATRIX_TYPE_FULL, Q, mpi);
+    starneig_matrix_t S_d = starneig_mpi_cache_convert_and_release(
+        tile_size, tile_size, MATRIX_TYPE_FULL, S, mpi);
 
-    int world_size = starneig_mpi_get_comm_size();
-    for (int i = 0; i < world_size; i++)
-        starneig_vector_gather(i, selected_d);
+    starneig_validate_factorization(
+        probes, A_d, Q_d, S_d, mpi, residual, orthogonality);
 
+    starneig_matrix_acquire(A_d);
+    starneig_matrix_acquire(Q_d);
     starneig_matrix_acquire(S_d);
 
-    starneig_vector_unregister(selected_d);
-    starneig_vector_free(selected_d);
-
     starpu_task_wait_for_all();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
-    if (num_selected != NULL) {
-        *num_selected = 0;
-        for (int i = 0; i < m; i++)
-            if (selected[i]) (*num_selected)++;
-    }
-
     return STARNEIG_SUCCESS;
 }
 
@@ -253,58 +275,46 @@ starneig_error_t starneig_GEP_DM_Select(
     if (!starneig_node_initialized())
         return STARNEIG_NOT_INITIALIZED;
 
-    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_SEQUENTIAL);
-    starneig_node_set_mode(STARNEIG_MODE_DM);
-    starneig_mpi_start_starpumpi();
-    starneig_node_resume_starpu();
-
-    int m = starneig_distr_matrix_get_rows(S);
-
-    mpi_info_t mpi = starneig_mpi_get_info();
-
-    int tile_size = starneig_mpi_find_valid_tile_size(128, S, T, NULL, NULL);
-
-    starneig_matrix_t S_d = starneig_mpi_cache_convert_and_release(
-        tile_size, tile_size, MATRIX_TYPE_UPPER_HESSENBERG, S, mpi);
-
-    starneig_matrix_t T_d = starneig_mpi_cache_convert_and_release(
-        tile_size, tile_size, MATRIX_TYPE_UPPER_TRIANGULAR, T, mpi);
-
-    starneig_vector_t selected_d = starneig_init_matching_vector_descr(
-        S_d, sizeof(int), selected, mpi);
-
     struct gep_args args = {
         .predicate = predicate,
-        .arg = arg,
+        .arg = arg
     };
 
-    starneig_insert_scan_diagonal(
-        0, m, 0, 1, 1, 1, 1, STARPU_MAX_PRIO, apply_predicate_gep,
-        &args, S_d, T_d, mpi, selected_d, NULL);
+    struct starneig_select_predicate _predicate = {
+        .sep = NULL,
+        .gep = apply_predicate_gep,
+        .arg = &args
+    };
 
-    int world_size = starneig_mpi_get_comm_size();
-    for (int i = 0; i < world_size; i++)
-        starneig_vector_gather(i, selected_d);
+    select_eigenvalues(S, T, &_predicate, selected, num_selected);
 
-    starneig_matrix_acquire(S_d);
-    starneig_matrix_acquire(T_d);
+    return STARNEIG_SUCCESS;
+}
 
-    starneig_vector_unregister(selected_d);
-    starneig_vector_free(selected_d);
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_GEP_DM_Select_batched(
+    starneig_distr_matrix_t S,
+    starneig_distr_matrix_t T,
+    void (*predicate)(int count, double const real[], double const imag[],
+        double const beta[], int selected[], void *arg),
+    void *arg,
+    int selected[],
+    int *num_selected)
+{
+    if (S == NULL)          return -1;
+    if (T == NULL)          return -2;
+    if (predicate == NULL)  return -3;
 
-    starpu_task_wait_for_all();
-    starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    if (!starneig_node_initialized())
+        return STARNEIG_NOT_INITIALIZED;
 
-    starneig_node_pause_starpu();
-    starneig_mpi_stop_starpumpi();
-    starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
+    struct starneig_select_predicate _predicate = {
+        .sep = NULL,
+        .gep = predicate,
+        .arg = arg
+    };
 
-    if (num_selected != NULL) {
-        *num_selected = 0;
-        for (int i = 0; i < m; i++)
-            if (selected[i]) (*num_selected)++;
-    }
+    select_eigenvalues(S, T, &_predicate, selected, num_selected);
 
     return STARNEIG_SUCCESS;
 }
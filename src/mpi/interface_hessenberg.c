@@ -43,6 +43,10 @@
 #include <starneig/gep_dm.h>
 #include "../common/node_internal.h"
 #include "../common/utils.h"
+#include "../common/comm_stats.h"
+#include "../common/trace.h"
+#include "../common/progress.h"
+#include "../common/dry_run.h"
 #include "../mpi/utils.h"
 #include "../mpi/node_internal.h"
 #include "../hessenberg/core.h"
@@ -116,22 +120,28 @@ static starneig_error_t hessenberg_mpi(
         starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, A, mpi);
+    STARNEIG_EVENT_SET_LABEL(A_d, 'A');
 
     starneig_matrix_t Q_d = NULL;
     if (Q != NULL)
         Q_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, Q, mpi);
+    STARNEIG_EVENT_SET_LABEL(Q_d, 'Q');
 
     //
     // insert tasks
     //
 
+    starneig_dry_run_begin(mpi);
+
     starneig_error_t err = starneig_hessenberg_insert_tasks(
         conf->panel_width, begin, end,
         STARPU_MAX_PRIO, STARPU_DEFAULT_PRIO, STARPU_MIN_PRIO,
         Q_d, A_d, false, mpi);
 
+    starneig_dry_run_end();
+
     //
     // finalize
     //
@@ -164,12 +174,18 @@ starneig_error_t starneig_SEP_DM_Hessenberg_expert(
     starneig_mpi_start_starpumpi();
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("hessenberg");
+    starneig_progress_begin("hessenberg");
+
     starneig_error_t ret = hessenberg_mpi(
         conf, begin, end, Q, A);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
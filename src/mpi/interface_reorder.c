@@ -41,6 +41,9 @@
 #include <starneig/gep_dm.h>
 #include "../common/utils.h"
 #include "../common/node_internal.h"
+#include "../common/comm_stats.h"
+#include "../common/trace.h"
+#include "../common/progress.h"
 #include "../mpi/utils.h"
 #include "../mpi/node_internal.h"
 #include "../reorder/common.h"
@@ -113,24 +116,28 @@ starneig_error_t reorder_mpi(
         starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_UPPER_HESSENBERG, A, mpi);
+    STARNEIG_EVENT_SET_LABEL(A_d, 'A');
 
     starneig_matrix_t B_d = NULL;
     if (B != NULL)
         B_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_UPPER_TRIANGULAR, B, mpi);
+    STARNEIG_EVENT_SET_LABEL(B_d, 'B');
 
     starneig_matrix_t Q_d = NULL;
     if (Q != NULL)
         Q_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, Q, mpi);
+    STARNEIG_EVENT_SET_LABEL(Q_d, 'Q');
 
     starneig_matrix_t Z_d = NULL;
     if (Z != NULL)
         Z_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, Z, mpi);
+    STARNEIG_EVENT_SET_LABEL(Z_d, 'Z');
 
     starneig_vector_t selected_d = starneig_init_matching_vector_descr(
         A_d, sizeof(int), selected, mpi);
@@ -238,12 +245,18 @@ starneig_error_t starneig_SEP_DM_ReorderSchur_expert(
 
     mpi_info_t mpi = starneig_mpi_get_info();
 
+    starneig_trace_phase_begin("reorder");
+    starneig_progress_begin("reorder");
+
     starneig_error_t ret = reorder_mpi(
         conf, selected, Q, NULL, S, NULL, real, imag, NULL, mpi);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -296,12 +309,18 @@ starneig_error_t starneig_GEP_DM_ReorderSchur_expert(
 
     mpi_info_t mpi = starneig_mpi_get_info();
 
+    starneig_trace_phase_begin("reorder");
+    starneig_progress_begin("reorder");
+
     starneig_error_t ret = reorder_mpi(
         conf, selected, Q, Z, S, T, real, imag, beta, mpi);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -43,6 +43,9 @@
 #include <starneig/gep_dm.h>
 #include "../common/node_internal.h"
 #include "../common/utils.h"
+#include "../common/comm_stats.h"
+#include "../common/trace.h"
+#include "../common/progress.h"
 #include "../mpi/utils.h"
 #include "../mpi/node_internal.h"
 #include "../schur/core.h"
@@ -112,24 +115,28 @@ static starneig_error_t schur_mpi(
         starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, A, mpi);
+    STARNEIG_EVENT_SET_LABEL(A_d, 'A');
 
     starneig_matrix_t B_d = NULL;
     if (B != NULL)
         B_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, B, mpi);
+    STARNEIG_EVENT_SET_LABEL(B_d, 'B');
 
     starneig_matrix_t Q_d = NULL;
     if (Q != NULL)
         Q_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, Q, mpi);
+    STARNEIG_EVENT_SET_LABEL(Q_d, 'Q');
 
     starneig_matrix_t Z_d = NULL;
     if (Z != NULL)
         Z_d = starneig_mpi_cache_convert_and_release(
             conf->tile_size, conf->tile_size,
             MATRIX_TYPE_FULL, Z, mpi);
+    STARNEIG_EVENT_SET_LABEL(Z_d, 'Z');
 
     starneig_vector_t real_d = NULL;
     if (real != NULL)
@@ -206,12 +213,18 @@ starneig_error_t starneig_SEP_DM_Schur_expert(
 
     mpi_info_t mpi = starneig_mpi_get_info();
 
+    starneig_trace_phase_begin("schur");
+    starneig_progress_begin("schur");
+
     starneig_error_t ret = schur_mpi(
         conf, Q, NULL, H, NULL, real, imag, NULL, mpi);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -259,12 +272,18 @@ starneig_error_t starneig_GEP_DM_Schur_expert(
 
     mpi_info_t mpi = starneig_mpi_get_info();
 
+    starneig_trace_phase_begin("schur");
+    starneig_progress_begin("schur");
+
     starneig_error_t ret = schur_mpi(
         conf, Q, Z, H, T, real, imag, beta, mpi);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -0,0 +1,392 @@
+///
+/// @file
+///
+/// @brief This file contains the MPI-IO functions that read and write
+/// distributed matrices in the raw matrix format.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/distr_matrix.h>
+#include <starneig/distr_helpers.h>
+#include "distr_matrix_internal.h"
+#include "../common/common.h"
+#include "../common/raw_format.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+
+///
+/// @brief A contiguous column segment of a distributed block.
+///
+struct segment {
+    MPI_Aint file_disp;     ///< displacement inside the file (bytes)
+    MPI_Aint mem_addr;      ///< memory address
+    int length;             ///< number of matrix elements
+};
+
+static int compare_segments(void const *a, void const *b)
+{
+    MPI_Aint x = ((struct segment const *) a)->file_disp;
+    MPI_Aint y = ((struct segment const *) b)->file_disp;
+    return (x > y) - (x < y);
+}
+
+///
+/// @brief Builds the file and memory datatypes that cover the locally owned
+/// distributed blocks.
+///
+///  The column segments are sorted by their file displacements since an MPI
+///  file view must be monotonically non-decreasing.
+///
+/// @param[in] matrix
+///         The distributed matrix.
+///
+/// @param[out] filetype
+///         Returns the file datatype.
+///
+/// @param[out] memtype
+///         Returns the memory datatype (absolute addresses, use with
+///         MPI_BOTTOM).
+///
+static void build_datatypes(
+    starneig_distr_matrix_t matrix, MPI_Datatype *filetype,
+    MPI_Datatype *memtype)
+{
+    int count = 0;
+    for (int k = 0; k < matrix->block_count; k++)
+        count += matrix->blocks[k].col_blksz;
+
+    struct segment *segments = malloc(MAX(1, count)*sizeof(struct segment));
+
+    int l = 0;
+    for (int k = 0; k < matrix->block_count; k++) {
+        struct starneig_distr_block const *block = &matrix->blocks[k];
+        for (int i = 0; i < block->col_blksz; i++) {
+            segments[l].file_disp = sizeof(double) * (
+                (MPI_Aint) (block->glo_col+i)*matrix->rows + block->glo_row);
+            MPI_Get_address(
+                (double *) block->ptr + (size_t) i*block->ld,
+                &segments[l].mem_addr);
+            segments[l].length = block->row_blksz;
+            l++;
+        }
+    }
+
+    qsort(segments, count, sizeof(struct segment), &compare_segments);
+
+    int *lengths = malloc(MAX(1, count)*sizeof(int));
+    MPI_Aint *file_disps = malloc(MAX(1, count)*sizeof(MPI_Aint));
+    MPI_Aint *mem_addrs = malloc(MAX(1, count)*sizeof(MPI_Aint));
+
+    for (int i = 0; i < count; i++) {
+        lengths[i] = segments[i].length;
+        file_disps[i] = segments[i].file_disp;
+        mem_addrs[i] = segments[i].mem_addr;
+    }
+
+    MPI_Type_create_hindexed(
+        count, lengths, file_disps, MPI_DOUBLE, filetype);
+    MPI_Type_commit(filetype);
+
+    MPI_Type_create_hindexed(
+        count, lengths, mem_addrs, MPI_DOUBLE, memtype);
+    MPI_Type_commit(memtype);
+
+    free(segments);
+    free(lengths);
+    free(file_disps);
+    free(mem_addrs);
+}
+
+///
+/// @brief Converts an MPI-IO configuration structure to an MPI info object.
+///
+/// @param[in] conf
+///         The MPI-IO configuration structure.
+///
+/// @param[in] write
+///         Non-zero if the file is opened for writing.
+///
+/// @return The MPI info object.
+///
+static MPI_Info create_info(struct starneig_io_conf const *conf, int write)
+{
+    MPI_Info info;
+    MPI_Info_create(&info);
+
+    char value[32];
+
+    if (conf->collective_buffering != STARNEIG_IO_DEFAULT_HINT)
+        MPI_Info_set(info, write ? "romio_cb_write" : "romio_cb_read",
+            conf->collective_buffering ? "enable" : "disable");
+
+    if (conf->cb_nodes != STARNEIG_IO_DEFAULT_HINT) {
+        snprintf(value, sizeof(value), "%d", conf->cb_nodes);
+        MPI_Info_set(info, "cb_nodes", value);
+    }
+
+    if (conf->cb_buffer_size != STARNEIG_IO_DEFAULT_HINT) {
+        snprintf(value, sizeof(value), "%d", conf->cb_buffer_size);
+        MPI_Info_set(info, "cb_buffer_size", value);
+    }
+
+    if (write && conf->striping_factor != STARNEIG_IO_DEFAULT_HINT) {
+        snprintf(value, sizeof(value), "%d", conf->striping_factor);
+        MPI_Info_set(info, "striping_factor", value);
+    }
+
+    if (write && conf->striping_unit != STARNEIG_IO_DEFAULT_HINT) {
+        snprintf(value, sizeof(value), "%d", conf->striping_unit);
+        MPI_Info_set(info, "striping_unit", value);
+    }
+
+    return info;
+}
+
+///
+/// @brief Reads the header of a stored matrix. Collective.
+///
+/// @param[in] fh
+///         The MPI file handle.
+///
+/// @param[out] rows
+///         Returns the number of rows in the matrix.
+///
+/// @param[out] cols
+///         Returns the number of columns in the matrix.
+///
+/// @param[out] offset
+///         Returns the offset of the first matrix element.
+///
+/// @return STARNEIG_SUCCESS (0) on success. Otherwise, an error code.
+///
+static starneig_error_t read_header(
+    MPI_File fh, int *rows, int *cols, MPI_Offset *offset)
+{
+    long long header[4] = { STARNEIG_GENERIC_ERROR, 0, 0, 0 };
+
+    if (starneig_mpi_get_comm_rank() == 0) {
+        char buffer[RAW_HEADER_MAX] = { 0 };
+        MPI_Status status;
+        MPI_File_read_at(
+            fh, 0, buffer, RAW_HEADER_MAX, MPI_CHAR, &status);
+
+        int m, n;
+        size_t offset;
+        if (starneig_raw_parse_header(
+        buffer, RAW_HEADER_MAX, &m, &n, &offset) == STARNEIG_SUCCESS) {
+            header[0] = STARNEIG_SUCCESS;
+            header[1] = m;
+            header[2] = n;
+            header[3] = offset;
+        }
+    }
+
+    MPI_Bcast(header, 4, MPI_LONG_LONG, 0, starneig_mpi_get_comm());
+
+    *rows = header[1];
+    *cols = header[2];
+    *offset = header[3];
+
+    if (header[0] != STARNEIG_SUCCESS)
+        starneig_error("Invalid file header.");
+
+    return header[0];
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_io_init_conf(struct starneig_io_conf *conf)
+{
+    conf->collective_buffering = STARNEIG_IO_DEFAULT_HINT;
+    conf->cb_nodes = STARNEIG_IO_DEFAULT_HINT;
+    conf->cb_buffer_size = STARNEIG_IO_DEFAULT_HINT;
+    conf->striping_factor = STARNEIG_IO_DEFAULT_HINT;
+    conf->striping_unit = STARNEIG_IO_DEFAULT_HINT;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_distr_matrix_read_dimensions(
+    char const *filename, int *rows, int *cols)
+{
+    if (filename == NULL)   return -1;
+    if (rows == NULL)       return -2;
+    if (cols == NULL)       return -3;
+
+    MPI_File fh;
+    if (MPI_File_open(starneig_mpi_get_comm(), filename, MPI_MODE_RDONLY,
+    MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        starneig_error("Failed to open %s.", filename);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    MPI_Offset offset;
+    starneig_error_t ret = read_header(fh, rows, cols, &offset);
+
+    MPI_File_close(&fh);
+
+    return ret;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_distr_matrix_read(
+    char const *filename, struct starneig_io_conf const *conf,
+    starneig_distr_matrix_t matrix)
+{
+    if (filename == NULL)   return -1;
+    if (matrix == NULL)     return -3;
+
+    struct starneig_io_conf local_conf;
+    if (conf == NULL) {
+        starneig_io_init_conf(&local_conf);
+        conf = &local_conf;
+    }
+
+    MPI_Info info = create_info(conf, 0);
+
+    MPI_File fh;
+    if (MPI_File_open(starneig_mpi_get_comm(), filename, MPI_MODE_RDONLY,
+    info, &fh) != MPI_SUCCESS) {
+        starneig_error("Failed to open %s.", filename);
+        MPI_Info_free(&info);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    int rows, cols;
+    MPI_Offset offset;
+    starneig_error_t ret = read_header(fh, &rows, &cols, &offset);
+    if (ret != STARNEIG_SUCCESS)
+        goto cleanup;
+
+    if (rows != matrix->rows || cols != matrix->cols) {
+        starneig_error(
+            "The stored matrix is %d X %d but the distributed matrix is "
+            "%d X %d.", rows, cols, matrix->rows, matrix->cols);
+        ret = STARNEIG_INVALID_DISTR_MATRIX;
+        goto cleanup;
+    }
+
+    double start = MPI_Wtime();
+
+    MPI_Datatype filetype, memtype;
+    build_datatypes(matrix, &filetype, &memtype);
+
+    MPI_File_set_view(fh, offset, MPI_DOUBLE, filetype, "native", info);
+
+    MPI_Status status;
+    if (MPI_File_read_all(fh, MPI_BOTTOM, 1, memtype, &status) !=
+    MPI_SUCCESS) {
+        starneig_error("Failed to read %s.", filename);
+        ret = STARNEIG_GENERIC_ERROR;
+    }
+
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&memtype);
+
+    starneig_verbose("Read a %d X %d matrix from %s in %.2f seconds.",
+        rows, cols, filename, MPI_Wtime() - start);
+
+cleanup:
+    MPI_File_close(&fh);
+    MPI_Info_free(&info);
+
+    return ret;
+}
+
+__attribute__ ((visibility ("default")))
+starneig_error_t starneig_distr_matrix_write(
+    char const *filename, struct starneig_io_conf const *conf,
+    starneig_distr_matrix_t matrix)
+{
+    if (filename == NULL)   return -1;
+    if (matrix == NULL)     return -3;
+
+    struct starneig_io_conf local_conf;
+    if (conf == NULL) {
+        starneig_io_init_conf(&local_conf);
+        conf = &local_conf;
+    }
+
+    MPI_Info info = create_info(conf, 1);
+
+    MPI_File fh;
+    if (MPI_File_open(starneig_mpi_get_comm(), filename,
+    MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh) != MPI_SUCCESS) {
+        starneig_error("Failed to open %s.", filename);
+        MPI_Info_free(&info);
+        return STARNEIG_GENERIC_ERROR;
+    }
+
+    double start = MPI_Wtime();
+
+    starneig_error_t ret = STARNEIG_SUCCESS;
+
+    char header[RAW_HEADER_MAX];
+    MPI_Offset offset =
+        starneig_matrix_header(matrix->rows, matrix->cols, header);
+
+    // truncate an existing file
+    MPI_File_set_size(fh,
+        offset + (MPI_Offset) matrix->rows*matrix->cols*sizeof(double));
+
+    if (starneig_mpi_get_comm_rank() == 0) {
+        MPI_Status status;
+        MPI_File_write_at(fh, 0, header, offset, MPI_CHAR, &status);
+    }
+
+    MPI_Datatype filetype, memtype;
+    build_datatypes(matrix, &filetype, &memtype);
+
+    MPI_File_set_view(fh, offset, MPI_DOUBLE, filetype, "native", info);
+
+    MPI_Status status;
+    if (MPI_File_write_all(fh, MPI_BOTTOM, 1, memtype, &status) !=
+    MPI_SUCCESS) {
+        starneig_error("Failed to write %s.", filename);
+        ret = STARNEIG_GENERIC_ERROR;
+    }
+
+    MPI_Type_free(&filetype);
+    MPI_Type_free(&memtype);
+
+    MPI_File_close(&fh);
+    MPI_Info_free(&info);
+
+    starneig_verbose("Wrote a %d X %d matrix to %s in %.2f seconds.",
+        matrix->rows, matrix->cols, filename, MPI_Wtime() - start);
+
+    return ret;
+}
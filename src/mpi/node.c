@@ -40,6 +40,8 @@
 #include "distr_matrix_internal.h"
 #include "../common/common.h"
 #include "../common/node_internal.h"
+#include "../common/multicast.h"
+#include "../common/comm_stats.h"
 #include <starpu.h>
 #include <starpu_mpi.h>
 
@@ -101,6 +103,7 @@ void starneig_mpi_stop_persistent_starpumpi()
         starneig_fatal_error("StarPU-MPI is not in persistent mode.");
 
     starneig_mpi_cache_clear();
+    starneig_multicast_clear();
     starpu_mpi_shutdown();
 
     mpi_mode = MPI_MODE_OFF;
@@ -114,6 +117,7 @@ void starneig_mpi_pause_persistent_starpumpi()
     starneig_verbose("Pausing StarPU-MPI persistent mode.");
 
     starneig_mpi_cache_clear();
+    starneig_multicast_clear();
     starpu_mpi_shutdown();
 }
 
@@ -150,6 +154,10 @@ void starneig_mpi_start_starpumpi()
 
 void starneig_mpi_stop_starpumpi()
 {
+    starneig_mpi_cache_trim();
+    starneig_comm_stats_report();
+    starneig_comm_stats_flush();
+
     if (mpi_mode == MPI_MODE_PERSISTENT)
         return;
 
@@ -159,6 +167,7 @@ void starneig_mpi_stop_starpumpi()
         starneig_fatal_error("StarPU-MPI is not initialized.");
 
     starneig_mpi_cache_clear();
+    starneig_multicast_clear();
     starpu_mpi_shutdown();
 
     mpi_mode = MPI_MODE_OFF;
@@ -182,6 +191,7 @@ void starneig_mpi_broadcast(int root, size_t size, void *buffer)
     starpu_mpi_data_register_comm(
         buffer_h, mpi->tag_offset++, root, starneig_mpi_get_comm());
 
+    starneig_comm_stats_broadcast(buffer_h);
     starpu_mpi_get_data_on_all_nodes_detached(
         starneig_mpi_get_comm(), buffer_h);
 
@@ -189,7 +199,8 @@ void starneig_mpi_broadcast(int root, size_t size, void *buffer)
 
     starpu_task_wait_for_all();
     starpu_mpi_cache_flush_all_data(starneig_mpi_get_comm());
-    starpu_mpi_barrier(starneig_mpi_get_comm());
+    starneig_comm_stats_flush();
+    starneig_comm_stats_barrier();
 
     starneig_node_pause_starpu();
     starneig_mpi_stop_starpumpi();
@@ -0,0 +1,190 @@
+///
+/// @file
+///
+/// @brief This file contains the node-local MPI-3 shared memory segments that
+/// back distributed matrices.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <starneig/distr_helpers.h>
+#include "shared_memory.h"
+#include "../common/common.h"
+#include "../common/alloc.h"
+#include <stdlib.h>
+
+static int shared_memory = 0;
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_enable_shared_memory()
+{
+    shared_memory = 1;
+}
+
+__attribute__ ((visibility ("default")))
+void starneig_mpi_disable_shared_memory()
+{
+    shared_memory = 0;
+}
+
+int starneig_mpi_shared_memory_enabled()
+{
+    return shared_memory;
+}
+
+void * starneig_mpi_alloc_shared_matrix(
+    int m, int n, size_t elemsize, size_t *ld,
+    struct starneig_shared_segment **segment)
+{
+    MPI_Comm comm = starneig_mpi_get_comm();
+
+    int my_rank, world_size;
+    MPI_Comm_rank(comm, &my_rank);
+    MPI_Comm_size(comm, &world_size);
+
+    struct starneig_shared_segment *seg =
+        malloc(sizeof(struct starneig_shared_segment));
+
+    MPI_Comm_split_type(
+        comm, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL, &seg->node_comm);
+
+    int local_rank, local_size;
+    MPI_Comm_rank(seg->node_comm, &local_rank);
+    MPI_Comm_size(seg->node_comm, &local_size);
+
+    //
+    // the node is identified by the rank of the first node-local rank
+    //
+
+    int node = my_rank;
+    MPI_Bcast(&node, 1, MPI_INT, 0, seg->node_comm);
+
+    seg->node_of = malloc(world_size*sizeof(int));
+    seg->local_rank_of = malloc(world_size*sizeof(int));
+    MPI_Allgather(&node, 1, MPI_INT, seg->node_of, 1, MPI_INT, comm);
+    MPI_Allgather(
+        &local_rank, 1, MPI_INT, seg->local_rank_of, 1, MPI_INT, comm);
+
+    //
+    // allocate the window
+    //
+
+    size_t _ld = starneig_alloc_ld(m, elemsize);
+    MPI_Aint size = (MPI_Aint) _ld*n*elemsize;
+
+    // each local buffer should start from its own page
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+
+    void *ptr;
+    if (MPI_Win_allocate_shared(size, elemsize, info, seg->node_comm,
+    &ptr, &seg->win) != MPI_SUCCESS)
+        starneig_fatal_error("Failed to allocate a shared memory window.");
+
+    MPI_Info_free(&info);
+
+    // passive target epoch for the whole lifetime of the window
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, seg->win);
+
+    //
+    // query the local buffers of the co-located ranks
+    //
+
+    unsigned long __ld = _ld;
+    unsigned long *lds = malloc(local_size*sizeof(unsigned long));
+    MPI_Allgather(
+        &__ld, 1, MPI_UNSIGNED_LONG, lds, 1, MPI_UNSIGNED_LONG,
+        seg->node_comm);
+
+    seg->bases = malloc(local_size*sizeof(void*));
+    seg->lds = malloc(local_size*sizeof(size_t));
+    for (int i = 0; i < local_size; i++) {
+        MPI_Aint _size;
+        int disp_unit;
+        MPI_Win_shared_query(seg->win, i, &_size, &disp_unit, &seg->bases[i]);
+        seg->lds[i] = lds[i];
+    }
+
+    free(lds);
+
+    starneig_verbose(
+        "Allocated %.0f MB for a local buffer from a shared memory window "
+        "(%d co-located ranks).", 1.0E-6 * size, local_size);
+
+    *ld = _ld;
+    *segment = seg;
+    return ptr;
+}
+
+void starneig_mpi_free_shared_matrix(struct starneig_shared_segment *segment)
+{
+    if (segment == NULL)
+        return;
+
+    MPI_Win_unlock_all(segment->win);
+    MPI_Win_free(&segment->win);
+    MPI_Comm_free(&segment->node_comm);
+
+    free(segment->node_of);
+    free(segment->local_rank_of);
+    free(segment->bases);
+    free(segment->lds);
+    free(segment);
+}
+
+int starneig_mpi_shared_colocated(
+    int a, int b, struct starneig_shared_segment const *segment)
+{
+    return segment != NULL && segment->node_of[a] == segment->node_of[b];
+}
+
+void * starneig_mpi_shared_get_base(
+    int rank, struct starneig_shared_segment const *segment, size_t *ld)
+{
+    STARNEIG_ASSERT(starneig_mpi_shared_colocated(
+        rank, starneig_mpi_get_comm_rank(), segment));
+
+    int local_rank = segment->local_rank_of[rank];
+    *ld = segment->lds[local_rank];
+    return segment->bases[local_rank];
+}
+
+void starneig_mpi_shared_sync(struct starneig_shared_segment const *segment)
+{
+    MPI_Win_sync(segment->win);
+    MPI_Barrier(segment->node_comm);
+    MPI_Win_sync(segment->win);
+}
@@ -0,0 +1,155 @@
+///
+/// @file
+///
+/// @brief This file contains the node-local MPI-3 shared memory segments that
+/// back distributed matrices.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_MPI_SHARED_MEMORY_H
+#define STARNEIG_MPI_SHARED_MEMORY_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include <stddef.h>
+#include <mpi.h>
+
+///
+/// @brief Node-local shared memory segment (MPI-3 shared memory window).
+///
+///  Every rank in the library communicator contributes a (possibly empty)
+///  local buffer to the segment. Ranks that are located on the same node can
+///  access each other's local buffers directly.
+///
+struct starneig_shared_segment {
+    /// The node-local communicator.
+    MPI_Comm node_comm;
+    /// The shared memory window.
+    MPI_Win win;
+    /// The node index of each rank in the library communicator.
+    int *node_of;
+    /// The node-local rank of each rank in the library communicator.
+    int *local_rank_of;
+    /// The local buffer of each node-local rank.
+    void **bases;
+    /// The leading dimension of the local buffer of each node-local rank.
+    size_t *lds;
+};
+
+///
+/// @brief Checks whether distributed matrices should be allocated from
+/// node-local shared memory segments.
+///
+/// @return Non-zero if the shared memory segments are enabled.
+///
+int starneig_mpi_shared_memory_enabled();
+
+///
+/// @brief Allocates a local buffer from a node-local shared memory segment.
+/// Collective over the library communicator.
+///
+/// @param[in] m
+///         The number of rows in the local buffer.
+///
+/// @param[in] n
+///         The number of columns in the local buffer.
+///
+/// @param[in] elemsize
+///         The matrix element size.
+///
+/// @param[out] ld
+///         Returns the leading dimension of the local buffer.
+///
+/// @param[out] segment
+///         Returns the shared memory segment descriptor.
+///
+/// @return A pointer to the local buffer.
+///
+void * starneig_mpi_alloc_shared_matrix(
+    int m, int n, size_t elemsize, size_t *ld,
+    struct starneig_shared_segment **segment);
+
+///
+/// @brief Frees a node-local shared memory segment. Collective over the
+/// node-local communicator.
+///
+/// @param[in,out] segment
+///         The shared memory segment descriptor.
+///
+void starneig_mpi_free_shared_matrix(struct starneig_shared_segment *segment);
+
+///
+/// @brief Checks whether two ranks are located on the same node.
+///
+/// @param[in] a
+///         The first rank.
+///
+/// @param[in] b
+///         The second rank.
+///
+/// @param[in] segment
+///         The shared memory segment descriptor.
+///
+/// @return Non-zero if the ranks are located on the same node.
+///
+int starneig_mpi_shared_colocated(
+    int a, int b, struct starneig_shared_segment const *segment);
+
+///
+/// @brief Returns the local buffer of a co-located rank.
+///
+/// @param[in] rank
+///         The rank.
+///
+/// @param[in] segment
+///         The shared memory segment descriptor.
+///
+/// @param[out] ld
+///         Returns the leading dimension of the local buffer.
+///
+/// @return A pointer to the local buffer.
+///
+void * starneig_mpi_shared_get_base(
+    int rank, struct starneig_shared_segment const *segment, size_t *ld);
+
+///
+/// @brief Makes the local buffers of the co-located ranks consistent.
+/// Collective over the node-local communicator.
+///
+/// @param[in] segment
+///         The shared memory segment descriptor.
+///
+void starneig_mpi_shared_sync(struct starneig_shared_segment const *segment);
+
+#endif // STARNEIG_MPI_SHARED_MEMORY_H
@@ -42,6 +42,9 @@
 #include "../common/common.h"
 #include "../common/utils.h"
 #include "../common/tasks.h"
+#include "../common/comm_stats.h"
+#include "../common/progress.h"
+#include "../common/dry_run.h"
 #include <math.h>
 #ifdef STARNEIG_ENABLE_MPI
 #include <starpu_mpi.h>
@@ -664,6 +667,11 @@ starneig_error_t starneig_reorder_insert_tasks(
     int *complex_distr = starneig_acquire_vector_descr(complex_distr_d);
     starneig_vector_free(complex_distr_d);
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    // the subdiagonal extraction tasks are not executed during a simulation
+    memset(complex_distr, 0, n*sizeof(int));
+#endif
+
     struct plan *plan = plan_desc->func(n, window_size, values_per_chain,
         tile_size, host_selected, complex_distr);
 
@@ -674,8 +682,14 @@ starneig_error_t starneig_reorder_insert_tasks(
     // insert tasks
     //
 
+    starneig_progress_set_total(starneig_count_plan_windows(plan));
+
+    int phase = starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_REORDER);
+    starneig_dry_run_begin(mpi);
     starneig_process_plan(&engine_conf, blueprint_desc->blueprint, selected,
         Q, Z, A, B, plan, mpi);
+    starneig_dry_run_end();
+    starneig_comm_stats_set_phase(phase);
 
     //
     // finalize
@@ -43,6 +43,7 @@
 #include "../common/sanity.h"
 #include "../common/tiles.h"
 #include "../common/math.h"
+#include "../common/alloc.h"
 #include "../common/trace.h"
 
 #include <math.h>
@@ -84,9 +85,9 @@ static int reorder_window(
 
     // allocate work space for dtgsen/dtrsen
     if (B != NULL)
-        work = malloc((7*n+16)*sizeof(double));
+        work = starneig_alloc_aligned((7*n+16)*sizeof(double));
     else
-        work = malloc(3*n*sizeof(double));
+        work = starneig_alloc_aligned(3*n*sizeof(double));
 
     // make sure that the window is big enough and call
     // *_starneig_reorder_window directly if it is not
@@ -205,7 +206,7 @@ static int reorder_window(
 
 cleanup:
 
-    free(work);
+    starneig_free_aligned(work);
     starneig_free_matrix(vT);
     starneig_free_matrix(hT);
     starneig_free_matrix(lQ);
@@ -41,6 +41,7 @@
 #include "../common/common.h"
 #include "../common/tiles.h"
 #include "../common/math.h"
+#include "../common/alloc.h"
 
 #include <math.h>
 #include <starpu.h>
@@ -186,16 +187,17 @@ static int reorder_window(cudaStream_t stream, cublasHandle_t handle,
 
     // allocate work space for dtgsen/dtrsen
     if (B != NULL)
-        _work = (double *) malloc((7*n+16)*sizeof(double));
+        _work = (double *) starneig_alloc_aligned((7*n+16)*sizeof(double));
     else
-        _work = (double *) malloc(3*n*sizeof(double));
+        _work = (double *) starneig_alloc_aligned(3*n*sizeof(double));
 
     // make sure that the window is big enough and call
     // *_starneig_reorder_window directly if it is not
     if (n < threshold) {
 
         if (B != NULL) {
-            ld_lA = ld_lB = ld_lQ = ld_lZ = divceil(n, 8)*8;
+            ld_lA = ld_lB = ld_lQ = ld_lZ =
+                starneig_alloc_ld(n, sizeof(double));
             err = cudaHostAlloc(
                 &_lA, 4*n*ld_lA*sizeof(double), cudaHostAllocDefault);
             if (err != cudaSuccess)
@@ -206,7 +208,7 @@ static int reorder_window(cudaStream_t stream, cublasHandle_t handle,
             _lZ = _lQ + n*ld_lQ;
         }
         else {
-            ld_lA = ld_lQ = divceil(n, 8)*8;
+            ld_lA = ld_lQ = starneig_alloc_ld(n, sizeof(double));
             err = cudaHostAlloc(
                 &_lA, 2*n*ld_lA*sizeof(double), cudaHostAllocDefault);
             if (err != cudaSuccess)
@@ -310,7 +312,8 @@ static int reorder_window(cudaStream_t stream, cublasHandle_t handle,
     // allocate host workspace
 
     if (B != NULL) {
-        ld_lA = ld_lB = ld_lQ = ld_lZ = divceil(window_size, 8)*8;
+        ld_lA = ld_lB = ld_lQ = ld_lZ =
+            starneig_alloc_ld(window_size, sizeof(double));
         err = cudaHostAlloc(
             &_lA, 4*window_size*ld_lA*sizeof(double), cudaHostAllocDefault);
         if (err != cudaSuccess)
@@ -321,7 +324,7 @@ static int reorder_window(cudaStream_t stream, cublasHandle_t handle,
         _lZ = _lQ + window_size*ld_lQ;
     }
     else {
-        ld_lA = ld_lQ = divceil(window_size, 8)*8;
+        ld_lA = ld_lQ = starneig_alloc_ld(window_size, sizeof(double));
         err = cudaHostAlloc(
             &_lA, 2*window_size*ld_lA*sizeof(double), cudaHostAllocDefault);
         if (err != cudaSuccess)
@@ -628,7 +631,7 @@ cleanup:
 
     cudaFreeHost(_select);
     cudaFreeHost(_lA);
-    free(_work);
+    starneig_free_aligned(_work);
 
     cudaFree(lQ);
     cudaFree(vT);
@@ -41,6 +41,7 @@
 #include "../common/node_internal.h"
 #include "../common/utils.h"
 #include "../common/trace.h"
+#include "../common/progress.h"
 #include <starneig/sep_sm.h>
 #include <starneig/gep_sm.h>
 
@@ -133,8 +134,6 @@ static starneig_error_t reorder(
     // insert tasks
     //
 
-    STARNEIG_EVENT_INIT();
-
     starneig_error_t ret = starneig_reorder_insert_tasks(
         conf, selected_d, Q_d, Z_d, A_d, B_d, real_d, imag_d, beta_d, NULL);
 
@@ -160,9 +159,6 @@ static starneig_error_t reorder(
     starneig_vector_free(imag_d);
     starneig_vector_free(beta_d);
 
-    STARNEIG_EVENT_STORE(n, "trace.dat");
-    STARNEIG_EVENT_FREE();
-
     for (int i = 0; i < n; i++) {
         if (1 < selected[i]) {
             if (ret == STARNEIG_SUCCESS)
@@ -229,10 +225,15 @@ starneig_error_t starneig_SEP_SM_ReorderSchur_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("reorder");
+    starneig_progress_begin("reorder");
+
     starneig_error_t ret = reorder(
         conf, n, ldQ, 0, ldS, 0, selected, Q, NULL, S, NULL, real, imag, NULL);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
@@ -290,10 +291,15 @@ starneig_error_t starneig_GEP_SM_ReorderSchur_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("reorder");
+    starneig_progress_begin("reorder");
+
     starneig_error_t ret = reorder(
         conf, n, ldQ, ldZ, ldS, ldT, selected, Q, Z, S, T, real, imag, beta);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
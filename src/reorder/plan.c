@@ -371,6 +371,21 @@ void starneig_free_plan(struct plan *plan)
     free(plan);
 }
 
+int starneig_count_plan_windows(struct plan const *plan)
+{
+    if (plan == NULL)
+        return 0;
+
+    int count = 0;
+    for (struct chain_list *it = plan->begin; it != NULL; it = it->next)
+        for (struct window_chain *cit = it->top; cit != NULL; cit = cit->down)
+            for (struct window *wit = cit->bottom; wit != NULL; wit = wit->up)
+                if (wit->begin < wit->end)
+                    count++;
+
+    return count;
+}
+
 struct plan* starneig_formulate_plan(
     int n, int window_size, int values_per_chain, int tile_size,
     int *selected, int *complex_distr)
@@ -69,6 +69,16 @@ void starneig_unregister_plan(struct plan *plan);
 ///
 void starneig_free_plan(struct plan *plan);
 
+///
+/// @brief Counts the non-empty windows in an eigenvalue reordering plan.
+///
+/// @param[in] plan
+///         eigenvalue reordering plan
+///
+/// @return number of windows
+///
+int starneig_count_plan_windows(struct plan const *plan);
+
 ///
 /// @brief Interface for a plan generation function.
 ///
@@ -43,6 +43,9 @@
 #endif
 #include "../common/common.h"
 #include "../common/tiles.h"
+#include "../common/comm_stats.h"
+#include "../common/progress.h"
+#include "../common/dry_run.h"
 
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
@@ -229,13 +232,20 @@ void starneig_reorder_insert_window(
     // insert task
     //
 
+    // each swap applies a small orthogonal transformation to the window and
+    // to the local transformation matrices
+    double flops = (matrix_b != NULL ? 36.0 : 18.0) *
+        window->swaps*window_size;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &reorder_window_cl,
             STARPU_EXECUTE_ON_NODE, owner,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &packing_info_selected, sizeof(packing_info_selected),
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
@@ -244,11 +254,13 @@ void starneig_reorder_insert_window(
                 sizeof(small_window_threshold),
             STARPU_VALUE, &window->swaps, sizeof(window->swaps),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &reorder_window_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &packing_info_selected, sizeof(packing_info_selected),
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
@@ -258,6 +270,8 @@ void starneig_reorder_insert_window(
             STARPU_VALUE, &window->swaps, sizeof(window->swaps),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
 
+    starneig_progress_insert_marker(1, window->lq_h, mpi);
+
 #ifdef STARNEIG_ENABLE_MPI
 
     //
@@ -265,11 +279,13 @@ void starneig_reorder_insert_window(
     //
 
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(window->lq_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), window->lq_h);
         starpu_mpi_data_set_rank_comm(
             window->lq_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (matrix_b != NULL) {
+            starneig_comm_stats_broadcast(window->lz_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), window->lz_h);
             starpu_mpi_data_set_rank_comm(
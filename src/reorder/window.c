@@ -38,6 +38,7 @@
 #include <starneig/configuration.h>
 #include "window.h"
 #include "../common/common.h"
+#include "../common/multicast.h"
 
 struct window* starneig_create_window(
     int idx, int gidx, int begin, int end, int swaps)
@@ -62,10 +63,10 @@ void starneig_unregister_window(struct window *window)
         return;
 
     if (window->lq_h != NULL)
-        starpu_data_unregister_submit(window->lq_h);
+        starneig_multicast_unregister_submit(window->lq_h);
 
     if (window->lz_h != NULL)
-        starpu_data_unregister_submit(window->lz_h);
+        starneig_multicast_unregister_submit(window->lz_h);
 
     window->lq_h = NULL;
     window->lz_h = NULL;
@@ -0,0 +1,776 @@
+///
+/// @file
+///
+/// @brief This file contains the checkpoint/restart functionality of the
+/// QR/QZ algorithm.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "checkpoint.h"
+#include "../common/common.h"
+#include "../common/vector.h"
+#include "../common/dry_run.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <starpu.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include <starneig/distr_helpers.h>
+#include <starpu_mpi.h>
+#endif
+
+//
+// A checkpoint file contains a header (struct checkpoint_header), the segment
+// list (struct checkpoint_segment) and the locally owned tiles of the matrices
+// A, B, Q and Z. Each tile occupies a slot of the size bm * bn elements
+// (column stride bm). The slots are ordered by matrix and then in
+// column-major tile order. A new checkpoint is written to filename.tmp and
+// renamed to filename once complete. The previous checkpoint is kept as
+// filename.prev. The header records a fingerprint of the tile owners and a
+// checkpoint is accepted only if the tiles are distributed in the same way.
+//
+
+#define CHECKPOINT_MAGIC "STARNEIG CKPT\n"
+#define CHECKPOINT_VERSION 2
+#define CHECKPOINT_ALIGNMENT 4096
+#define CHECKPOINT_DEFAULT_INTERVAL 10
+#define CHECKPOINT_MEMBERS 4
+
+///
+/// @brief Checkpoint file header.
+///
+struct checkpoint_header {
+    char magic[16];             ///< "STARNEIG CKPT\n"
+    uint32_t version;           ///< format version
+    uint32_t world_size;        ///< number of MPI ranks
+    int64_t sequence;           ///< checkpoint sequence number
+    int32_t m;                  ///< matrix dimension
+    int32_t bm;                 ///< tile height
+    int32_t bn;                 ///< tile width
+    uint32_t elemsize;          ///< element size
+    uint32_t members;           ///< stored matrices (A, B, Q, Z)
+    uint32_t segments;          ///< number of segments
+    uint64_t owners;            ///< fingerprint of the tile owners
+};
+
+///
+/// @brief Checkpointed segment.
+///
+struct checkpoint_segment {
+    int32_t begin;              ///< first row/column of the segment
+    int32_t end;                ///< last row/column of the segment + 1
+    int32_t iter;               ///< segment iteration counter
+    int32_t aed_failed;         ///< number of failed AEDs
+};
+
+struct checkpoint {
+    char *name;                 ///< checkpoint filename (this rank)
+    int interval;               ///< iterations between checkpoints
+    int iterations;             ///< iterations since the last checkpoint
+    int64_t sequence;           ///< sequence number of the last checkpoint
+    int rank;                   ///< MPI rank
+    int world_size;             ///< number of MPI ranks
+    uint64_t owners;            ///< fingerprint of the tile owners
+    starneig_matrix_t matrices[CHECKPOINT_MEMBERS]; ///< A, B, Q and Z
+    int fd;                     ///< file descriptor of the pending checkpoint
+    int pending;                ///< tiles left in the pending checkpoint
+    int failed;                 ///< non-zero if a write has failed
+    pthread_mutex_t mutex;      ///< protects fd, pending and failed
+    pthread_cond_t cond;        ///< signaled when a checkpoint completes
+};
+
+static char * get_name(char const *filename, char const *suffix, int rank,
+    int world_size)
+{
+    char *name = malloc(strlen(filename) + strlen(suffix) + 16);
+    if (1 < world_size)
+        sprintf(name, "%s.%d%s", filename, rank, suffix);
+    else
+        sprintf(name, "%s%s", filename, suffix);
+    return name;
+}
+
+static int owns_tile(
+    int i, int j, starneig_matrix_t matrix, int rank, mpi_info_t mpi)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL)
+        return starneig_matrix_get_tile_owner(i, j, matrix) == rank;
+#endif
+    return 1;
+}
+
+///
+/// @brief Computes a fingerprint (64-bit FNV-1a) of the tile owners. The
+/// fingerprint is identical on all MPI ranks.
+///
+/// @param[in] matrices
+///         A, B, Q and Z
+///
+/// @param[in] mpi
+///         MPI info
+///
+/// @return fingerprint
+///
+static uint64_t get_owners(starneig_matrix_t const *matrices, mpi_info_t mpi)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (int k = 0; k < CHECKPOINT_MEMBERS; k++) {
+        starneig_matrix_t matrix = matrices[k];
+        if (matrix == NULL)
+            continue;
+
+        int ibegin = STARNEIG_MATRIX_TILE_IDX(0, matrix);
+        int iend = STARNEIG_MATRIX_TILE_IDX(STARNEIG_MATRIX_M(matrix)-1, matrix);
+        int jbegin = STARNEIG_MATRIX_TILE_IDY(0, matrix);
+        int jend = STARNEIG_MATRIX_TILE_IDY(STARNEIG_MATRIX_N(matrix)-1, matrix);
+
+        for (int j = jbegin; j <= jend; j++) {
+            for (int i = ibegin; i <= iend; i++) {
+                uint64_t owner = 0;
+#ifdef STARNEIG_ENABLE_MPI
+                if (mpi != NULL)
+                    owner = starneig_matrix_get_tile_owner(i, j, matrix);
+#endif
+                hash ^= (uint64_t) k << 56 | owner;
+                hash *= 0x100000001b3ULL;
+            }
+        }
+    }
+
+    return hash;
+}
+
+static size_t get_data_offset(int segments)
+{
+    size_t offset = sizeof(struct checkpoint_header) +
+        segments*sizeof(struct checkpoint_segment);
+    return (offset + CHECKPOINT_ALIGNMENT - 1) /
+        CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+}
+
+static int pwrite_all(int fd, void const *buffer, size_t length, off_t offset)
+{
+    char const *ptr = buffer;
+    while (0 < length) {
+        ssize_t ret = pwrite(fd, ptr, length, offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        ptr += ret;
+        length -= ret;
+        offset += ret;
+    }
+    return 0;
+}
+
+static int pread_all(int fd, void *buffer, size_t length, off_t offset)
+{
+    char *ptr = buffer;
+    while (0 < length) {
+        ssize_t ret = pread(fd, ptr, length, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return -1;
+        ptr += ret;
+        length -= ret;
+        offset += ret;
+    }
+    return 0;
+}
+
+///
+/// @brief Completes the pending checkpoint. Must be called with the mutex
+/// locked.
+///
+static void finalize(struct checkpoint *checkpoint)
+{
+    if (checkpoint->fd == -1 || fsync(checkpoint->fd) != 0)
+        checkpoint->failed = 1;
+    if (checkpoint->fd != -1)
+        close(checkpoint->fd);
+    checkpoint->fd = -1;
+
+    char *tmp_name = get_name(checkpoint->name, ".tmp", 0, 1);
+    char *prev_name = get_name(checkpoint->name, ".prev", 0, 1);
+
+    if (!checkpoint->failed) {
+        rename(checkpoint->name, prev_name);
+        if (rename(tmp_name, checkpoint->name) != 0)
+            checkpoint->failed = 1;
+    }
+
+    if (checkpoint->failed)
+        starneig_warning("Failed to write checkpoint %s.", checkpoint->name);
+    else
+        starneig_verbose("Checkpoint %d written to %s.",
+            (int) checkpoint->sequence, checkpoint->name);
+
+    free(tmp_name);
+    free(prev_name);
+
+    pthread_cond_broadcast(&checkpoint->cond);
+}
+
+static void complete_tiles(struct checkpoint *checkpoint, int count, int error)
+{
+    pthread_mutex_lock(&checkpoint->mutex);
+    checkpoint->failed |= error;
+    checkpoint->pending -= count;
+    if (checkpoint->pending == 0)
+        finalize(checkpoint);
+    pthread_mutex_unlock(&checkpoint->mutex);
+}
+
+static void wait_pending(struct checkpoint *checkpoint)
+{
+    pthread_mutex_lock(&checkpoint->mutex);
+    while (0 < checkpoint->pending)
+        pthread_cond_wait(&checkpoint->cond, &checkpoint->mutex);
+    pthread_mutex_unlock(&checkpoint->mutex);
+}
+
+///
+/// @brief Writes a matrix tile to a checkpoint file.
+///
+///  Arguments:
+///   - checkpoint writer
+///   - slot offset
+///   - tile height
+///
+///  Buffers:
+///   - matrix tile (STARPU_R)
+///
+static void cpu_write_tile(void *buffers[], void *cl_arg)
+{
+    struct checkpoint *checkpoint;
+    off_t offset;
+    int bm;
+    starpu_codelet_unpack_args(cl_arg, &checkpoint, &offset, &bm);
+
+    struct starpu_matrix_interface *A_i = buffers[0];
+    char *A = (char *) STARPU_MATRIX_GET_PTR(A_i);
+    size_t ldA = STARPU_MATRIX_GET_LD(A_i);
+    int m = STARPU_MATRIX_GET_NX(A_i);
+    int n = STARPU_MATRIX_GET_NY(A_i);
+    size_t elemsize = STARPU_MATRIX_GET_ELEMSIZE(A_i);
+
+    // the write is skipped if the checkpoint has already failed
+    int error = __atomic_load_n(&checkpoint->failed, __ATOMIC_RELAXED);
+
+    if (!error && ldA == (size_t) bm)
+        error = pwrite_all(checkpoint->fd, A, (size_t)n*ldA*elemsize, offset);
+    else
+        for (int i = 0; !error && i < n; i++)
+            error = pwrite_all(checkpoint->fd, A + i*ldA*elemsize,
+                m*elemsize, offset + (off_t)i*bm*elemsize);
+
+    complete_tiles(checkpoint, 1, error != 0);
+}
+
+static struct starpu_codelet write_tile_cl = {
+    .name = "starneig_schur_checkpoint_write_tile",
+    .cpu_funcs = { cpu_write_tile },
+    .cpu_funcs_name = { "cpu_write_tile" },
+    .nbuffers = 1,
+    .modes = { STARPU_R }
+};
+
+struct checkpoint * starneig_schur_checkpoint_init(
+    char const *filename, int interval,
+    starneig_matrix_t matrix_q, starneig_matrix_t matrix_z,
+    starneig_matrix_t matrix_a, starneig_matrix_t matrix_b, mpi_info_t mpi)
+{
+    struct checkpoint *checkpoint = malloc(sizeof(struct checkpoint));
+
+    checkpoint->rank = 0;
+    checkpoint->world_size = 1;
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        checkpoint->rank = starneig_mpi_get_comm_rank();
+        checkpoint->world_size = starneig_mpi_get_comm_size();
+    }
+#endif
+
+    checkpoint->name = get_name(
+        filename, "", checkpoint->rank, checkpoint->world_size);
+    checkpoint->interval = 0 < interval ? interval : CHECKPOINT_DEFAULT_INTERVAL;
+    checkpoint->iterations = 0;
+    checkpoint->sequence = 0;
+    checkpoint->matrices[0] = matrix_a;
+    checkpoint->matrices[1] = matrix_b;
+    checkpoint->matrices[2] = matrix_q;
+    checkpoint->matrices[3] = matrix_z;
+    checkpoint->owners = get_owners(checkpoint->matrices, mpi);
+    checkpoint->fd = -1;
+    checkpoint->pending = 0;
+    checkpoint->failed = 0;
+    pthread_mutex_init(&checkpoint->mutex, NULL);
+    pthread_cond_init(&checkpoint->cond, NULL);
+
+    starneig_message("Writing checkpoints to %s every %d iterations.",
+        checkpoint->name, checkpoint->interval);
+
+    return checkpoint;
+}
+
+void starneig_schur_checkpoint_count(struct checkpoint *checkpoint)
+{
+    if (checkpoint != NULL)
+        checkpoint->iterations++;
+}
+
+int starneig_schur_checkpoint_due(
+    struct segment_list const *list, struct checkpoint const *checkpoint)
+{
+    if (checkpoint == NULL || checkpoint->iterations < checkpoint->interval)
+        return 0;
+
+    if (list->top == NULL || starneig_dry_run_recording())
+        return 0;
+
+    for (struct segment *it = list->top; it != NULL; it = it->down)
+        if (it->status != SEGMENT_BOOTSTRAP && it->status != SEGMENT_NEW &&
+        it->status != SEGMENT_BULGES && it->status != SEGMENT_SKIPPED)
+            return 0;
+
+    return 1;
+}
+
+void starneig_schur_checkpoint_insert(
+    int prio, struct segment_list const *list, struct checkpoint *checkpoint,
+    mpi_info_t mpi)
+{
+    wait_pending(checkpoint);
+
+    // a new sequence must not be mixed with an old one
+    if (checkpoint->sequence == 0) {
+        char *prev_name = get_name(checkpoint->name, ".prev", 0, 1);
+        unlink(checkpoint->name);
+        unlink(prev_name);
+        free(prev_name);
+    }
+
+    checkpoint->iterations = 0;
+    checkpoint->sequence++;
+
+    //
+    // write the header and the segment list
+    //
+
+    int segments = 0;
+    for (struct segment *it = list->top; it != NULL; it = it->down)
+        segments++;
+
+    struct checkpoint_segment *segment_array =
+        malloc(segments*sizeof(struct checkpoint_segment));
+    {
+        int i = 0;
+        for (struct segment *it = list->top; it != NULL; it = it->down)
+            segment_array[i++] = (struct checkpoint_segment) {
+                .begin = it->begin, .end = it->end,
+                .iter = it->iter, .aed_failed = it->aed_failed };
+    }
+
+    starneig_matrix_t matrix_a = checkpoint->matrices[0];
+
+    struct checkpoint_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.world_size = checkpoint->world_size;
+    header.sequence = checkpoint->sequence;
+    header.m = STARNEIG_MATRIX_M(matrix_a);
+    header.bm = STARNEIG_MATRIX_BM(matrix_a);
+    header.bn = STARNEIG_MATRIX_BN(matrix_a);
+    header.elemsize = STARNEIG_MATRIX_ELEMSIZE(matrix_a);
+    header.segments = segments;
+    header.owners = checkpoint->owners;
+    for (int k = 0; k < CHECKPOINT_MEMBERS; k++)
+        if (checkpoint->matrices[k] != NULL)
+            header.members |= 1 << k;
+
+    char *tmp_name = get_name(checkpoint->name, ".tmp", 0, 1);
+    checkpoint->fd = open(tmp_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    free(tmp_name);
+
+    checkpoint->failed = checkpoint->fd == -1 ||
+        pwrite_all(checkpoint->fd, &header, sizeof(header), 0) != 0 ||
+        pwrite_all(checkpoint->fd, segment_array,
+            segments*sizeof(struct checkpoint_segment), sizeof(header)) != 0;
+
+    free(segment_array);
+
+    //
+    // insert the tile write tasks
+    //
+
+    // the extra count keeps the checkpoint pending until all tasks have been
+    // inserted
+    checkpoint->pending = 1;
+
+    // all MPI ranks must insert the same tasks even if the checkpoint has
+    // already failed locally
+
+    size_t slot_size = (size_t) header.bm * header.bn * header.elemsize;
+    off_t offset = get_data_offset(segments);
+
+    for (int k = 0; k < CHECKPOINT_MEMBERS; k++) {
+        starneig_matrix_t matrix = checkpoint->matrices[k];
+        if (matrix == NULL)
+            continue;
+
+        int ibegin = STARNEIG_MATRIX_TILE_IDX(0, matrix);
+        int iend = STARNEIG_MATRIX_TILE_IDX(STARNEIG_MATRIX_M(matrix)-1, matrix);
+        int jbegin = STARNEIG_MATRIX_TILE_IDY(0, matrix);
+        int jend = STARNEIG_MATRIX_TILE_IDY(STARNEIG_MATRIX_N(matrix)-1, matrix);
+
+        for (int j = jbegin; j <= jend; j++) {
+            for (int i = ibegin; i <= iend; i++) {
+                int owner = owns_tile(i, j, matrix, checkpoint->rank, mpi);
+
+                starpu_data_handle_t tile =
+                    starneig_matrix_get_tile(i, j, matrix);
+                off_t tile_offset = owner ? offset : 0;
+                int bm = header.bm;
+
+                if (owner) {
+                    pthread_mutex_lock(&checkpoint->mutex);
+                    checkpoint->pending++;
+                    pthread_mutex_unlock(&checkpoint->mutex);
+                    offset += slot_size;
+                }
+
+#ifdef STARNEIG_ENABLE_MPI
+                if (mpi != NULL)
+                    starneig_mpi_task_insert(
+                        starneig_mpi_get_comm(),
+                        &write_tile_cl,
+                        STARPU_EXECUTE_ON_DATA, tile,
+                        STARPU_PRIORITY, prio,
+                        STARPU_VALUE, &checkpoint, sizeof(checkpoint),
+                        STARPU_VALUE, &tile_offset, sizeof(tile_offset),
+                        STARPU_VALUE, &bm, sizeof(bm),
+                        STARPU_R, tile, 0);
+                else
+#endif
+                    starneig_task_insert(
+                        &write_tile_cl,
+                        STARPU_PRIORITY, prio,
+                        STARPU_VALUE, &checkpoint, sizeof(checkpoint),
+                        STARPU_VALUE, &tile_offset, sizeof(tile_offset),
+                        STARPU_VALUE, &bm, sizeof(bm),
+                        STARPU_R, tile, 0);
+            }
+        }
+    }
+
+    complete_tiles(checkpoint, 1, 0);
+}
+
+void starneig_schur_checkpoint_free(struct checkpoint *checkpoint)
+{
+    if (checkpoint == NULL)
+        return;
+
+    wait_pending(checkpoint);
+
+    pthread_mutex_destroy(&checkpoint->mutex);
+    pthread_cond_destroy(&checkpoint->cond);
+    free(checkpoint->name);
+    free(checkpoint);
+}
+
+///
+/// @brief Reads and validates a checkpoint file header.
+///
+/// @return checkpoint sequence number, -1 if the file is not a valid
+/// checkpoint for the given matrices
+///
+static int64_t read_header(char const *name, struct checkpoint_header *header,
+    int world_size, uint64_t owners, starneig_matrix_t *matrices)
+{
+    int fd = open(name, O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    int ret = pread_all(fd, header, sizeof(*header), 0);
+    close(fd);
+
+    if (ret != 0 ||
+    memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+    header->version != CHECKPOINT_VERSION ||
+    header->world_size != (uint32_t) world_size ||
+    header->m != STARNEIG_MATRIX_M(matrices[0]) ||
+    header->bm != STARNEIG_MATRIX_BM(matrices[0]) ||
+    header->bn != STARNEIG_MATRIX_BN(matrices[0]) ||
+    header->elemsize != STARNEIG_MATRIX_ELEMSIZE(matrices[0])) {
+        starneig_warning("%s is not a valid checkpoint for this problem.",
+            name);
+        return -1;
+    }
+
+    if (header->owners != owners) {
+        starneig_warning(
+            "%s was written with a different data distribution.", name);
+        return -1;
+    }
+
+    for (int k = 0; k < CHECKPOINT_MEMBERS; k++) {
+        if (matrices[k] != NULL && !(header->members & (1 << k))) {
+            starneig_warning("%s does not contain all matrices.", name);
+            return -1;
+        }
+    }
+
+    return header->sequence;
+}
+
+#ifdef STARNEIG_ENABLE_MPI
+
+static int rank_owner(int i, void const *arg)
+{
+    return i;
+}
+
+///
+/// @brief Returns the largest sequence number that is available on all MPI
+/// ranks.
+///
+/// @param[in] local
+///         sequence numbers of the current and the previous checkpoint
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+/// @return sequence number, -1 if none
+///
+static int64_t agree_on_sequence(int64_t const *local, mpi_info_t mpi)
+{
+    int world_size = starneig_mpi_get_comm_size();
+    int my_rank = starneig_mpi_get_comm_rank();
+
+    starneig_vector_t vector = starneig_vector_init(
+        world_size, 1, 2*sizeof(int64_t), &rank_owner, NULL, mpi);
+
+    starpu_data_handle_t handle = starneig_vector_get_tile(my_rank, vector);
+    starpu_data_acquire(handle, STARPU_W);
+    memcpy((void *) starpu_vector_get_local_ptr(handle),
+        local, 2*sizeof(int64_t));
+    starpu_data_release(handle);
+
+    for (int i = 0; i < world_size; i++)
+        starneig_vector_gather_section(i, 0, world_size, vector);
+
+    int64_t *all = malloc(2*world_size*sizeof(int64_t));
+    for (int i = 0; i < world_size; i++) {
+        handle = starneig_vector_get_tile(i, vector);
+        starpu_data_acquire(handle, STARPU_R);
+        memcpy(all+2*i, (void *) starpu_vector_get_local_ptr(handle),
+            2*sizeof(int64_t));
+        starpu_data_release(handle);
+    }
+
+    starneig_vector_free(vector);
+
+    int64_t best = -1;
+    for (int i = 0; i < 2*world_size; i++) {
+        if (all[i] <= best)
+            continue;
+        int everywhere = 1;
+        for (int j = 0; everywhere && j < world_size; j++)
+            everywhere = all[2*j] == all[i] || all[2*j+1] == all[i];
+        if (everywhere)
+            best = all[i];
+    }
+
+    free(all);
+
+    return best;
+}
+
+#endif
+
+starneig_error_t starneig_schur_checkpoint_restore(
+    char const *filename,
+    starneig_matrix_t matrix_q, starneig_matrix_t matrix_z,
+    starneig_matrix_t matrix_a, starneig_matrix_t matrix_b, mpi_info_t mpi,
+    struct checkpoint *checkpoint, struct segment_list **list)
+{
+    starneig_error_t ret = STARNEIG_SUCCESS;
+    struct checkpoint_segment *segments = NULL;
+    int fd = -1;
+
+    int rank = 0, world_size = 1;
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        rank = starneig_mpi_get_comm_rank();
+        world_size = starneig_mpi_get_comm_size();
+    }
+#endif
+
+    starneig_matrix_t matrices[CHECKPOINT_MEMBERS] =
+        { matrix_a, matrix_b, matrix_q, matrix_z };
+
+    char *names[2] = {
+        get_name(filename, "", rank, world_size),
+        get_name(filename, ".prev", rank, world_size) };
+
+    //
+    // select the checkpoint
+    //
+
+    uint64_t owners = get_owners(matrices, mpi);
+
+    struct checkpoint_header headers[2];
+    int64_t sequences[2];
+    for (int i = 0; i < 2; i++)
+        sequences[i] = read_header(
+            names[i], &headers[i], world_size, owners, matrices);
+
+    int64_t sequence = MAX(sequences[0], sequences[1]);
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL)
+        sequence = agree_on_sequence(sequences, mpi);
+#endif
+
+    if (sequence < 0) {
+        starneig_error("Could not find a complete checkpoint %s.", filename);
+        ret = STARNEIG_INVALID_ARGUMENTS;
+        goto cleanup;
+    }
+
+    int selected = sequences[0] == sequence ? 0 : 1;
+    struct checkpoint_header *header = &headers[selected];
+
+    starneig_message("Restarting from checkpoint %d in %s.",
+        (int) sequence, names[selected]);
+
+    if (checkpoint != NULL)
+        checkpoint->sequence = sequence;
+
+    fd = open(names[selected], O_RDONLY);
+    segments = malloc(header->segments*sizeof(struct checkpoint_segment));
+    if (fd == -1 || pread_all(fd, segments,
+    header->segments*sizeof(struct checkpoint_segment),
+    sizeof(struct checkpoint_header)) != 0) {
+        starneig_error("Failed to read checkpoint %s.", names[selected]);
+        ret = STARNEIG_GENERIC_ERROR;
+        goto cleanup;
+    }
+
+    //
+    // restore the locally owned tiles
+    //
+
+    size_t slot_size = (size_t) header->bm * header->bn * header->elemsize;
+    off_t offset = get_data_offset(header->segments);
+
+    for (int k = 0; k < CHECKPOINT_MEMBERS; k++) {
+        starneig_matrix_t matrix = matrices[k];
+        if (matrix == NULL)
+            continue;
+
+        int ibegin = STARNEIG_MATRIX_TILE_IDX(0, matrix);
+        int iend = STARNEIG_MATRIX_TILE_IDX(STARNEIG_MATRIX_M(matrix)-1, matrix);
+        int jbegin = STARNEIG_MATRIX_TILE_IDY(0, matrix);
+        int jend = STARNEIG_MATRIX_TILE_IDY(STARNEIG_MATRIX_N(matrix)-1, matrix);
+
+        for (int j = jbegin; j <= jend; j++) {
+            for (int i = ibegin; i <= iend; i++) {
+                if (!owns_tile(i, j, matrix, rank, mpi))
+                    continue;
+
+                starpu_data_handle_t tile =
+                    starneig_matrix_get_tile(i, j, matrix);
+                starpu_data_acquire(tile, STARPU_W);
+
+                char *A = (char *) starpu_matrix_get_local_ptr(tile);
+                size_t ldA = starpu_matrix_get_local_ld(tile);
+                int m = starpu_matrix_get_nx(tile);
+                int n = starpu_matrix_get_ny(tile);
+
+                int error = 0;
+                for (int l = 0; !error && l < n; l++)
+                    error = pread_all(fd, A + l*ldA*header->elemsize,
+                        m*header->elemsize,
+                        offset + (off_t)l*header->bm*header->elemsize);
+
+                starpu_data_release(tile);
+                offset += slot_size;
+
+                if (error) {
+                    starneig_error(
+                        "Failed to read checkpoint %s.", names[selected]);
+                    ret = STARNEIG_GENERIC_ERROR;
+                    goto cleanup;
+                }
+            }
+        }
+    }
+
+    //
+    // restore the segment list
+    //
+
+    *list = starneig_create_segment_list();
+    for (uint32_t i = 0; i < header->segments; i++) {
+        struct segment *segment = starneig_create_segment(
+            SEGMENT_BOOTSTRAP, segments[i].begin, segments[i].end);
+        segment->iter = segments[i].iter;
+        segment->aed_failed = segments[i].aed_failed;
+        starneig_add_segment_to_list_bottom(segment, *list);
+    }
+
+cleanup:
+
+    if (fd != -1)
+        close(fd);
+    free(segments);
+    free(names[0]);
+    free(names[1]);
+
+    return ret;
+}
@@ -0,0 +1,192 @@
+///
+/// @file
+///
+/// @brief This file contains the checkpoint/restart functionality of the
+/// QR/QZ algorithm.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_SCHUR_CHECKPOINT_H
+#define STARNEIG_SCHUR_CHECKPOINT_H
+
+#include <starneig_config.h>
+#include <starneig/configuration.h>
+#include "segment.h"
+#include "../common/common.h"
+#include "../common/matrix.h"
+#include <starneig/error.h>
+
+///
+/// @brief Checkpoint writer.
+///
+struct checkpoint;
+
+///
+/// @brief Creates a checkpoint writer.
+///
+///  In distributed memory, each MPI rank writes the tiles it owns to a file
+///  of its own (filename.rank).
+///
+/// @param[in] filename
+///         checkpoint filename
+///
+/// @param[in] interval
+///         number of QR/QZ iterations between checkpoints
+///
+/// @param[in] matrix_q
+///         matrix Q descriptor (or NULL)
+///
+/// @param[in] matrix_z
+///         matrix Z descriptor (or NULL)
+///
+/// @param[in] matrix_a
+///         matrix A descriptor
+///
+/// @param[in] matrix_b
+///         matrix B descriptor (or NULL)
+///
+/// @param[in] mpi
+///         MPI info
+///
+/// @return checkpoint writer
+///
+struct checkpoint * starneig_schur_checkpoint_init(
+    char const *filename, int interval,
+    starneig_matrix_t matrix_q, starneig_matrix_t matrix_z,
+    starneig_matrix_t matrix_a, starneig_matrix_t matrix_b, mpi_info_t mpi);
+
+///
+/// @brief Records a started QR/QZ iteration.
+///
+/// @param[in,out] checkpoint
+///         checkpoint writer (or NULL)
+///
+void starneig_schur_checkpoint_count(struct checkpoint *checkpoint);
+
+///
+/// @brief Checks whether a checkpoint should be written.
+///
+///  A checkpoint is due once the checkpoint interval has been reached and
+///  every segment is in a state that can be restarted from the matrices alone
+///  (SEGMENT_BOOTSTRAP, SEGMENT_NEW, SEGMENT_BULGES or SEGMENT_SKIPPED). The
+///  outcome is the same on all MPI ranks.
+///
+/// @param[in] list
+///         segment list
+///
+/// @param[in] checkpoint
+///         checkpoint writer (or NULL)
+///
+/// @return non-zero if a checkpoint should be written
+///
+int starneig_schur_checkpoint_due(
+    struct segment_list const *list, struct checkpoint const *checkpoint);
+
+///
+/// @brief Writes a checkpoint.
+///
+///  The segment list is written immediately. The matrices are written
+///  asynchronously by tasks that read one tile each. The tasks observe the
+///  matrices as they are after all previously inserted tasks. The checkpoint
+///  replaces the previous one once all tiles have been written. The function
+///  waits until the previous checkpoint has been written. The first checkpoint
+///  of a new sequence removes old checkpoint files.
+///
+/// @param[in] prio
+///         StarPU priority
+///
+/// @param[in] list
+///         segment list
+///
+/// @param[in,out] checkpoint
+///         checkpoint writer
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+void starneig_schur_checkpoint_insert(
+    int prio, struct segment_list const *list, struct checkpoint *checkpoint,
+    mpi_info_t mpi);
+
+///
+/// @brief Waits until the pending checkpoint has been written and frees a
+/// checkpoint writer.
+///
+/// @param[in,out] checkpoint
+///         checkpoint writer (or NULL)
+///
+void starneig_schur_checkpoint_free(struct checkpoint *checkpoint);
+
+///
+/// @brief Restores the matrices and the segment list from the latest
+/// complete checkpoint.
+///
+///  In distributed memory, the MPI ranks agree on the latest checkpoint that
+///  is complete on all of them. The restored segments are placed to the state
+///  SEGMENT_BOOTSTRAP.
+///
+/// @param[in] filename
+///         checkpoint filename
+///
+/// @param[in,out] matrix_q
+///         matrix Q descriptor (or NULL)
+///
+/// @param[in,out] matrix_z
+///         matrix Z descriptor (or NULL)
+///
+/// @param[in,out] matrix_a
+///         matrix A descriptor
+///
+/// @param[in,out] matrix_b
+///         matrix B descriptor (or NULL)
+///
+/// @param[in,out] mpi
+///         MPI info
+///
+/// @param[in,out] checkpoint
+///         checkpoint writer that continues the sequence of the restored
+///         checkpoint (or NULL)
+///
+/// @param[out] list
+///         restored segment list
+///
+/// @return error code
+///
+starneig_error_t starneig_schur_checkpoint_restore(
+    char const *filename,
+    starneig_matrix_t matrix_q, starneig_matrix_t matrix_z,
+    starneig_matrix_t matrix_a, starneig_matrix_t matrix_b, mpi_info_t mpi,
+    struct checkpoint *checkpoint, struct segment_list **list);
+
+#endif
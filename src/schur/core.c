@@ -52,11 +52,16 @@
 #include "core.h"
 #include "process_args.h"
 #include "segment.h"
+#include "checkpoint.h"
 #include "tasks.h"
 #include "../common/common.h"
 #include "../common/utils.h"
 #include "../common/tasks.h"
+#include "../common/multicast.h"
+#include "../common/transform_log.h"
+#include "../common/comm_stats.h"
 #include "../common/trace.h"
+#include "../common/progress.h"
 #include "../hessenberg/core.h"
 #include <math.h>
 #include <time.h>
@@ -76,10 +81,14 @@
 /// @param[in,out] args
 ///         Segment processing arguments.
 ///
+/// @param[in,out] checkpoint
+///         Checkpoint writer (or NULL).
+///
 /// @return Error code.
 ///
 static starneig_error_t scan_segment_list(
-    struct segment_list *list, struct process_args *args);
+    struct segment_list *list, struct process_args *args,
+    struct checkpoint *checkpoint);
 
 ///
 /// @brief Calls an appropriate state shift function for a given segment.
@@ -95,6 +104,89 @@ static starneig_error_t scan_segment_list(
 static enum segment_status process_segment(
     struct segment *segment, struct process_args *args);
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+
+///
+/// @brief Returns the fraction of an AED window that is assumed to deflate
+/// during a simulation.
+///
+///  The kernels are not executed when StarPU runs on top of SimGrid and the
+///  convergence of the QR/QZ algorithm must therefore be modelled. The
+///  fraction can be set with the STARNEIG_SIMGRID_DEFLATION environmental
+///  variable.
+///
+/// @return deflation fraction
+///
+static double get_simulated_deflation()
+{
+    static double deflation = -1.0;
+    if (deflation < 0.0) {
+        char *env = getenv("STARNEIG_SIMGRID_DEFLATION");
+        deflation = env != NULL ? atof(env) : 0.15;
+        if (deflation <= 0.0 || 1.0 <= deflation) {
+            starneig_warning(
+                "Invalid STARNEIG_SIMGRID_DEFLATION. Using 0.15.");
+            deflation = 0.15;
+        }
+    }
+    return deflation;
+}
+
+///
+/// @brief Replaces the outcome of a deflation window with a simulated one.
+///
+///  A fixed fraction of the deflation window deflates and the remaining
+///  diagonal blocks are left undeflated. The undeflated blocks fill at least
+///  one tile so that they are always moved and the deflation process advances.
+///
+/// @param[in] segment
+///         segment
+///
+/// @param[in] tile_size
+///         tile size
+///
+/// @param[out] status
+///         simulated deflation window status
+///
+static void simulate_deflate_status(
+    struct segment const *segment, int tile_size,
+    struct deflate_status *status)
+{
+    int end = segment->aed_deflate_bottom;
+    int begin = MAX(1, MAX(segment->aed_deflate_top-1,
+        ((end-1) / tile_size - 1) * tile_size));
+
+    int deflated = MAX(0, MIN(
+        get_simulated_deflation()*(end-begin), end-begin-tile_size));
+
+    status->begin = MAX(segment->aed_deflate_top, begin);
+    status->end = end - deflated;
+}
+
+///
+/// @brief Replaces the outcome of a small AED window with a simulated one.
+///
+/// @param[in] padded_size
+///         padded AED window size
+///
+/// @param[in] requested_shifts
+///         number of requested shifts
+///
+/// @param[out] status
+///         simulated AED status
+///
+static void simulate_aed_status(
+    int padded_size, int requested_shifts, struct aed_status *status)
+{
+    status->status = AED_STATUS_SUCCESS;
+    status->converged = MIN(padded_size-1,
+        MAX(1, get_simulated_deflation()*(padded_size-1)));
+    status->computed_shifts =
+        MIN(requested_shifts, padded_size-1-status->converged);
+}
+
+#endif
+
 ///
 /// @brief Window chain direction hint for the insert_updates and the
 /// insert_segment_updates functions.
@@ -105,6 +197,56 @@ enum update_direction_hint {
     UPDATE_DIRECTION_NONE   ///< no preferred direction
 };
 
+///
+/// @brief Inserts the Q and Z matrix updates that correspond to a given
+/// diagonal window. The local transformation matrices are recorded to the
+/// transformation logs instead when the Schur vector formation is deferred.
+///
+/// @param[in] begin
+///         First row/column that belongs to the diagonal window.
+///
+/// @param[in] end
+///         Last row/column that belongs to the diagonal window + 1.
+///
+/// @param[in] q_height
+///         Height of a Q matrix update task.
+///
+/// @param[in] z_height
+///         Height of a Z matrix update task.
+///
+/// @param[in] lQ_h
+///         Local left-hand size transformation matrix.
+///
+/// @param[in] lZ_h
+///         Local right-hand size transformation matrix.
+///
+/// @param[in,out] args
+///         Segment processing arguments.
+///
+static void insert_vector_updates(
+    int begin, int end, int q_height, int z_height,
+    starpu_data_handle_t lQ_h, starpu_data_handle_t lZ_h,
+    struct process_args *args)
+{
+    // update Q
+
+    if (args->log_q != NULL)
+        starneig_transform_log_record(begin, end, lQ_h, args->log_q);
+    else if (args->matrix_q != NULL)
+        starneig_insert_right_gemm_update(
+            0, STARNEIG_MATRIX_M(args->matrix_q), begin, end, q_height,
+            args->min_prio, lQ_h, args->matrix_q, args->mpi);
+
+    // update Z
+
+    if (args->log_z != NULL)
+        starneig_transform_log_record(begin, end, lZ_h, args->log_z);
+    else if (args->matrix_z != NULL)
+        starneig_insert_right_gemm_update(
+            0, STARNEIG_MATRIX_M(args->matrix_z), begin, end, z_height,
+            args->min_prio, lZ_h, args->matrix_z, args->mpi);
+}
+
 ///
 /// @brief Inserts update tasks that correspond to a given diagonal window.
 ///
@@ -168,19 +310,10 @@ static void insert_updates(
             left_prio, lQ_h, args->matrix_b, args->mpi);
     }
 
-    // update Q
-
-    if (args->matrix_q != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_q), begin, end, args->q_height,
-            args->min_prio, lQ_h, args->matrix_q, args->mpi);
+    // update Q and Z
 
-    // update Z
-
-    if (args->matrix_z != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_z), begin, end, args->z_height,
-            args->min_prio, lZ_h, args->matrix_z, args->mpi);
+    insert_vector_updates(
+        begin, end, args->q_height, args->z_height, lQ_h, lZ_h, args);
 }
 
 ///
@@ -265,19 +398,10 @@ static void insert_segment_updates(
 
     #undef update_matrix
 
-    // update Q
-
-    if (args->matrix_q != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_q), begin, end, args->q_height,
-            args->min_prio, lQ_h, args->matrix_q, args->mpi);
-
-    // update Z
+    // update Q and Z
 
-    if (args->matrix_z != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_z), begin, end, args->z_height,
-            args->min_prio, lZ_h, args->matrix_z, args->mpi);
+    insert_vector_updates(
+        begin, end, args->q_height, args->z_height, lQ_h, lZ_h, args);
 }
 
 ///
@@ -356,19 +480,10 @@ static void insert_reverse_updates(
 
     #undef update_matrix
 
-    // update Q
+    // update Q and Z
 
-    if (args->matrix_q != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_q), begin, end, args->q_height,
-            args->min_prio, lQ_h, args->matrix_q, args->mpi);
-
-    // update Z
-
-    if (args->matrix_z != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_z), begin, end, args->z_height,
-            args->min_prio, lZ_h, args->matrix_z, args->mpi);
+    insert_vector_updates(
+        begin, end, args->q_height, args->z_height, lQ_h, lZ_h, args);
 }
 
 ///
@@ -442,21 +557,12 @@ static void insert_aed_updates(
 
     #undef update_matrix
 
-    // update Q
-
-    if (args->matrix_q != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_q), begin, end,
-            STARNEIG_MATRIX_BM(args->matrix_q), args->min_prio, lQ_h,
-            args->matrix_q, args->mpi);
-
-    // update Z
+    // update Q and Z
 
-    if (args->matrix_z != NULL)
-        starneig_insert_right_gemm_update(
-            0, STARNEIG_MATRIX_M(args->matrix_z), begin, end,
-            STARNEIG_MATRIX_BM(args->matrix_z), args->min_prio, lZ_h,
-            args->matrix_z, args->mpi);
+    insert_vector_updates(begin, end,
+        args->matrix_q != NULL ? STARNEIG_MATRIX_BM(args->matrix_q) : 0,
+        args->matrix_z != NULL ? STARNEIG_MATRIX_BM(args->matrix_z) : 0,
+        lQ_h, lZ_h, args);
 }
 
 ///
@@ -523,8 +629,8 @@ static void insert_push_inf_top(
             insert_segment_updates(
                 wbegin, wend, lQ_h, lZ_h, segment, args, UPDATE_DIRECTION_UP);
 
-            starpu_data_unregister_submit(lQ_h);
-            starpu_data_unregister_submit(lZ_h);
+            starneig_multicast_unregister_submit(lQ_h);
+            starneig_multicast_unregister_submit(lZ_h);
 
             // quit if this was the topmost window in the chain
             if (wbegin == begin)
@@ -633,8 +739,8 @@ static void insert_bulges_fixed(
                 lQ_h, lZ_h, segment, args);
 
             if (lZ_h != NULL && lZ_h != lQ_h)
-                starpu_data_unregister_submit(lZ_h);
-            starpu_data_unregister_submit(lQ_h);
+                starneig_multicast_unregister_submit(lZ_h);
+            starneig_multicast_unregister_submit(lQ_h);
 
             i -= shifts_per_window;
         }
@@ -740,8 +846,8 @@ static void insert_bulges_rounded(
                 lQ_h, lZ_h, segment, args);
 
             if (lZ_h != NULL && lZ_h != lQ_h)
-                starpu_data_unregister_submit(lZ_h);
-            starpu_data_unregister_submit(lQ_h);
+                starneig_multicast_unregister_submit(lZ_h);
+            starneig_multicast_unregister_submit(lQ_h);
 
             i -= shifts_per_window;
         }
@@ -763,6 +869,170 @@ static void insert_bulges_rounded(
 #endif
 }
 
+///
+/// @brief Inserts a task that tests the shifts of a segment against the region
+/// predicate.
+///
+///  The shifts are the eigenvalues of the undeflated part of the AED window and
+///  they approximate the eigenvalues at the bottom of the segment. The outcome
+///  is consumed by update_region_misses() once the segment is processed again.
+///  The shifts are meaningless in a simulation and no task is inserted; every
+///  check is assumed to hit the region so that all segments are reduced.
+///
+/// @param[in,out] segment
+///         Segment.
+///
+/// @param[in,out] args
+///         Segment processing arguments.
+///
+static void check_region(struct segment *segment, struct process_args *args)
+{
+    if (args->region_disc == NULL || segment->status != SEGMENT_BULGES)
+        return;
+
+    if (segment->region_hit_h != NULL)
+        starpu_data_unregister_submit(segment->region_hit_h);
+
+#ifdef STARNEIG_ENABLE_SIMGRID
+    segment->region_hit_h = NULL;
+    segment->region_misses = 0;
+#else
+    segment->region_hit_h = starneig_schur_insert_check_region(
+        segment->computed_shifts, args->max_prio, args->region,
+        args->region_arg, segment->shifts_real, segment->shifts_imag,
+        args->mpi);
+#endif
+}
+
+///
+/// @brief Updates the region miss counter of a segment.
+///
+///  The region miss counter is reset if a shift fell inside the region and
+///  incremented otherwise.
+///
+/// @param[in,out] segment
+///         Segment.
+///
+static void update_region_misses(struct segment *segment)
+{
+    if (segment->region_hit_h == NULL)
+        return;
+
+    starpu_data_acquire(segment->region_hit_h, STARPU_R);
+    int hit = *((int *) starpu_variable_get_local_ptr(segment->region_hit_h));
+    starpu_data_release(segment->region_hit_h);
+    starpu_data_unregister_submit(segment->region_hit_h);
+    segment->region_hit_h = NULL;
+
+    if (hit)
+        segment->region_misses = 0;
+    else
+        segment->region_misses++;
+}
+
+///
+/// @brief Decides whether a segment can be left unreduced.
+///
+///  The shifts approximate only the eigenvalues at the bottom of the segment.
+///  Once they have fallen outside the region during region_patience
+///  consecutive AED steps, tasks that enclose the eigenvalues of the segment in
+///  a disc are inserted. The disc is tested against the region the next time
+///  the segment is processed; the segment can only have shrunk in the meantime
+///  and the disc still contains its eigenvalues. If the disc intersects the
+///  region, the region miss counter is reset.
+///
+/// @param[in,out] segment
+///         Segment.
+///
+/// @param[in,out] args
+///         Segment processing arguments.
+///
+/// @return Non-zero if the segment contains no eigenvalues from the region.
+///
+static int check_region_bound(
+    struct segment *segment, struct process_args *args)
+{
+    if (segment->region_bound_h != NULL) {
+        starpu_data_acquire(segment->region_bound_h, STARPU_R);
+        int hit = *((int *)
+            starpu_variable_get_local_ptr(segment->region_bound_h));
+        starpu_data_release(segment->region_bound_h);
+        starpu_data_unregister_submit(segment->region_bound_h);
+        segment->region_bound_h = NULL;
+
+        if (!hit)
+            return 1;
+
+        segment->region_misses = 0;
+        return 0;
+    }
+
+    if (args->region_patience <= segment->region_misses)
+        segment->region_bound_h = starneig_schur_insert_check_region_bound(
+            segment->begin, segment->end, args->max_prio, args->region_disc,
+            args->region_arg, args->matrix_a, args->mpi);
+
+    return 0;
+}
+
+///
+/// @brief Inserts progress markers for the diagonal entries that have been
+/// deflated since the previous call.
+///
+///  Everything outside the remaining segments has been deflated. The deflated
+///  entries are reported once the tasks that modify the corresponding
+///  diagonal tiles have finished, not when the deflation is first observed.
+///
+/// @param[in] list
+///         Segment list.
+///
+/// @param[in,out] reported
+///         Non-zero for each diagonal entry that has already been reported.
+///
+/// @param[out] active
+///         Workspace of size n.
+///
+/// @param[in] A
+///         Matrix A.
+///
+/// @param[in,out] mpi
+///         MPI info.
+///
+static void insert_progress_markers(
+    struct segment_list const *list, char *reported, char *active,
+    starneig_matrix_t A, mpi_info_t mpi)
+{
+    int n = STARNEIG_MATRIX_M(A);
+    int bm = STARNEIG_MATRIX_BM(A);
+    int bn = STARNEIG_MATRIX_BN(A);
+
+    memset(active, 0, n*sizeof(char));
+    for (struct segment *it = list->top; it != NULL; it = it->down)
+        for (int i = it->begin; i < it->end; i++)
+            active[i] = 1;
+
+    int begin = 0;
+    while (begin < n) {
+        if (active[begin] || reported[begin]) {
+            begin++;
+            continue;
+        }
+
+        // a run of newly deflated entries that ends at the end of a tile or
+        // at the first active or already reported entry
+        int tile = (STARNEIG_MATRIX_RBEGIN(A) + begin) / bm;
+        int end = begin;
+        while (end < n && !active[end] && !reported[end] &&
+        (STARNEIG_MATRIX_RBEGIN(A) + end) / bm == tile)
+            reported[end++] = 1;
+
+        starneig_progress_insert_marker(end - begin, starneig_matrix_get_tile(
+            tile, (STARNEIG_MATRIX_CBEGIN(A) + end - 1) / bn, A), mpi);
+
+        begin = end;
+    }
+}
+
 ///
 /// @brief Performs deflation process finalization.
 ///
@@ -792,12 +1062,14 @@ static enum segment_status perform_deflate_finalize(
     //
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (args->mpi != NULL)
+    if (args->mpi != NULL) {
+        starneig_comm_stats_broadcast(segment->aed_status_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), segment->aed_status_h);
+    }
 #endif
 
-    starpu_data_acquire(segment->aed_status_h, STARPU_R);
+    starneig_comm_stats_acquire(segment->aed_status_h, STARPU_R);
     struct aed_status *status = (struct aed_status *)
         starpu_variable_get_local_ptr(segment->aed_status_h);
 
@@ -908,8 +1180,8 @@ static enum segment_status perform_deflate_finalize(
                     &segment->aed_args, UPDATE_DIRECTION_NONE);
 
                 if (_lZ != NULL && _lZ != _lQ)
-                    starpu_data_unregister_submit(_lZ);
-                starpu_data_unregister_submit(_lQ);
+                    starneig_multicast_unregister_submit(_lZ);
+                starneig_multicast_unregister_submit(_lQ);
 
             }
             else {
@@ -969,8 +1241,8 @@ static enum segment_status perform_deflate_finalize(
             segment->aed_begin, segment->end, lQ, lZ, segment, args);
 
         if (lZ != lQ)
-            starpu_data_unregister_submit(lZ);
-        starpu_data_unregister_submit(lQ);
+            starneig_multicast_unregister_submit(lZ);
+        starneig_multicast_unregister_submit(lQ);
 
         //
         // resize the segment
@@ -1042,6 +1314,8 @@ cleanup:
     starneig_vector_free(segment->aed_deflate_base);
     segment->aed_deflate_base = NULL;
 
+    check_region(segment, args);
+
     starneig_vector_free(segment->shifts_real);
     segment->shifts_real = NULL;
 
@@ -1104,6 +1378,10 @@ static enum segment_status perform_deflate_step(
             starpu_variable_get_local_ptr(segment->aed_deflate_status_h));
         starpu_data_release(segment->aed_deflate_status_h);
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+        simulate_deflate_status(segment, tile_size, &deflate_status);
+#endif
+
         // record progress
         segment->aed_deflate_bottom = deflate_status.end;
         if (deflate_status.begin <= segment->aed_deflate_top)
@@ -1161,8 +1439,8 @@ static enum segment_status perform_deflate_step(
                         UPDATE_DIRECTION_UP);
 
                     if (lZ_h != NULL && lZ_h != lQ_h)
-                        starpu_data_unregister_submit(lZ_h);
-                    starpu_data_unregister_submit(lQ_h);
+                        starneig_multicast_unregister_submit(lZ_h);
+                    starneig_multicast_unregister_submit(lQ_h);
 
                     // last/topmost reordering window?
                     if (begin <= segment->aed_deflate_top)
@@ -1224,8 +1502,8 @@ static enum segment_status perform_deflate_step(
             UPDATE_DIRECTION_UP);
 
         if (lZ_h != NULL && lZ_h != lQ_h)
-            starpu_data_unregister_submit(lZ_h);
-        starpu_data_unregister_submit(lQ_h);
+            starneig_multicast_unregister_submit(lZ_h);
+        starneig_multicast_unregister_submit(lQ_h);
     }
     // otherwise all blocks have been checked, ...
     else {
@@ -1272,7 +1550,7 @@ static enum segment_status perform_single_shot_aed(
     // reduce the AED window to Schur form
     while (segment->children->top != NULL) {
         starneig_error_t ret =
-            scan_segment_list(segment->children, &segment->aed_args);
+            scan_segment_list(segment->children, &segment->aed_args, NULL);
         if (ret != STARNEIG_SUCCESS) {
             starneig_verbose("Large AED related QR/QZ failed.");
             return perform_deflate_finalize(segment, args);
@@ -1332,15 +1610,17 @@ static enum segment_status perform_small(
         UPDATE_DIRECTION_NONE);
 
     if (lZ_h != NULL && lZ_h != lQ_h)
-        starpu_data_unregister_submit(lZ_h);
-    starpu_data_unregister_submit(lQ_h);
+        starneig_multicast_unregister_submit(lZ_h);
+    starneig_multicast_unregister_submit(lQ_h);
 
     // gather the small QR task state to all MPI nodes
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (args->mpi != NULL)
+    if (args->mpi != NULL) {
+        starneig_comm_stats_broadcast(segment->small_status_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), segment->small_status_h);
+    }
 #endif
 
     segment->status = SEGMENT_SMALL;
@@ -1395,9 +1675,11 @@ static enum segment_status perform_small_aed(
     // gather the AED window task state to all MPI nodes
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (args->mpi != NULL)
+    if (args->mpi != NULL) {
+        starneig_comm_stats_broadcast(segment->aed_status_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), segment->aed_status_h);
+    }
 #endif
 
     segment->status = SEGMENT_AED_SMALL;
@@ -1608,6 +1890,11 @@ static enum segment_status perform_aftermath_check(
             starneig_vector_get_in_tile_idx(
                 segment->end, i, segment->bulges_aftermath));
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+        // the simulated bulge chasing never causes deflations
+        _end = _begin;
+#endif
+
         // scan the current tile
         for (int j = _begin; j < _end; j++) {
 
@@ -1894,6 +2181,18 @@ static enum segment_status process_segment_new(
 
     int small_limit = evaluate_parameter(segment_size, args->small_limit);
 
+    update_region_misses(segment);
+
+    // leave the segment unreduced if its eigenvalues are outside the region;
+    // small segments are cheap to finish
+    if (args->region_disc != NULL && small_limit <= segment_size &&
+    check_region_bound(segment, args)) {
+        starneig_verbose("Segment [%d,%d[ is outside the region.",
+            segment->begin, segment->end);
+        segment->status = SEGMENT_SKIPPED;
+        return SEGMENT_SKIPPED;
+    }
+
     int aed_parallel_soft_limit =
         evaluate_parameter(segment_size, args->aed_parallel_soft_limit);
     int aed_parallel_hard_limit =
@@ -1994,12 +2293,18 @@ static enum segment_status process_segment_new(
 static enum segment_status process_segment_small(
     struct segment *segment, struct process_args *args)
 {
-    starpu_data_acquire(segment->small_status_h, STARPU_R);
+    starneig_comm_stats_acquire(segment->small_status_h, STARPU_R);
 
     struct small_schur_status const * status =
         (struct small_schur_status const *) starpu_variable_get_local_ptr(
             segment->small_status_h);
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    struct small_schur_status simulated = {
+        .converged = segment->end - segment->begin };
+    status = &simulated;
+#endif
+
     if (status->converged < segment->end - segment->begin) {
         segment->status = SEGMENT_FAILURE;
     }
@@ -2036,7 +2341,7 @@ static enum segment_status process_segment_small(
 static enum segment_status process_segment_aed_small(
     struct segment *segment, struct process_args *args)
 {
-    starpu_data_acquire(segment->aed_status_h, STARPU_R);
+    starneig_comm_stats_acquire(segment->aed_status_h, STARPU_R);
 
     struct aed_status const *status = (struct aed_status const *)
         starpu_variable_get_local_ptr(segment->aed_status_h);
@@ -2047,6 +2352,12 @@ static enum segment_status process_segment_aed_small(
     int requested_shifts = MIN(0.30*padded_size, evaluate_parameter(
         segment->end - segment->begin, args->shift_count));
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    struct aed_status simulated;
+    simulate_aed_status(padded_size, requested_shifts, &simulated);
+    status = &simulated;
+#endif
+
     int nibble = evaluate_parameter(
         segment->end - segment->begin, args->aed_nibble);
 
@@ -2073,10 +2384,10 @@ static enum segment_status process_segment_aed_small(
 
     starneig_verbose("Deflated %d eigenvalues.", status->converged);
 
-    starpu_data_unregister_submit(segment->aed_small_lQ_h);
+    starneig_multicast_unregister_submit(segment->aed_small_lQ_h);
     if (segment->aed_small_lZ_h != NULL &&
     segment->aed_small_lZ_h != segment->aed_small_lQ_h)
-        starpu_data_unregister_submit(segment->aed_small_lZ_h);
+        starneig_multicast_unregister_submit(segment->aed_small_lZ_h);
     segment->aed_small_lQ_h = NULL;
     segment->aed_small_lZ_h = NULL;
 
@@ -2110,6 +2421,8 @@ static enum segment_status process_segment_aed_small(
     starpu_data_unregister_submit(segment->aed_status_h);
     segment->aed_status_h = NULL;
 
+    check_region(segment, args);
+
     starneig_vector_free(segment->shifts_real);
     segment->shifts_real = NULL;
 
@@ -2140,7 +2453,7 @@ static enum segment_status process_segment_aed_schur(
 {
     {
         starneig_error_t ret =
-            scan_segment_list(segment->children, &segment->aed_args);
+            scan_segment_list(segment->children, &segment->aed_args, NULL);
         if (ret != STARNEIG_SUCCESS)
             return perform_deflate_finalize(segment, args);
     }
@@ -2216,6 +2529,8 @@ static char const * status_to_str(enum segment_status status) {
             return "SEGMENT_CHILDREN";
         case SEGMENT_CONVERGED:
             return "SEGMENT_CONVERGED";
+        case SEGMENT_SKIPPED:
+            return "SEGMENT_SKIPPED";
         case SEGMENT_FAILURE:
             return "SEGMENT_FAILURE";
         default:
@@ -2237,6 +2552,12 @@ static enum segment_status process_segment(
             "vvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvvv");
     }
 
+    if (segment->status == SEGMENT_BOOTSTRAP ||
+    segment->status == SEGMENT_BULGES)
+        starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_BULGES);
+    else
+        starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_AED);
+
     switch (segment->status) {
         case SEGMENT_BOOTSTRAP:
             // ===> SEGMENT_BULGES
@@ -2270,6 +2591,8 @@ static enum segment_status process_segment(
             // the current segment will be replaced by it's children
         case SEGMENT_CONVERGED:
             // the current segment will be removed
+        case SEGMENT_SKIPPED:
+            // the current segment is left unreduced
         case SEGMENT_FAILURE:
             // the current segment is reported as a failure
             break;
@@ -2293,13 +2616,16 @@ static enum segment_status process_segment(
 }
 
 static starneig_error_t scan_segment_list(
-    struct segment_list *list, struct process_args *args)
+    struct segment_list *list, struct process_args *args,
+    struct checkpoint *checkpoint)
 {
     // loop over the segments
     struct segment *iter = list->top;
     while (iter != NULL) {
 
         // process segment
+        if (iter->status == SEGMENT_NEW)
+            starneig_schur_checkpoint_count(checkpoint);
         process_segment(iter, args);
 
         // if the segment converged, ...
@@ -2332,9 +2658,34 @@ static starneig_error_t scan_segment_list(
         }
     }
 
+    // checkpoint at the segment list boundary if the segments can be restarted
+    if (starneig_schur_checkpoint_due(list, checkpoint)) {
+        starneig_transform_log_flush(args->log_q);
+        starneig_transform_log_flush(args->log_z);
+        starneig_schur_checkpoint_insert(
+            args->max_prio, list, checkpoint, args->mpi);
+    }
+
     return STARNEIG_SUCCESS;
 }
 
+///
+/// @brief Checks whether a segment list contains segments that are still
+/// being reduced.
+///
+/// @param[in] list
+///         Segment list.
+///
+/// @return Non-zero if the segment list contains active segments.
+///
+static int has_active_segments(struct segment_list const *list)
+{
+    for (struct segment *it = list->top; it != NULL; it = it->down)
+        if (it->status != SEGMENT_SKIPPED)
+            return 1;
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -2352,6 +2703,9 @@ starneig_error_t starneig_schur_insert_tasks(
 {
     starneig_error_t ret = STARNEIG_SUCCESS;
     struct segment_list *list = NULL;
+    struct transform_log *log_q = NULL, *log_z = NULL;
+    struct checkpoint *checkpoint = NULL;
+    int phase = starneig_comm_stats_set_phase(STARNEIG_COMM_PHASE_OTHER);
 
     //
     // check threshold arguments
@@ -2383,6 +2737,27 @@ starneig_error_t starneig_schur_insert_tasks(
         goto cleanup;
     }
 
+    if (conf->restart && conf->checkpoint_file == NULL) {
+        starneig_error("Restarting requires a checkpoint file.");
+        ret = STARNEIG_INVALID_CONFIGURATION;
+        goto cleanup;
+    }
+
+    //
+    // restore the checkpoint
+    //
+
+    if (conf->checkpoint_file != NULL)
+        checkpoint = starneig_schur_checkpoint_init(
+            conf->checkpoint_file, conf->checkpoint_interval, Q, Z, A, B, mpi);
+
+    if (conf->restart) {
+        ret = starneig_schur_checkpoint_restore(
+            conf->checkpoint_file, Q, Z, A, B, mpi, checkpoint, &list);
+        if (ret != STARNEIG_SUCCESS)
+            goto cleanup;
+    }
+
     //
     // compute norms if necessary
     //
@@ -2471,6 +2846,20 @@ starneig_error_t starneig_schur_insert_tasks(
     if (ret != STARNEIG_SUCCESS)
         goto cleanup;
 
+    //
+    // prepare for deferred Schur vector formation
+    //
+
+    if (conf->defer_transforms) {
+        if (Q != NULL)
+            args.log_q = log_q = starneig_transform_log_init(
+                args.q_height, args.min_prio, 4*STARNEIG_MATRIX_BN(Q), Q, mpi);
+        if (Z != NULL)
+            args.log_z = log_z = starneig_transform_log_init(
+                args.z_height, args.min_prio, 4*STARNEIG_MATRIX_BN(Z), Z, mpi);
+        starneig_message("Deferring Schur vector formation.");
+    }
+
     starneig_message("Using AED windows size %d.", (int)
         evaluate_parameter(STARNEIG_MATRIX_N(A), args.aed_window_size));
     starneig_message("Using %d shifts.", (int)
@@ -2480,18 +2869,48 @@ starneig_error_t starneig_schur_insert_tasks(
     // prepare for the bootstrap process
     //
 
-    list = starneig_create_segment_list();
-    starneig_add_segment_to_list_top(starneig_create_segment(
-        SEGMENT_BOOTSTRAP, 0, STARNEIG_MATRIX_M(A)), list);
+    if (list == NULL) {
+        list = starneig_create_segment_list();
+        starneig_add_segment_to_list_top(starneig_create_segment(
+            SEGMENT_BOOTSTRAP, 0, STARNEIG_MATRIX_M(A)), list);
+    }
 
     //
     // main loop
     //
 
-    while (list->top != NULL) {
-        ret = scan_segment_list(list, &args);
-        if (ret != STARNEIG_SUCCESS)
+    starneig_progress_set_total(STARNEIG_MATRIX_M(A));
+    char *reported = calloc(STARNEIG_MATRIX_M(A), sizeof(char));
+    char *active = malloc(STARNEIG_MATRIX_M(A)*sizeof(char));
+
+    while (has_active_segments(list)) {
+        ret = scan_segment_list(list, &args, checkpoint);
+        if (ret != STARNEIG_SUCCESS) {
+            free(reported);
+            free(active);
             goto cleanup;
+        }
+
+        insert_progress_markers(list, reported, active, A, mpi);
+    }
+
+    free(reported);
+    free(active);
+
+    //
+    // mark the final diagonal blocks
+    //
+
+    int unreduced = 0;
+    for (struct segment *it = list->top; it != NULL; it = it->down)
+        unreduced += it->end - it->begin;
+
+    if (conf->region != NULL && conf->region_final != NULL) {
+        for (int i = 0; i < STARNEIG_MATRIX_M(A); i++)
+            conf->region_final[i] = 1;
+        for (struct segment *it = list->top; it != NULL; it = it->down)
+            for (int i = it->begin; i < it->end; i++)
+                conf->region_final[i] = 0;
     }
 
     //
@@ -2502,8 +2921,26 @@ starneig_error_t starneig_schur_insert_tasks(
         starneig_insert_extract_eigenvalues(
             STARPU_MAX_PRIO, A, B, real, imag, beta, mpi);
 
+    if (0 < unreduced) {
+        starneig_message(
+            "Left %d diagonal entries outside the region unreduced.",
+            unreduced);
+        ret = STARNEIG_PARTIAL_SCHUR;
+    }
+
 cleanup:
 
+    //
+    // form the Schur vectors
+    //
+
+    starneig_transform_log_free(log_q);
+    starneig_transform_log_free(log_z);
+
+    starneig_schur_checkpoint_free(checkpoint);
+
+    starneig_comm_stats_set_phase(phase);
+
     //
     // clean up
     //
@@ -46,6 +46,7 @@
 #include "../common/sanity.h"
 #include "../common/tiles.h"
 #include "../common/math.h"
+#include "../common/alloc.h"
 #include "../common/trace.h"
 #include <math.h>
 
@@ -744,7 +745,7 @@ void starneig_cpu_deflate(void *buffers[], void *cl_arg)
         lwork = size+1;
     }
 
-    double *work = malloc(lwork*sizeof(double));
+    double *work = starneig_alloc_aligned(lwork*sizeof(double));
 
 #ifdef STARNEIG_ENABLE_SANITY_CHECKS
     //
@@ -1000,7 +1001,7 @@ void starneig_cpu_deflate(void *buffers[], void *cl_arg)
     starneig_free_matrix(Q);
     if (Z != Q)
         starneig_free_matrix(Z);
-    free(work);
+    starneig_free_aligned(work);
 
     STARNEIG_EVENT_END();
 }
@@ -1061,6 +1062,85 @@ void starneig_cpu_extract_shifts(void *buffers[], void *cl_args)
     free(imag);
 }
 
+void starneig_cpu_check_region(void *buffers[], void *cl_args)
+{
+    int count;
+    int (*region)(double, double, double, void *);
+    void *region_arg;
+    starpu_codelet_unpack_args(cl_args, &count, &region, &region_arg);
+
+    double *real = (double *) STARPU_VECTOR_GET_PTR(buffers[0]);
+    double *imag = (double *) STARPU_VECTOR_GET_PTR(buffers[1]);
+
+    int hit = 0;
+    for (int i = 0; !hit && i < count; i++)
+        hit = region(real[i], imag[i], 1.0, region_arg) != 0;
+
+    *((int *)STARPU_VARIABLE_GET_PTR(buffers[2])) = hit;
+}
+
+void starneig_cpu_compute_bound_a(void *buffers[], void *cl_args)
+{
+    int rbegin, rend, cbegin, cend, offset;
+    starpu_codelet_unpack_args(
+        cl_args, &rbegin, &rend, &cbegin, &cend, &offset);
+
+    double *A = (double *) STARPU_MATRIX_GET_PTR(buffers[0]);
+    int ldA = STARPU_MATRIX_GET_LD(buffers[0]);
+
+    double dot = 0.0, min = INFINITY, max = -INFINITY;
+    for (int j = cbegin; j < cend; j++) {
+        for (int i = rbegin; i < rend; i++) {
+            if (i - j == offset) {
+                min = MIN(min, A[j*ldA+i]);
+                max = MAX(max, A[j*ldA+i]);
+                if (isnan(A[j*ldA+i]))
+                    dot = NAN;
+            }
+            else {
+                dot += squ(A[j*ldA+i]);
+            }
+        }
+    }
+
+    double *bound = (double *) STARPU_VARIABLE_GET_PTR(buffers[1]);
+    bound[0] = dot;
+    bound[1] = min;
+    bound[2] = max;
+}
+
+void starneig_cpu_check_region_bound(void *buffers[], void *cl_args)
+{
+    int n, count;
+    int (*region_disc)(double, double, double, void *);
+    void *region_arg;
+    starpu_codelet_unpack_args(
+        cl_args, &n, &count, &region_disc, &region_arg);
+
+    double dot = 0.0, min = INFINITY, max = -INFINITY;
+    for (int i = 0; i < count; i++) {
+        double const *bound =
+            (double const *) STARPU_VARIABLE_GET_PTR(buffers[i]);
+        dot += bound[0];
+        min = MIN(min, bound[1]);
+        max = MAX(max, bound[2]);
+    }
+
+    // A = D + N, where D is diagonal and N is off-diagonal. The eigenvalues
+    // of A are within ||A - cI||_2 <= ||D - cI||_2 + ||N||_F from the center
+    // c of the diagonal entries. The radius is padded to cover the rounding
+    // errors.
+    double center = 0.5*(min + max);
+    double radius = 0.5*(max - min) + sqrt(dot);
+    radius += n*dlamch("Precision")*(radius + MAX(fabs(min), fabs(max)));
+
+    int hit = 1;
+    if (isfinite(center) && isfinite(radius))
+        hit = region_disc(center, 0.0, radius, region_arg) != 0;
+
+    *((int *)STARPU_VARIABLE_GET_PTR(buffers[count])) = hit;
+}
+
 void starneig_cpu_compute_norm_a(void *buffers[], void *cl_args)
 {
     int rbegin, rend, cbegin, cend;
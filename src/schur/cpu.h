@@ -115,6 +115,30 @@ void starneig_cpu_deflate(void *buffers[], void *cl_arg);
 ///
 void starneig_cpu_extract_shifts(void *buffers[], void *cl_args);
 
+///
+/// @prief check_region codelet / CPU implementation.
+///
+/// @param[in,out] buffers  StarPU buffers
+/// @param[in]     cl_arg   StarPU arguments
+///
+void starneig_cpu_check_region(void *buffers[], void *cl_args);
+
+///
+/// @prief compute_bound_a codelet / CPU implementation.
+///
+/// @param[in,out] buffers  StarPU buffers
+/// @param[in]     cl_arg   StarPU arguments
+///
+void starneig_cpu_compute_bound_a(void *buffers[], void *cl_args);
+
+///
+/// @prief check_region_bound codelet / CPU implementation.
+///
+/// @param[in,out] buffers  StarPU buffers
+/// @param[in]     cl_arg   StarPU arguments
+///
+void starneig_cpu_check_region_bound(void *buffers[], void *cl_args);
+
 ///
 /// @prief compute_norm_a codelet / CPU implementation.
 ///
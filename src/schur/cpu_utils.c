@@ -44,6 +44,7 @@
 #include "../common/common.h"
 #include "../common/sanity.h"
 #include "../common/math.h"
+#include "../common/alloc.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -1837,11 +1838,14 @@ static size_t get_push_bulges_workspace(
     const int batch = 16;
     int window_size = MIN(n, 3*batch+2);
 
+    size_t ld = starneig_alloc_ld(window_size, sizeof(double));
+    size_t ldvT = starneig_alloc_ld(n, sizeof(double));
+
     size_t lwork = 0;
-    lwork += window_size * divceil(window_size, 8)*8;
+    lwork += window_size * ld;
     if (0 < ldB)
-        lwork += window_size * divceil(window_size, 8)*8;
-    lwork += MAX(n * divceil(window_size, 8)*8, window_size * divceil(n, 8)*8);
+        lwork += window_size * ld;
+    lwork += MAX(n * ld, window_size * ldvT);
 
     return lwork;
 }
@@ -2038,22 +2042,22 @@ static void perform_push_bulges(
             break;
     }
 
-    int ldlQ = divceil(window_size, 8)*8;
+    int ldlQ = starneig_alloc_ld(window_size, sizeof(double));
     double *lQ = work;
     work += window_size*ldlQ;
 
     int ldlZ = ldlQ;
     double *lZ = lQ;
     if (B != NULL) {
-        ldlZ = divceil(window_size, 8)*8;
+        ldlZ = starneig_alloc_ld(window_size, sizeof(double));
         lZ = work;
         work += window_size*ldlZ;
     }
 
-    int ldhT = divceil(window_size, 8)*8;
+    int ldhT = starneig_alloc_ld(window_size, sizeof(double));
     double *hT = work;
 
-    int ldvT = divceil(n, 8)*8;
+    int ldvT = starneig_alloc_ld(n, sizeof(double));
     double *vT = work;
 
     // divide the shifts to batches
@@ -2341,7 +2345,7 @@ static size_t get_small_schur_reduction_workspace(
         return get_lapack_schur_reduction_workspace(
             0, n, n, ldQ, ldZ, ldA, ldB);
 
-    int lwork = 0, ld = divceil(window_size, 8)*8;
+    int lwork = 0, ld = starneig_alloc_ld(window_size, sizeof(double));
 
     if (0 < ldB) {
         lwork += 4*window_size * ld;
@@ -2354,7 +2358,7 @@ static size_t get_small_schur_reduction_workspace(
             0, window_size, window_size, ld, ld, ld, 0);
     }
 
-    lwork += MAX(n*ld, window_size*divceil(n, 8)*8);
+    lwork += MAX(n*ld, window_size*starneig_alloc_ld(n, sizeof(double)));
 
     return lwork;
 }
@@ -2453,9 +2457,9 @@ static int perform_small_schur_reduction(
         *__hT = NULL, *__vT = NULL;
     double *__work = work;
     int __lwork = lwork;
-    int __ld = divceil(window_size, 8)*8;
-    int __ldhT = divceil(window_size, 8)*8;
-    int __ldvT = divceil(n, 8)*8;
+    int __ld = starneig_alloc_ld(window_size, sizeof(double));
+    int __ldhT = starneig_alloc_ld(window_size, sizeof(double));
+    int __ldvT = starneig_alloc_ld(n, sizeof(double));
 
     #define add_work(__X, __X_size) \
         __X = __work; __work += __X_size; __lwork -= __X_size
@@ -3089,7 +3093,7 @@ static size_t get_schur_reduction_workspace(
 
     size_t aed_lwork = 0;
 
-    int ld = divceil(aed_window_size, 8)*8;
+    int ld = starneig_alloc_ld(aed_window_size, sizeof(double));
     if (0 < ldB) {
         aed_lwork += get_aggressively_deflate_workspace(
             aed_window_size, ld, ld, ld, ld);
@@ -3101,8 +3105,8 @@ static size_t get_schur_reduction_workspace(
         aed_lwork += 2*aed_window_size*ld;
     }
 
-    aed_lwork +=
-        MAX(n*divceil(aed_window_size, 8)*8, aed_window_size*divceil(n, 8)*8);
+    aed_lwork += MAX(
+        n*ld, aed_window_size*starneig_alloc_ld(n, sizeof(double)));
 
     return MAX(aed_lwork, MAX(
         get_push_bulges_workspace(n, ldQ, ldZ, ldA, ldB),
@@ -3217,9 +3221,9 @@ static int perform_schur_reduction(
         *__hT = NULL, *__vT = NULL, *__work = NULL;
     int __lwork = 0, __ld = 0, __ldhT = 0, __ldvT = 0;
     if (small_limit < end-begin) {
-        __ld = divceil(aed_window_size, 8)*8;
-        __ldhT = divceil(aed_window_size, 8)*8;
-        __ldvT = divceil(n, 8)*8;
+        __ld = starneig_alloc_ld(aed_window_size, sizeof(double));
+        __ldhT = starneig_alloc_ld(aed_window_size, sizeof(double));
+        __ldvT = starneig_alloc_ld(n, sizeof(double));
 
         __work = work;
         __lwork = lwork;
@@ -3425,13 +3429,13 @@ void starneig_push_bulges(
     size_t lwork = get_push_bulges_workspace(n, ldQ, ldZ, ldA, ldB);
     double *work = NULL;
     if (0 < lwork)
-        work = malloc(lwork*sizeof(double));
+        work = starneig_alloc_aligned(lwork*sizeof(double));
 
     perform_push_bulges(
         mode, 0, n, shifts, n, ldQ, ldZ, ldA, ldB, lwork,
         thres_a, thres_b, thres_inf, real, imag, Q, Z, A, B, work);
 
-    free(work);
+    starneig_free_aligned(work);
 }
 
 void starneig_aggressively_deflate(
@@ -3443,13 +3447,13 @@ void starneig_aggressively_deflate(
     size_t lwork = get_aggressively_deflate_workspace(n, ldQ, ldZ, ldA, ldB);
     double *work = NULL;
     if (0 < lwork)
-        work = malloc(lwork*sizeof(double));
+        work = starneig_alloc_aligned(lwork*sizeof(double));
 
     perform_aggressively_deflate(
         n, ldQ, ldZ, ldA, ldB, lwork, thres_a, thres_b, thres_inf,
         real, imag, Q, Z, A, B, work, unconverged, converged);
 
-    free(work);
+    starneig_free_aligned(work);
 }
 
 int starneig_schur_reduction(
@@ -3461,13 +3465,13 @@ int starneig_schur_reduction(
     size_t lwork = get_schur_reduction_workspace(0, n, n, ldQ, ldZ, ldA, ldB);
     double *work = NULL;
     if (0 < lwork)
-        work = malloc(lwork*sizeof(double));
+        work = starneig_alloc_aligned(lwork*sizeof(double));
 
     int bottom = perform_schur_reduction(
         0, n, n, ldQ, ldZ, ldA, ldB, lwork, thres_a, thres_b, thres_inf,
         real, imag, beta, Q, Z, A, B, work);
 
-    free(work);
+    starneig_free_aligned(work);
 
     return bottom;
 }
@@ -3480,12 +3484,12 @@ int starneig_hessenberg_reduction(
         0, n, n, ldQ, ldZ, ldA, ldB);
     double *work = NULL;
     if (0 < lwork)
-        work = malloc(lwork*sizeof(double));
+        work = starneig_alloc_aligned(lwork*sizeof(double));
 
     int bottom = perform_hessenberg_reduction(
         0, n, n, ldQ, ldZ, ldA, ldB, lwork, Q, Z, A, B, work);
 
-    free(work);
+    starneig_free_aligned(work);
 
     return bottom;
 }
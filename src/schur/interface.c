@@ -43,6 +43,7 @@
 #include "../common/utils.h"
 #include "../common/node_internal.h"
 #include "../common/trace.h"
+#include "../common/progress.h"
 #include <starneig/sep_sm.h>
 #include <starneig/gep_sm.h>
 
@@ -128,8 +129,6 @@ static starneig_error_t schur(
     // insert tasks
     //
 
-    STARNEIG_EVENT_INIT();
-
     starneig_error_t ret = starneig_schur_insert_tasks(
         conf, Q_d, Z_d, A_d, B_d, real_d, imag_d, beta_d, NULL);
 
@@ -153,9 +152,6 @@ static starneig_error_t schur(
     starneig_vector_free(imag_d);
     starneig_vector_free(beta_d);
 
-    STARNEIG_EVENT_STORE(n, "trace.dat");
-    STARNEIG_EVENT_FREE();
-
     return ret;
 }
 
@@ -185,6 +181,15 @@ void starneig_schur_init_conf(struct starneig_schur_conf *conf)
     conf->left_threshold = STARNEIG_SCHUR_DEFAULT_THRESHOLD;
     conf->right_threshold = STARNEIG_SCHUR_DEFAULT_THRESHOLD;
     conf->inf_threshold = STARNEIG_SCHUR_DEFAULT_THRESHOLD;
+    conf->defer_transforms = STARNEIG_SCHUR_DEFAULT_DEFER_TRANSFORMS;
+    conf->checkpoint_file = NULL;
+    conf->checkpoint_interval = STARNEIG_SCHUR_DEFAULT_CHECKPOINT_INTERVAL;
+    conf->restart = 0;
+    conf->region = NULL;
+    conf->region_disc = NULL;
+    conf->region_arg = NULL;
+    conf->region_patience = STARNEIG_SCHUR_DEFAULT_REGION_PATIENCE;
+    conf->region_final = NULL;
 }
 
 __attribute__ ((visibility ("default")))
@@ -208,10 +213,15 @@ starneig_error_t starneig_SEP_SM_Schur_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("schur");
+    starneig_progress_begin("schur");
+
     starneig_error_t ret = schur(
         conf, n, ldQ, 0, ldH, 0, Q, NULL, H, NULL, real, imag, NULL);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
@@ -264,10 +274,15 @@ starneig_error_t starneig_GEP_SM_Schur_expert(
     starneig_node_set_mode(STARNEIG_MODE_SM);
     starneig_node_resume_starpu();
 
+    starneig_trace_phase_begin("schur");
+    starneig_progress_begin("schur");
+
     starneig_error_t ret = schur(
         conf, n, ldQ, ldZ, ldH, ldT, Q, Z, H, T, real, imag, beta);
 
     starpu_task_wait_for_all();
+    starneig_progress_end();
+    starneig_trace_phase_end();
     starneig_node_pause_starpu();
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
 
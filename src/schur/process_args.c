@@ -237,11 +237,19 @@ starneig_error_t starneig_build_process_args_from(
     args->matrix_b = matrix_b;
     args->matrix_q = matrix_q;
     args->matrix_z = matrix_z;
+    args->log_q = NULL;
+    args->log_z = NULL;
 
     args->thres_a = source->thres_a;
     args->thres_b = source->thres_b;
     args->thres_inf = source->thres_inf;
 
+    // AED windows must always be reduced to Schur form
+    args->region = NULL;
+    args->region_disc = NULL;
+    args->region_arg = NULL;
+    args->region_patience = 0;
+
     return STARNEIG_SUCCESS;
 }
 
@@ -513,10 +521,38 @@ starneig_error_t starneig_build_process_args(
     args->matrix_b = matrix_b;
     args->matrix_q = matrix_q;
     args->matrix_z = matrix_z;
+    args->log_q = NULL;
+    args->log_z = NULL;
 
     args->thres_a = thres_a;
     args->thres_b = thres_b;
     args->thres_inf = thres_inf;
 
+    // region predicate
+    args->region = NULL;
+    args->region_disc = NULL;
+    args->region_arg = NULL;
+    args->region_patience = 0;
+    if (conf != NULL && conf->region != NULL) {
+        args->region = conf->region;
+        // the disc test bounds only the eigenvalues of a standard eigenvalue
+        // problem
+        if (matrix_b == NULL)
+            args->region_disc = conf->region_disc;
+        args->region_arg = conf->region_arg;
+        if (conf->region_patience == STARNEIG_SCHUR_DEFAULT_REGION_PATIENCE) {
+            args->region_patience = 2;
+        }
+        else {
+            if (0 < conf->region_patience) {
+                args->region_patience = conf->region_patience;
+            }
+            else {
+                starneig_error("Invalid region patience. Exiting...");
+                return STARNEIG_INVALID_CONFIGURATION;
+            }
+        }
+    }
+
     return STARNEIG_SUCCESS;
 }
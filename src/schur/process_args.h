@@ -45,6 +45,7 @@
 #include "../common/common.h"
 #include "../common/vector.h"
 #include "../common/matrix.h"
+#include "../common/transform_log.h"
 #include <starneig/expert.h>
 #include <starneig/error.h>
 #include <starpu.h>
@@ -106,11 +107,17 @@ struct process_args {
     starneig_matrix_t matrix_b;     ///< matrix B descriptor
     starneig_matrix_t matrix_q;     ///< matrix Q descriptor
     starneig_matrix_t matrix_z;     ///< matrix Z descriptor
+    struct transform_log *log_q;    ///< deferred matrix Q updates (or NULL)
+    struct transform_log *log_z;    ///< deferred matrix Z updates (or NULL)
     double thres_a;                       ///< threshold for matrix A
     double thres_b;                       ///< threshold for off-diagonal
                                           ///< entries of matrix B
     double thres_inf;                     ///< threshold for diagonal entries
                                           ///< of matrix B
+    int (*region)(double, double, double, void *); ///< region predicate
+    int (*region_disc)(double, double, double, void *); ///< region disc test
+    void *region_arg;                     ///< region predicate argument
+    int region_patience;                  ///< region patience
 };
 
 ///
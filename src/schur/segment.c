@@ -39,6 +39,7 @@
 #include <starneig_config.h>
 #include <starneig/configuration.h>
 #include "segment.h"
+#include "../common/multicast.h"
 #include <math.h>
 
 struct segment * starneig_create_segment(
@@ -91,13 +92,18 @@ void starneig_free_segment(struct segment *segment)
 
     if (segment->aed_small_lZ_h != NULL &&
     segment->aed_small_lZ_h != segment->aed_small_lQ_h)
-        starpu_data_unregister_submit(segment->aed_small_lZ_h);
-    if (segment->aed_small_lQ_h != NULL)
-        starpu_data_unregister_submit(segment->aed_small_lQ_h);
+        starneig_multicast_unregister_submit(segment->aed_small_lZ_h);
+    starneig_multicast_unregister_submit(segment->aed_small_lQ_h);
 
     if (segment->aed_status_h != NULL)
         starpu_data_unregister_submit(segment->aed_status_h);
 
+    if (segment->region_hit_h != NULL)
+        starpu_data_unregister_submit(segment->region_hit_h);
+
+    if (segment->region_bound_h != NULL)
+        starpu_data_unregister_submit(segment->region_bound_h);
+
     starneig_matrix_free(segment->aed_args.matrix_a);
     starneig_matrix_free(segment->aed_args.matrix_b);
     starneig_matrix_free(segment->aed_args.matrix_q);
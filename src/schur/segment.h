@@ -60,6 +60,7 @@ enum segment_status {
     SEGMENT_BULGES,      ///< bulge chasing in progress
     SEGMENT_CHILDREN,    ///< segment has been divided into sub-segments
     SEGMENT_CONVERGED,   ///< segment has converged
+    SEGMENT_SKIPPED,     ///< segment is left unreduced (outside the region)
     SEGMENT_FAILURE      ///< an error has occurred while processing the segment
 };
 
@@ -93,6 +94,19 @@ struct segment {
     /// stores the number of failed AEDs
     int aed_failed;
 
+    /// stores the number of consecutive AEDs whose shifts fell outside the
+    /// region
+    int region_misses;
+
+    /// when a region predicate is given, this handle encapsulates the outcome
+    /// of the latest region check (int)
+    starpu_data_handle_t region_hit_h;
+
+    /// when the shifts have fallen outside the region long enough, this
+    /// handle encapsulates the outcome of the conservative region check that
+    /// decides whether the segment is left unreduced (int)
+    starpu_data_handle_t region_bound_h;
+
     /// Allocator for AED related tasks. Used when the segment is in the states
     /// SEGMENT_AED_SCHUR and SEGMENT_AED_DEFLATE.
     struct allocator *aed_allocator;
@@ -44,6 +44,8 @@
 #include "../common/common.h"
 #include "../common/utils.h"
 #include "../common/tiles.h"
+#include "../common/comm_stats.h"
+#include "../common/dry_run.h"
 
 #include <starpu_scheduler.h>
 #ifdef STARNEIG_ENABLE_MPI
@@ -519,6 +521,73 @@ static struct starpu_codelet extract_shifts_cl = {
     .nbuffers = STARPU_VARIABLE_NBUFFERS
 };
 
+///
+/// @brief check_region codelet tests whether any of the shifts falls inside a
+/// region.
+///
+///  Arguments:
+///   - number of shifts
+///   - region predicate
+///   - region predicate argument
+///
+///  Buffers:
+///   - shift vector tile (real parts) (STARPU_R)
+///   - shift vector tile (imaginary parts) (STARPU_R)
+///   - outcome (STARPU_W, int)
+///
+static struct starpu_codelet check_region_cl = {
+    .name = "starneig_check_region",
+    .cpu_funcs = { starneig_cpu_check_region },
+    .cpu_funcs_name = { "starneig_cpu_check_region" },
+    .nbuffers = 3,
+    .modes = { STARPU_R, STARPU_R, STARPU_W }
+};
+
+///
+/// @brief compute_bound_a codelet computes the partial eigenvalue bound of a
+/// tile.
+///
+///  Arguments:
+///   - first row of the tile to be processed
+///   - last row of the tile to be processed + 1
+///   - first column of the tile to processed
+///   - last column of the tile to be processed + 1
+///   - column index - row index of the diagonal entries inside the tile
+///
+///  Buffers:
+///   - tile (STARPU_R)
+///   - square of the Frobenius norm of the off-diagonal entries, the smallest
+///     diagonal entry and the largest diagonal entry (STARPU_W, 3 doubles)
+///
+static struct starpu_codelet compute_bound_a_cl = {
+    .name = "starneig_compute_bound_a",
+    .cpu_funcs = { starneig_cpu_compute_bound_a },
+    .cpu_funcs_name = { "starneig_cpu_compute_bound_a" },
+    .modes = { STARPU_R, STARPU_W },
+    .nbuffers = 2
+};
+
+///
+/// @brief check_region_bound codelet tests whether a disc that contains the
+/// eigenvalues of a diagonal block can intersect a region.
+///
+///  Arguments:
+///   - diagonal block size
+///   - the number of partial bounds
+///   - region disc test
+///   - region disc test argument
+///
+///  Buffers:
+///   - partial bounds (STARPU_R)
+///   - outcome (STARPU_W, int)
+///
+static struct starpu_codelet check_region_bound_cl = {
+    .name = "starneig_check_region_bound",
+    .cpu_funcs = { starneig_cpu_check_region_bound },
+    .cpu_funcs_name = { "starneig_cpu_check_region_bound" },
+    .nbuffers = STARPU_VARIABLE_NBUFFERS
+};
+
 ///
 /// @brief compute_norm_a codelet compute the square of the Frobenius norm of
 /// a tile.
@@ -622,8 +691,9 @@ void starneig_schur_insert_push_inf_top(
     //
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &push_inf_top_cl,
             STARPU_EXECUTE_ON_NODE, owner,
@@ -634,9 +704,10 @@ void starneig_schur_insert_push_inf_top(
             STARPU_VALUE, &top, sizeof(top),
             STARPU_VALUE, &bottom, sizeof(bottom),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &push_inf_top_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &thres_inf, sizeof(thres_inf),
@@ -648,11 +719,13 @@ void starneig_schur_insert_push_inf_top(
 
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(*lQ_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), *lQ_h);
         starpu_mpi_data_set_rank_comm(
             *lQ_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (*lZ_h != *lQ_h) {
+            starneig_comm_stats_broadcast(*lZ_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), *lZ_h);
             starpu_mpi_data_set_rank_comm(
@@ -748,13 +821,21 @@ void starneig_schur_insert_push_bulges(
     // insert task
     //
 
+    // each shift pair is chased through the window with 3 x 3 reflectors
+    // that are applied to the window and to the local transformation
+    // matrices
+    double flops = (matrix_b != NULL ? 30.0 : 15.0) *
+        (shifts_end-shifts_begin)*window_size*window_size;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &push_bulges_cl,
             STARPU_EXECUTE_ON_NODE, owner,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &thres_a, sizeof(thres_a),
             STARPU_VALUE, &thres_b, sizeof(thres_b),
             STARPU_VALUE, &thres_inf, sizeof(thres_inf),
@@ -768,11 +849,13 @@ void starneig_schur_insert_push_bulges(
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
             STARPU_VALUE, &mode, sizeof(mode),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &push_bulges_cl,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &thres_a, sizeof(thres_a),
             STARPU_VALUE, &thres_b, sizeof(thres_b),
             STARPU_VALUE, &thres_inf, sizeof(thres_inf),
@@ -789,11 +872,13 @@ void starneig_schur_insert_push_bulges(
 
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(*lQ_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), *lQ_h);
         starpu_mpi_data_set_rank_comm(
             *lQ_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (*lZ_h != *lQ_h) {
+            starneig_comm_stats_broadcast(*lZ_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), *lZ_h);
             starpu_mpi_data_set_rank_comm(
@@ -944,13 +1029,19 @@ void starneig_schur_insert_aggressively_deflate(
         matrix_b != NULL ?
             &aggressively_deflate_gep_cl : &aggressively_deflate_sep_cl;
 
+    // Schur decomposition and Hessenberg(-triangular) reduction of the window
+    double flops = (matrix_b != NULL ? 2.0 : 1.0) *
+        (25.0+14.0/3.0)*window_size*window_size*window_size;
+
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             codelet,
             STARPU_EXECUTE_ON_NODE, owner,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &thres_a, sizeof(thres_a),
             STARPU_VALUE, &thres_b, sizeof(thres_b),
             STARPU_VALUE, &thres_inf, sizeof(thres_inf),
@@ -961,11 +1052,13 @@ void starneig_schur_insert_aggressively_deflate(
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             codelet,
             STARPU_PRIORITY, prio,
+            STARPU_FLOPS, flops,
             STARPU_VALUE, &thres_a, sizeof(thres_a),
             STARPU_VALUE, &thres_b, sizeof(thres_b),
             STARPU_VALUE, &thres_inf, sizeof(thres_inf),
@@ -979,11 +1072,13 @@ void starneig_schur_insert_aggressively_deflate(
 
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(*lQ_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), *lQ_h);
         starpu_mpi_data_set_rank_comm(
             *lQ_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (*lZ_h != *lQ_h) {
+            starneig_comm_stats_broadcast(*lZ_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), *lZ_h);
             starpu_mpi_data_set_rank_comm(
@@ -1072,8 +1167,9 @@ void starneig_schur_insert_small_schur(
     //
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &small_schur_cl,
             STARPU_EXECUTE_ON_NODE, owner,
@@ -1084,9 +1180,10 @@ void starneig_schur_insert_small_schur(
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &small_schur_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &thres_a, sizeof(thres_a),
@@ -1098,11 +1195,13 @@ void starneig_schur_insert_small_schur(
 
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(*lQ_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), *lQ_h);
         starpu_mpi_data_set_rank_comm(
             *lQ_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (*lZ_h != *lQ_h) {
+            starneig_comm_stats_broadcast(*lZ_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), *lZ_h);
             starpu_mpi_data_set_rank_comm(
@@ -1177,8 +1276,9 @@ void starneig_schur_insert_small_hessenberg(
     //
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(owner, helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &small_hessenberg_cl,
             STARPU_EXECUTE_ON_NODE, owner,
@@ -1186,9 +1286,10 @@ void starneig_schur_insert_small_hessenberg(
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
             STARPU_VALUE, &packing_info_B, sizeof(packing_info_B),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &small_hessenberg_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
@@ -1197,11 +1298,13 @@ void starneig_schur_insert_small_hessenberg(
 
 #ifdef STARNEIG_ENABLE_MPI
     if (mpi != NULL) {
+        starneig_comm_stats_broadcast(*lQ_h);
         starpu_mpi_get_data_on_all_nodes_detached(
             starneig_mpi_get_comm(), *lQ_h);
         starpu_mpi_data_set_rank_comm(
             *lQ_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
         if (*lZ_h != *lQ_h) {
+            starneig_comm_stats_broadcast(*lZ_h);
             starpu_mpi_get_data_on_all_nodes_detached(
                 starneig_mpi_get_comm(), *lZ_h);
             starpu_mpi_data_set_rank_comm(
@@ -1237,7 +1340,7 @@ void starneig_schur_insert_form_spike(
         1, starneig_vector_get_rows(*spike), *spike, helper, &packing_info_spike, 0);
 
     // insert task
-    starpu_task_insert(
+    starneig_task_insert(
         &form_spike_cl,
         STARPU_PRIORITY, prio,
         STARPU_VALUE, &packing_info, sizeof(packing_info),
@@ -1267,7 +1370,7 @@ void starneig_schur_insert_embed_spike(
         matrix_a, helper, &packing_info, 0);
 
     // insert task
-    starpu_task_insert(
+    starneig_task_insert(
         &embed_spike_cl,
         STARPU_PRIORITY, prio,
         STARPU_VALUE, &packing_info_spike, sizeof(packing_info_spike),
@@ -1339,7 +1442,7 @@ void starneig_schur_insert_deflate(
 
     int corner = end == STARNEIG_MATRIX_M(matrix_a);
 
-    starpu_task_insert(
+    starneig_task_insert(
         &deflate_cl,
         STARPU_PRIORITY, prio,
         STARPU_VALUE, &thres_a, sizeof(thres_a),
@@ -1380,8 +1483,11 @@ void starneig_schur_insert_extract_shifts(
         0, end-begin, imag, helper, &packing_info_imag, 0);
 
 #ifdef STARNEIG_ENABLE_MPI
-    if (mpi != NULL)
-        starpu_mpi_task_insert(
+    if (mpi != NULL) {
+        starneig_comm_stats_task(
+            starneig_vector_get_elem_owner(begin, real),
+            helper->descrs, helper->count);
+        starneig_mpi_task_insert(
             starneig_mpi_get_comm(),
             &extract_shifts_cl,
             STARPU_EXECUTE_ON_NODE,
@@ -1392,9 +1498,10 @@ void starneig_schur_insert_extract_shifts(
             STARPU_VALUE, &packing_info_real, sizeof(packing_info_real),
             STARPU_VALUE, &packing_info_imag, sizeof(packing_info_imag),
             STARPU_DATA_MODE_ARRAY, helper->descrs, helper->count, 0);
+    }
     else
 #endif
-        starpu_task_insert(
+        starneig_task_insert(
             &extract_shifts_cl,
             STARPU_PRIORITY, prio,
             STARPU_VALUE, &packing_info_A, sizeof(packing_info_A),
@@ -1406,6 +1513,193 @@ void starneig_schur_insert_extract_shifts(
     starneig_free_packing_helper(helper);
 }
 
+starpu_data_handle_t starneig_schur_insert_check_region(
+    int count, int prio,
+    int (*region)(double real, double imag, double beta, void *arg),
+    void *region_arg, starneig_vector_t real, starneig_vector_t imag,
+    mpi_info_t mpi)
+{
+    starpu_data_handle_t real_h = starneig_vector_get_tile(0, real);
+    starpu_data_handle_t imag_h = starneig_vector_get_tile(0, imag);
+
+    starpu_data_handle_t hit_h;
+    starpu_variable_data_register(&hit_h, -1, 0, sizeof(int));
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL) {
+        int owner = starneig_vector_get_tile_owner(0, real);
+        starpu_mpi_data_register_comm(
+            hit_h, mpi->tag_offset++, owner, starneig_mpi_get_comm());
+
+        starneig_comm_stats_task(owner, (struct starpu_data_descr[]) {
+            { .handle = real_h, .mode = STARPU_R },
+            { .handle = imag_h, .mode = STARPU_R },
+            { .handle = hit_h, .mode = STARPU_W } }, 3);
+        starneig_mpi_task_insert(
+            starneig_mpi_get_comm(),
+            &check_region_cl,
+            STARPU_EXECUTE_ON_NODE, owner,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &count, sizeof(count),
+            STARPU_VALUE, &region, sizeof(region),
+            STARPU_VALUE, &region_arg, sizeof(region_arg),
+            STARPU_R, real_h, STARPU_R, imag_h, STARPU_W, hit_h, 0);
+
+        // broadcast the outcome to all nodes
+        starneig_comm_stats_broadcast(hit_h);
+        starpu_mpi_get_data_on_all_nodes_detached(
+            starneig_mpi_get_comm(), hit_h);
+        starpu_mpi_data_set_rank_comm(
+            hit_h, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
+    }
+    else
+#endif
+    {
+        starneig_task_insert(
+            &check_region_cl,
+            STARPU_PRIORITY, prio,
+            STARPU_VALUE, &count, sizeof(count),
+            STARPU_VALUE, &region, sizeof(region),
+            STARPU_VALUE, &region_arg, sizeof(region_arg),
+            STARPU_R, real_h, STARPU_R, imag_h, STARPU_W, hit_h, 0);
+    }
+
+    return hit_h;
+}
+
+starpu_data_handle_t starneig_schur_insert_check_region_bound(
+    int begin, int end, int prio,
+    int (*region_disc)(double real, double imag, double radius, void *arg),
+    void *region_arg, starneig_matrix_t matrix, mpi_info_t mpi)
+{
+#ifdef STARNEIG_ENABLE_MPI
+    int my_rank = starneig_mpi_get_comm_rank();
+#endif
+
+    int bm = STARNEIG_MATRIX_BM(matrix);
+    int bn = STARNEIG_MATRIX_BN(matrix);
+
+    int rbegin = STARNEIG_MATRIX_RBEGIN(matrix) + begin;
+    int rend = STARNEIG_MATRIX_RBEGIN(matrix) + end;
+    int cbegin = STARNEIG_MATRIX_CBEGIN(matrix) + begin;
+    int cend = STARNEIG_MATRIX_CBEGIN(matrix) + end;
+
+    int rbbegin = rbegin / bm;
+    int rbend = (rend-1) / bm + 1;
+    int cbbegin = cbegin / bn;
+    int cbend = (cend-1) / bn + 1;
+
+    int tiles = 0;
+    struct starpu_data_descr *descrs = malloc(
+        ((rbend-rbbegin)*(cbend-cbbegin)+1)*sizeof(struct starpu_data_descr));
+
+    //
+    // process tiles
+    //
+
+    for (int j = cbbegin; j < cbend; j++) {
+        for (int i = rbbegin; i < rbend; i++) {
+
+            starpu_data_handle_t tile =
+                starneig_matrix_get_tile(i, j, matrix);
+
+            starpu_data_handle_t handle;
+            starpu_variable_data_register(&handle, -1, 0, 3*sizeof(double));
+
+            // pack the handle and the access mode for the check_region_bound
+            // task
+            descrs[tiles].handle = handle;
+            descrs[tiles].mode = STARPU_R;
+            tiles++;
+
+            int _rbegin = MAX(0, rbegin - i*bm);
+            int _rend = MIN(bm, rend - i*bm);
+
+            int _cbegin = MAX(0, cbegin - j*bn);
+            int _cend = MIN(bn, cend - j*bn);
+
+            int offset = (j*bn - cbegin) - (i*bm - rbegin);
+
+#ifdef STARNEIG_ENABLE_MPI
+            if (mpi != NULL) {
+                int owner = starpu_mpi_data_get_rank(tile);
+                starpu_mpi_data_register_comm(
+                    handle, mpi->tag_offset++, owner, starneig_mpi_get_comm());
+
+                if (my_rank == owner)
+                    starneig_mpi_task_insert(
+                        starneig_mpi_get_comm(),
+                        &compute_bound_a_cl,
+                        STARPU_EXECUTE_ON_NODE, owner,
+                        STARPU_PRIORITY, prio,
+                        STARPU_VALUE, &_rbegin, sizeof(_rbegin),
+                        STARPU_VALUE, &_rend, sizeof(_rend),
+                        STARPU_VALUE, &_cbegin, sizeof(_cbegin),
+                        STARPU_VALUE, &_cend, sizeof(_cend),
+                        STARPU_VALUE, &offset, sizeof(offset),
+                        STARPU_R, tile, STARPU_W, handle, 0);
+
+                // gather result to all nodes
+                starneig_comm_stats_broadcast(handle);
+                starpu_mpi_get_data_on_all_nodes_detached(
+                    starneig_mpi_get_comm(), handle);
+                starpu_mpi_data_set_rank_comm(
+                    handle, STARPU_MPI_PER_NODE, starneig_mpi_get_comm());
+            }
+            else
+#endif
+            {
+                starneig_task_insert(
+                    &compute_bound_a_cl,
+                    STARPU_PRIORITY, prio,
+                    STARPU_VALUE, &_rbegin, sizeof(_rbegin),
+                    STARPU_VALUE, &_rend, sizeof(_rend),
+                    STARPU_VALUE, &_cbegin, sizeof(_cbegin),
+                    STARPU_VALUE, &_cend, sizeof(_cend),
+                    STARPU_VALUE, &offset, sizeof(offset),
+                    STARPU_R, tile, STARPU_W, handle, 0);
+            }
+        }
+    }
+
+    //
+    // test the bound against the region on every node
+    //
+
+    starpu_data_handle_t hit_h;
+    starpu_variable_data_register(&hit_h, -1, 0, sizeof(int));
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi != NULL)
+        starpu_mpi_data_register_comm(
+            hit_h, mpi->tag_offset++, STARPU_MPI_PER_NODE,
+            starneig_mpi_get_comm());
+#endif
+
+    descrs[tiles].handle = hit_h;
+    descrs[tiles].mode = STARPU_W;
+
+    int size = end - begin;
+    starneig_task_insert(
+        &check_region_bound_cl,
+        STARPU_PRIORITY, prio,
+        STARPU_VALUE, &size, sizeof(size),
+        STARPU_VALUE, &tiles, sizeof(tiles),
+        STARPU_VALUE, &region_disc, sizeof(region_disc),
+        STARPU_VALUE, &region_arg, sizeof(region_arg),
+        STARPU_DATA_MODE_ARRAY, descrs, tiles+1, 0);
+
+    //
+    // cleanup
+    //
+
+    for (int i = 0; i < tiles; i++)
+        starpu_data_unregister_submit(descrs[i].handle);
+
+    free(descrs);
+
+    return hit_h;
+}
+
 starpu_data_handle_t starneig_schur_insert_compute_norm(
     int prio, starneig_matrix_t matrix, mpi_info_t mpi)
 {
@@ -1456,7 +1750,7 @@ starpu_data_handle_t starneig_schur_insert_compute_norm(
                     handle, mpi->tag_offset++, owner, starneig_mpi_get_comm());
 
                 if (my_rank == owner)
-                    starpu_mpi_task_insert(
+                    starneig_mpi_task_insert(
                         starneig_mpi_get_comm(),
                         &compute_norm_a_cl,
                         STARPU_EXECUTE_ON_NODE, owner,
@@ -1468,6 +1762,7 @@ starpu_data_handle_t starneig_schur_insert_compute_norm(
                         STARPU_R, tile, STARPU_W, handle, 0);
 
                 // gather result to all nodes
+                starneig_comm_stats_broadcast(handle);
                 starpu_mpi_get_data_on_all_nodes_detached(
                     starneig_mpi_get_comm(), handle);
                 starpu_mpi_data_set_rank_comm(
@@ -1476,7 +1771,7 @@ starpu_data_handle_t starneig_schur_insert_compute_norm(
             else
 #endif
             {
-                starpu_task_insert(
+                starneig_task_insert(
                     &compute_norm_a_cl,
                     STARPU_PRIORITY, prio,
                     STARPU_VALUE, &rbegin, sizeof(rbegin),
@@ -1504,7 +1799,7 @@ starpu_data_handle_t starneig_schur_insert_compute_norm(
     descrs[tiles].handle = norm;
     descrs[tiles].mode = STARPU_W;
 
-    starpu_task_insert(
+    starneig_task_insert(
         &compute_norm_b_cl,
         STARPU_PRIORITY, prio,
         STARPU_VALUE, &tiles, sizeof(tiles),
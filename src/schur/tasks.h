@@ -441,6 +441,80 @@ void starneig_schur_insert_extract_shifts(
     starneig_matrix_t matrix_b, starneig_vector_t real,
     starneig_vector_t imag, mpi_info_t mpi);
 
+///
+/// @brief Inserts a check_region task.
+///
+/// @see check_region_cl
+///
+/// @param[in] count
+///         Number of shifts.
+///
+/// @param[in] prio
+///         StarPU priority.
+///
+/// @param[in] region
+///         Region predicate.
+///
+/// @param[in] region_arg
+///         Region predicate argument.
+///
+/// @param[in] real
+///         Shift vector (real parts).
+///
+/// @param[in] imag
+///         Shift vector (imaginary parts).
+///
+/// @param[in,out] mpi
+///             MPI info.
+///
+/// @return  A handle to an integer that is non-zero if a shift falls inside
+///          the region. The integer is made available to all MPI ranks.
+///
+starpu_data_handle_t starneig_schur_insert_check_region(
+    int count, int prio,
+    int (*region)(double real, double imag, double beta, void *arg),
+    void *region_arg, starneig_vector_t real, starneig_vector_t imag,
+    mpi_info_t mpi);
+
+///
+/// @brief Inserts tasks that test whether the eigenvalues of a diagonal block
+/// can fall inside a region.
+///
+///  The eigenvalues are enclosed in a disc whose center is the midpoint of the
+///  diagonal entries and whose radius is bounded with the Frobenius norm of
+///  the off-diagonal entries. The disc is then tested against the region.
+///
+/// @see compute_bound_a_cl, check_region_bound_cl
+///
+/// @param[in] begin
+///         First row/column that belongs to the diagonal block.
+///
+/// @param[in] end
+///         Last row/column that belongs to the diagonal block + 1.
+///
+/// @param[in] prio
+///         StarPU priority.
+///
+/// @param[in] region_disc
+///         Region disc test.
+///
+/// @param[in] region_arg
+///         Region disc test argument.
+///
+/// @param[in] matrix
+///         Matrix descriptor.
+///
+/// @param[in,out] mpi
+///             MPI info.
+///
+/// @return  A handle to an integer that is zero if the disc does not intersect
+///          the region. The integer is made available to all MPI ranks.
+///
+starpu_data_handle_t starneig_schur_insert_check_region_bound(
+    int begin, int end, int prio,
+    int (*region_disc)(double real, double imag, double radius, void *arg),
+    void *region_arg, starneig_matrix_t matrix, mpi_info_t mpi);
+
 ///
 /// @brief Inserts tasks that compute the Frobenius norm of a matrix.
 ///
@@ -39,6 +39,7 @@
 #include "common.h"
 #include "../common/common.h"
 #include "../common/node_internal.h"
+#include "../common/alloc.h"
 #include <starneig/gep_sm.h>
 #include <cblas.h>
 #include <stdlib.h>
@@ -135,7 +136,7 @@ starneig_error_t starneig_GEP_SM_HessenbergTriangular(
     }
 
     tau = malloc(n*sizeof(double));
-    work = malloc(lwork*sizeof(double));
+    work = starneig_alloc_huge(lwork*sizeof(double));
 
     //
     // reduce
@@ -173,7 +174,7 @@ cleanup:
     starneig_wrappers_finish();
 
     free(tau);
-    free(work);
+    starneig_free_huge(work);
 
     return info;
 }
@@ -43,6 +43,7 @@
 #include "common.h"
 #include "../common/common.h"
 #include "../common/node_internal.h"
+#include "../common/alloc.h"
 
 static int are_compatible(
     starneig_distr_matrix_t A, starneig_distr_matrix_t B,
@@ -270,7 +271,7 @@ starneig_error_t starneig_GEP_DM_HessenbergTriangular(
     }
 
     tau = malloc(n*sizeof(double));
-    work = malloc(lwork*sizeof(double));
+    work = starneig_alloc_huge(lwork*sizeof(double));
 
     //
     // reduce
@@ -329,7 +330,7 @@ cleanup:
     starneig_blacs_destroy_matrix(&descr_w, (void **)&local_w);
 
     free(tau);
-    free(work);
+    starneig_free_huge(work);
     starneig_blacs_gridexit(context);
 
     starneig_node_set_blas_mode(STARNEIG_BLAS_MODE_ORIGINAL);
@@ -47,6 +47,7 @@
 
 static unsigned long seed = 2019;
 static int pinning = 1;
+static int simulated = 0;
 
 void init_prand(unsigned int _seed)
 {
@@ -58,6 +59,33 @@ int prand()
     return (seed = ((seed * 1103515245) + 12345) & 0x7fffffff);
 }
 
+uint64_t crand_key()
+{
+    uint64_t high = prand();
+    uint64_t low = prand();
+    return (high << 32) ^ low;
+}
+
+double crand(uint64_t key, int row, int col)
+{
+    uint32_t ctr[4] = { (uint32_t) row, (uint32_t) col, 0, 0 };
+    uint32_t k[2] = { (uint32_t) key, (uint32_t) (key >> 32) };
+
+    for (int i = 0; i < 10; i++) {
+        uint64_t p0 = (uint64_t) 0xD2511F53 * ctr[0];
+        uint64_t p1 = (uint64_t) 0xCD9E8D57 * ctr[2];
+        ctr[0] = (uint32_t) (p1 >> 32) ^ ctr[1] ^ k[0];
+        ctr[1] = (uint32_t) p1;
+        ctr[2] = (uint32_t) (p0 >> 32) ^ ctr[3] ^ k[1];
+        ctr[3] = (uint32_t) p0;
+        k[0] += 0x9E3779B9;
+        k[1] += 0xBB67AE85;
+    }
+
+    // 53 random bits -> [0,1)
+    return ((((uint64_t) ctr[0] << 32) | ctr[1]) >> 11) * 0x1.0p-53;
+}
+
 void print_matrix(int m, int n, int ld, double const *mat)
 {
     for (int i = 0; i < m; ++i) {
@@ -93,6 +121,16 @@ void set_pinning(int value)
     pinning = value;
 }
 
+void set_simulated(int value)
+{
+    simulated = value;
+}
+
+int get_simulated()
+{
+    return simulated;
+}
+
 void * alloc_matrix(
     int m, int n, size_t elemsize, size_t *ld)
 {
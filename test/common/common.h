@@ -42,6 +42,7 @@
 #include <starneig/configuration.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 
 ///
@@ -116,6 +117,34 @@ void init_prand(unsigned int seed);
 ///
 int prand();
 
+///
+/// @brief Draws a new key for the counter-based random number generator from
+/// the internal pseudo random number generator.
+///
+/// @return Key.
+///
+uint64_t crand_key();
+
+///
+/// @brief Generates a random number using a counter-based (Philox4x32-10)
+/// random number generator.
+///
+///  The returned value depends only on the key and the (row, column) pair.
+///  Matrix elements can therefore be generated in any order and in parallel.
+///
+/// @param[in] key
+///         Key.
+///
+/// @param[in] row
+///         Row index.
+///
+/// @param[in] col
+///         Column index.
+///
+/// @return Uniformly distributed random number from [0,1).
+///
+double crand(uint64_t key, int row, int col);
+
 ///
 /// @brief Wrapper for BLAS DGEMM subroutine.
 ///
@@ -178,6 +207,20 @@ void compare_print_matrix(
 
 void set_pinning(int value);
 
+///
+/// @brief Marks the run as simulated. The random matrix generators leave the
+/// matrix contents uninitialized in a simulated run.
+///
+/// @param[in] value
+///         Non-zero if the run is simulated.
+///
+void set_simulated(int value);
+
+///
+/// @brief Returns non-zero if the run is simulated.
+///
+int get_simulated();
+
 ///
 /// @brief Allocated a matrix (two-dimensional array).
 ///
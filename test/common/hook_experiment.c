@@ -43,8 +43,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 #include <assert.h>
+#include <math.h>
 #include <time.h>
+#include <unistd.h>
 #include <starpu.h>
 
 #ifdef STARNEIG_ENABLE_MPI
@@ -498,8 +501,8 @@ static struct hook_list_t * read_hooks(
                 argr[i]++;
         }
     }
-    else {
-        // process default hooks
+    else if (!read_opt("--simulate", argc, argv, NULL)) {
+        // process default hooks; simulated runs produce meaningless data
         for (struct hook_descr_t const **i = descrs; *i != NULL; i++) {
             if ((*i)->is_enabled)
                 add_to_hook_list(create_hook_list_elem(
@@ -1294,6 +1297,82 @@ static void print_avail_solvers(
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+///
+/// @brief Scaling mode descriptor.
+///
+struct scaling_mode {
+    char const *name;       ///< mode name
+    char const *desc;       ///< mode description
+    double exponent;        ///< problem size rule n_p = n (p / p_0)^exponent
+};
+
+static const struct scaling_mode scaling_modes[] = {
+    { .name = "none",
+        .desc = "No scaling sweep",
+        .exponent = 0.0 },
+    { .name = "strong",
+        .desc = "Fixed problem size",
+        .exponent = 0.0 },
+    { .name = "weak",
+        .desc = "Fixed amount of work (flops) per core",
+        .exponent = 1.0/3.0 },
+    { .name = "weak-memory",
+        .desc = "Fixed amount of memory per core",
+        .exponent = 1.0/2.0 }
+};
+
+static READ_FROM_ARGV(read_scaling_mode, struct scaling_mode const,
+    name, scaling_modes, 0)
+
+static PRINT_AVAIL(print_avail_scaling_modes, "Available scaling modes:",
+    name, desc, scaling_modes, 0)
+
+///
+/// @brief Maximum number of points in a scaling sweep.
+///
+#define MAX_SCALING_POINTS 64
+
+///
+/// @brief Reads the core counts of a scaling sweep from the command line.
+///
+/// @param[in] argc - command line argument count
+/// @param[in] argv - command line arguments
+/// @param[inout] argr - processed command line arguments
+/// @param[out] cores - core counts
+///
+/// @return number of core counts, -1 if the list is invalid
+///
+static int read_scaling_cores(
+    int argc, char * const *argv, int *argr, int *cores)
+{
+    char const *str =
+        read_str("--scaling-cores", argc, argv, argr, "default");
+
+    if (strcmp(str, "default") == 0) {
+        // powers of two followed by the number of online cores
+        int available = MAX(1, sysconf(_SC_NPROCESSORS_ONLN));
+        int count = 0;
+        for (int i = 1; i < available && count < MAX_SCALING_POINTS-1; i *= 2)
+            cores[count++] = i;
+        cores[count++] = available;
+        return count;
+    }
+
+    int count = 0;
+    while (*str != '\0') {
+        char *end;
+        long value = strtol(str, &end, 10);
+        if (end == str || value < 1 || MAX_SCALING_POINTS <= count)
+            return -1;
+        cores[count++] = value;
+        str = *end == ',' ? end+1 : end;
+        if (*end != ',' && *end != '\0')
+            return -1;
+    }
+
+    return 0 < count ? count : -1;
+}
+
 void hook_experiment_print_usage(
     int argc, char * const *argv, const experiment_info_t info)
 {
@@ -1309,8 +1388,17 @@ void hook_experiment_print_usage(
         "  --warmup (num) -- Perform \"warmups\"\n"
         "  --keep-going -- Try to recover from a solver failure\n"
         "  --abort -- Call abort() in failure\n"
+        "  --scaling (mode) -- Scaling sweep mode\n"
+        "  --scaling-cores [default,(num),(num),...] -- Swept core counts\n"
+        "  --scaling-csv (filename) -- Store the scaling sweep as CSV\n"
     );
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    printf(
+        "  --simulate -- Simulated run, no hooks are enabled by default\n");
+#endif
+
+    print_avail_scaling_modes();
     print_avail_formats(argc, argv);
     print_avail_converters(argc, argv);
     print_avail_initializers(descr->initializers, argc, argv);
@@ -1422,6 +1510,20 @@ void hook_experiment_print_args(
     if (read_opt("--abort", argc, argv, NULL))
         printf(" --abort");
 
+    if (read_opt("--simulate", argc, argv, NULL))
+        printf(" --simulate");
+
+    struct scaling_mode const *scaling =
+        read_scaling_mode("--scaling", argc, argv, NULL);
+
+    if (scaling != &scaling_modes[0]) {
+        printf(" --scaling %s --scaling-cores %s", scaling->name,
+            read_str("--scaling-cores", argc, argv, NULL, "default"));
+        char const *csv = read_str("--scaling-csv", argc, argv, NULL, NULL);
+        if (csv != NULL)
+            printf(" --scaling-csv %s", csv);
+    }
+
     free_hook_list(hooks);
 }
 
@@ -1561,20 +1663,66 @@ int hook_experiment_check_args(
         ret = -1; goto cleanup;
     }
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+    read_opt("--simulate", argc, argv, argr);
+#else
+    if (read_opt("--simulate", argc, argv, argr)) {
+        fprintf(stderr,
+            "--simulate requires a StarPU library with SimGrid support.\n");
+        ret = -1; goto cleanup;
+    }
+#endif
+
+    struct scaling_mode const *scaling =
+        read_scaling_mode("--scaling", argc, argv, argr);
+    if (scaling == NULL) {
+        fprintf(stderr, "Invalid scaling mode.\n");
+        ret = -1; goto cleanup;
+    }
+
+    if (scaling != &scaling_modes[0]) {
+        int cores[MAX_SCALING_POINTS];
+        if (read_scaling_cores(argc, argv, argr, cores) < 1) {
+            fprintf(stderr, "Invalid scaling core list.\n");
+            ret = -1; goto cleanup;
+        }
+
+        read_str("--scaling-csv", argc, argv, argr, NULL);
+
+        if (0.0 < scaling->exponent &&
+        read_int("--n", argc, argv, NULL, -1) < 1) {
+            fprintf(stderr, "Weak scaling requires the --n argument.\n");
+            ret = -1; goto cleanup;
+        }
+    }
+
 cleanup:
 
     free_hook_list(hooks);
     return ret;
 }
 
-int hook_experiment_run(
-    int argc, char * const *argv, const experiment_info_t info)
+///
+/// @brief Runs the experiment loop.
+///
+/// @param[in] argc - command line argument count
+/// @param[in] argv - command line arguments
+/// @param[in] descr - experiment descriptor
+/// @param[inout] shared - if not NULL, the initial data is copied from
+///                        *shared instead of calling the initializer. If
+///                        *shared is NULL, a copy of the initial data is
+///                        stored to it.
+/// @param[out] median - if not NULL, returns the median execution time
+///
+/// @return number of failures
+///
+static int run_experiment(
+    int argc, char * const *argv, struct hook_experiment_descr const *descr,
+    struct hook_data_env **shared, double *median)
 {
     int failures = 0;
     int warnings = 0;
 
-    struct hook_experiment_descr const *descr = info;
-
     //
     // set relevant variables to valid initial values
     //
@@ -1630,12 +1778,14 @@ int hook_experiment_run(
     int repeat = read_int("--repeat", argc, argv, NULL, 1);
     int warmup = read_int("--warmup", argc, argv, NULL, 0);
 
-    int reinit =
+    int reinit = shared == NULL &&
         1 < repeat + warmup && !read_opt("--no-reinit", argc, argv, NULL);
 
     int keep_going = read_opt("--keep-going", argc, argv, NULL);
     int _abort = read_opt("--abort", argc, argv, NULL);
 
+    set_simulated(read_opt("--simulate", argc, argv, NULL));
+
     //
     // initialize hooks
     //
@@ -1679,20 +1829,30 @@ int hook_experiment_run(
             // either reinitialize before each run or this is the first run
             if (reinit || i == -warmup) {
                 free_hook_data_env(data);
-                data = initializer->init(init_format, argc, argv);
 
-                if (data == NULL) {
-                    fprintf(stderr, "Error while initializing data.\n");
-                    failures++;
-                    if (_abort)
-                        abort();
-                    goto cleanup;
+                if (shared != NULL && *shared != NULL) {
+                    data = copy_hook_data_env(*shared);
                 }
-
-                struct hook_supplementer_t const **iter = descr->supplementers;
-                while (*iter != NULL) {
-                    (*iter)->supplement(data, argc, argv);
-                    iter++;
+                else {
+                    data = initializer->init(init_format, argc, argv);
+
+                    if (data == NULL) {
+                        fprintf(stderr, "Error while initializing data.\n");
+                        failures++;
+                        if (_abort)
+                            abort();
+                        goto cleanup;
+                    }
+
+                    struct hook_supplementer_t const **iter =
+                        descr->supplementers;
+                    while (*iter != NULL) {
+                        (*iter)->supplement(data, argc, argv);
+                        iter++;
+                    }
+
+                    if (shared != NULL)
+                        *shared = copy_hook_data_env(data);
                 }
             }
 
@@ -1813,8 +1973,13 @@ int hook_experiment_run(
             printf("PROCESS...\n");
             fflush(stdout);
 
+#ifdef STARNEIG_ENABLE_SIMGRID
+            // measure the simulated time
+            double start = starpu_timing_now();
+#else
             struct timespec start, stop;
             clock_gettime(CLOCK_REALTIME, &start);
+#endif
 
             int ret = solver->run(solver_state);
 
@@ -1822,10 +1987,14 @@ int hook_experiment_run(
             if (1 < world_size)
                 MPI_Barrier(MPI_COMM_WORLD);
 #endif
+#ifdef STARNEIG_ENABLE_SIMGRID
+            double current_time = (starpu_timing_now() - start) * 1e-3;
+#else
             clock_gettime(CLOCK_REALTIME, &stop);
 
             double current_time = stop.tv_sec*1e+3+stop.tv_nsec*1e-6 -
                 (start.tv_sec*1e+3+start.tv_nsec*1e-6);
+#endif
 
             if (i < 0)
                 printf("WARMUP TIME = %.0f MS\n", current_time);
@@ -1926,6 +2095,9 @@ int hook_experiment_run(
             double_median(repeat, time), double_mean(repeat, time),
             double_cv(repeat, time), time[0], time[repeat-1]);
 
+        if (median != NULL)
+            *median = double_median(repeat, time);
+
         //
         // process after_solver_run hooks
         //
@@ -1971,3 +2143,165 @@ cleanup:
 
     return failures;
 }
+
+///
+/// @brief Replaces (or appends) the value of a command line argument.
+///
+/// @param[in] name - argument name
+/// @param[in] value - new value
+/// @param[inout] argc - command line argument count
+/// @param[inout] argv - command line arguments, must have room for two
+///                      additional arguments
+///
+static void set_arg(char const *name, char *value, int *argc, char **argv)
+{
+    for (int i = 0; i < *argc-1; i++) {
+        if (strcmp(name, argv[i]) == 0) {
+            argv[i+1] = value;
+            return;
+        }
+    }
+
+    argv[(*argc)++] = (char *) name;
+    argv[(*argc)++] = value;
+}
+
+///
+/// @brief Runs a scaling sweep. Each point re-runs the experiment loop with
+/// modified --cores (and --n) arguments.
+///
+static int run_scaling(
+    int argc, char * const *argv, struct hook_experiment_descr const *descr,
+    struct scaling_mode const *scaling)
+{
+    int failures = 0;
+
+    int my_rank = 0, world_size = 1;
+#ifdef STARNEIG_ENABLE_MPI
+    {
+        int mpi;
+        MPI_Initialized(&mpi);
+
+        if (mpi) {
+            MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+            MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+        }
+    }
+#endif
+
+    int cores[MAX_SCALING_POINTS];
+    int points = read_scaling_cores(argc, argv, NULL, cores);
+    int n0 = read_int("--n", argc, argv, NULL, -1);
+
+    int n[MAX_SCALING_POINTS];
+    double time[MAX_SCALING_POINTS];
+
+    int _argc = argc;
+    char **_argv = malloc((argc+4)*sizeof(char *));
+    memcpy(_argv, argv, argc*sizeof(char *));
+
+    char cores_str[32], n_str[32];
+
+    // with a fixed problem size, the same matrices are used at every point
+    struct hook_data_env *shared = NULL;
+
+    for (int i = 0; i < points; i++) {
+        n[i] = n0;
+        if (0.0 < scaling->exponent)
+            n[i] = round(n0 * pow(1.0*cores[i]/cores[0], scaling->exponent));
+
+        snprintf(cores_str, sizeof(cores_str), "%d", cores[i]);
+        set_arg("--cores", cores_str, &_argc, _argv);
+
+        if (0.0 < scaling->exponent) {
+            snprintf(n_str, sizeof(n_str), "%d", n[i]);
+            set_arg("--n", n_str, &_argc, _argv);
+            free_hook_data_env(shared);
+            shared = NULL;
+        }
+
+        printf(
+            "================================================================"
+            "\n");
+        printf("SCALING POINT %d / %d: %d CORES, %d RANKS", i+1, points,
+            cores[i], world_size);
+        if (0 < n[i])
+            printf(", N = %d", n[i]);
+        printf("\n");
+
+        time[i] = 0.0;
+        failures += run_experiment(_argc, _argv, descr, &shared, &time[i]);
+    }
+
+    free_hook_data_env(shared);
+    free(_argv);
+
+    if (my_rank != 0)
+        return failures;
+
+    //
+    // the efficiency is relative to the first point:
+    //   E_p = (T_0 W_p p_0) / (T_p W_0 p), W = n^3
+    //
+
+    double speedup[MAX_SCALING_POINTS], efficiency[MAX_SCALING_POINTS];
+    for (int i = 0; i < points; i++) {
+        double work = 1.0;
+        if (0 < n0)
+            work = pow(1.0*n[i]/n[0], 3.0);
+        speedup[i] = 0.0 < time[i] ? time[0] * work / time[i] : 0.0;
+        efficiency[i] = speedup[i] * cores[0] / cores[i];
+    }
+
+    printf(
+        "================================================================\n");
+    printf("SCALING (%s):\n", scaling->name);
+    printf("%8s %8s %8s %12s %10s %10s\n",
+        "CORES", "RANKS", "N", "TIME (MS)", "SPEEDUP", "EFFICIENCY");
+    for (int i = 0; i < points; i++) {
+        char n_str[32] = "-";
+        if (0 < n[i])
+            snprintf(n_str, sizeof(n_str), "%d", n[i]);
+        printf("%8d %8d %8s %12.0f %10.2f %10.2f\n", cores[i], world_size,
+            n_str, time[i], speedup[i], efficiency[i]);
+    }
+
+    char const *csv_name = read_str("--scaling-csv", argc, argv, NULL, NULL);
+
+    FILE *csv = stdout;
+    if (csv_name != NULL) {
+        csv = fopen(csv_name, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "Cannot open %s.\n", csv_name);
+            return failures + 1;
+        }
+    }
+    else {
+        printf("SCALING CSV:\n");
+    }
+
+    fprintf(csv, "mode,cores,ranks,n,time_ms,speedup,efficiency\n");
+    for (int i = 0; i < points; i++)
+        fprintf(csv, "%s,%d,%d,%d,%.3f,%.4f,%.4f\n", scaling->name,
+            cores[i], world_size, MAX(0, n[i]), time[i], speedup[i],
+            efficiency[i]);
+
+    if (csv != stdout)
+        fclose(csv);
+
+    return failures;
+}
+
+int hook_experiment_run(
+    int argc, char * const *argv, const experiment_info_t info)
+{
+    struct hook_experiment_descr const *descr = info;
+
+    struct scaling_mode const *scaling =
+        read_scaling_mode("--scaling", argc, argv, NULL);
+
+    if (scaling != &scaling_modes[0])
+        return run_scaling(argc, argv, descr, scaling);
+
+    return run_experiment(argc, argv, descr, NULL, NULL);
+}
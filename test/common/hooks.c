@@ -43,8 +43,16 @@
 #include "crawler.h"
 #include "init.h"
 #include "local_pencil.h"
+#include "threads.h"
+#include <starneig/starneig.h>
+#ifdef STARNEIG_ENABLE_MPI
+#include "starneig_pencil.h"
+#include <mpi.h>
+#endif
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
+#include <float.h>
 
 ///
 /// @brief Default residual failure threshold.
@@ -431,6 +439,511 @@ const struct hook_descr_t default_residual_test_descr = {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+///
+/// @brief Default number of probe vectors.
+///
+static const int estimate_default_probes = 4;
+
+///
+/// @brief Randomized residual estimate hook state.
+///
+struct estimate_test_state_t {
+    int probes;             ///< number of probe vectors
+    int fail_threshold;     ///< norm failure threshold
+    int warn_threshold;     ///< norm warning threshold
+};
+
+static void estimate_print_usage(int argc, char * const *argv)
+{
+    printf(
+        "  --estimate-probes (num) -- Number of random probe vectors\n"
+        "  --estimate-fail-threshold (num) -- Failure threshold\n"
+        "  --estimate-warn-threshold (num) -- Warning threshold\n"
+    );
+}
+
+static void estimate_print_args(int argc, char * const *argv)
+{
+    printf(" --estimate-probes %d",
+        read_int("--estimate-probes", argc, argv, NULL,
+            estimate_default_probes));
+    printf(" --estimate-fail-threshold %d",
+        read_int("--estimate-fail-threshold", argc, argv, NULL,
+            residual_default_fail_threshold));
+    printf(" --estimate-warn-threshold %d",
+        read_int("--estimate-warn-threshold", argc, argv, NULL,
+            residual_default_warn_threshold));
+}
+
+static int estimate_check_args(int argc, char * const *argv, int *argr)
+{
+    int probes = read_int("--estimate-probes", argc, argv, argr,
+        estimate_default_probes);
+    int fail_threshold =
+        read_int("--estimate-fail-threshold", argc, argv, argr,
+            residual_default_fail_threshold);
+    int warn_threshold =
+        read_int("--estimate-warn-threshold", argc, argv, argr,
+            residual_default_warn_threshold);
+
+    if (probes < 1) {
+        fprintf(stderr, "Invalid number of probe vectors\n");
+        return 1;
+    }
+    if (fail_threshold < 0) {
+        fprintf(stderr, "Invalid failure threshold\n");
+        return 1;
+    }
+    if (warn_threshold < 0) {
+        fprintf(stderr, "Invalid warning threshold\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int estimate_test_init(
+    int argc, char * const *argv, int repeat, int warmup, hook_state_t *state)
+{
+    struct estimate_test_state_t *t =
+        malloc(sizeof(struct estimate_test_state_t));
+
+    t->probes = read_int("--estimate-probes", argc, argv, NULL,
+        estimate_default_probes);
+    t->fail_threshold = read_int("--estimate-fail-threshold", argc, argv, NULL,
+        residual_default_fail_threshold);
+    t->warn_threshold = read_int("--estimate-warn-threshold", argc, argv, NULL,
+        residual_default_warn_threshold);
+
+    *state = t;
+
+    return 0;
+}
+
+static int estimate_test_clean(hook_state_t state)
+{
+    free(state);
+    return 0;
+}
+
+static hook_return_t estimate_test_after_data_init(
+    int iter, hook_state_t state, struct hook_data_env *env)
+{
+    if (iter < 0)
+        return HOOK_SUCCESS;
+
+    fill_pencil((pencil_t) env->data);
+
+    return HOOK_SUCCESS;
+}
+
+static hook_return_t estimate_test_after_solver_run(
+    int iter, hook_state_t state, struct hook_data_env *env)
+{
+    if (iter < 0)
+        return HOOK_SUCCESS;
+
+    pencil_t pencil = (pencil_t) env->data;
+    struct estimate_test_state_t *t = state;
+
+    if (pencil->mat_b != NULL) {
+        printf("Residual estimates are available only for the standard "
+            "case.\n");
+        return HOOK_SUCCESS;
+    }
+
+    int n = GENERIC_MATRIX_M(pencil->mat_a);
+
+    double residual = NAN, orthogonality = NAN;
+    starneig_error_t ret = STARNEIG_SUCCESS;
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (pencil->mat_a->type == STARNEIG_MATRIX ||
+    pencil->mat_a->type == BLACS_MATRIX) {
+        int initialized = starneig_node_initialized();
+        if (!initialized)
+            starneig_node_init(threads_get_workers(), 0,
+                threads_get_fast_dm() | STARNEIG_NO_VERBOSE |
+                STARNEIG_FXT_DISABLE);
+
+        ret = starneig_SEP_DM_Validate(
+            STARNEIG_MATRIX_HANDLE(pencil->mat_ca),
+            STARNEIG_MATRIX_HANDLE(pencil->mat_q),
+            STARNEIG_MATRIX_HANDLE(pencil->mat_a),
+            t->probes, &residual, &orthogonality);
+
+        if (!initialized)
+            starneig_node_finalize();
+    }
+    else
+#endif
+    {
+        int initialized = starneig_node_initialized();
+        if (!initialized)
+            starneig_node_init(threads_get_workers(), 0,
+                STARNEIG_HINT_SM | STARNEIG_NO_VERBOSE | STARNEIG_FXT_DISABLE);
+
+        ret = starneig_SEP_SM_Validate(n,
+            LOCAL_MATRIX_PTR(pencil->mat_ca), LOCAL_MATRIX_LD(pencil->mat_ca),
+            LOCAL_MATRIX_PTR(pencil->mat_q), LOCAL_MATRIX_LD(pencil->mat_q),
+            LOCAL_MATRIX_PTR(pencil->mat_a), LOCAL_MATRIX_LD(pencil->mat_a),
+            t->probes, &residual, &orthogonality);
+
+        if (!initialized)
+            starneig_node_finalize();
+    }
+
+    if (ret != STARNEIG_SUCCESS) {
+        fprintf(stderr, "Residual estimation failed.\n");
+        return HOOK_SOFT_FAIL;
+    }
+
+    // use the same units as the residual hook
+    residual /= DBL_EPSILON;
+    orthogonality /= sqrt(n)*DBL_EPSILON;
+
+    printf("est. |Q ~A Q^T - A| / |A| = %.0f u\n", residual);
+    printf("est. |Q Q^T - I| / |I| = %.0f u\n", orthogonality);
+
+    if (t->fail_threshold < residual || isnan(residual) ||
+    t->fail_threshold < orthogonality || isnan(orthogonality))
+        return HOOK_SOFT_FAIL;
+
+    if (t->warn_threshold < residual || t->warn_threshold < orthogonality)
+        return HOOK_WARNING;
+
+    return HOOK_SUCCESS;
+}
+
+const struct hook_t estimate_test = {
+    .name = "estimate",
+    .desc = "Randomized residual estimate",
+    .formats = (hook_data_format_t[]) {
+        HOOK_DATA_FORMAT_PENCIL_LOCAL,
+#ifdef STARNEIG_ENABLE_MPI
+        HOOK_DATA_FORMAT_PENCIL_STARNEIG,
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        HOOK_DATA_FORMAT_PENCIL_BLACS,
+#endif
+        0 },
+    .print_usage = &estimate_print_usage,
+    .print_args = &estimate_print_args,
+    .check_args = &estimate_check_args,
+    .init = &estimate_test_init,
+    .clean = &estimate_test_clean,
+    .after_data_init = &estimate_test_after_data_init,
+    .after_solver_run = &estimate_test_after_solver_run
+};
+
+const struct hook_descr_t default_estimate_test_descr = {
+    .is_enabled = 0,
+    .default_mode = HOOK_MODE_NORMAL,
+    .hook = &estimate_test
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// @brief Selection criterion that is shared by all selection predicates.
+///
+static int select_criterion(double real, double imag, double beta)
+{
+    return 0.0 < (real + imag) * beta;
+}
+
+static int select_sep_predicate(double real, double imag, void *arg)
+{
+    __atomic_fetch_add((int *) arg, 1, __ATOMIC_RELAXED);
+    return select_criterion(real, imag, 1.0);
+}
+
+static int select_gep_predicate(
+    double real, double imag, double beta, void *arg)
+{
+    __atomic_fetch_add((int *) arg, 1, __ATOMIC_RELAXED);
+    return select_criterion(real, imag, beta);
+}
+
+static void select_sep_batched_predicate(
+    int count, double const real[], double const imag[], int selected[],
+    void *arg)
+{
+    __atomic_fetch_add((int *) arg, count, __ATOMIC_RELAXED);
+    for (int i = 0; i < count; i++)
+        selected[i] = select_criterion(real[i], imag[i], 1.0);
+}
+
+static void select_gep_batched_predicate(
+    int count, double const real[], double const imag[], double const beta[],
+    int selected[], void *arg)
+{
+    __atomic_fetch_add((int *) arg, count, __ATOMIC_RELAXED);
+    for (int i = 0; i < count; i++)
+        selected[i] = select_criterion(real[i], imag[i], beta[i]);
+}
+
+struct select_crawler_arg {
+    int errors;         ///< number of mismatching selection array entries
+    int blocks;         ///< number of diagonal blocks
+    int selected;       ///< number of selected eigenvalues
+    int *scalar;        ///< selection array from the scalar predicate
+    int *batched;       ///< selection array from the batched predicate
+};
+
+///
+/// @brief Walks the diagonal serially like the original selection helpers and
+/// compares the outcome against the computed selection arrays.
+///
+static int crawl_select(
+    int offset, int width, int m, int n, int count, size_t *lds,
+    void **ptrs, void *arg)
+{
+    struct select_crawler_arg *state = arg;
+
+    double *A = ptrs[0];
+    int ldA = lds[0];
+
+    double *B = NULL;
+    int ldB = 0;
+    if (1 < count) {
+        B = ptrs[1];
+        ldB = lds[1];
+    }
+
+    #define _A(i,j) A[(size_t)((j)-offset)*ldA+(i)]
+    #define _B(i,j) B[(size_t)((j)-offset)*ldB+(i)]
+
+    extern double dlamch_(char const *);
+    const double safmin = dlamch_("S");
+
+    int _n = offset+width < n ? offset+width-1 : n;
+
+    int i = offset;
+    while (i < _n) {
+        double real, imag = 0.0, beta = 1.0;
+        int size = 1;
+
+        if (i+1 < n && _A(i+1,i) != 0.0) {
+            if (B != NULL) {
+                extern void dlag2_(double const *, int const *,
+                    double const *, int const *, double const *,
+                    double const *, double *, double *, double *, double *);
+
+                double beta2, real2;
+                dlag2_(&_A(i,i), &ldA, &_B(i,i), &ldB, &safmin,
+                    &beta, &beta2, &real, &real2, &imag);
+            }
+            else {
+                extern void dlanv2_(
+                    double *, double *, double *, double *, double *,
+                    double *, double *, double *, double *, double *);
+
+                double a[] = {
+                    _A(i,i), _A(i+1,i), _A(i,i+1), _A(i+1,i+1)
+                };
+                double real2, imag2, cs, ss;
+                dlanv2_(&a[0], &a[2], &a[1], &a[3],
+                    &real, &imag, &real2, &imag2, &cs, &ss);
+            }
+            size = 2;
+        }
+        else {
+            real = _A(i,i);
+            if (B != NULL)
+                beta = _B(i,i);
+        }
+
+        int expected = select_criterion(real, imag, beta);
+        for (int j = i; j < i+size; j++) {
+            if (state->scalar[j] != expected || state->batched[j] != expected)
+                state->errors++;
+            state->selected += expected;
+        }
+
+        state->blocks++;
+        i += size;
+    }
+
+    #undef _A
+    #undef _B
+
+    return i;
+}
+
+static hook_return_t select_test_after_solver_run(
+    int iter, hook_state_t state, struct hook_data_env *env)
+{
+    if (iter < 0)
+        return HOOK_SUCCESS;
+
+    pencil_t pencil = (pencil_t) env->data;
+
+    int n = GENERIC_MATRIX_M(pencil->mat_a);
+
+    int *scalar = malloc(n*sizeof(int));
+    int *batched = malloc(n*sizeof(int));
+    int num_scalar = -1, num_batched = -1;
+    int evals_scalar = 0, evals_batched = 0;
+    starneig_error_t ret = STARNEIG_SUCCESS;
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (pencil->mat_a->type == STARNEIG_MATRIX ||
+    pencil->mat_a->type == BLACS_MATRIX) {
+        int initialized = starneig_node_initialized();
+        if (!initialized)
+            starneig_node_init(threads_get_workers(), 0,
+                threads_get_fast_dm() | STARNEIG_NO_VERBOSE |
+                STARNEIG_FXT_DISABLE);
+
+        if (pencil->mat_b != NULL) {
+            ret = starneig_GEP_DM_Select(
+                STARNEIG_MATRIX_HANDLE(pencil->mat_a),
+                STARNEIG_MATRIX_HANDLE(pencil->mat_b),
+                &select_gep_predicate, &evals_scalar, scalar, &num_scalar);
+            if (ret == STARNEIG_SUCCESS)
+                ret = starneig_GEP_DM_Select_batched(
+                    STARNEIG_MATRIX_HANDLE(pencil->mat_a),
+                    STARNEIG_MATRIX_HANDLE(pencil->mat_b),
+                    &select_gep_batched_predicate, &evals_batched,
+                    batched, &num_batched);
+        }
+        else {
+            ret = starneig_SEP_DM_Select(
+                STARNEIG_MATRIX_HANDLE(pencil->mat_a),
+                &select_sep_predicate, &evals_scalar, scalar, &num_scalar);
+            if (ret == STARNEIG_SUCCESS)
+                ret = starneig_SEP_DM_Select_batched(
+                    STARNEIG_MATRIX_HANDLE(pencil->mat_a),
+                    &select_sep_batched_predicate, &evals_batched,
+                    batched, &num_batched);
+        }
+
+        if (!initialized)
+            starneig_node_finalize();
+
+        // each MPI rank counts the evaluations of its own diagonal tiles
+        MPI_Allreduce(MPI_IN_PLACE, &evals_scalar, 1, MPI_INT, MPI_SUM,
+            MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &evals_batched, 1, MPI_INT, MPI_SUM,
+            MPI_COMM_WORLD);
+    }
+    else
+#endif
+    {
+        int initialized = starneig_node_initialized();
+        if (!initialized)
+            starneig_node_init(threads_get_workers(), 0,
+                STARNEIG_HINT_SM | STARNEIG_NO_VERBOSE | STARNEIG_FXT_DISABLE);
+
+        if (pencil->mat_b != NULL) {
+            ret = starneig_GEP_SM_Select(n,
+                LOCAL_MATRIX_PTR(pencil->mat_a),
+                LOCAL_MATRIX_LD(pencil->mat_a),
+                LOCAL_MATRIX_PTR(pencil->mat_b),
+                LOCAL_MATRIX_LD(pencil->mat_b),
+                &select_gep_predicate, &evals_scalar, scalar, &num_scalar);
+            if (ret == STARNEIG_SUCCESS)
+                ret = starneig_GEP_SM_Select_batched(n,
+                    LOCAL_MATRIX_PTR(pencil->mat_a),
+                    LOCAL_MATRIX_LD(pencil->mat_a),
+                    LOCAL_MATRIX_PTR(pencil->mat_b),
+                    LOCAL_MATRIX_LD(pencil->mat_b),
+                    &select_gep_batched_predicate, &evals_batched,
+                    batched, &num_batched);
+        }
+        else {
+            ret = starneig_SEP_SM_Select(n,
+                LOCAL_MATRIX_PTR(pencil->mat_a),
+                LOCAL_MATRIX_LD(pencil->mat_a),
+                &select_sep_predicate, &evals_scalar, scalar, &num_scalar);
+            if (ret == STARNEIG_SUCCESS)
+                ret = starneig_SEP_SM_Select_batched(n,
+                    LOCAL_MATRIX_PTR(pencil->mat_a),
+                    LOCAL_MATRIX_LD(pencil->mat_a),
+                    &select_sep_batched_predicate, &evals_batched,
+                    batched, &num_batched);
+        }
+
+        if (!initialized)
+            starneig_node_finalize();
+    }
+
+    if (ret != STARNEIG_SUCCESS) {
+        fprintf(stderr, "Eigenvalue selection failed.\n");
+        free(scalar);
+        free(batched);
+        return HOOK_SOFT_FAIL;
+    }
+
+    struct select_crawler_arg arg = {
+        .errors = 0,
+        .blocks = 0,
+        .selected = 0,
+        .scalar = scalar,
+        .batched = batched
+    };
+
+    crawl_matrices(CRAWLER_R, CRAWLER_PANEL, &crawl_select, &arg, sizeof(arg),
+        pencil->mat_a, pencil->mat_b, NULL);
+
+    free(scalar);
+    free(batched);
+
+    hook_return_t status = HOOK_SUCCESS;
+
+    if (0 < arg.errors) {
+        fprintf(stderr, "SELECT TEST: %d MISMATCHING ENTRIES\n", arg.errors);
+        status = HOOK_SOFT_FAIL;
+    }
+    if (num_scalar != arg.selected || num_batched != arg.selected) {
+        fprintf(stderr,
+            "SELECT TEST: SELECTED %d (SCALAR) AND %d (BATCHED), "
+            "EXPECTED %d\n", num_scalar, num_batched, arg.selected);
+        status = HOOK_SOFT_FAIL;
+    }
+    if (evals_scalar != arg.blocks || evals_batched != arg.blocks) {
+        fprintf(stderr,
+            "SELECT TEST: %d (SCALAR) AND %d (BATCHED) PREDICATE "
+            "EVALUATIONS FOR %d DIAGONAL BLOCKS\n",
+            evals_scalar, evals_batched, arg.blocks);
+        status = HOOK_SOFT_FAIL;
+    }
+
+    if (status == HOOK_SUCCESS)
+        printf("SELECT TEST: %d OF %d EIGENVALUES SELECTED\n",
+            arg.selected, n);
+
+    return status;
+}
+
+const struct hook_t select_test = {
+    .name = "select",
+    .desc = "Compares the selection helpers against a serial diagonal walk",
+    .formats = (hook_data_format_t[]) {
+        HOOK_DATA_FORMAT_PENCIL_LOCAL,
+#ifdef STARNEIG_ENABLE_MPI
+        HOOK_DATA_FORMAT_PENCIL_STARNEIG,
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        HOOK_DATA_FORMAT_PENCIL_BLACS,
+#endif
+        0 },
+    .after_solver_run = &select_test_after_solver_run
+};
+
+const struct hook_descr_t default_select_test_descr = {
+    .is_enabled = 0,
+    .default_mode = HOOK_MODE_NORMAL,
+    .hook = &select_test
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 static int crawl_hessenberg(
     int offset, int width, int m, int n, int count, size_t *lds,
     void **ptrs, void *arg)
@@ -50,6 +50,12 @@ extern const struct hook_descr_t default_schur_test_descr;
 extern const struct hook_t residual_test;
 extern const struct hook_descr_t default_residual_test_descr;
 
+extern const struct hook_t estimate_test;
+extern const struct hook_descr_t default_estimate_test_descr;
+
+extern const struct hook_t select_test;
+extern const struct hook_descr_t default_select_test_descr;
+
 extern const struct hook_t print_input_pencil;
 extern const struct hook_descr_t default_print_input_pencil_descr;
 
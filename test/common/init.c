@@ -43,6 +43,7 @@
 #include "local_pencil.h"
 #ifdef STARNEIG_ENABLE_MPI
 #include "starneig_pencil.h"
+#include <mpi.h>
 #endif
 #include <stddef.h>
 #include <stdlib.h>
@@ -50,6 +51,12 @@
 #include <assert.h>
 #include <math.h>
 
+///
+/// @brief Width of the column panels that are generated in parallel when the
+/// matrix is stored locally.
+///
+#define RANDOM_PANEL_WIDTH 128
+
 struct init_helper {
     matrix_type_t type;
     data_type_t dtype;
@@ -91,87 +98,129 @@ static int crawl_identity_dr(
     return width;
 }
 
-static int crawl_random_full_dr(
-    int offset, int width, int m, int n, int count, size_t *lds,
-    void **ptrs, void *arg)
-{
-    double *A = ptrs[0];
-    size_t ldA = lds[0];
-
-    for (int i = 0; i < width; i++)
-        for (int j = 0; j < m; j++)
-            A[i*ldA+j] = 2.0*(1.0*prand()/PRAND_MAX)-1.0;
+///
+/// @brief Random matrix structures.
+///
+typedef enum {
+    RANDOM_FULL,            ///< full matrix, elements from [-1,1)
+    RANDOM_FULLPOS,         ///< full matrix, elements from [0,1)
+    RANDOM_UPTRIAG,         ///< upper triangular matrix
+    RANDOM_UPTRIAGPOS,      ///< upper triangular matrix, positive diagonal
+    RANDOM_HESSENBERG       ///< upper Hessenberg matrix
+} random_structure_t;
 
-    return width;
+///
+/// @brief Computes a single random matrix element.
+///
+/// @param[in] structure
+///         Matrix structure.
+///
+/// @param[in] key
+///         Random number generator key.
+///
+/// @param[in] i
+///         Row index.
+///
+/// @param[in] j
+///         Column index.
+///
+/// @return Matrix element.
+///
+static inline double random_element(
+    random_structure_t structure, uint64_t key, int i, int j)
+{
+    switch (structure) {
+        case RANDOM_FULL:
+            return 2.0*crand(key, i, j)-1.0;
+        case RANDOM_FULLPOS:
+            return crand(key, i, j);
+        case RANDOM_UPTRIAG:
+            return i <= j ? 2.0*crand(key, i, j)-1.0 : 0.0;
+        case RANDOM_UPTRIAGPOS:
+            if (i < j)
+                return 2.0*crand(key, i, j)-1.0;
+            return i == j ? crand(key, i, j) : 0.0;
+        case RANDOM_HESSENBERG:
+            return i <= j+1 ? 2.0*crand(key, i, j)-1.0 : 0.0;
+        default:
+            return 0.0;
+    }
 }
 
-static int crawl_random_fullpos_dr(
-    int offset, int width, int m, int n, int count, size_t *lds,
-    void **ptrs, void *arg)
+///
+/// @brief Fills a block with random matrix elements.
+///
+/// @param[in] structure
+///         Matrix structure.
+///
+/// @param[in] key
+///         Random number generator key.
+///
+/// @param[in] row
+///         Topmost global row that belongs to the block.
+///
+/// @param[in] col
+///         Leftmost global column that belongs to the block.
+///
+/// @param[in] m
+///         Row count.
+///
+/// @param[in] n
+///         Column count.
+///
+/// @param[in] ld
+///         Leading dimension.
+///
+/// @param[out] A
+///         Block.
+///
+static void fill_random_block(
+    random_structure_t structure, uint64_t key, int row, int col,
+    int m, int n, size_t ld, double *A)
 {
-    double *A = ptrs[0];
-    size_t ldA = lds[0];
-
-    for (int i = 0; i < width; i++)
+    for (int i = 0; i < n; i++)
         for (int j = 0; j < m; j++)
-            A[i*ldA+j] = 1.0*prand()/PRAND_MAX;
-
-    return width;
+            A[i*ld+j] = random_element(structure, key, row+j, col+i);
 }
 
-static int crawl_random_uptriag_dr(
-    int offset, int width, int m, int n, int count, size_t *lds,
-    void **ptrs, void *arg)
+///
+/// @brief Fills a matrix with random matrix elements.
+///
+///  The matrix elements are generated in parallel and each element depends
+///  only on the generator key and the element's global location. The result is
+///  therefore independent of the number of threads, the number of MPI ranks and
+///  the data distribution. The matrix is left uninitialized in a simulated
+///  run.
+///
+/// @param[in] structure
+///         Matrix structure.
+///
+/// @param[in,out] matrix
+///         Matrix.
+///
+static void fill_random(random_structure_t structure, matrix_t matrix)
 {
-    double *A = ptrs[0];
-    size_t ldA = lds[0];
-
-    for (int i = 0; i < width; i++) {
-        int end = MIN(m, offset+i+1);
-        for (int j = 0; j < end; j++)
-            A[i*ldA+j] = 2.0*(1.0*prand()/PRAND_MAX)-1.0;
-        for (int j = end; j < m; j++)
-            A[i*ldA+j] = 0.0;
-    }
+    uint64_t key = crand_key();
 
-    return width;
-}
-
-static int crawl_random_uptriagpos_dr(
-    int offset, int width, int m, int n, int count, size_t *lds,
-    void **ptrs, void *arg)
-{
-    double *A = ptrs[0];
-    size_t ldA = lds[0];
+    // the kernels do not read the matrix elements in a simulated run
+    if (get_simulated())
+        return;
 
-    for (int i = 0; i < width; i++) {
-        int end = MIN(m, offset+i);
-        for (int j = 0; j < end; j++)
-            A[i*ldA+j] = 2.0*(1.0*prand()/PRAND_MAX)-1.0;
-        A[i*ldA+end] = prand()/PRAND_MAX;
-        for (int j = end+1; j < m; j++)
-            A[i*ldA+j] = 0.0;
-    }
+#ifdef STARNEIG_ENABLE_MPI
+    // all ranks must agree on the key
+    if (matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX)
+        MPI_Bcast(&key, sizeof(key), MPI_BYTE, 0, MPI_COMM_WORLD);
+#endif
 
-    return width;
-}
+    struct local_block *blocks;
+    int count = get_local_blocks(matrix, RANDOM_PANEL_WIDTH, &blocks);
 
-static int crawl_random_hessenberg_dr(
-    int offset, int width, int m, int n, int count, size_t *lds,
-    void **ptrs, void *arg)
-{
-    double *A = ptrs[0];
-    size_t ldA = lds[0];
-
-    for (int i = 0; i < width; i++) {
-        int end = MIN(m, offset+i+2);
-        for (int j = 0; j < end; j++)
-            A[i*ldA+j] = 2.0*(1.0*prand()/PRAND_MAX)-1.0;
-        for (int j = end; j < m; j++)
-            A[i*ldA+j] = 0.0;
-    }
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < count; i++)
+        fill_random_block(structure, key, blocks[i].row, blocks[i].col,
+            blocks[i].m, blocks[i].n, blocks[i].ld, blocks[i].ptr);
 
-    return width;
+    free(blocks);
 }
 
 static int crawl_householder_dr(
@@ -434,15 +483,12 @@ void init_identity(matrix_t matrix)
 
 void init_random_full(matrix_t matrix)
 {
-    crawl_matrices(
-        CRAWLER_W, CRAWLER_PANEL, &crawl_random_full_dr, NULL, 0, matrix, NULL);
+    fill_random(RANDOM_FULL, matrix);
 }
 
 void init_random_fullpos(matrix_t matrix)
 {
-    crawl_matrices(
-        CRAWLER_W, CRAWLER_PANEL, &crawl_random_fullpos_dr, NULL, 0, matrix,
-        NULL);
+    fill_random(RANDOM_FULLPOS, matrix);
 }
 
 matrix_t generate_zero(int m, int n, init_helper_t helper)
@@ -487,9 +533,7 @@ matrix_t generate_random_uptriag(int m, int n, init_helper_t helper)
 
     matrix_t desc = init_matrix(m, n, helper);
 
-    crawl_matrices(
-        CRAWLER_W, CRAWLER_PANEL, &crawl_random_uptriag_dr, NULL, 0, desc,
-        NULL);
+    fill_random(RANDOM_UPTRIAG, desc);
 
     return desc;
 }
@@ -500,9 +544,7 @@ matrix_t generate_random_uptriagpos(int m, int n, init_helper_t helper)
 
     matrix_t desc = init_matrix(m, n, helper);
 
-    crawl_matrices(
-        CRAWLER_W, CRAWLER_PANEL, &crawl_random_uptriagpos_dr, NULL, 0, desc,
-        NULL);
+    fill_random(RANDOM_UPTRIAGPOS, desc);
 
     return desc;
 }
@@ -513,9 +555,7 @@ matrix_t generate_random_hessenberg(int m, int n, init_helper_t helper)
 
     matrix_t desc = init_matrix(m, n, helper);
 
-    crawl_matrices(
-        CRAWLER_W, CRAWLER_PANEL, &crawl_random_hessenberg_dr, NULL, 0, desc,
-        NULL);
+    fill_random(RANDOM_HESSENBERG, desc);
 
     return desc;
 }
@@ -526,9 +566,13 @@ matrix_t generate_random_householder(int n, init_helper_t helper)
 
     matrix_t desc = init_matrix(n, n, helper);
 
+    uint64_t key = crand_key();
+    if (get_simulated())
+        return desc;
+
     double *vec_v = malloc(n*sizeof(double));
     for (int i = 0; i < n; i++)
-        vec_v[i] = 2.0*(1.0*prand()/PRAND_MAX)-1.0;
+        vec_v[i] = 2.0*crand(key, i, 0)-1.0;
     scale_to_unit_dr(n, vec_v);
 
     crawl_matrices(
@@ -548,3 +592,155 @@ void mul_QAZT(
     mul_C_AB("N", "T", 1.0, tmp, mat_z, 0.0, mat_c);
     free_matrix_descr(tmp);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct random_orthogonal {
+    int n;          ///< matrix dimension
+    int k;          ///< number of Householder reflectors
+    double *V;      ///< Householder reflectors (n-by-k, leading dimension n)
+    double *T;      ///< upper triangular factor (k-by-k, leading dimension k)
+};
+
+random_orthogonal_t init_random_orthogonal(int n, int k)
+{
+    k = MAX(1, MIN(n, k));
+
+    // the prand() streams are synchronized among the MPI ranks
+    uint64_t key = crand_key();
+
+    random_orthogonal_t orth = malloc(sizeof(struct random_orthogonal));
+    orth->n = n;
+    orth->k = k;
+    orth->V = malloc((size_t)n*k*sizeof(double));
+    orth->T = calloc((size_t)k*k, sizeof(double));
+
+    double *V = orth->V, *T = orth->T;
+
+    #pragma omp parallel for
+    for (int j = 0; j < k; j++) {
+        for (int i = 0; i < n; i++)
+            V[(size_t)j*n+i] = 2.0*crand(key, i, j)-1.0;
+        scale_to_unit_dr(n, V+(size_t)j*n);
+    }
+
+    // H_1 H_2 ... H_k = I - V T V^T, H_j = I - 2 v_j v_j^T (cf. xLARFT)
+    double *w = malloc(k*sizeof(double));
+    for (int j = 0; j < k; j++) {
+        for (int i = 0; i < j; i++) {
+            w[i] = 0.0;
+            for (int l = 0; l < n; l++)
+                w[i] += V[(size_t)i*n+l] * V[(size_t)j*n+l];
+        }
+        for (int i = 0; i < j; i++) {
+            double sum = 0.0;
+            for (int l = i; l < j; l++)
+                sum += T[l*k+i] * w[l];
+            T[j*k+i] = -2.0 * sum;
+        }
+        T[j*k+j] = 2.0;
+    }
+    free(w);
+
+    return orth;
+}
+
+void free_random_orthogonal(random_orthogonal_t orth)
+{
+    if (orth == NULL)
+        return;
+
+    free(orth->V);
+    free(orth->T);
+    free(orth);
+}
+
+void transform_QAZT(
+    random_orthogonal_t orth_q, random_orthogonal_t orth_z, matrix_t mat_a)
+{
+    if ((orth_q == NULL && orth_z == NULL) || get_simulated())
+        return;
+
+    int n = GENERIC_MATRIX_N(mat_a);
+    assert(orth_q == NULL || orth_q->n == n);
+    assert(orth_z == NULL || orth_z->n == n);
+
+    struct local_block *blocks;
+    int count = get_local_blocks(mat_a, RANDOM_PANEL_WIDTH, &blocks);
+
+    int kq = orth_q != NULL ? orth_q->k : 0;
+    int kz = orth_z != NULL ? orth_z->k : 0;
+
+    // X = A^T V_Q and Y = A V_Z
+    double *X = calloc((size_t)n*(kq+kz), sizeof(double));
+    double *Y = X + (size_t)n*kq;
+
+    for (int i = 0; i < count; i++) {
+        struct local_block *b = &blocks[i];
+        if (0 < kq)
+            dgemm("T", "N", b->n, kq, b->m, 1.0, b->ptr, b->ld,
+                orth_q->V+b->row, n, 1.0, X+b->col, n);
+        if (0 < kz)
+            dgemm("N", "N", b->m, kz, b->n, 1.0, b->ptr, b->ld,
+                orth_z->V+b->col, n, 1.0, Y+b->row, n);
+    }
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (mat_a->type == STARNEIG_MATRIX || mat_a->type == BLACS_MATRIX)
+        MPI_Allreduce(MPI_IN_PLACE, X, n*(kq+kz), MPI_DOUBLE, MPI_SUM,
+            MPI_COMM_WORLD);
+#endif
+
+    // Q A Z^T = A - V_Q F^T - G V_Z^T, where
+    //   F = X T_Q^T and
+    //   G = Y T_Z^T - V_Q T_Q (V_Q^T Y) T_Z^T
+
+    double *F = NULL, *G = NULL;
+
+    if (0 < kq) {
+        F = malloc((size_t)n*kq*sizeof(double));
+        dgemm("N", "T", n, kq, kq, 1.0, X, n, orth_q->T, kq, 0.0, F, n);
+    }
+
+    if (0 < kz) {
+        G = malloc((size_t)n*kz*sizeof(double));
+        dgemm("N", "T", n, kz, kz, 1.0, Y, n, orth_z->T, kz, 0.0, G, n);
+
+        if (0 < kq) {
+            double *M = malloc((size_t)kq*kz*sizeof(double));
+            double *tmp = malloc((size_t)kq*kz*sizeof(double));
+            dgemm("T", "N", kq, kz, n, 1.0, orth_q->V, n, Y, n, 0.0, M, kq);
+            dgemm("N", "N", kq, kz, kq, 1.0, orth_q->T, kq, M, kq, 0.0, tmp, kq);
+            dgemm("N", "T", kq, kz, kz, 1.0, tmp, kq, orth_z->T, kz, 0.0, M, kq);
+            dgemm("N", "N", n, kz, kq, -1.0, orth_q->V, n, M, kq, 1.0, G, n);
+            free(M);
+            free(tmp);
+        }
+    }
+
+    // rank-k updates are independent between the blocks
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < count; i++) {
+        struct local_block *b = &blocks[i];
+        if (0 < kq)
+            dgemm("N", "T", b->m, b->n, kq, -1.0, orth_q->V+b->row, n,
+                F+b->col, n, 1.0, b->ptr, b->ld);
+        if (0 < kz)
+            dgemm("N", "T", b->m, b->n, kz, -1.0, G+b->row, n,
+                orth_z->V+b->col, n, 1.0, b->ptr, b->ld);
+    }
+
+    free(F);
+    free(G);
+    free(X);
+    free(blocks);
+}
+
+matrix_t generate_random_orthogonal(
+    random_orthogonal_t orth, init_helper_t helper)
+{
+    matrix_t desc = generate_identity(orth->n, orth->n, helper);
+    transform_QAZT(orth, NULL, desc);
+    return desc;
+}
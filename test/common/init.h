@@ -187,6 +187,8 @@ void init_helper_free(init_helper_t helper);
 
 matrix_t init_matrix(int m, int n, init_helper_t helper);
 
+void init_zero(matrix_t matrix);
+
 void init_identity(matrix_t matrix);
 
 void init_random_full(matrix_t matrix);
@@ -287,4 +289,56 @@ matrix_t generate_random_householder(int n, init_helper_t helper);
 void mul_QAZT(
     matrix_t mat_q, matrix_t mat_a, matrix_t mat_z, matrix_t *mat_c);
 
+///
+/// @brief Random orthogonal matrix that is stored as a product of Householder
+/// reflectors in compact WY form, Q = H_1 H_2 ... H_k = I - V T V^T.
+///
+typedef struct random_orthogonal * random_orthogonal_t;
+
+///
+/// @brief Generates a random orthogonal matrix as a product of random
+/// Householder reflectors.
+///
+///  All MPI ranks must make the same calls in the same order.
+///
+/// @param[in] n - matrix dimension
+/// @param[in] k - number of Householder reflectors
+///
+/// @return random orthogonal matrix
+///
+random_orthogonal_t init_random_orthogonal(int n, int k);
+
+///
+/// @brief Frees a random orthogonal matrix.
+///
+/// @param[in,out] orth - random orthogonal matrix
+///
+void free_random_orthogonal(random_orthogonal_t orth);
+
+///
+/// @brief Forms a random orthogonal matrix explicitly.
+///
+/// @param[in] orth - random orthogonal matrix
+/// @param[in] helper - matrix initialization helper
+///
+/// @return a pointer to an allocated matrix descriptor structure
+///
+matrix_t generate_random_orthogonal(
+    random_orthogonal_t orth, init_helper_t helper);
+
+///
+/// @brief Computes A <- Q A Z^T in place.
+///
+///  The transformation is applied as two rank-k updates in O(n^2 k) time. Only
+///  two n-by-k matrices are reduced among the MPI ranks; the updates are local
+///  to the blocks and are applied in parallel. Nothing is done in a simulated
+///  run.
+///
+/// @param[in] orth_q - random orthogonal matrix Q, NULL for identity
+/// @param[in] orth_z - random orthogonal matrix Z, NULL for identity
+/// @param[in,out] mat_a - matrix A
+///
+void transform_QAZT(
+    random_orthogonal_t orth_q, random_orthogonal_t orth_z, matrix_t mat_a);
+
 #endif
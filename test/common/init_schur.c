@@ -60,6 +60,7 @@ static void default_initializer_print_usage(int argc, char * const *argv)
         "distribution module\n"
         "  --qI -- Initialize Q to identity\n"
         "  --zI -- Initialize Z to identity\n"
+        "  --reflectors (num) -- Number of Householder reflectors in Q and Z\n"
     );
 
     init_helper_print_usage("", INIT_HELPER_ALL, argc, argv);
@@ -84,6 +85,8 @@ static void default_initializer_print_args(int argc, char * const *argv)
     if (generalized && read_opt("--zI", argc, argv, NULL))
         printf(" --zI");
 
+    printf(" --reflectors %d", read_int("--reflectors", argc, argv, NULL, 1));
+
     if (complex_distr->print_args != NULL)
         complex_distr->print_args(argc, argv);
 
@@ -110,6 +113,11 @@ static int default_initializer_check_args(
     if (generalized)
         read_opt("--zI", argc, argv, argr);
 
+    if (read_int("--reflectors", argc, argv, argr, 1) < 1) {
+        fprintf(stderr, "Invalid number of Householder reflectors.\n");
+        return -1;
+    }
+
     if (complex_distr->check_args != NULL) {
         int ret = complex_distr->check_args(argc, argv, argr);
         if (ret)
@@ -133,6 +141,7 @@ static struct hook_data_env* default_initializer_init(
 
     int qI = read_opt("--qI", argc, argv, NULL);
     int zI = read_opt("--zI", argc, argv, NULL);
+    int reflectors = read_int("--reflectors", argc, argv, NULL, 1);
 
     init_helper_t helper = init_helper_init_hook(
         "", format, n, n, PREC_DOUBLE | NUM_REAL, argc, argv);
@@ -158,26 +167,47 @@ static struct hook_data_env* default_initializer_init(
     // generate Q matrix
     //
 
-    if (qI)
+    random_orthogonal_t orth_q = NULL;
+    if (qI) {
         pencil->mat_q = generate_identity(n, n, helper);
-    else
-        pencil->mat_q = generate_random_householder(n, helper);
-
+    }
+    else {
+        orth_q = init_random_orthogonal(n, reflectors);
+        pencil->mat_q = generate_random_orthogonal(orth_q, helper);
+    }
 
+    //
+    // generate Z matrix
+    //
 
+    random_orthogonal_t orth_z = orth_q;
     if (generalized) {
-
-        //
-        // generate Z matrix
-        //
-
-        if (zI)
+        if (zI) {
+            orth_z = NULL;
             pencil->mat_z = generate_identity(n, n, helper);
-        else
-            pencil->mat_z = generate_random_householder(n, helper);
+        }
+        else {
+            orth_z = init_random_orthogonal(n, reflectors);
+            pencil->mat_z = generate_random_orthogonal(orth_z, helper);
+        }
+    }
 
+    //
+    // form the original matrices using rank-k updates; fill_pencil() would
+    // otherwise compute them with dense matrix-matrix multiplications
+    //
+
+    pencil->mat_ca = copy_matrix_descr(pencil->mat_a);
+    transform_QAZT(orth_q, orth_z, pencil->mat_ca);
+    if (generalized) {
+        pencil->mat_cb = copy_matrix_descr(pencil->mat_b);
+        transform_QAZT(orth_q, orth_z, pencil->mat_cb);
     }
 
+    free_random_orthogonal(orth_q);
+    if (orth_z != orth_q)
+        free_random_orthogonal(orth_z);
+
     init_helper_free(helper);
 
     return env;
@@ -51,6 +51,13 @@
 #include "hook_experiment.h"
 #include "../3rdparty/matrixmarket/mmio.h"
 #include <unistd.h>
+#include <stdint.h>
+#include <limits.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 void read_mtx_dimensions_from_file(char const *name, int *m, int *n)
 {
@@ -115,6 +122,335 @@ matrix_t read_mtx_matrix_from_file(char const *name, init_helper_t helper)
     return read_mtx_sub_matrix_from_file(0, m, name, helper);
 }
 
+///
+/// @brief Exact powers of ten.
+///
+static const double mtx_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+///
+/// @brief Parses a floating-point number.
+///
+///  Numbers that have at most 19 significant digits and a mantissa that is
+///  exactly representable are converted with a single multiplication or
+///  division by an exact power of ten (correctly rounded). Other numbers are
+///  passed to strtod().
+///
+/// @param[in] ptr
+///         Beginning of the number.
+///
+/// @param[in] end
+///         End of the buffer.
+///
+/// @param[out] val
+///         Returns the number.
+///
+/// @return A pointer to the first character after the number, NULL on failure.
+///
+static char const * mtx_parse_double(
+    char const *ptr, char const *end, double *val)
+{
+    char const *begin = ptr;
+
+    int negative = 0;
+    if (ptr < end && (*ptr == '-' || *ptr == '+'))
+        negative = *ptr++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0, any = 0, exact = 1;
+
+    for (; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++, any = 1) {
+        if (digits < 19) {
+            mantissa = 10*mantissa + (*ptr - '0');
+            digits += 0 < mantissa;
+        }
+        else {
+            exact = 0;
+        }
+    }
+
+    if (ptr < end && *ptr == '.') {
+        for (ptr++; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++, any = 1) {
+            if (digits < 19) {
+                mantissa = 10*mantissa + (*ptr - '0');
+                digits += 0 < mantissa;
+                exponent--;
+            }
+            else {
+                exact = 0;
+            }
+        }
+    }
+
+    if (any && ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+        char const *mark = ptr++;
+        int sign = 1;
+        if (ptr < end && (*ptr == '-' || *ptr == '+'))
+            sign = *ptr++ == '-' ? -1 : 1;
+        if (ptr < end && '0' <= *ptr && *ptr <= '9') {
+            int e = 0;
+            for (; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++)
+                e = MIN(10000, 10*e + (*ptr - '0'));
+            exponent += sign*e;
+        }
+        else {
+            ptr = mark;
+        }
+    }
+
+    if (any && exact && mantissa < ((uint64_t) 1 << 53) &&
+    -22 <= exponent && exponent <= 22) {
+        double x = mantissa;
+        x = exponent < 0 ? x / mtx_pow10[-exponent] : x * mtx_pow10[exponent];
+        *val = negative ? -x : x;
+        return ptr;
+    }
+
+    // slow path (long mantissas, large exponents, inf, nan, ...)
+
+    if (!any)
+        for (ptr = begin; ptr < end && !isspace(*ptr); ptr++);
+
+    char buffer[128];
+    size_t length = ptr - begin;
+    if (length == 0 || sizeof(buffer) <= length)
+        return NULL;
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+
+    char *tail;
+    *val = strtod(buffer, &tail);
+    if (tail != buffer + length)
+        return NULL;
+
+    return ptr;
+}
+
+///
+/// @brief Parses a positive integer.
+///
+/// @param[in] ptr
+///         Beginning of the number.
+///
+/// @param[in] end
+///         End of the buffer.
+///
+/// @param[out] val
+///         Returns the number.
+///
+/// @return A pointer to the first character after the number, NULL on failure.
+///
+static char const * mtx_parse_int(char const *ptr, char const *end, int *val)
+{
+    if (end <= ptr || *ptr < '0' || '9' < *ptr)
+        return NULL;
+
+    long x = 0;
+    for (; ptr < end && '0' <= *ptr && *ptr <= '9'; ptr++)
+        x = MIN((long) INT_MAX, 10*x + (*ptr - '0'));
+
+    *val = x;
+    return ptr;
+}
+
+///
+/// @brief Skips spaces and tabulators.
+///
+static inline char const * mtx_skip_blank(char const *ptr, char const *end)
+{
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t'))
+        ptr++;
+    return ptr;
+}
+
+///
+/// @brief Destination of the parsed matrix entries.
+///
+struct mtx_target {
+    int begin;                  ///< first row/column to be stored
+    int end;                    ///< last row/column to be stored + 1
+    struct local_block *blocks; ///< locally stored blocks
+    int row_count;              ///< number of distinct block rows
+    int col_count;              ///< number of distinct block columns
+    int *row_starts;            ///< sorted topmost rows of the block rows
+    int *col_starts;            ///< sorted leftmost columns of the block cols
+    int *table;                 ///< block row x block column -> block (or -1)
+};
+
+static int compare_ints(void const *a, void const *b)
+{
+    int x = *(int const *) a, y = *(int const *) b;
+    return (x > y) - (x < y);
+}
+
+static int unique_ints(int count, int *array)
+{
+    qsort(array, count, sizeof(int), &compare_ints);
+    int unique = 0;
+    for (int i = 0; i < count; i++)
+        if (unique == 0 || array[unique-1] != array[i])
+            array[unique++] = array[i];
+    return unique;
+}
+
+///
+/// @brief Returns the index of the last element that is <= x, or -1.
+///
+static int find_start(int count, int const *starts, int x)
+{
+    int low = 0, high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (starts[mid] <= x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low - 1;
+}
+
+///
+/// @brief Builds a lookup table that maps a block row and a block column to
+/// a locally stored block.
+///
+static void mtx_target_init(matrix_t matrix, struct mtx_target *target)
+{
+    int num_blocks = get_local_blocks(matrix, 0, &target->blocks);
+
+    target->row_starts = malloc(MAX(1, num_blocks)*sizeof(int));
+    target->col_starts = malloc(MAX(1, num_blocks)*sizeof(int));
+    for (int k = 0; k < num_blocks; k++) {
+        target->row_starts[k] = target->blocks[k].row;
+        target->col_starts[k] = target->blocks[k].col;
+    }
+    target->row_count = unique_ints(num_blocks, target->row_starts);
+    target->col_count = unique_ints(num_blocks, target->col_starts);
+
+    target->table = malloc(
+        MAX(1, (size_t) target->row_count*target->col_count)*sizeof(int));
+    for (size_t k = 0; k < (size_t) target->row_count*target->col_count; k++)
+        target->table[k] = -1;
+
+    for (int k = 0; k < num_blocks; k++) {
+        int r = find_start(
+            target->row_count, target->row_starts, target->blocks[k].row);
+        int c = find_start(
+            target->col_count, target->col_starts, target->blocks[k].col);
+        target->table[(size_t) c*target->row_count+r] = k;
+    }
+}
+
+///
+/// @brief Frees the lookup table.
+///
+static void mtx_target_free(struct mtx_target *target)
+{
+    free(target->blocks);
+    free(target->row_starts);
+    free(target->col_starts);
+    free(target->table);
+}
+
+///
+/// @brief Stores a matrix entry.
+///
+/// @param[in] target
+///         Destination.
+///
+/// @param[in] i
+///         Row index (one-based, inside the whole stored matrix).
+///
+/// @param[in] j
+///         Column index (one-based, inside the whole stored matrix).
+///
+/// @param[in] val
+///         Matrix entry.
+///
+static inline void mtx_store(
+    struct mtx_target const *target, int i, int j, double val)
+{
+    i = i - 1 - target->begin;
+    j = j - 1 - target->begin;
+
+    if (i < 0 || target->end - target->begin <= i ||
+    j < 0 || target->end - target->begin <= j)
+        return;
+
+    int r = find_start(target->row_count, target->row_starts, i);
+    int c = find_start(target->col_count, target->col_starts, j);
+    if (r < 0 || c < 0)
+        return;
+
+    int k = target->table[(size_t) c*target->row_count+r];
+    if (k < 0)
+        return;
+
+    struct local_block const *block = &target->blocks[k];
+    int _i = i - block->row;
+    int _j = j - block->col;
+    if (block->m <= _i || block->n <= _j)
+        return;
+
+    block->ptr[(size_t) _j*block->ld+_i] = val;
+}
+
+///
+/// @brief Parses a line-aligned chunk of Matrix Market coordinate entries.
+///
+/// @param[in] ptr
+///         Beginning of the chunk.
+///
+/// @param[in] end
+///         End of the chunk.
+///
+/// @param[in] target
+///         Destination.
+///
+/// @return The number of parsed entries, -1 on failure.
+///
+static long mtx_parse_chunk(
+    char const *ptr, char const *end, struct mtx_target const *target)
+{
+    long count = 0;
+
+    while (ptr < end) {
+        ptr = mtx_skip_blank(ptr, end);
+
+        // empty and comment lines
+        if (ptr < end && (*ptr == '\n' || *ptr == '\r' || *ptr == '%')) {
+            while (ptr < end && *ptr != '\n')
+                ptr++;
+            ptr++;
+            continue;
+        }
+        if (end <= ptr)
+            break;
+
+        int i, j;
+        double val;
+
+        if ((ptr = mtx_parse_int(ptr, end, &i)) == NULL)
+            return -1;
+        ptr = mtx_skip_blank(ptr, end);
+        if ((ptr = mtx_parse_int(ptr, end, &j)) == NULL)
+            return -1;
+        ptr = mtx_skip_blank(ptr, end);
+        if ((ptr = mtx_parse_double(ptr, end, &val)) == NULL)
+            return -1;
+
+        while (ptr < end && *ptr != '\n')
+            ptr++;
+        ptr++;
+
+        mtx_store(target, i, j, val);
+        count++;
+    }
+
+    return count;
+}
+
 matrix_t read_mtx_sub_matrix_from_file(
     int begin, int end, char const *name, init_helper_t helper)
 {
@@ -146,6 +482,10 @@ matrix_t read_mtx_sub_matrix_from_file(
         abort();
     }
 
+    // the coordinate entries begin after the size line
+    long offset = ftell(file);
+    fclose(file);
+
     if (begin == 0 && end == m)
         printf("READING A %d X %d MATRIX ...\n", m, n);
     else
@@ -154,64 +494,140 @@ matrix_t read_mtx_sub_matrix_from_file(
 
     matrix_t matrix = generate_zero(end-begin, end-begin, helper);
 
-    if (matrix->type == LOCAL_MATRIX) {
-        double *A = LOCAL_MATRIX_PTR(matrix);
-        size_t ldA = LOCAL_MATRIX_LD(matrix);
+    struct mtx_target target = { .begin = begin, .end = end };
+    mtx_target_init(matrix, &target);
 
-        for (int k = 0; k < nz; k++) {
-            int i, j;
-            double val;
-            if (fscanf(file, "%d %d %lg\n", &i, &j, &val) == EOF) {
-                fprintf(stderr, "Invalid file.\n");
-                abort();
-            }
+    //
+    // map the file and split it at line boundaries
+    //
 
-            if (begin <= i-1 && i-1 < end && begin <= j-1 && j-1 < end)
-                A[(j-1-begin)*ldA+i-1-begin] = val;
+    int fd = open(name, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "Invalid filename.\n");
+        abort();
+    }
+
+    size_t size = st.st_size;
+    char const *data = MAP_FAILED;
+    if (offset < size) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            fprintf(stderr, "Failed to map the file.\n");
+            abort();
         }
+        madvise((void *) data, size, MADV_SEQUENTIAL);
+        madvise((void *) data, size, MADV_WILLNEED);
     }
+    close(fd);
+
+    long total = 0;
+    int failed = 0;
+
+    if (data != MAP_FAILED) {
+        #pragma omp parallel reduction(+:total) reduction(|:failed)
+        {
+            int chunks = omp_get_num_threads();
+            int chunk = omp_get_thread_num();
+
+            // a chunk begins from the first line that begins inside it
+            size_t from = offset + (size-offset) * chunk / chunks;
+            size_t to = offset + (size-offset) * (chunk+1) / chunks;
+            while (offset < from && from < size && data[from-1] != '\n')
+                from++;
+            while (to < size && data[to-1] != '\n')
+                to++;
+
+            long count = 0;
+            if (from < to)
+                count = mtx_parse_chunk(data+from, data+to, &target);
+
+            if (count < 0)
+                failed = 1;
+            else
+                total += count;
+        }
 
-#ifdef STARNEIG_ENABLE_MPI
-    if (matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX) {
-        struct starneig_distr_block *blocks;
-        int num_blocks;
-        starneig_distr_matrix_get_blocks(
-            STARNEIG_MATRIX_HANDLE(matrix), &blocks, &num_blocks);
+        munmap((void *) data, size);
+    }
 
-        for (int k = 0; k < nz; k++) {
-            int i, j;
-            double val;
-            if (fscanf(file, "%d %d %lg\n", &i, &j, &val) == EOF) {
-                fprintf(stderr, "Invalid file.\n");
-                abort();
-            }
+    mtx_target_free(&target);
 
-            for (int l = 0; l < num_blocks; l++) {
-                if (
-                    blocks[l].glo_row <= i-1-begin &&
-                        i-1-begin < blocks[l].glo_row+blocks[l].row_blksz &&
-                    blocks[l].glo_col <= j-1-begin &&
-                        j-1-begin < blocks[l].glo_col+blocks[l].col_blksz
-                ) {
-                    double *A = blocks[l].ptr;
-                    size_t ldA = blocks[l].ld;
-                    int _i = i-1-begin-blocks[l].glo_row;
-                    int _j = j-1-begin-blocks[l].glo_col;
-
-                    A[_j*ldA+_i] = val;
-
-                    break;
-                }
-            }
+    if (failed || total != nz) {
+        fprintf(stderr, "Invalid file.\n");
+        abort();
+    }
+
+    return matrix;
+}
+
+long verify_mtx_sub_matrix_from_file(
+    int begin, int end, char const *name, const matrix_t matrix)
+{
+    FILE *file = fopen(name, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Invalid filename.\n");
+        abort();
+    }
+
+    MM_typecode matcode;
+    int m, n, nz;
+    if (mm_read_banner(file, &matcode) != 0 ||
+    mm_read_mtx_crd_size(file, &m, &n, &nz) != 0) {
+        fprintf(stderr, "Invalid file.\n");
+        abort();
+    }
+
+    matrix_t reference = copy_matrix_descr(matrix);
+    init_zero(reference);
+
+    struct mtx_target target = { .begin = begin, .end = end };
+    mtx_target_init(reference, &target);
+
+    // reference reader: sequential fscanf() and strtod() conversions
+    for (int k = 0; k < nz; k++) {
+        int i, j;
+        double val;
+        if (fscanf(file, "%d %d %lg\n", &i, &j, &val) != 3) {
+            fprintf(stderr, "Invalid file.\n");
+            abort();
         }
+        mtx_store(&target, i, j, val);
     }
-#endif
 
+    mtx_target_free(&target);
     fclose(file);
 
-    return matrix;
+    struct local_block *blocks, *ref_blocks;
+    int count = get_local_blocks(matrix, 0, &blocks);
+    int ref_count = get_local_blocks(reference, 0, &ref_blocks);
+
+    long mismatches = 0;
+    for (int k = 0; k < count && k < ref_count; k++) {
+        struct local_block const *b = &blocks[k], *r = &ref_blocks[k];
+        for (int j = 0; j < b->n; j++)
+            for (int i = 0; i < b->m; i++)
+                if (memcmp(b->ptr+(size_t)j*b->ld+i,
+                r->ptr+(size_t)j*r->ld+i, sizeof(double)) != 0)
+                    mismatches++;
+    }
+    if (count != ref_count)
+        mismatches++;
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX)
+        MPI_Allreduce(MPI_IN_PLACE, &mismatches, 1, MPI_LONG, MPI_SUM,
+            MPI_COMM_WORLD);
+#endif
+
+    free(blocks);
+    free(ref_blocks);
+    free_matrix_descr(reference);
+
+    return mismatches;
 }
 
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static int write_raw_crawler(
@@ -237,6 +653,17 @@ static int write_raw_crawler(
 
 void write_raw_matrix_to_file(char const *name, matrix_t matrix)
 {
+#ifdef STARNEIG_ENABLE_MPI
+    if (matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX) {
+        if (starneig_distr_matrix_write(
+        name, NULL, STARNEIG_MATRIX_HANDLE(matrix)) != STARNEIG_SUCCESS) {
+            fprintf(stderr, "Failed to write the matrix.\n");
+            abort();
+        }
+        return;
+    }
+#endif
+
     FILE *file = fopen(name, "wb");
     if (file == NULL) {
         fprintf(stderr, "Invalid filename.\n");
@@ -246,7 +673,12 @@ void write_raw_matrix_to_file(char const *name, matrix_t matrix)
     int m = GENERIC_MATRIX_M(matrix);
     int n = GENERIC_MATRIX_N(matrix);
 
-    if (fprintf(file, "STARNEIG RAW REAL DOUBLE M %d N %d\n", m, n) < 0) {
+    // the header is padded so that the matrix elements become aligned and
+    // the file can be mapped directly to memory
+    char header[STARNEIG_MATRIX_HEADER_MAX];
+    int length = starneig_matrix_header(m, n, header);
+
+    if (fwrite(header, 1, length, file) != (size_t) length) {
         fprintf(stderr, "write_raw_crawler write error.\n");
         abort();
     }
@@ -311,6 +743,20 @@ matrix_t read_raw_sub_matrix_from_file(
 
     matrix_t matrix = init_matrix(end-begin, end-begin, helper);
 
+#ifdef STARNEIG_ENABLE_MPI
+    // the whole matrix is read collectively using MPI-IO
+    if ((matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX) &&
+    begin == 0 && end == m && end == n) {
+        fclose(file);
+        if (starneig_distr_matrix_read(
+        name, NULL, STARNEIG_MATRIX_HANDLE(matrix)) != STARNEIG_SUCCESS) {
+            fprintf(stderr, "read_raw_sub_matrix_from_file failed.\n");
+            abort();
+        }
+        return matrix;
+    }
+#endif
+
     if (matrix->type == LOCAL_MATRIX) {
         double *A = LOCAL_MATRIX_PTR(matrix);
         size_t ldA = LOCAL_MATRIX_LD(matrix);
@@ -361,6 +807,32 @@ matrix_t read_raw_sub_matrix_from_file(
     return matrix;
 }
 
+matrix_t map_raw_sub_matrix_from_file(
+    int begin, int end, char const *name, starneig_map_flag_t flags)
+{
+    int m, n, ld;
+    double *ptr;
+    if (starneig_matrix_map(name, flags, &m, &n, &ptr, &ld) !=
+    STARNEIG_SUCCESS) {
+        fprintf(stderr, "map_raw_sub_matrix_from_file failed.\n");
+        abort();
+    }
+
+    if (begin < 0 || end < begin || m < end || n < end) {
+        fprintf(stderr, "Invalid submatrix dimension.\n");
+        abort();
+    }
+
+    if (begin == 0 && end == m && end == n)
+        printf("MAPPING A %d X %d MATRIX ...\n", m, n);
+    else
+        printf("MAPPING DIAGONAL SUBMATRIX [%d,%d[ FROM A %d X %d MATRIX ...\n",
+            begin, end, m, n);
+
+    return init_local_matrix_mapped(end-begin, end-begin, ld,
+        PREC_DOUBLE | NUM_REAL, ptr + (size_t)begin*ld + begin);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -617,6 +1089,7 @@ static void mtx_initializer_print_usage(int argc, char * const *argv)
         "file name\n"
         "  --input-begin (num) -- First matrix row/column to be read\n"
         "  --input-end (num) -- Last matrix row/column to be read + 1\n"
+        "  --input-verify -- Compare against a sequential fscanf() reader\n"
     );
 
     init_helper_print_usage("", INIT_HELPER_ALL, argc, argv);
@@ -634,6 +1107,8 @@ static void mtx_initializer_print_args(int argc, char * const *argv)
     int input_end = read_int("--input-end", argc, argv, NULL, -1);
     if (0 <= input_begin && 0 <= input_end)
         printf(" --input-begin %d --input-end %d", input_begin, input_end);
+    if (read_opt("--input-verify", argc, argv, NULL))
+        printf(" --input-verify");
 
     init_helper_print_args("", INIT_HELPER_ALL, argc, argv);
 }
@@ -665,9 +1140,27 @@ static int mtx_initializer_check_args(
     if (input_begin < 0 && input_end < input_begin)
         return 1;
 
+    read_opt("--input-verify", argc, argv, argr);
+
     return init_helper_check_args("", INIT_HELPER_ALL, argc, argv, argr);
 }
 
+///
+/// @brief Compares a matrix that was read from a MTX file against the
+/// sequential reference reader. Aborts on mismatch.
+///
+static void verify_mtx(
+    int begin, int end, char const *name, const matrix_t matrix)
+{
+    long mismatches = verify_mtx_sub_matrix_from_file(begin, end, name, matrix);
+    if (mismatches != 0) {
+        fprintf(stderr, "MTX: %ld MISMATCHING ENTRIES IN %s.\n",
+            mismatches, name);
+        abort();
+    }
+    printf("MTX: %s VERIFIED.\n", name);
+}
+
 static struct hook_data_env* mtx_initializer_init(
     hook_data_format_t format, int argc, char * const *argv)
 {
@@ -677,6 +1170,7 @@ static struct hook_data_env* mtx_initializer_init(
     char const *right_input = read_str("--right-input", argc, argv, NULL, NULL);
     int input_begin = read_int("--input-begin", argc, argv, NULL, -1);
     int input_end = read_int("--input-end", argc, argv, NULL, -1);
+    int input_verify = read_opt("--input-verify", argc, argv, NULL);
 
     struct hook_data_env *env = malloc(sizeof(struct hook_data_env));
     env->format = format;
@@ -697,11 +1191,15 @@ static struct hook_data_env* mtx_initializer_init(
 
     data->mat_a = read_mtx_sub_matrix_from_file(
         input_begin, input_end, left_input, helper);
+    if (input_verify)
+        verify_mtx(input_begin, input_end, left_input, data->mat_a);
     data->mat_q = generate_identity(n, n, helper);
 
     if (right_input != NULL) {
         data->mat_b = read_mtx_sub_matrix_from_file(
             input_begin, input_end, right_input, helper);
+        if (input_verify)
+            verify_mtx(input_begin, input_end, right_input, data->mat_b);
         data->mat_z = generate_identity(n, n, helper);
     }
 
@@ -737,6 +1235,9 @@ static void raw_initializer_print_usage(int argc, char * const *argv)
         "  --input-only -- Read only necessary input matrices\n"
         "  --input-begin (num) -- First matrix row/column to be read\n"
         "  --input-end (num) -- Last matrix row/column to be read + 1\n"
+        "  --input-mmap -- Map the input files to memory (local matrices)\n"
+        "  --input-huge-pages -- Use huge pages when an input file must be "
+        "copied\n"
     );
 
     init_helper_print_usage("", INIT_HELPER_ALL, argc, argv);
@@ -747,6 +1248,11 @@ static void raw_initializer_print_args(int argc, char * const *argv)
     printf(" --input %s", read_str("--input", argc, argv, NULL, NULL));
     if (read_opt("--input-only", argc, argv, NULL))
         printf(" --input-only");
+    if (read_opt("--input-mmap", argc, argv, NULL)) {
+        printf(" --input-mmap");
+        if (read_opt("--input-huge-pages", argc, argv, NULL))
+            printf(" --input-huge-pages");
+    }
     int input_begin = read_int("--input-begin", argc, argv, NULL, -1);
     int input_end = read_int("--input-end", argc, argv, NULL, -1);
     if (0 <= input_begin && 0 <= input_end)
@@ -782,6 +1288,8 @@ static int raw_initializer_check_args(
     free(filename);
 
     read_opt("--input-only", argc, argv, argr);
+    if (read_opt("--input-mmap", argc, argv, argr))
+        read_opt("--input-huge-pages", argc, argv, argr);
 
     int input_begin = read_int("--input-begin", argc, argv, argr, -1);
     int input_end = read_int("--input-end", argc, argv, argr, -1);
@@ -791,6 +1299,38 @@ static int raw_initializer_check_args(
     return init_helper_check_args("", INIT_HELPER_ALL, argc, argv, argr);
 }
 
+///
+/// @brief Reads or maps a diagonal submatrix from a file.
+///
+/// @param[in] format
+///         The data format.
+///
+/// @param[in] map_flags
+///         The mapping flags, -1 if the matrix should be read.
+///
+/// @param[in] begin
+///         The first row/column that belongs to the submatrix.
+///
+/// @param[in] end
+///         The last row/column that belongs to the submatrix.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[in,out] helper
+///         The initialization helper.
+///
+/// @return The submatrix.
+///
+static matrix_t read_or_map_raw(
+    hook_data_format_t format, int map_flags, int begin, int end,
+    char const *name, init_helper_t helper)
+{
+    if (0 <= map_flags && format == HOOK_DATA_FORMAT_PENCIL_LOCAL)
+        return map_raw_sub_matrix_from_file(begin, end, name, map_flags);
+    return read_raw_sub_matrix_from_file(begin, end, name, helper);
+}
+
 static struct hook_data_env* raw_initializer_init(
     hook_data_format_t format, int argc, char * const *argv)
 {
@@ -801,6 +1341,13 @@ static struct hook_data_env* raw_initializer_init(
     int input_begin = read_int("--input-begin", argc, argv, NULL, -1);
     int input_end = read_int("--input-end", argc, argv, NULL, -1);
 
+    int map_flags = -1;
+    if (read_opt("--input-mmap", argc, argv, NULL)) {
+        map_flags = STARNEIG_MAP_PREFETCH;
+        if (read_opt("--input-huge-pages", argc, argv, NULL))
+            map_flags |= STARNEIG_MAP_HUGE_PAGES;
+    }
+
     struct hook_data_env *env = malloc(sizeof(struct hook_data_env));
     env->format = format;
     env->copy_data = (hook_data_env_copy_t) copy_pencil;
@@ -826,8 +1373,8 @@ static struct hook_data_env* raw_initializer_init(
 
     if (access(filename, R_OK) == 0) {
         printf("READING FROM %s...\n", filename);
-        pencil->mat_a = read_raw_sub_matrix_from_file(
-            input_begin, input_end, filename, helper);
+        pencil->mat_a = read_or_map_raw(
+            format, map_flags, input_begin, input_end, filename, helper);
     }
 
     if (0 < input_begin || input_end < n) {
@@ -838,20 +1385,22 @@ static struct hook_data_env* raw_initializer_init(
         sprintf(filename, input, "Q");
         if (access(filename, R_OK) == 0) {
             printf("READING FROM %s...\n", filename);
-            pencil->mat_q = read_raw_matrix_from_file(filename, helper);
+            pencil->mat_q = read_or_map_raw(
+                format, map_flags, 0, n, filename, helper);
         }
         sprintf(filename, input, "CA");
         if (!input_only && access(filename, R_OK) == 0) {
             printf("READING FROM %s...\n", filename);
-            pencil->mat_ca = read_raw_matrix_from_file(filename, helper);
+            pencil->mat_ca = read_or_map_raw(
+                format, map_flags, 0, n, filename, helper);
         }
     }
 
     sprintf(filename, input, "B");
     if (access(filename, R_OK) == 0) {
         printf("READING FROM %s...\n", filename);
-        pencil->mat_b = read_raw_sub_matrix_from_file(
-            input_begin, input_end, filename, helper);
+        pencil->mat_b = read_or_map_raw(
+            format, map_flags, input_begin, input_end, filename, helper);
 
         if (0 < input_begin || input_end < n) {
             printf("INITIALIZING Z WITH A RANDOM HOUSEHOLDER REFLECTOR...\n");
@@ -862,12 +1411,14 @@ static struct hook_data_env* raw_initializer_init(
             sprintf(filename, input, "Z");
             if (access(filename, R_OK) == 0) {
                 printf("READING FROM %s...\n", filename);
-                pencil->mat_z = read_raw_matrix_from_file(filename, helper);
+                pencil->mat_z = read_or_map_raw(
+                    format, map_flags, 0, n, filename, helper);
             }
             sprintf(filename, input, "CB");
             if (!input_only && access(filename, R_OK) == 0) {
                 printf("READING FROM %s...\n", filename);
-                pencil->mat_cb = read_raw_matrix_from_file(filename, helper);
+                pencil->mat_cb = read_or_map_raw(
+                    format, map_flags, 0, n, filename, helper);
             }
         }
     }
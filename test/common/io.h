@@ -42,6 +42,7 @@
 #include <starneig/configuration.h>
 #include "pencil.h"
 #include "init.h"
+#include <starneig/matrix_io.h>
 
 ///
 /// @brief Reads the dimensions of a matrix from a MTX file.
@@ -90,6 +91,28 @@ matrix_t read_mtx_matrix_from_file(char const *name, init_helper_t helper);
 matrix_t read_mtx_sub_matrix_from_file(
     int begin, int end, char const *name, init_helper_t helper);
 
+///
+/// @brief Compares a submatrix that was read with
+/// read_mtx_sub_matrix_from_file() against a sequential fscanf() based
+/// reader. The entries are compared bit for bit.
+///
+/// @param[in] begin
+///         The first row/column that belongs to the submatrix.
+///
+/// @param[in] end
+///         The last row/column that belongs to the submatrix.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[in] matrix
+///         The submatrix.
+///
+/// @return The number of mismatching entries (summed over all MPI ranks).
+///
+long verify_mtx_sub_matrix_from_file(
+    int begin, int end, char const *name, const matrix_t matrix);
+
 ///
 /// @brief Writes a matrix to a file.
 ///
@@ -149,6 +172,27 @@ matrix_t read_raw_matrix_from_file(char const *name, init_helper_t helper);
 matrix_t read_raw_sub_matrix_from_file(
     int begin, int end, char const *name, init_helper_t helper);
 
+///
+/// @brief Maps a diagonal submatrix from a file to memory (local matrices
+/// only). The submatrix is not copied.
+///
+/// @param[in] begin
+///         The first row/column that belongs to the submatrix.
+///
+/// @param[in] end
+///         The last row/column that belongs to the submatrix.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[in] flags
+///         The mapping flags.
+///
+/// @return The submatrix.
+///
+matrix_t map_raw_sub_matrix_from_file(
+    int begin, int end, char const *name, starneig_map_flag_t flags);
+
 extern const struct hook_t store_raw_pencil;
 extern const struct hook_descr_t default_store_raw_pencil_descr;
 
@@ -40,6 +40,7 @@
 #include "common.h"
 #include "init.h"
 #include "threads.h"
+#include <starneig/starneig.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -53,6 +54,7 @@ struct local_matrix {
     size_t n;                  ///< The column count.
     size_t ld;                 ///< The leading dimension.
     size_t elemsize;           ///< The element size.
+    int mapped;                ///< Non-zero if the matrix is memory mapped.
 };
 
 typedef struct local_matrix * local_matrix_t;
@@ -62,7 +64,10 @@ static void free_local_matrix(local_matrix_t descr)
     if (descr == NULL)
         return;
 
-    free_matrix(descr->ptr);
+    if (descr->mapped)
+        starneig_matrix_unmap(descr->ptr);
+    else
+        free_matrix(descr->ptr);
     free(descr);
 }
 
@@ -75,6 +80,7 @@ static local_matrix_t copy_local_matrix(const local_matrix_t descr)
     new->m = descr->m;
     new->n = descr->n;
     new->elemsize = descr->elemsize;
+    new->mapped = 0;
     new->ptr =
         alloc_matrix(new->m, new->n, new->elemsize, &new->ld);
 
@@ -148,6 +154,29 @@ matrix_t init_local_matrix(int m, int n, data_type_t dtype)
     local_descr->ptr =
         alloc_matrix(m, n, data_type_size(dtype), &local_descr->ld);
     local_descr->elemsize = data_type_size(dtype);
+    local_descr->mapped = 0;
+
+    descr->ptr = local_descr;
+
+    return descr;
+}
+
+matrix_t init_local_matrix_mapped(
+    int m, int n, size_t ld, data_type_t dtype, void *ptr)
+{
+    assert(1 <= m && 1 <= n && m <= ld);
+
+    matrix_t descr = malloc(sizeof(struct matrix));
+    descr->type = LOCAL_MATRIX;
+    descr->dtype = dtype;
+
+    local_matrix_t local_descr = malloc(sizeof(struct local_matrix));
+    local_descr->m = m;
+    local_descr->n = n;
+    local_descr->ld = ld;
+    local_descr->ptr = ptr;
+    local_descr->elemsize = data_type_size(dtype);
+    local_descr->mapped = 1;
 
     descr->ptr = local_descr;
 
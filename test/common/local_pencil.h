@@ -54,6 +54,21 @@
 ///
 matrix_t init_local_matrix(int m, int n, data_type_t dtype);
 
+///
+/// @brief Initializes a local matrix from a memory mapped matrix. The mapping
+/// is released (starneig_matrix_unmap) when the matrix is freed.
+///
+/// @param[in] m         The number of rows in the matrix.
+/// @param[in] n         The number of columns in the matrix.
+/// @param[in] ld        The leading dimension of the matrix.
+/// @param[in] dtype     The matrix element data type
+/// @param[in] ptr       A pointer to the first matrix element.
+///
+/// @return An initialized local matrix.
+///
+matrix_t init_local_matrix_mapped(
+    int m, int n, size_t ld, data_type_t dtype, void *ptr);
+
 ///
 /// @brief Returns the first element of a given local matrix.
 ///
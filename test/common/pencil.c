@@ -38,6 +38,7 @@
 #include <starneig_test_config.h>
 #include <starneig/configuration.h>
 #include "pencil.h"
+#include "common.h"
 #include "init.h"
 #include "math.h"
 #include "crawler.h"
@@ -219,6 +220,60 @@ size_t GENERIC_MATRIX_N(const matrix_t matrix)
     return handler->get_cols(matrix);
 }
 
+int get_local_blocks(
+    const matrix_t matrix, int panel_width, struct local_block **blocks)
+{
+    if (matrix->type == LOCAL_MATRIX) {
+        int m = LOCAL_MATRIX_M(matrix);
+        int n = LOCAL_MATRIX_N(matrix);
+        size_t ld = LOCAL_MATRIX_LD(matrix);
+        double *A = LOCAL_MATRIX_PTR(matrix);
+
+        if (panel_width <= 0)
+            panel_width = MAX(1, n);
+
+        int count = (n+panel_width-1)/panel_width;
+        *blocks = malloc(MAX(1, count)*sizeof(struct local_block));
+        for (int i = 0; i < count; i++) {
+            int col = i*panel_width;
+            (*blocks)[i] = (struct local_block) {
+                .row = 0, .col = col, .m = m,
+                .n = MIN(panel_width, n-col),
+                .ld = ld, .ptr = A+(size_t)col*ld
+            };
+        }
+
+        return count;
+    }
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (matrix->type == STARNEIG_MATRIX || matrix->type == BLACS_MATRIX) {
+        struct starneig_distr_block *distr_blocks;
+        int count;
+        starneig_distr_matrix_get_blocks(
+            STARNEIG_MATRIX_HANDLE(matrix), &distr_blocks, &count);
+
+        *blocks = malloc(MAX(1, count)*sizeof(struct local_block));
+        for (int i = 0; i < count; i++) {
+            (*blocks)[i] = (struct local_block) {
+                .row = distr_blocks[i].glo_row,
+                .col = distr_blocks[i].glo_col,
+                .m = distr_blocks[i].row_blksz,
+                .n = distr_blocks[i].col_blksz,
+                .ld = distr_blocks[i].ld,
+                .ptr = distr_blocks[i].ptr
+            };
+        }
+
+        return count;
+    }
+#endif
+
+    fprintf(stderr,
+        "get_local_blocks() encountered an invalid matrix type.\n");
+    abort();
+}
+
 void mul_C_AB(
     char const *trans_a, char const *trans_b, double alpha,
     const matrix_t mat_a, const matrix_t mat_b, double beta, matrix_t *mat_c)
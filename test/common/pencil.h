@@ -183,6 +183,37 @@ double norm_C(const matrix_t mat_c);
 ///
 void print_matrix_descr(const matrix_t matrix, FILE * stream);
 
+///
+/// @brief Locally stored matrix block.
+///
+struct local_block {
+    int row;        ///< topmost global row that belongs to the block
+    int col;        ///< leftmost global column that belongs to the block
+    int m;          ///< row count
+    int n;          ///< column count
+    size_t ld;      ///< leading dimension
+    double *ptr;    ///< local array
+};
+
+///
+/// @brief Returns the locally stored blocks of an opaque matrix object.
+///
+/// @param[in] matrix
+///         The opaque matrix object.
+///
+/// @param[in] panel_width
+///         Local matrices are split into column panels of this width. If zero,
+///         a local matrix is returned as a single block.
+///
+/// @param[out] blocks
+///         Returns an array that contains the locally stored blocks. Should be
+///         freed by the caller.
+///
+/// @return The number of locally stored blocks.
+///
+int get_local_blocks(
+    const matrix_t matrix, int panel_width, struct local_block **blocks);
+
 ///
 /// @brief Opaque matrix pencil descriptor.
 ///
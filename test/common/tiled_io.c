@@ -0,0 +1,1210 @@
+///
+/// @file This file contains the tiled matrix pencil container of the test
+/// program.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_test_config.h>
+#include <starneig/configuration.h>
+#include "tiled_io.h"
+#include "common.h"
+#include "parse.h"
+#include "local_pencil.h"
+#ifdef STARNEIG_ENABLE_MPI
+#include "starneig_pencil.h"
+#include <mpi.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <omp.h>
+
+//
+// A tiled pencil file begins with a fixed size header (struct tiled_header)
+// that is followed by one tile grid and one tile directory per stored pencil
+// member. The tile grid lists the topmost rows (tiles_m + 1 values, the last
+// one equals the row count) and the leftmost columns (tiles_n + 1 values) of
+// the tiles as 64-bit integers. The tiles are split at the block boundaries of
+// the data distribution and are at most tile_size x tile_size. Each tile
+// directory contains one entry (struct tiled_entry) per tile in column-major
+// tile order. The tiles themselves are stored after the directories in an
+// arbitrary order. All integers are stored in the native byte order.
+//
+
+#define TILED_MAGIC "STARNEIG TILED\n"
+#define TILED_VERSION 2
+#define TILED_DATATYPE_REAL_DOUBLE 1
+#define TILED_MEMBERS 7
+#define TILED_HEADER_SIZE 512
+#define TILED_DATA_ALIGNMENT 64
+#define TILED_DEFAULT_TILE_SIZE 512
+
+///
+/// @brief Tiled pencil file header.
+///
+struct tiled_header {
+    char magic[16];             ///< "STARNEIG TILED\n"
+    uint32_t version;           ///< format version
+    uint32_t datatype;          ///< matrix element datatype
+    uint32_t members;           ///< stored pencil members (tiled_member_t)
+    uint32_t tile_size;         ///< maximum tile size
+    struct {
+        uint64_t rows;          ///< row count
+        uint64_t cols;          ///< column count
+        uint64_t grid;          ///< offset of the tile grid
+        uint64_t directory;     ///< offset of the tile directory
+        uint32_t tiles_m;       ///< number of tile rows
+        uint32_t tiles_n;       ///< number of tile columns
+    } member[TILED_MEMBERS];    ///< pencil members
+};
+
+///
+/// @brief Tile grid of a pencil member.
+///
+struct tiled_grid {
+    int tiles_m;                ///< number of tile rows
+    int tiles_n;                ///< number of tile columns
+    uint64_t *rows;             ///< topmost rows of the tiles (tiles_m + 1)
+    uint64_t *cols;             ///< leftmost columns of the tiles (tiles_n + 1)
+};
+
+///
+/// @brief Tile directory entry.
+///
+struct tiled_entry {
+    uint64_t offset;            ///< offset of the stored tile
+    uint64_t length;            ///< length of the stored tile in bytes
+    uint64_t checksum;          ///< checksum of the uncompressed tile
+    uint32_t encoding;          ///< tile encoding (tiled_encoding_t)
+    uint32_t reserved;          ///< reserved, zero
+};
+
+///
+/// @brief Tile transfer. Describes a rectangular region that belongs to a
+/// tile and to a locally stored matrix block.
+///
+struct tiled_job {
+    int entry;                  ///< global tile directory entry
+    int tile_m;                 ///< tile row count
+    int tile_n;                 ///< tile column count
+    int row;                    ///< first tile row that belongs to the region
+    int col;                    ///< first tile column that belongs to the region
+    int m;                      ///< region row count
+    int n;                      ///< region column count
+    size_t ld;                  ///< leading dimension of the local array
+    double *ptr;                ///< region inside the local array
+};
+
+static char const * const member_names[TILED_MEMBERS] =
+    { "A", "B", "Q", "Z", "X", "CA", "CB" };
+
+static matrix_t * get_member(int i, pencil_t pencil)
+{
+    matrix_t *members[TILED_MEMBERS] = {
+        &pencil->mat_a, &pencil->mat_b, &pencil->mat_q, &pencil->mat_z,
+        &pencil->mat_x, &pencil->mat_ca, &pencil->mat_cb };
+    return members[i];
+}
+
+///
+/// @brief Returns the first stored pencil member.
+///
+static matrix_t get_first_member(pencil_t pencil)
+{
+    for (int i = 0; i < TILED_MEMBERS; i++)
+        if (*get_member(i, pencil) != NULL)
+            return *get_member(i, pencil);
+    return NULL;
+}
+
+///
+/// @brief Computes a checksum (64-bit FNV-1a over 8-byte words).
+///
+static uint64_t compute_checksum(uint64_t const *words, size_t count)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= words[i];
+        hash *= 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+///
+/// @brief Zero-run encodes a packed tile. The encoded tile consists of
+/// records. Each record begins with a 64-bit word that contains the length of
+/// a zero run (low 32 bits) and the number of literal words that follow it
+/// (high 32 bits).
+///
+/// @param[in] in
+///         The packed tile.
+///
+/// @param[in] count
+///         The number of words in the packed tile.
+///
+/// @param[out] out
+///         The encoded tile. If NULL, then only the length is computed.
+///
+/// @return The number of words in the encoded tile.
+///
+static size_t zero_run_encode(uint64_t const *in, size_t count, uint64_t *out)
+{
+    size_t i = 0, o = 0;
+    while (i < count) {
+        size_t zeros = 0;
+        while (i < count && in[i] == 0 && zeros < UINT32_MAX) {
+            zeros++;
+            i++;
+        }
+
+        size_t begin = i;
+        while (i < count && in[i] != 0 && i-begin < UINT32_MAX)
+            i++;
+        size_t literals = i - begin;
+
+        if (out != NULL) {
+            out[o] = (uint64_t) zeros | (uint64_t) literals << 32;
+            memcpy(out+o+1, in+begin, literals*sizeof(uint64_t));
+        }
+        o += 1 + literals;
+    }
+    return o;
+}
+
+///
+/// @brief Decodes a zero-run encoded tile.
+///
+/// @return 0 on success, non-zero if the encoded tile is malformed.
+///
+static int zero_run_decode(
+    uint64_t const *in, size_t in_count, uint64_t *out, size_t out_count)
+{
+    size_t i = 0, o = 0;
+    while (i < in_count) {
+        size_t zeros = in[i] & 0xffffffff;
+        size_t literals = in[i] >> 32;
+        i++;
+
+        if (out_count - o < zeros + literals || in_count - i < literals)
+            return 1;
+
+        memset(out+o, 0, zeros*sizeof(uint64_t));
+        o += zeros;
+        memcpy(out+o, in+i, literals*sizeof(uint64_t));
+        o += literals;
+        i += literals;
+    }
+    return o != out_count;
+}
+
+static void pack_tile(struct tiled_job const *job, double *tile)
+{
+    for (int j = 0; j < job->n; j++)
+        memcpy(tile + (size_t)j*job->tile_m,
+            job->ptr + (size_t)j*job->ld, job->m*sizeof(double));
+}
+
+static void unpack_tile(double const *tile, struct tiled_job const *job)
+{
+    for (int j = 0; j < job->n; j++)
+        memcpy(job->ptr + (size_t)j*job->ld,
+            tile + (size_t)(job->col+j)*job->tile_m + job->row,
+            job->m*sizeof(double));
+}
+
+static void pwrite_all(int fd, void const *buffer, size_t length, off_t offset)
+{
+    char const *ptr = buffer;
+    while (0 < length) {
+        ssize_t ret = pwrite(fd, ptr, length, offset);
+        if (ret < 0) {
+            perror("pwrite");
+            abort();
+        }
+        ptr += ret;
+        length -= ret;
+        offset += ret;
+    }
+}
+
+static int pread_all(int fd, void *buffer, size_t length, off_t offset)
+{
+    char *ptr = buffer;
+    while (0 < length) {
+        ssize_t ret = pread(fd, ptr, length, offset);
+        if (ret <= 0)
+            return 1;
+        ptr += ret;
+        length -= ret;
+        offset += ret;
+    }
+    return 0;
+}
+
+///
+/// @brief Computes the tile grid and tile directory offsets and the offset of
+/// the first tile. The tile counts must be set.
+///
+/// @return The offset of the first tile.
+///
+static uint64_t set_directories(struct tiled_header *header, int *first_entry)
+{
+    uint64_t offset = TILED_HEADER_SIZE;
+    int entries = 0;
+    for (int i = 0; i < TILED_MEMBERS; i++) {
+        first_entry[i] = entries;
+        if (!(header->members & (1 << i)))
+            continue;
+        int tiles_m = header->member[i].tiles_m;
+        int tiles_n = header->member[i].tiles_n;
+        header->member[i].grid = offset;
+        offset += (uint64_t) (tiles_m + tiles_n + 2) * sizeof(uint64_t);
+        header->member[i].directory = offset;
+        offset += (uint64_t) tiles_m * tiles_n * sizeof(struct tiled_entry);
+        entries += tiles_m * tiles_n;
+    }
+    first_entry[TILED_MEMBERS] = entries;
+
+    return (offset + TILED_DATA_ALIGNMENT - 1) /
+        TILED_DATA_ALIGNMENT * TILED_DATA_ALIGNMENT;
+}
+
+static void read_header(int fd, char const *name, struct tiled_header *header)
+{
+    if (pread_all(fd, header, sizeof(struct tiled_header), 0) != 0 ||
+    memcmp(header->magic, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0) {
+        fprintf(stderr, "%s is not a tiled pencil file.\n", name);
+        abort();
+    }
+
+    if (header->version != TILED_VERSION ||
+    header->datatype != TILED_DATATYPE_REAL_DOUBLE) {
+        fprintf(stderr,
+            "%s has an unsupported version or datatype.\n", name);
+        abort();
+    }
+}
+
+void read_tiled_dimensions_from_file(char const *name, int *m, int *n)
+{
+    int fd = open(name, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Cannot open %s.\n", name);
+        abort();
+    }
+
+    struct tiled_header header;
+    read_header(fd, name, &header);
+    close(fd);
+
+    *m = header.member[0].rows;
+    *n = header.member[0].cols;
+}
+
+static int compare_uint64(void const *a, void const *b)
+{
+    uint64_t x = *(uint64_t const *) a, y = *(uint64_t const *) b;
+    return (x > y) - (x < y);
+}
+
+///
+/// @brief Sorts an array and removes the duplicates.
+///
+/// @return The number of unique elements.
+///
+static int unique_uint64(int count, uint64_t *array)
+{
+    qsort(array, count, sizeof(uint64_t), &compare_uint64);
+    int unique = 0;
+    for (int i = 0; i < count; i++)
+        if (unique == 0 || array[unique-1] != array[i])
+            array[unique++] = array[i];
+    return unique;
+}
+
+///
+/// @brief Forms the tile boundaries along one dimension. The boundaries
+/// consist of the multiples of the tile size and the block boundaries of all
+/// MPI ranks.
+///
+/// @param[in] tile_size
+///         The maximum tile size.
+///
+/// @param[in] size
+///         The row or column count.
+///
+/// @param[in] count
+///         The number of local block boundaries.
+///
+/// @param[in] local
+///         The local block boundaries.
+///
+/// @param[in] distributed
+///         Non-zero if the matrix is distributed.
+///
+/// @param[out] starts
+///         Returns the tile boundaries (tile count + 1 values). Should be
+///         freed by the caller.
+///
+/// @return The number of tiles.
+///
+static int form_boundaries(int tile_size, int size, int count,
+    uint64_t const *local, int distributed, uint64_t **starts)
+{
+    int total = count;
+    int *counts = NULL, *displs = NULL;
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed) {
+        int world_size;
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        counts = malloc(world_size*sizeof(int));
+        displs = malloc(world_size*sizeof(int));
+        MPI_Allgather(&count, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+        total = 0;
+        for (int i = 0; i < world_size; i++) {
+            displs[i] = total;
+            total += counts[i];
+        }
+    }
+#endif
+
+    int multiples = divceil(size, tile_size) + 1;
+    *starts = malloc((total + multiples)*sizeof(uint64_t));
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed)
+        MPI_Allgatherv(local, count, MPI_UINT64_T,
+            *starts, counts, displs, MPI_UINT64_T, MPI_COMM_WORLD);
+    else
+#endif
+        memcpy(*starts, local, count*sizeof(uint64_t));
+
+    free(counts);
+    free(displs);
+
+    for (int i = 0; i < multiples; i++)
+        (*starts)[total+i] = MIN((uint64_t) i*tile_size, (uint64_t) size);
+
+    return unique_uint64(total + multiples, *starts) - 1;
+}
+
+///
+/// @brief Forms a tile grid that splits the tiles at the block boundaries of
+/// all MPI ranks so that each tile is owned by a single MPI rank.
+///
+/// @param[in] tile_size
+///         The maximum tile size.
+///
+/// @param[in] distributed
+///         Non-zero if the matrix is distributed.
+///
+/// @param[in] matrix
+///         The matrix.
+///
+/// @param[out] grid
+///         Returns the tile grid.
+///
+static void form_grid(
+    int tile_size, int distributed, matrix_t matrix, struct tiled_grid *grid)
+{
+    struct local_block *blocks;
+    int count = get_local_blocks(matrix, 0, &blocks);
+
+    uint64_t *rows = malloc(MAX(1, 2*count)*sizeof(uint64_t));
+    uint64_t *cols = malloc(MAX(1, 2*count)*sizeof(uint64_t));
+    for (int i = 0; i < count; i++) {
+        rows[2*i] = blocks[i].row;
+        rows[2*i+1] = blocks[i].row + blocks[i].m;
+        cols[2*i] = blocks[i].col;
+        cols[2*i+1] = blocks[i].col + blocks[i].n;
+    }
+    free(blocks);
+
+    grid->tiles_m = form_boundaries(tile_size, GENERIC_MATRIX_M(matrix),
+        2*count, rows, distributed, &grid->rows);
+    grid->tiles_n = form_boundaries(tile_size, GENERIC_MATRIX_N(matrix),
+        2*count, cols, distributed, &grid->cols);
+
+    free(rows);
+    free(cols);
+}
+
+///
+/// @brief Returns the index of the tile that contains a row or a column.
+///
+static int find_tile(int tiles, uint64_t const *starts, int x)
+{
+    int low = 0, high = tiles;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (starts[mid] <= (uint64_t) x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low - 1;
+}
+
+///
+/// @brief Finds the tiles that intersect with the locally stored blocks.
+///
+/// @param[in] grid
+///         The tile grid.
+///
+/// @param[in] first_entry
+///         The first tile directory entry that belongs to the member.
+///
+/// @param[in] matrix
+///         The matrix.
+///
+/// @param[in,out] jobs
+///         The tile transfer array.
+///
+/// @param[in,out] count
+///         The number of tile transfers in the array.
+///
+/// @param[in,out] size
+///         The size of the tile transfer array.
+///
+static void find_jobs(struct tiled_grid const *grid, int first_entry,
+    matrix_t matrix, struct tiled_job **jobs, int *count, int *size)
+{
+    struct local_block *blocks;
+    int block_count = get_local_blocks(matrix, 0, &blocks);
+
+    for (int i = 0; i < block_count; i++) {
+        struct local_block *b = &blocks[i];
+        if (b->m == 0 || b->n == 0)
+            continue;
+
+        int tj_begin = find_tile(grid->tiles_n, grid->cols, b->col);
+        int tj_end = find_tile(grid->tiles_n, grid->cols, b->col+b->n-1);
+        int ti_begin = find_tile(grid->tiles_m, grid->rows, b->row);
+        int ti_end = find_tile(grid->tiles_m, grid->rows, b->row+b->m-1);
+
+        for (int tj = tj_begin; tj <= tj_end; tj++) {
+            for (int ti = ti_begin; ti <= ti_end; ti++) {
+                int tile_top = grid->rows[ti];
+                int tile_left = grid->cols[tj];
+                int top = MAX(b->row, tile_top);
+                int bottom = MIN(b->row+b->m, (int) grid->rows[ti+1]);
+                int left = MAX(b->col, tile_left);
+                int right = MIN(b->col+b->n, (int) grid->cols[tj+1]);
+
+                if (*size <= *count) {
+                    *size = 2*(*size) + 16;
+                    *jobs = realloc(*jobs, (*size)*sizeof(struct tiled_job));
+                }
+
+                (*jobs)[(*count)++] = (struct tiled_job) {
+                    .entry = first_entry + tj*grid->tiles_m + ti,
+                    .tile_m = grid->rows[ti+1] - tile_top,
+                    .tile_n = grid->cols[tj+1] - tile_left,
+                    .row = top - tile_top,
+                    .col = left - tile_left,
+                    .m = bottom - top,
+                    .n = right - left,
+                    .ld = b->ld,
+                    .ptr = b->ptr +
+                        (size_t)(left-b->col)*b->ld + (top-b->row)
+                };
+            }
+        }
+    }
+
+    free(blocks);
+}
+
+void write_tiled_pencil_to_file(char const *name, int tile_size,
+    tiled_encoding_t encoding, pencil_t pencil)
+{
+    matrix_t first = get_first_member(pencil);
+    if (first == NULL)
+        return;
+
+    int distributed = first->type != LOCAL_MATRIX;
+    int rank = 0;
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed)
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    //
+    // prepare the header, the tile grids and the tile directories
+    //
+
+    struct tiled_grid grids[TILED_MEMBERS];
+    memset(grids, 0, sizeof(grids));
+
+    struct tiled_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC));
+    header.version = TILED_VERSION;
+    header.datatype = TILED_DATATYPE_REAL_DOUBLE;
+    header.tile_size = tile_size;
+    for (int i = 0; i < TILED_MEMBERS; i++) {
+        matrix_t matrix = *get_member(i, pencil);
+        if (matrix != NULL) {
+            form_grid(tile_size, distributed, matrix, &grids[i]);
+            header.members |= 1 << i;
+            header.member[i].rows = GENERIC_MATRIX_M(matrix);
+            header.member[i].cols = GENERIC_MATRIX_N(matrix);
+            header.member[i].tiles_m = grids[i].tiles_m;
+            header.member[i].tiles_n = grids[i].tiles_n;
+        }
+    }
+
+    int first_entry[TILED_MEMBERS+1];
+    uint64_t data_begin = set_directories(&header, first_entry);
+
+    int entry_count = first_entry[TILED_MEMBERS];
+    struct tiled_entry *entries =
+        calloc(entry_count, sizeof(struct tiled_entry));
+
+    //
+    // find the locally owned tiles
+    //
+
+    struct tiled_job *jobs = NULL;
+    int job_count = 0, job_size = 0;
+    for (int i = 0; i < TILED_MEMBERS; i++) {
+        matrix_t matrix = *get_member(i, pencil);
+        if (matrix != NULL)
+            find_jobs(&grids[i], first_entry[i], matrix,
+                &jobs, &job_count, &job_size);
+    }
+
+    //
+    // compute the checksums and the encoded tile lengths
+    //
+
+    #pragma omp parallel
+    {
+        double *tile = malloc((size_t)tile_size*tile_size*sizeof(double));
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < job_count; i++) {
+            struct tiled_job const *job = &jobs[i];
+            struct tiled_entry *entry = &entries[job->entry];
+            size_t words = (size_t)job->tile_m*job->tile_n;
+
+            pack_tile(job, tile);
+            entry->checksum = compute_checksum((uint64_t *) tile, words);
+            entry->encoding = TILED_ENCODING_RAW;
+            entry->length = words*sizeof(double);
+
+            if (encoding == TILED_ENCODING_ZERO_RUN) {
+                size_t encoded = zero_run_encode((uint64_t *) tile, words, NULL);
+                if (encoded < words) {
+                    entry->encoding = TILED_ENCODING_ZERO_RUN;
+                    entry->length = encoded*sizeof(uint64_t);
+                }
+            }
+        }
+
+        free(tile);
+    }
+
+    //
+    // compute the tile offsets
+    //
+
+    uint64_t local_length = 0;
+    for (int i = 0; i < job_count; i++)
+        local_length += entries[jobs[i].entry].length;
+
+    uint64_t offset = 0;
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed) {
+        MPI_Exscan(&local_length, &offset, 1, MPI_UINT64_T, MPI_SUM,
+            MPI_COMM_WORLD);
+        if (rank == 0)
+            offset = 0;
+    }
+#endif
+    offset += data_begin;
+
+    for (int i = 0; i < job_count; i++) {
+        entries[jobs[i].entry].offset = offset;
+        offset += entries[jobs[i].entry].length;
+    }
+
+    //
+    // write the tiles
+    //
+
+    if (rank == 0)
+        printf("WRITING TO %s...\n", name);
+
+    int fd = -1;
+    if (rank == 0)
+        fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rank != 0)
+            fd = open(name, O_WRONLY);
+    }
+#endif
+    if (fd == -1) {
+        fprintf(stderr, "Cannot open %s for writing.\n", name);
+        abort();
+    }
+
+    #pragma omp parallel
+    {
+        size_t words = (size_t)tile_size*tile_size;
+        double *tile = malloc(words*sizeof(double));
+        uint64_t *encoded = malloc(words*sizeof(uint64_t));
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < job_count; i++) {
+            struct tiled_job const *job = &jobs[i];
+            struct tiled_entry const *entry = &entries[job->entry];
+
+            pack_tile(job, tile);
+            if (entry->encoding == TILED_ENCODING_ZERO_RUN) {
+                zero_run_encode((uint64_t *) tile,
+                    (size_t)job->tile_m*job->tile_n, encoded);
+                pwrite_all(fd, encoded, entry->length, entry->offset);
+            }
+            else {
+                pwrite_all(fd, tile, entry->length, entry->offset);
+            }
+        }
+
+        free(tile);
+        free(encoded);
+    }
+
+    //
+    // gather and write the tile directories
+    //
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed) {
+        // the entries of the tiles that are not owned are zero
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : entries, entries,
+            entry_count*sizeof(struct tiled_entry)/sizeof(uint64_t),
+            MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    }
+#endif
+
+    if (rank == 0) {
+        char padded[TILED_HEADER_SIZE];
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, &header, sizeof(header));
+        pwrite_all(fd, padded, sizeof(padded), 0);
+
+        for (int i = 0; i < TILED_MEMBERS; i++) {
+            if (!(header.members & (1 << i)))
+                continue;
+            pwrite_all(fd, grids[i].rows,
+                (grids[i].tiles_m+1)*sizeof(uint64_t), header.member[i].grid);
+            pwrite_all(fd, grids[i].cols,
+                (grids[i].tiles_n+1)*sizeof(uint64_t),
+                header.member[i].grid +
+                    (grids[i].tiles_m+1)*sizeof(uint64_t));
+            pwrite_all(fd, entries + first_entry[i],
+                (first_entry[i+1]-first_entry[i]) *
+                sizeof(struct tiled_entry), header.member[i].directory);
+        }
+    }
+
+    close(fd);
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (distributed)
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+    for (int i = 0; i < TILED_MEMBERS; i++) {
+        free(grids[i].rows);
+        free(grids[i].cols);
+    }
+    free(jobs);
+    free(entries);
+}
+
+///
+/// @brief Reads and validates the tile grid of a pencil member.
+///
+/// @return Zero on success, non-zero if the grid is invalid.
+///
+static int read_grid(int fd, struct tiled_header const *header, int member,
+    struct tiled_grid *grid)
+{
+    grid->tiles_m = header->member[member].tiles_m;
+    grid->tiles_n = header->member[member].tiles_n;
+    grid->rows = malloc((grid->tiles_m+1)*sizeof(uint64_t));
+    grid->cols = malloc((grid->tiles_n+1)*sizeof(uint64_t));
+
+    if (pread_all(fd, grid->rows, (grid->tiles_m+1)*sizeof(uint64_t),
+    header->member[member].grid) != 0 ||
+    pread_all(fd, grid->cols, (grid->tiles_n+1)*sizeof(uint64_t),
+    header->member[member].grid + (grid->tiles_m+1)*sizeof(uint64_t)) != 0)
+        return 1;
+
+    // the tiles must cover the matrix and fit the tile buffers
+    if (grid->rows[0] != 0 || grid->cols[0] != 0 ||
+    grid->rows[grid->tiles_m] != header->member[member].rows ||
+    grid->cols[grid->tiles_n] != header->member[member].cols)
+        return 1;
+    for (int i = 0; i < grid->tiles_m; i++)
+        if (grid->rows[i+1] <= grid->rows[i] ||
+        header->tile_size < grid->rows[i+1] - grid->rows[i])
+            return 1;
+    for (int i = 0; i < grid->tiles_n; i++)
+        if (grid->cols[i+1] <= grid->cols[i] ||
+        header->tile_size < grid->cols[i+1] - grid->cols[i])
+            return 1;
+
+    return 0;
+}
+
+void read_tiled_pencil_from_file(char const *name, tiled_member_t members,
+    init_helper_t helper, pencil_t pencil)
+{
+    int fd = open(name, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Cannot open %s.\n", name);
+        abort();
+    }
+
+    struct tiled_header header;
+    read_header(fd, name, &header);
+
+    members &= header.members;
+
+    int first_entry[TILED_MEMBERS+1];
+    struct tiled_header layout = header;
+    set_directories(&layout, first_entry);
+
+    int entry_count = first_entry[TILED_MEMBERS];
+    struct tiled_entry *entries =
+        malloc(entry_count*sizeof(struct tiled_entry));
+
+    //
+    // read the tile directories and allocate the matrices
+    //
+
+    struct tiled_job *jobs = NULL;
+    int job_count = 0, job_size = 0;
+    int tile_size = header.tile_size;
+
+    for (int i = 0; i < TILED_MEMBERS; i++) {
+        if (!(members & (1 << i)))
+            continue;
+
+        struct tiled_grid grid;
+        if (read_grid(fd, &header, i, &grid) != 0) {
+            fprintf(stderr, "Cannot read the tile grid of %s from %s.\n",
+                member_names[i], name);
+            abort();
+        }
+
+        if (pread_all(fd, entries + first_entry[i],
+        (first_entry[i+1]-first_entry[i]) * sizeof(struct tiled_entry),
+        header.member[i].directory) != 0) {
+            fprintf(stderr, "Cannot read the tile directory of %s from %s.\n",
+                member_names[i], name);
+            abort();
+        }
+
+        printf("READING %s FROM %s...\n", member_names[i], name);
+
+        matrix_t *matrix = get_member(i, pencil);
+        free_matrix_descr(*matrix);
+        *matrix = init_matrix(
+            header.member[i].rows, header.member[i].cols, helper);
+
+        find_jobs(&grid, first_entry[i], *matrix,
+            &jobs, &job_count, &job_size);
+
+        free(grid.rows);
+        free(grid.cols);
+    }
+
+    //
+    // read, verify and decode the tiles
+    //
+
+    int failed = 0;
+
+    #pragma omp parallel
+    {
+        size_t words = (size_t)tile_size*tile_size;
+        double *tile = malloc(words*sizeof(double));
+        uint64_t *stored = malloc(words*sizeof(uint64_t));
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < job_count; i++) {
+            struct tiled_job const *job = &jobs[i];
+            struct tiled_entry const *entry = &entries[job->entry];
+            size_t count = (size_t)job->tile_m*job->tile_n;
+
+            int error = words*sizeof(uint64_t) < entry->length;
+            if (!error && entry->encoding == TILED_ENCODING_RAW) {
+                error = entry->length != count*sizeof(double) ||
+                    pread_all(fd, tile, entry->length, entry->offset);
+            }
+            else if (!error && entry->encoding == TILED_ENCODING_ZERO_RUN) {
+                error = pread_all(fd, stored, entry->length, entry->offset) ||
+                    zero_run_decode(stored, entry->length/sizeof(uint64_t),
+                        (uint64_t *) tile, count);
+            }
+            else {
+                error = 1;
+            }
+
+            if (!error &&
+            compute_checksum((uint64_t *) tile, count) != entry->checksum)
+                error = 1;
+
+            if (error) {
+                #pragma omp critical
+                {
+                    fprintf(stderr,
+                        "Tile %d in %s is corrupted.\n", job->entry, name);
+                    failed = 1;
+                }
+                continue;
+            }
+
+            unpack_tile(tile, job);
+        }
+
+        free(tile);
+        free(stored);
+    }
+
+    close(fd);
+
+    if (failed)
+        abort();
+
+    free(jobs);
+    free(entries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///
+/// @brief Tiled pencil store hook state.
+///
+struct store_tiled_state {
+    char const *name;               ///< output filename
+    int tile_size;                  ///< requested tile size
+    tiled_encoding_t encoding;      ///< preferred tile encoding
+};
+
+static void store_tiled_print_usage(
+    char const *prefix, char const *def, int argc, char * const *argv)
+{
+    printf(
+        "  --store-tiled-%s (filename) -- Tiled pencil file [default %s]\n"
+        "  --store-tiled-%s-tile-size (num) -- Tile size\n"
+        "  --store-tiled-%s-no-compress -- Disable zero-run compression\n",
+        prefix, def, prefix, prefix);
+}
+
+static void store_tiled_print_args(
+    char const *prefix, char const *def, int argc, char * const *argv)
+{
+    char str[64];
+
+    sprintf(str, "--store-tiled-%s", prefix);
+    printf(" %s %s", str, read_str(str, argc, argv, NULL, def));
+
+    sprintf(str, "--store-tiled-%s-tile-size", prefix);
+    printf(" %s %d", str,
+        read_int(str, argc, argv, NULL, TILED_DEFAULT_TILE_SIZE));
+
+    sprintf(str, "--store-tiled-%s-no-compress", prefix);
+    if (read_opt(str, argc, argv, NULL))
+        printf(" %s", str);
+}
+
+static int store_tiled_check_args(char const *prefix, char const *def,
+    int argc, char * const *argv, int *argr)
+{
+    char str[64];
+
+    sprintf(str, "--store-tiled-%s", prefix);
+    read_str(str, argc, argv, argr, def);
+
+    sprintf(str, "--store-tiled-%s-tile-size", prefix);
+    if (read_int(str, argc, argv, argr, TILED_DEFAULT_TILE_SIZE) < 1) {
+        fprintf(stderr, "Invalid tile size.\n");
+        return 1;
+    }
+
+    sprintf(str, "--store-tiled-%s-no-compress", prefix);
+    read_opt(str, argc, argv, argr);
+
+    return 0;
+}
+
+static int store_tiled_init(char const *prefix, char const *def,
+    int argc, char * const *argv, hook_state_t *state)
+{
+    char str[64];
+    struct store_tiled_state *store = malloc(sizeof(struct store_tiled_state));
+
+    sprintf(str, "--store-tiled-%s", prefix);
+    store->name = read_str(str, argc, argv, NULL, def);
+
+    sprintf(str, "--store-tiled-%s-tile-size", prefix);
+    store->tile_size = read_int(
+        str, argc, argv, NULL, TILED_DEFAULT_TILE_SIZE);
+
+    sprintf(str, "--store-tiled-%s-no-compress", prefix);
+    store->encoding = read_opt(str, argc, argv, NULL) ?
+        TILED_ENCODING_RAW : TILED_ENCODING_ZERO_RUN;
+
+    *state = store;
+    return 0;
+}
+
+static hook_return_t store_tiled_run(
+    int iter, hook_state_t state, struct hook_data_env *env)
+{
+    struct store_tiled_state *store = state;
+    write_tiled_pencil_to_file(store->name, store->tile_size, store->encoding,
+        (pencil_t) env->data);
+    return HOOK_SUCCESS;
+}
+
+static int store_tiled_clean(hook_state_t state)
+{
+    free(state);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void store_tiled_pencil_print_usage(int argc, char * const *argv)
+{
+    store_tiled_print_usage("output", "output.tiled", argc, argv);
+}
+
+static void store_tiled_pencil_print_args(int argc, char * const *argv)
+{
+    store_tiled_print_args("output", "output.tiled", argc, argv);
+}
+
+static int store_tiled_pencil_check_args(
+    int argc, char * const *argv, int *argr)
+{
+    return store_tiled_check_args("output", "output.tiled", argc, argv, argr);
+}
+
+static int store_tiled_pencil_init(int argc, char * const *argv, int repeat,
+    int warmup, hook_state_t *state)
+{
+    return store_tiled_init("output", "output.tiled", argc, argv, state);
+}
+
+const struct hook_t store_tiled_pencil = {
+    .name = "store-tiled",
+    .desc = "Writes the output matrix pencil to a tiled pencil file",
+    .formats = (hook_data_format_t[]) {
+        HOOK_DATA_FORMAT_PENCIL_LOCAL,
+#ifdef STARNEIG_ENABLE_MPI
+        HOOK_DATA_FORMAT_PENCIL_STARNEIG,
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        HOOK_DATA_FORMAT_PENCIL_BLACS,
+#endif
+        0 },
+    .print_usage = &store_tiled_pencil_print_usage,
+    .print_args = &store_tiled_pencil_print_args,
+    .check_args = &store_tiled_pencil_check_args,
+    .init = &store_tiled_pencil_init,
+    .after_solver_run = &store_tiled_run,
+    .clean = &store_tiled_clean
+};
+
+const struct hook_descr_t default_store_tiled_pencil_descr = {
+    .is_enabled = 0,
+    .default_mode = HOOK_MODE_NORMAL,
+    .hook = &store_tiled_pencil
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void store_tiled_input_pencil_print_usage(int argc, char * const *argv)
+{
+    store_tiled_print_usage("input", "input.tiled", argc, argv);
+}
+
+static void store_tiled_input_pencil_print_args(int argc, char * const *argv)
+{
+    store_tiled_print_args("input", "input.tiled", argc, argv);
+}
+
+static int store_tiled_input_pencil_check_args(
+    int argc, char * const *argv, int *argr)
+{
+    return store_tiled_check_args("input", "input.tiled", argc, argv, argr);
+}
+
+static int store_tiled_input_pencil_init(int argc, char * const *argv,
+    int repeat, int warmup, hook_state_t *state)
+{
+    return store_tiled_init("input", "input.tiled", argc, argv, state);
+}
+
+const struct hook_t store_tiled_input_pencil = {
+    .name = "store-tiled-input",
+    .desc = "Writes the input matrix pencil to a tiled pencil file",
+    .formats = (hook_data_format_t[]) {
+        HOOK_DATA_FORMAT_PENCIL_LOCAL,
+#ifdef STARNEIG_ENABLE_MPI
+        HOOK_DATA_FORMAT_PENCIL_STARNEIG,
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        HOOK_DATA_FORMAT_PENCIL_BLACS,
+#endif
+        0 },
+    .print_usage = &store_tiled_input_pencil_print_usage,
+    .print_args = &store_tiled_input_pencil_print_args,
+    .check_args = &store_tiled_input_pencil_check_args,
+    .init = &store_tiled_input_pencil_init,
+    .before_solver_run = &store_tiled_run,
+    .clean = &store_tiled_clean
+};
+
+const struct hook_descr_t default_store_tiled_input_pencil_descr = {
+    .is_enabled = 0,
+    .default_mode = HOOK_MODE_NORMAL,
+    .hook = &store_tiled_input_pencil
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void tiled_initializer_print_usage(int argc, char * const *argv)
+{
+    printf(
+        "  --input (filename) -- Tiled pencil file\n"
+        "  --input-only -- Read only necessary input matrices\n"
+    );
+
+    init_helper_print_usage("", INIT_HELPER_ALL, argc, argv);
+}
+
+static void tiled_initializer_print_args(int argc, char * const *argv)
+{
+    printf(" --input %s", read_str("--input", argc, argv, NULL, NULL));
+    if (read_opt("--input-only", argc, argv, NULL))
+        printf(" --input-only");
+
+    init_helper_print_args("", INIT_HELPER_ALL, argc, argv);
+}
+
+static int tiled_initializer_check_args(
+    int argc, char * const *argv, int *argr)
+{
+    char const *input = read_str("--input", argc, argv, argr, NULL);
+    if (input == NULL)
+        return 1;
+
+    if (access(input, R_OK) != 0) {
+        fprintf(stderr, "Input file does not exists.\n");
+        return 1;
+    }
+
+    read_opt("--input-only", argc, argv, argr);
+
+    return init_helper_check_args("", INIT_HELPER_ALL, argc, argv, argr);
+}
+
+static struct hook_data_env* tiled_initializer_init(
+    hook_data_format_t format, int argc, char * const *argv)
+{
+    printf("INIT... \n");
+
+    char const *input = read_str("--input", argc, argv, NULL, NULL);
+    int input_only = read_opt("--input-only", argc, argv, NULL);
+
+    struct hook_data_env *env = malloc(sizeof(struct hook_data_env));
+    env->format = format;
+    env->copy_data = (hook_data_env_copy_t) copy_pencil;
+    env->free_data = (hook_data_env_free_t) free_pencil;
+    pencil_t pencil = env->data = init_pencil();
+
+    int m, n;
+    read_tiled_dimensions_from_file(input, &m, &n);
+
+    init_helper_t helper = init_helper_init_hook(
+        "", format, m, n, PREC_DOUBLE | NUM_REAL, argc, argv);
+
+    tiled_member_t members = TILED_MEMBER_A | TILED_MEMBER_B |
+        TILED_MEMBER_Q | TILED_MEMBER_Z;
+    if (!input_only)
+        members |= TILED_MEMBER_CA | TILED_MEMBER_CB;
+
+    read_tiled_pencil_from_file(input, members, helper, pencil);
+
+    init_helper_free(helper);
+
+    return env;
+}
+
+const struct hook_initializer_t tiled_initializer = {
+    .name = "read-tiled",
+    .desc = "Reads the matrix pencil from a tiled pencil file",
+    .formats = (hook_data_format_t[]) {
+        HOOK_DATA_FORMAT_PENCIL_LOCAL,
+#ifdef STARNEIG_ENABLE_MPI
+        HOOK_DATA_FORMAT_PENCIL_STARNEIG,
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        HOOK_DATA_FORMAT_PENCIL_BLACS,
+#endif
+        0 },
+    .print_usage = &tiled_initializer_print_usage,
+    .print_args = &tiled_initializer_print_args,
+    .check_args = &tiled_initializer_check_args,
+    .init = &tiled_initializer_init
+};
@@ -0,0 +1,132 @@
+///
+/// @file This file contains the tiled matrix pencil container of the test
+/// program.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_TESTS_COMMON_TILED_IO_H
+#define STARNEIG_TESTS_COMMON_TILED_IO_H
+
+#include <starneig_test_config.h>
+#include <starneig/configuration.h>
+#include "pencil.h"
+#include "init.h"
+#include "hook_experiment.h"
+
+///
+/// @brief Pencil member flags.
+///
+typedef enum {
+    TILED_MEMBER_A       = 0x01,    ///< matrix A
+    TILED_MEMBER_B       = 0x02,    ///< matrix B
+    TILED_MEMBER_Q       = 0x04,    ///< matrix Q
+    TILED_MEMBER_Z       = 0x08,    ///< matrix Z
+    TILED_MEMBER_X       = 0x10,    ///< matrix X
+    TILED_MEMBER_CA      = 0x20,    ///< matrix CA
+    TILED_MEMBER_CB      = 0x40,    ///< matrix CB
+    TILED_MEMBER_ALL     = 0x7f     ///< all members
+} tiled_member_t;
+
+///
+/// @brief Tile encodings.
+///
+typedef enum {
+    TILED_ENCODING_RAW      = 0,    ///< uncompressed column-major tile
+    TILED_ENCODING_ZERO_RUN = 1     ///< zero-run encoded tile
+} tiled_encoding_t;
+
+///
+/// @brief Reads the dimensions of the matrix A from a tiled pencil file.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[out] m
+///         The number of rows in the matrix.
+///
+/// @param[out] n
+///         The number of columns in the matrix.
+///
+void read_tiled_dimensions_from_file(char const *name, int *m, int *n);
+
+///
+/// @brief Writes a matrix pencil to a tiled pencil file.
+///
+///  Each MPI rank writes the tiles it owns. The tiles are split at the block
+///  boundaries of all MPI ranks so that each tile is owned by a single MPI rank
+///  and the resulting tile grid is recorded in the file.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[in] tile_size
+///         The maximum tile size.
+///
+/// @param[in] encoding
+///         The preferred tile encoding. A tile is stored uncompressed when
+///         the encoding does not reduce its size.
+///
+/// @param[in] pencil
+///         The matrix pencil.
+///
+void write_tiled_pencil_to_file(char const *name, int tile_size,
+    tiled_encoding_t encoding, pencil_t pencil);
+
+///
+/// @brief Reads a matrix pencil from a tiled pencil file.
+///
+/// @param[in] name
+///         The file name.
+///
+/// @param[in] members
+///         The pencil members to be read.
+///
+/// @param[in,out] helper
+///         The initialization helper.
+///
+/// @param[in,out] pencil
+///         The matrix pencil.
+///
+void read_tiled_pencil_from_file(char const *name, tiled_member_t members,
+    init_helper_t helper, pencil_t pencil);
+
+extern const struct hook_t store_tiled_pencil;
+extern const struct hook_descr_t default_store_tiled_pencil_descr;
+
+extern const struct hook_t store_tiled_input_pencil;
+extern const struct hook_descr_t default_store_tiled_input_pencil_descr;
+
+extern const struct hook_initializer_t tiled_initializer;
+
+#endif
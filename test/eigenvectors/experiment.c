@@ -46,6 +46,7 @@
 #include "../common/checks.h"
 #include "../common/hooks.h"
 #include "../common/io.h"
+#include "../common/tiled_io.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -454,6 +455,7 @@ const struct hook_experiment_descr eigenvectors_experiment = {
         &default_schur_initializer,
         &starpu_schur_initializer,
         &raw_initializer,
+        &tiled_initializer,
         0
     },
     .supplementers = (struct hook_supplementer_t const *[])
@@ -476,6 +478,8 @@ const struct hook_experiment_descr eigenvectors_experiment = {
         &default_print_input_pencil_descr,
         &default_store_raw_pencil_descr,
         &default_store_raw_input_pencil_descr,
+        &default_store_tiled_pencil_descr,
+        &default_store_tiled_input_pencil_descr,
         0
     }
 };
@@ -47,18 +47,34 @@
 #include "eigenvectors/experiment.h"
 #include "misc/full_chain.h"
 #include "misc/partial_hessenberg.h"
+#include "misc/benchmark.h"
 #include "misc/validator.h"
 
 #include <starneig/starneig.h>
 #ifdef STARNEIG_ENABLE_MPI
 #include <starneig/distr_helpers.h>
 #endif
+#ifdef STARNEIG_ENABLE_SIMGRID
+// StarPU replaces the main function when it runs on top of SimGrid
+#include <starpu.h>
+#endif
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #ifdef STARNEIG_ENABLE_MPI
 #include <mpi.h>
 #endif
+#ifdef PERF_EVENT_FOUND
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+///
+/// @brief Exit code that tells ctest that the test was skipped.
+///
+#define EXIT_SKIPPED 77
 
 ///
 /// @brief Experiment modules.
@@ -111,6 +127,13 @@ static const struct experiment_descr experiments[] = {
         .print_args = &partial_hessenberg_print_args,
         .run = &partial_hessenberg_run
     },
+    { .name = "benchmark",
+        .desc = "Solver pipeline benchmark",
+        .print_usage = &benchmark_print_usage,
+        .check_args = &benchmark_check_args,
+        .print_args = &benchmark_print_args,
+        .run = &benchmark_run
+    },
     { .name = "validator",
         .desc = "Validation experiment",
         .print_usage = &hook_experiment_print_usage,
@@ -145,10 +168,20 @@ static void print_usage(int argc, char * const *argv)
 #ifdef STARNEIG_ENABLE_MPI
         "  --mpi -- Enable MPI\n"
         "  --mpi-mode [serialized,multiple] -- MPI mode\n"
+        "  --mpi-shared-memory -- Allocate distributed matrices from "
+        "node-local shared memory\n"
+        "  --mpi-comm-stats -- Print modelled communication statistics\n"
+        "  --mpi-descr-cache-limit (num) -- Descriptor cache memory limit "
+        "in bytes\n"
+        "  --mpi-descr-cache-stats -- Print descriptor cache statistics\n"
 #endif
 #ifdef STARNEIG_ENABLE_CUDA
         "  --no-pinning -- Disable memory pinning\n"
 #endif
+        "  --counters (file) -- Sample hardware performance counters and "
+        "store them after the experiment\n"
+        "  --dry-run (file) -- Record the task graph instead of executing it "
+        "and store it after the experiment\n"
         "  --seed (num) -- Random number generator seed\n"
         "  --experiment (experiment) -- Experiment module\n",
         argv[0]);
@@ -159,6 +192,194 @@ static void print_usage(int argc, char * const *argv)
     printf("\n");
 }
 
+///
+/// @brief Checks whether the hardware performance counters can be opened.
+///
+/// @return Non-zero if perf_event_open() succeeds.
+///
+static int counters_available()
+{
+#ifdef PERF_EVENT_FOUND
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0)
+        return 0;
+    close(fd);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+///
+/// @brief Stores the hardware performance counter counts and prints the number
+/// of stored entries. The library node has been finalized at this point.
+///
+/// @param[in] file_name
+///         File name.
+///
+/// @return EXIT_SUCCESS if the counts were stored, EXIT_FAILURE otherwise.
+///
+static int store_counters(char const *file_name)
+{
+    if (starneig_node_store_counters(file_name) != 0)
+        return EXIT_FAILURE;
+
+    FILE *file = fopen(file_name, "r");
+    if (file == NULL)
+        return EXIT_FAILURE;
+
+    int entries = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+        for (char *ptr = strstr(line, "\"name\""); ptr != NULL;
+        ptr = strstr(ptr+1, "\"name\""))
+            entries++;
+    fclose(file);
+
+    printf("COUNTERS: %d ENTRIES STORED TO %s\n", entries, file_name);
+    return EXIT_SUCCESS;
+}
+
+///
+/// @brief Stores the recorded task graph, prints its metrics and checks that
+/// the stored file is in the expected format. The library node has been
+/// finalized at this point.
+///
+/// @param[in] file_name
+///         File name. The graph is stored in DOT format if the name ends with
+///         `.dot` and in JSON format otherwise.
+///
+/// @return EXIT_SUCCESS if the task graph was stored, EXIT_FAILURE otherwise.
+///
+static int store_task_graph(char const *file_name)
+{
+    struct starneig_task_graph_info info;
+    starneig_node_get_task_graph_info(&info);
+
+    printf(
+        "DRY RUN: %d TASKS, %d EDGES, %d UNCALIBRATED, CRITICAL PATH %.6f S, "
+        "PARALLELISM %.2f\n", info.tasks, info.edges, info.uncalibrated,
+        info.critical_path, info.parallelism);
+
+    if (starneig_node_store_task_graph(file_name) != 0)
+        return EXIT_FAILURE;
+
+    FILE *file = fopen(file_name, "r");
+    if (file == NULL)
+        return EXIT_FAILURE;
+
+    size_t length = strlen(file_name);
+    int dot = 4 <= length && strcmp(file_name+length-4, ".dot") == 0;
+
+    // the DOT file has one line per task and one line per dependency; the
+    // JSON file begins with the summary
+    int valid = 0, tasks = 0, edges = 0;
+    char line[1024];
+    if (fgets(line, sizeof(line), file) != NULL) {
+        if (dot) {
+            valid = strncmp(line, "digraph", 7) == 0;
+            while (fgets(line, sizeof(line), file) != NULL) {
+                if (strstr(line, " -> ") != NULL)
+                    edges++;
+                else if (strstr(line, " [label=") != NULL && line[2] == 't')
+                    tasks++;
+            }
+        }
+        else {
+            valid = sscanf(line, "{\"summary\":{\"tasks\":%d,\"edges\":%d",
+                &tasks, &edges) == 2;
+        }
+    }
+    fclose(file);
+
+    if (!valid || tasks != info.tasks || edges != info.edges) {
+        printf("DRY RUN: INVALID TASK GRAPH FILE %s\n", file_name);
+        return EXIT_FAILURE;
+    }
+
+    printf("DRY RUN: TASK GRAPH STORED TO %s (%s)\n",
+        file_name, dot ? "DOT" : "JSON");
+    return EXIT_SUCCESS;
+}
+
+#ifdef STARNEIG_ENABLE_MPI
+
+///
+/// @brief Prints the communication statistics of all MPI ranks.
+///
+static void print_comm_stats()
+{
+    static char const * const names[STARNEIG_COMM_PHASE_COUNT] = {
+        "HESSENBERG PANEL", "HESSENBERG UPDATE", "AED", "BULGES", "REORDER",
+        "EIGENVALUES", "OTHER"
+    };
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    for (int i = 0; i < size; i++) {
+        if (i == rank) {
+            for (int j = 0; j < STARNEIG_COMM_PHASE_COUNT; j++) {
+                struct starneig_comm_stats stats;
+                starneig_mpi_get_comm_stats(j, STARNEIG_COMM_PEER_ALL, &stats);
+                printf(
+                    "COMM [%d] %s: MODELLED SENT %lld B (%lld MSGS), "
+                    "MODELLED RECEIVED %lld B (%lld MSGS), BLOCKED IN "
+                    "BARRIERS/ACQUIRES %.3f S\n", rank, names[j],
+                    stats.sent_bytes, stats.sent_messages,
+                    stats.recv_bytes, stats.recv_messages, stats.wait_time);
+            }
+            for (int j = 0; j < size; j++) {
+                struct starneig_comm_stats stats;
+                starneig_mpi_get_comm_stats(
+                    STARNEIG_COMM_PHASE_ALL, j, &stats);
+                printf(
+                    "COMM [%d] PEER %d: MODELLED SENT %lld B (%lld MSGS), "
+                    "MODELLED RECEIVED %lld B (%lld MSGS)\n", rank, j,
+                    stats.sent_bytes, stats.sent_messages,
+                    stats.recv_bytes, stats.recv_messages);
+            }
+            fflush(stdout);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+}
+
+///
+/// @brief Prints the descriptor cache statistics of all MPI ranks.
+///
+static void print_descr_cache_stats()
+{
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    for (int i = 0; i < size; i++) {
+        if (i == rank) {
+            struct starneig_descr_cache_stats stats;
+            starneig_mpi_get_descr_cache_stats(&stats);
+            printf(
+                "DESCR CACHE [%d]: HITS %lld, MISSES %lld, EVICTIONS %lld, "
+                "FOOTPRINT %zu B\n", rank, stats.hits, stats.misses,
+                stats.evictions, stats.footprint);
+            fflush(stdout);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+}
+
+#endif
+
 ///
 /// @brief Main function.
 ///
@@ -270,6 +491,19 @@ int main(int argc, char * const *argv)
 
         MPI_Comm_dup(MPI_COMM_WORLD, &comm);
         starneig_mpi_set_comm(comm);
+
+        if (read_opt("--mpi-shared-memory", argc, argv, argr))
+            starneig_mpi_enable_shared_memory();
+
+        if (read_opt("--mpi-comm-stats", argc, argv, argr))
+            starneig_mpi_enable_comm_stats();
+
+        double descr_cache_limit = read_double(
+            "--mpi-descr-cache-limit", argc, argv, argr, -1.0);
+        if (0.0 <= descr_cache_limit)
+            starneig_mpi_set_descr_cache_limit(descr_cache_limit);
+
+        read_opt("--mpi-descr-cache-stats", argc, argv, argr);
     }
 #endif
 
@@ -300,6 +534,19 @@ int main(int argc, char * const *argv)
 
     init_prand(seed);
 
+    //
+    // hardware performance counters
+    //
+
+    char const *counters_file =
+        read_str("--counters", argc, argv, argr, NULL);
+
+    //
+    // dry run
+    //
+
+    char const *dry_run_file = read_str("--dry-run", argc, argv, argr, NULL);
+
     //
     // check thread count arguments
     //
@@ -349,12 +596,26 @@ int main(int argc, char * const *argv)
         printf(" --mpi");
         print_multiarg(
             "--mpi-mode", argc, argv, "serialized", "multiple", NULL);
+        if (read_opt("--mpi-shared-memory", argc, argv, NULL))
+            printf(" --mpi-shared-memory");
+        if (read_opt("--mpi-comm-stats", argc, argv, NULL))
+            printf(" --mpi-comm-stats");
+        double descr_cache_limit = read_double(
+            "--mpi-descr-cache-limit", argc, argv, NULL, -1.0);
+        if (0.0 <= descr_cache_limit)
+            printf(" --mpi-descr-cache-limit %.0f", descr_cache_limit);
+        if (read_opt("--mpi-descr-cache-stats", argc, argv, NULL))
+            printf(" --mpi-descr-cache-stats");
     }
 #endif
 #ifdef STARNEIG_ENABLE_CUDA
     if (disable_pinning)
         printf(" --disable-pinning");
 #endif
+    if (counters_file != NULL)
+        printf(" --counters %s", counters_file);
+    if (dry_run_file != NULL)
+        printf(" --dry-run %s", dry_run_file);
     printf(" --seed %d --experiment %s", seed, experiment->name);
 
     thread_print_args(argc, argv);
@@ -370,8 +631,46 @@ int main(int argc, char * const *argv)
 
     threads_init(argc, argv);
 
+    if (counters_file != NULL) {
+        if (!counters_available()) {
+            printf("COUNTERS: perf_event_open() is not available. "
+                "Skipping...\n");
+            ret = EXIT_SKIPPED;
+            goto cleanup;
+        }
+        starneig_node_enable_counters();
+    }
+
+    if (dry_run_file != NULL)
+        starneig_node_enable_dry_run();
+
     ret = experiment->run(argc, argv, experiment->info);
 
+    // the task graph is stored after the experiment has finalized the node
+    if (dry_run_file != NULL) {
+        starneig_node_disable_dry_run();
+        if (store_task_graph(dry_run_file) != EXIT_SUCCESS) {
+            fprintf(stderr, "Failed to store the task graph.\n");
+            ret = EXIT_FAILURE;
+        }
+    }
+
+    // the counts are stored after the experiment has finalized the node
+    if (counters_file != NULL) {
+        starneig_node_disable_counters();
+        if (store_counters(counters_file) != EXIT_SUCCESS) {
+            fprintf(stderr, "Failed to store the counters.\n");
+            ret = EXIT_FAILURE;
+        }
+    }
+
+#ifdef STARNEIG_ENABLE_MPI
+    if (mpi && read_opt("--mpi-comm-stats", argc, argv, NULL))
+        print_comm_stats();
+    if (mpi && read_opt("--mpi-descr-cache-stats", argc, argv, NULL))
+        print_descr_cache_stats();
+#endif
+
 cleanup:
 
     //
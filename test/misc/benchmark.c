@@ -0,0 +1,880 @@
+///
+/// @file
+///
+/// @brief This file contains a benchmark experiment that times the complete
+/// solver pipelines over a named problem suite.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#include <starneig_test_config.h>
+#include <starneig/configuration.h>
+#include "benchmark.h"
+#include "../common/common.h"
+#include "../common/parse.h"
+#include "../common/init.h"
+#include "../common/io.h"
+#include "../common/local_pencil.h"
+#include <starneig/starneig.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+///
+/// @brief Default suite seed. A fixed seed makes the suites reproducible.
+///
+#define DEFAULT_SUITE_SEED 2020
+
+///
+/// @brief Problem kinds.
+///
+enum case_kind {
+    CASE_RANDOM,            ///< dense random matrix
+    CASE_KNOWN,             ///< prescribed (evenly spread) spectrum
+    CASE_CLUSTERED,         ///< prescribed (tightly clustered) spectrum
+    CASE_MTX                ///< MatrixMarket fixture
+};
+
+static char const * const case_kind_names[] = {
+    "random", "known-spectrum", "clustered", "mtx"
+};
+
+///
+/// @brief Suite case descriptor.
+///
+struct suite_case {
+    enum case_kind kind;    ///< problem kind
+    int n;                  ///< problem dimension
+};
+
+///
+/// @brief Suite descriptor.
+///
+struct suite {
+    char const *name;               ///< suite name
+    char const *desc;               ///< suite description
+    struct suite_case cases[8];     ///< cases, terminated by n == 0
+};
+
+static const struct suite suites[] = {
+    { .name = "quick",
+        .desc = "Small problems, suitable for smoke tests",
+        .cases = {
+            { CASE_RANDOM, 500 }, { CASE_KNOWN, 500 }, { CASE_CLUSTERED, 500 },
+            { 0, 0 } }
+    },
+    { .name = "standard",
+        .desc = "Medium-sized problems, the default baseline",
+        .cases = {
+            { CASE_RANDOM, 2000 }, { CASE_RANDOM, 4000 },
+            { CASE_KNOWN, 4000 }, { CASE_CLUSTERED, 4000 },
+            { 0, 0 } }
+    },
+    { .name = "large",
+        .desc = "Large problems",
+        .cases = {
+            { CASE_RANDOM, 10000 }, { CASE_RANDOM, 20000 },
+            { CASE_KNOWN, 10000 }, { CASE_CLUSTERED, 10000 },
+            { 0, 0 } }
+    }
+};
+
+static PRINT_AVAIL(print_avail_suites, "Available suites:",
+    name, desc, suites, 1)
+
+static READ_FROM_ARGV(read_suite, struct suite const, name, suites, 1)
+
+///
+/// @brief Pipelines.
+///
+enum pipeline {
+    PIPELINE_CHAIN = 0x1,   ///< Hessenberg, Schur, reorder, eigenvectors
+    PIPELINE_REDUCE = 0x2   ///< Reduce interface function
+};
+
+///
+/// @brief Timed phases.
+///
+enum phase {
+    PHASE_HESSENBERG,
+    PHASE_SCHUR,
+    PHASE_REORDER,
+    PHASE_EIGENVECTORS,
+    PHASE_CHAIN,
+    PHASE_REDUCE,
+    PHASE_COUNT
+};
+
+static char const * const phase_names[] = {
+    "hessenberg", "schur", "reorder", "eigenvectors", "chain", "reduce"
+};
+
+///
+/// @brief Benchmark input and workspace.
+///
+struct workspace {
+    char name[256];         ///< case name
+    enum case_kind kind;    ///< problem kind
+    int generalized;        ///< non-zero if the problem is generalized
+    int n;                  ///< problem dimension
+    matrix_t mat_a;         ///< original matrix A
+    matrix_t mat_b;         ///< original matrix B (generalized problems)
+    double *A, *B, *Q, *Z;  ///< work matrices
+    double *X;              ///< eigenvectors
+    size_t ld;              ///< leading dimension of the work matrices
+    double *real, *imag;    ///< eigenvalues
+    double *beta;           ///< generalized eigenvalues (beta)
+    int *selected;          ///< eigenvalue selection vector
+    int num_selected;       ///< number of selected eigenvalues
+    starneig_error_t ret;   ///< first non-zero return value
+};
+
+static int sep_predicate(double real, double imag, void *arg)
+{
+    return 0.0 < real;
+}
+
+static int gep_predicate(double real, double imag, double beta, void *arg)
+{
+    return 0.0 < beta && 0.0 < real;
+}
+
+static double get_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e+3 + ts.tv_nsec*1e-6;
+}
+
+static double uniform()
+{
+    return 1.0*prand()/PRAND_MAX;
+}
+
+///
+/// @brief Returns the k'th eigenvalue of a prescribed spectrum. Every third
+/// pair of eigenvalues is turned into a complex conjugate pair.
+///
+static void prescribed_eigenvalue(
+    enum case_kind kind, int n, int k, double *real, double *imag)
+{
+    if (kind == CASE_CLUSTERED) {
+        static const double centers[] = { -1.0, 0.5, 2.0 };
+        *real = centers[k % 3] + 1E-3*(2.0*uniform()-1.0);
+    }
+    else {
+        *real = -1.0 + 2.0*(k+0.5)/n;
+    }
+    *imag = k % 6 == 0 ? 0.1 + uniform() : 0.0;
+}
+
+///
+/// @brief Generates an upper quasi-triangular matrix pair (T_A, T_B) with a
+/// prescribed spectrum and forms A = Q T_A Z^T and B = Q T_B Z^T.
+///
+static void generate_prescribed(
+    enum case_kind kind, int n, int generalized, init_helper_t helper,
+    matrix_t *mat_a, matrix_t *mat_b)
+{
+    matrix_t mat_ta = generate_random_uptriag(n, n, helper);
+    matrix_t mat_tb = NULL;
+    if (generalized)
+        mat_tb = generate_random_uptriag(n, n, helper);
+
+    double *TA = LOCAL_MATRIX_PTR(mat_ta);
+    size_t ldTA = LOCAL_MATRIX_LD(mat_ta);
+    double *TB = generalized ? LOCAL_MATRIX_PTR(mat_tb) : NULL;
+    size_t ldTB = generalized ? LOCAL_MATRIX_LD(mat_tb) : 0;
+
+    int i = 0;
+    while (i < n) {
+        double real, imag;
+        prescribed_eigenvalue(kind, n, i, &real, &imag);
+
+        double d = generalized ? 0.5 + uniform() : 1.0;
+
+        if (0.0 < imag && i+1 < n) {
+            // a standardized 2-by-2 block [ a b ; -c a ], b*c = imag^2
+            double b = imag * (0.5 + uniform());
+            double c = imag*imag / b;
+            TA[i*ldTA+i] = d*real;
+            TA[(i+1)*ldTA+i] = d*b;
+            TA[i*ldTA+i+1] = -d*c;
+            TA[(i+1)*ldTA+i+1] = d*real;
+            if (generalized) {
+                TB[i*ldTB+i] = d;
+                TB[(i+1)*ldTB+i] = 0.0;
+                TB[(i+1)*ldTB+i+1] = d;
+            }
+            i += 2;
+        }
+        else {
+            TA[i*ldTA+i] = d*real;
+            if (generalized)
+                TB[i*ldTB+i] = d;
+            i++;
+        }
+    }
+
+    matrix_t mat_q = generate_random_householder(n, helper);
+    matrix_t mat_z = mat_q;
+    if (generalized)
+        mat_z = generate_random_householder(n, helper);
+
+    mul_QAZT(mat_q, mat_ta, mat_z, mat_a);
+    if (generalized)
+        mul_QAZT(mat_q, mat_tb, mat_z, mat_b);
+
+    free_matrix_descr(mat_ta);
+    free_matrix_descr(mat_tb);
+    if (mat_z != mat_q)
+        free_matrix_descr(mat_z);
+    free_matrix_descr(mat_q);
+}
+
+static struct workspace * init_workspace(
+    enum case_kind kind, int n, char const *filename, int generalized,
+    unsigned seed, int argc, char * const *argv)
+{
+    struct workspace *ws = calloc(1, sizeof(struct workspace));
+    ws->kind = kind;
+    ws->generalized = generalized;
+
+    init_prand(seed);
+
+    if (kind == CASE_MTX) {
+        int m;
+        read_mtx_dimensions_from_file(filename, &m, &n);
+        if (m != n) {
+            fprintf(stderr, "%s is not a square matrix.\n", filename);
+            free(ws);
+            return NULL;
+        }
+
+        char const *basename = strrchr(filename, '/');
+        snprintf(ws->name, sizeof(ws->name), "mtx-%s",
+            basename != NULL ? basename+1 : filename);
+    }
+    else {
+        snprintf(ws->name, sizeof(ws->name), "%s-%d",
+            case_kind_names[kind], n);
+    }
+
+    ws->n = n;
+
+    init_helper_t helper = init_helper_init(
+        "", LOCAL_MATRIX, n, n, PREC_DOUBLE | NUM_REAL, argc, argv);
+
+    switch (kind) {
+        case CASE_RANDOM:
+            ws->mat_a = generate_random_full(n, n, helper);
+            if (generalized)
+                ws->mat_b = generate_random_full(n, n, helper);
+            break;
+        case CASE_KNOWN:
+        case CASE_CLUSTERED:
+            generate_prescribed(
+                kind, n, generalized, helper, &ws->mat_a, &ws->mat_b);
+            break;
+        case CASE_MTX:
+            ws->mat_a = read_mtx_matrix_from_file(filename, helper);
+            if (generalized)
+                ws->mat_b = generate_random_full(n, n, helper);
+            break;
+    }
+
+    init_helper_free(helper);
+
+    ws->A = alloc_matrix(n, n, sizeof(double), &ws->ld);
+    ws->Q = alloc_matrix(n, n, sizeof(double), &ws->ld);
+    ws->X = alloc_matrix(n, n, sizeof(double), &ws->ld);
+    if (generalized) {
+        ws->B = alloc_matrix(n, n, sizeof(double), &ws->ld);
+        ws->Z = alloc_matrix(n, n, sizeof(double), &ws->ld);
+    }
+
+    ws->real = malloc(n*sizeof(double));
+    ws->imag = malloc(n*sizeof(double));
+    ws->beta = malloc(n*sizeof(double));
+    ws->selected = malloc(n*sizeof(int));
+
+    return ws;
+}
+
+static void free_workspace(struct workspace *ws)
+{
+    if (ws == NULL)
+        return;
+
+    free_matrix_descr(ws->mat_a);
+    free_matrix_descr(ws->mat_b);
+    free_matrix(ws->A);
+    free_matrix(ws->B);
+    free_matrix(ws->Q);
+    free_matrix(ws->Z);
+    free_matrix(ws->X);
+    free(ws->real);
+    free(ws->imag);
+    free(ws->beta);
+    free(ws->selected);
+    free(ws);
+}
+
+static void set_identity(int n, size_t ld, double *Q)
+{
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            Q[(size_t)i*ld+j] = i == j ? 1.0 : 0.0;
+}
+
+///
+/// @brief Restores the original input. Not timed.
+///
+static void reset_workspace(struct workspace *ws)
+{
+    int n = ws->n;
+
+    copy_matrix(n, n, LOCAL_MATRIX_LD(ws->mat_a), ws->ld, sizeof(double),
+        LOCAL_MATRIX_PTR(ws->mat_a), ws->A);
+    set_identity(n, ws->ld, ws->Q);
+
+    if (ws->generalized) {
+        copy_matrix(n, n, LOCAL_MATRIX_LD(ws->mat_b), ws->ld, sizeof(double),
+            LOCAL_MATRIX_PTR(ws->mat_b), ws->B);
+        set_identity(n, ws->ld, ws->Z);
+    }
+}
+
+static void record_ret(struct workspace *ws, starneig_error_t ret)
+{
+    if (ws->ret == STARNEIG_SUCCESS)
+        ws->ret = ret;
+}
+
+///
+/// @brief Runs the chain Hessenberg -> Schur -> reorder -> eigenvectors.
+///
+static void run_chain(struct workspace *ws, double *time)
+{
+    int n = ws->n, ld = ws->ld;
+    double t[5];
+
+    reset_workspace(ws);
+
+    t[0] = get_time();
+
+    if (ws->generalized) {
+        record_ret(ws, starneig_GEP_SM_HessenbergTriangular(
+            n, ws->A, ld, ws->B, ld, ws->Q, ld, ws->Z, ld));
+        t[1] = get_time();
+
+        record_ret(ws, starneig_GEP_SM_Schur(n, ws->A, ld, ws->B, ld,
+            ws->Q, ld, ws->Z, ld, ws->real, ws->imag, ws->beta));
+        t[2] = get_time();
+
+        ws->num_selected = 0;
+        for (int i = 0; i < n; i++) {
+            ws->selected[i] =
+                gep_predicate(ws->real[i], ws->imag[i], ws->beta[i], NULL);
+            ws->num_selected += ws->selected[i];
+        }
+
+        record_ret(ws, starneig_GEP_SM_ReorderSchur(n, ws->selected,
+            ws->A, ld, ws->B, ld, ws->Q, ld, ws->Z, ld,
+            ws->real, ws->imag, ws->beta));
+        t[3] = get_time();
+
+        record_ret(ws, starneig_GEP_SM_Eigenvectors(n, ws->selected,
+            ws->A, ld, ws->B, ld, ws->Z, ld, ws->X, ld));
+        t[4] = get_time();
+    }
+    else {
+        record_ret(ws, starneig_SEP_SM_Hessenberg(n, ws->A, ld, ws->Q, ld));
+        t[1] = get_time();
+
+        record_ret(ws, starneig_SEP_SM_Schur(
+            n, ws->A, ld, ws->Q, ld, ws->real, ws->imag));
+        t[2] = get_time();
+
+        ws->num_selected = 0;
+        for (int i = 0; i < n; i++) {
+            ws->selected[i] = sep_predicate(ws->real[i], ws->imag[i], NULL);
+            ws->num_selected += ws->selected[i];
+        }
+
+        record_ret(ws, starneig_SEP_SM_ReorderSchur(n, ws->selected,
+            ws->A, ld, ws->Q, ld, ws->real, ws->imag));
+        t[3] = get_time();
+
+        record_ret(ws, starneig_SEP_SM_Eigenvectors(n, ws->selected,
+            ws->A, ld, ws->Q, ld, ws->X, ld));
+        t[4] = get_time();
+    }
+
+    time[PHASE_HESSENBERG] = t[1] - t[0];
+    time[PHASE_SCHUR] = t[2] - t[1];
+    time[PHASE_REORDER] = t[3] - t[2];
+    time[PHASE_EIGENVECTORS] = t[4] - t[3];
+    time[PHASE_CHAIN] = t[4] - t[0];
+}
+
+///
+/// @brief Runs the combined Reduce interface function.
+///
+static void run_reduce(struct workspace *ws, double *time)
+{
+    int n = ws->n, ld = ws->ld;
+
+    reset_workspace(ws);
+
+    double begin = get_time();
+
+    if (ws->generalized)
+        record_ret(ws, starneig_GEP_SM_Reduce(n, ws->A, ld, ws->B, ld,
+            ws->Q, ld, ws->Z, ld, ws->real, ws->imag, ws->beta,
+            &gep_predicate, NULL, ws->selected, &ws->num_selected));
+    else
+        record_ret(ws, starneig_SEP_SM_Reduce(n, ws->A, ld, ws->Q, ld,
+            ws->real, ws->imag, &sep_predicate, NULL,
+            ws->selected, &ws->num_selected));
+
+    time[PHASE_REDUCE] = get_time() - begin;
+}
+
+///
+/// @brief Timing statistics.
+///
+struct stats {
+    double min, median, mean, stddev, max;
+};
+
+static int compare_doubles(void const *a, void const *b)
+{
+    double x = *(double const *) a, y = *(double const *) b;
+    return (x > y) - (x < y);
+}
+
+static struct stats compute_stats(int count, double const *samples)
+{
+    struct stats stats = { 0 };
+    if (count < 1)
+        return stats;
+
+    double *sorted = malloc(count*sizeof(double));
+    memcpy(sorted, samples, count*sizeof(double));
+    qsort(sorted, count, sizeof(double), &compare_doubles);
+
+    stats.min = sorted[0];
+    stats.max = sorted[count-1];
+    stats.median = count % 2 ? sorted[count/2] :
+        0.5*(sorted[count/2-1] + sorted[count/2]);
+
+    for (int i = 0; i < count; i++)
+        stats.mean += sorted[i];
+    stats.mean /= count;
+
+    if (1 < count) {
+        for (int i = 0; i < count; i++)
+            stats.stddev += squ(sorted[i] - stats.mean);
+        stats.stddev = sqrt(stats.stddev / (count-1));
+    }
+
+    free(sorted);
+    return stats;
+}
+
+static void fprint_json_string(FILE *stream, char const *str)
+{
+    fputc('"', stream);
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\')
+            fprintf(stream, "\\%c", *str);
+        else if ((unsigned char) *str < 0x20)
+            fprintf(stream, "\\u%04x", *str);
+        else
+            fputc(*str, stream);
+    }
+    fputc('"', stream);
+}
+
+///
+/// @brief Benchmark configuration.
+///
+struct bench_conf {
+    struct suite const *suite;
+    char const *mtx;
+    int generalized;
+    int pipelines;
+    int warmup;
+    int repeat;
+    double min_time;
+    int max_repeat;
+    int cores;
+    int gpus;
+    unsigned seed;
+    char const *output;
+};
+
+static int read_pipelines(char const *str)
+{
+    if (strcmp(str, "chain") == 0)
+        return PIPELINE_CHAIN;
+    if (strcmp(str, "reduce") == 0)
+        return PIPELINE_REDUCE;
+    if (strcmp(str, "all") == 0)
+        return PIPELINE_CHAIN | PIPELINE_REDUCE;
+    return 0;
+}
+
+static void read_conf(
+    int argc, char * const *argv, int *argr, struct bench_conf *conf)
+{
+    conf->suite = read_suite("--suite", argc, argv, argr);
+    conf->mtx = read_str("--mtx", argc, argv, argr, NULL);
+    conf->generalized = read_opt("--generalized", argc, argv, argr);
+    conf->pipelines = read_pipelines(
+        read_str("--pipelines", argc, argv, argr, "all"));
+    conf->warmup = read_int("--warmup", argc, argv, argr, 1);
+    conf->repeat = read_int("--repeat", argc, argv, argr, 5);
+    conf->min_time = read_double("--min-time", argc, argv, argr, 0.0);
+
+    struct multiarg_t max_repeat = read_multiarg(
+        "--max-repeat", argc, argv, argr, "default", NULL);
+    if (max_repeat.type == MULTIARG_INT)
+        conf->max_repeat = max_repeat.int_value;
+    else if (max_repeat.type == MULTIARG_STR)
+        conf->max_repeat =
+            0.0 < conf->min_time ? 10*conf->repeat : conf->repeat;
+    else
+        conf->max_repeat = -1;
+
+    struct multiarg_t cores = read_multiarg(
+        "--cores", argc, argv, argr, "default", NULL);
+    conf->cores = cores.type == MULTIARG_INT ?
+        cores.int_value : cores.type == MULTIARG_STR ? STARNEIG_USE_ALL : -2;
+
+    struct multiarg_t gpus = read_multiarg(
+        "--gpus", argc, argv, argr, "default", NULL);
+    conf->gpus = gpus.type == MULTIARG_INT ?
+        gpus.int_value : gpus.type == MULTIARG_STR ? STARNEIG_USE_ALL : -2;
+
+    conf->seed = read_uint(
+        "--suite-seed", argc, argv, argr, DEFAULT_SUITE_SEED);
+    conf->output = read_str("--output", argc, argv, argr, "benchmark.json");
+}
+
+void benchmark_print_usage(
+    int argc, char * const *argv, experiment_info_t const info)
+{
+    printf(
+        "  --suite (suite) -- Benchmark suite\n"
+        "  --mtx (filename) -- Add a MatrixMarket fixture to the suite\n"
+        "  --generalized -- Benchmark generalized problems\n"
+        "  --pipelines [chain,reduce,all] -- Pipelines to benchmark\n"
+        "  --warmup (num) -- Untimed warmup runs per case\n"
+        "  --repeat (num) -- Minimum number of timed runs per case\n"
+        "  --min-time (ms) -- Repeat until the total time exceeds this\n"
+        "  --max-repeat [default,(num)] -- Maximum number of timed runs\n"
+        "  --cores [default,(num)] -- Number of CPU cores\n"
+        "  --gpus [default,(num)] -- Number of GPUS\n"
+        "  --suite-seed (num) -- Seed used to generate the suite\n"
+        "  --output (filename) -- JSON output file\n"
+    );
+    print_avail_suites();
+}
+
+void benchmark_print_args(
+    int argc, char * const *argv, experiment_info_t const info)
+{
+    struct bench_conf conf;
+    read_conf(argc, argv, NULL, &conf);
+
+    printf(" --suite %s", conf.suite->name);
+    if (conf.mtx != NULL)
+        printf(" --mtx %s", conf.mtx);
+    if (conf.generalized)
+        printf(" --generalized");
+    printf(" --pipelines %s",
+        read_str("--pipelines", argc, argv, NULL, "all"));
+    printf(" --warmup %d --repeat %d --min-time %f",
+        conf.warmup, conf.repeat, conf.min_time);
+    print_multiarg("--max-repeat", argc, argv, "default", NULL);
+    print_multiarg("--cores", argc, argv, "default", NULL);
+    print_multiarg("--gpus", argc, argv, "default", NULL);
+    printf(" --suite-seed %u --output %s", conf.seed, conf.output);
+}
+
+int benchmark_check_args(
+    int argc, char * const *argv, int *argr, experiment_info_t const info)
+{
+    struct bench_conf conf;
+    read_conf(argc, argv, argr, &conf);
+
+    if (conf.suite == NULL) {
+        fprintf(stderr, "Invalid benchmark suite.\n");
+        return -1;
+    }
+
+    if (conf.mtx != NULL && access(conf.mtx, R_OK) != 0) {
+        fprintf(stderr, "Cannot read %s.\n", conf.mtx);
+        return -1;
+    }
+
+    if (conf.pipelines == 0) {
+        fprintf(stderr, "Invalid pipeline.\n");
+        return -1;
+    }
+
+    if (conf.warmup < 0 || conf.repeat < 1 || conf.min_time < 0.0) {
+        fprintf(stderr, "Invalid repeat policy.\n");
+        return -1;
+    }
+
+    if (conf.max_repeat < conf.repeat) {
+        fprintf(stderr, "Invalid maximum repeat count.\n");
+        return -1;
+    }
+
+    // the test driver and the library print to stdout
+    if (conf.output == NULL || strcmp(conf.output, "-") == 0) {
+        fprintf(stderr, "The JSON output must be written to a file.\n");
+        return -1;
+    }
+
+    if (conf.cores == -2 || conf.gpus == -2)
+        return -1;
+
+    return 0;
+}
+
+///
+/// @brief Benchmarks a single case and writes the results to a JSON stream.
+///
+static int benchmark_case(
+    struct bench_conf const *conf, struct workspace *ws, int pipeline,
+    int first, FILE *json)
+{
+    enum phase const chain_phases[] = {
+        PHASE_HESSENBERG, PHASE_SCHUR, PHASE_REORDER, PHASE_EIGENVECTORS,
+        PHASE_CHAIN };
+    enum phase const reduce_phases[] = { PHASE_REDUCE };
+
+    enum phase const *phases =
+        pipeline == PIPELINE_CHAIN ? chain_phases : reduce_phases;
+    int phase_count = pipeline == PIPELINE_CHAIN ? 5 : 1;
+    enum phase total_phase = phases[phase_count-1];
+    char const *pipeline_name = pipeline == PIPELINE_CHAIN ? "chain" : "reduce";
+
+    double *samples[PHASE_COUNT] = { 0 };
+    for (int i = 0; i < phase_count; i++)
+        samples[phases[i]] = malloc(conf->max_repeat*sizeof(double));
+
+    ws->ret = STARNEIG_SUCCESS;
+
+    printf("BENCHMARK: %s (%s)", ws->name, pipeline_name);
+    fflush(stdout);
+
+    int count = 0;
+    double total = 0.0;
+    for (int i = -conf->warmup; ; i++) {
+        double time[PHASE_COUNT];
+
+        if (pipeline == PIPELINE_CHAIN)
+            run_chain(ws, time);
+        else
+            run_reduce(ws, time);
+
+        if (i < 0)
+            continue;
+
+        for (int j = 0; j < phase_count; j++)
+            samples[phases[j]][count] = time[phases[j]];
+        total += time[total_phase];
+        count++;
+
+        if (conf->repeat <= count &&
+        (conf->min_time <= total || conf->max_repeat <= count))
+            break;
+    }
+
+    struct stats total_stats = compute_stats(count, samples[total_phase]);
+    printf(" %d runs, median %.0f MS, min %.0f MS, max %.0f MS\n",
+        count, total_stats.median, total_stats.min, total_stats.max);
+    if (ws->ret != STARNEIG_SUCCESS)
+        printf("BENCHMARK: %s (%s) returned %d\n",
+            ws->name, pipeline_name, ws->ret);
+
+    fprintf(json, "%s    {\"name\":", first ? "" : ",\n");
+    fprint_json_string(json, ws->name);
+    fprintf(json,
+        ",\"kind\":\"%s\",\"n\":%d,\"generalized\":%s,\"pipeline\":\"%s\","
+        "\"runs\":%d,\"selected\":%d,\"ret\":%d,\"phases\":{",
+        case_kind_names[ws->kind], ws->n, ws->generalized ? "true" : "false",
+        pipeline_name, count, ws->num_selected, ws->ret);
+
+    for (int i = 0; i < phase_count; i++) {
+        struct stats stats = compute_stats(count, samples[phases[i]]);
+        fprintf(json,
+            "%s\"%s\":{\"min\":%.3f,\"median\":%.3f,\"mean\":%.3f,"
+            "\"stddev\":%.3f,\"max\":%.3f}",
+            i ? "," : "", phase_names[phases[i]], stats.min, stats.median,
+            stats.mean, stats.stddev, stats.max);
+    }
+    fprintf(json, "}}");
+
+    for (int i = 0; i < PHASE_COUNT; i++)
+        free(samples[i]);
+
+    // a partial reordering is expected with the clustered spectra
+    return ws->ret != STARNEIG_SUCCESS &&
+        ws->ret != STARNEIG_PARTIAL_REORDERING;
+}
+
+static void fprint_json_header(
+    struct bench_conf const *conf, int argc, char * const *argv, FILE *json)
+{
+    char hostname[256] = "unknown";
+    gethostname(hostname, sizeof(hostname)-1);
+
+    char date[64];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(json, "{\n  \"version\":\"%d.%d.%d\",\n",
+        STARNEIG_VERSION_MAJOR, STARNEIG_VERSION_MINOR,
+        STARNEIG_VERSION_PATCH);
+
+    fprintf(json, "  \"host\":");
+    fprint_json_string(json, hostname);
+    fprintf(json, ",\n  \"date\":\"%s\",\n", date);
+
+    fprintf(json, "  \"command\":[");
+    for (int i = 0; i < argc; i++) {
+        if (i)
+            fputc(',', json);
+        fprint_json_string(json, argv[i]);
+    }
+    fprintf(json, "],\n");
+
+    fprintf(json,
+        "  \"config\":{\"mpi\":%s,\"cuda\":%s,\"blacs\":%s},\n",
+#ifdef STARNEIG_ENABLE_MPI
+        "true",
+#else
+        "false",
+#endif
+#ifdef STARNEIG_ENABLE_CUDA
+        "true",
+#else
+        "false",
+#endif
+#ifdef STARNEIG_ENABLE_BLACS
+        "true"
+#else
+        "false"
+#endif
+    );
+
+    fprintf(json,
+        "  \"suite\":\"%s\",\n  \"seed\":%u,\n"
+        "  \"policy\":{\"warmup\":%d,\"repeat\":%d,\"min_time\":%.3f,"
+        "\"max_repeat\":%d},\n",
+        conf->suite->name, conf->seed, conf->warmup, conf->repeat,
+        conf->min_time, conf->max_repeat);
+
+    fprintf(json, "  \"cases\":[\n");
+}
+
+int benchmark_run(
+    int argc, char * const *argv, experiment_info_t const info)
+{
+    struct bench_conf conf;
+    read_conf(argc, argv, NULL, &conf);
+
+    FILE *json = fopen(conf.output, "w");
+    if (json == NULL) {
+        fprintf(stderr, "Cannot open %s.\n", conf.output);
+        return 1;
+    }
+
+    fprint_json_header(&conf, argc, argv, json);
+
+    int case_count = 0;
+    while (conf.suite->cases[case_count].n != 0)
+        case_count++;
+
+    int failed = 0, first = 1, cores = 0, gpus = 0;
+    for (int i = 0; i < case_count + (conf.mtx != NULL); i++) {
+
+        // each case is generated from its own seed so that the cases do not
+        // depend on each other
+        struct workspace *ws;
+        if (i < case_count)
+            ws = init_workspace(conf.suite->cases[i].kind,
+                conf.suite->cases[i].n, NULL, conf.generalized, conf.seed+i,
+                argc, argv);
+        else
+            ws = init_workspace(CASE_MTX, 0, conf.mtx, conf.generalized,
+                conf.seed+i, argc, argv);
+
+        if (ws == NULL) {
+            failed++;
+            continue;
+        }
+
+        starneig_node_init(conf.cores, conf.gpus, STARNEIG_HINT_SM);
+        cores = starneig_node_get_cores();
+        gpus = starneig_node_get_gpus();
+
+        if (conf.pipelines & PIPELINE_CHAIN) {
+            failed += benchmark_case(&conf, ws, PIPELINE_CHAIN, first, json);
+            first = 0;
+        }
+        if (conf.pipelines & PIPELINE_REDUCE) {
+            failed += benchmark_case(&conf, ws, PIPELINE_REDUCE, first, json);
+            first = 0;
+        }
+
+        starneig_node_finalize();
+        free_workspace(ws);
+    }
+
+    fprintf(json, "\n  ],\n  \"cores\":%d,\n  \"gpus\":%d\n}\n", cores, gpus);
+
+    fclose(json);
+
+    return 0 < failed;
+}
@@ -0,0 +1,71 @@
+///
+/// @file
+///
+/// @brief This file contains a benchmark experiment that times the complete
+/// solver pipelines over a named problem suite.
+///
+/// @author Mirko Myllykoski (mirkom@cs.umu.se), Umeå University
+///
+/// @internal LICENSE
+///
+/// Copyright (c) 2019-2020, Umeå Universitet
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+///
+/// 1. Redistributions of source code must retain the above copyright notice,
+///    this list of conditions and the following disclaimer.
+///
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+///    this list of conditions and the following disclaimer in the documentation
+///    and/or other materials provided with the distribution.
+///
+/// 3. Neither the name of the copyright holder nor the names of its
+///    contributors may be used to endorse or promote products derived from this
+///    software without specific prior written permission.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+///
+
+#ifndef STARNEIG_TEST_BENCHMARK_H
+#define STARNEIG_TEST_BENCHMARK_H
+
+#include <starneig_test_config.h>
+#include <starneig/configuration.h>
+#include "../common/experiment.h"
+
+///
+/// @brief Prints experiment's instructions.
+///
+void benchmark_print_usage(
+    int argc, char * const *argv, experiment_info_t const info);
+
+///
+/// @brief Prints experiment's command line arguments.
+///
+void benchmark_print_args(
+    int argc, char * const *argv, experiment_info_t const info);
+
+///
+/// @brief Checks experiment's command line arguments.
+///
+int benchmark_check_args(
+    int argc, char * const *argv, int *argr, experiment_info_t const info);
+
+///
+/// @brief Executes the experiment.
+///
+int benchmark_run(
+    int argc, char * const *argv, experiment_info_t const info);
+
+#endif
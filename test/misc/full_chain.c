@@ -45,6 +45,7 @@
 #include "../common/starneig_pencil.h"
 #endif
 #include "../common/io.h"
+#include "../common/tiled_io.h"
 #include <starneig/starneig.h>
 #include <stdlib.h>
 #include <math.h>
@@ -322,6 +323,8 @@ const struct hook_experiment_descr full_chain_experiment = {
         &default_print_input_pencil_descr,
         &default_store_raw_pencil_descr,
         &default_store_raw_input_pencil_descr,
+        &default_store_tiled_pencil_descr,
+        &default_store_tiled_input_pencil_descr,
         0
     }
 };
@@ -39,6 +39,7 @@
 #include "validator.h"
 #include "../common/hooks.h"
 #include "../common/io.h"
+#include "../common/tiled_io.h"
 
 static hook_solver_state_t dummy_prepare(
     int argc, char * const *argv, struct hook_data_env *env)
@@ -78,6 +79,7 @@ const struct hook_experiment_descr validator_experiment = {
     .initializers = (struct hook_initializer_t const *[])
     {
         &raw_initializer,
+        &tiled_initializer,
         0
     },
     .supplementers = (struct hook_supplementer_t const *[])
@@ -113,6 +115,7 @@ const struct hook_experiment_descr validator_experiment = {
         }},
         &default_print_pencil_descr,
         &default_store_raw_pencil_descr,
+        &default_store_tiled_pencil_descr,
         0
     }
 };
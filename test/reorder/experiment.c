@@ -46,6 +46,7 @@
 #include "../common/checks.h"
 #include "../common/hooks.h"
 #include "../common/io.h"
+#include "../common/tiled_io.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -501,6 +502,7 @@ const struct hook_experiment_descr reorder_experiment = {
         &default_schur_initializer,
         &starpu_schur_initializer,
         &raw_initializer,
+        &tiled_initializer,
         0
     },
     .supplementers = (struct hook_supplementer_t const *[])
@@ -525,10 +527,14 @@ const struct hook_experiment_descr reorder_experiment = {
         &default_analysis_descr,
         &default_reordering_test_descr,
         &default_residual_test_descr,
+        &default_estimate_test_descr,
+        &default_select_test_descr,
         &default_print_pencil_descr,
         &default_print_input_pencil_descr,
         &default_store_raw_pencil_descr,
         &default_store_raw_input_pencil_descr,
+        &default_store_tiled_pencil_descr,
+        &default_store_tiled_input_pencil_descr,
         0
     }
 };
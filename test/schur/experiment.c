@@ -49,6 +49,7 @@
 #include "../common/starneig_pencil.h"
 #endif
 #include "../common/io.h"
+#include "../common/tiled_io.h"
 #include "../common/crawler.h"
 #include "../common/complex_distr.h"
 #include "../hessenberg/solvers.h"
@@ -243,6 +244,8 @@ static void known_initializer_print_usage(int argc, char * const *argv)
         "  --generalized -- Generalized problem\n"
         "  --complex-distr (complex distribution) -- 2-by-2 block "
         "distribution module\n"
+        "  --reflectors (num) -- Number of Householder reflectors in the "
+        "similarity transformation\n"
     );
 
     init_helper_print_usage("", INIT_HELPER_ALL, argc, argv);
@@ -262,6 +265,8 @@ static void known_initializer_print_args(int argc, char * const *argv)
 
     printf(" --complex-distr %s", complex_distr->name);
 
+    printf(" --reflectors %d", read_int("--reflectors", argc, argv, NULL, 1));
+
     if (complex_distr->print_args != NULL)
         complex_distr->print_args(argc, argv);
 
@@ -283,6 +288,11 @@ static int known_initializer_check_args(
         return -1;
     }
 
+    if (read_int("--reflectors", argc, argv, argr, 1) < 1) {
+        fprintf(stderr, "Invalid number of Householder reflectors.\n");
+        return -1;
+    }
+
     if (complex_distr->check_args != NULL) {
         int ret = complex_distr->check_args(argc, argv, argr);
         if (ret)
@@ -304,6 +314,8 @@ static struct hook_data_env* known_initializer_init(
     struct complex_distr const *complex_distr =
         read_complex_distr("--complex-distr", argc, argv, NULL);
 
+    int reflectors = read_int("--reflectors", argc, argv, NULL, 1);
+
     init_helper_t helper = init_helper_init_hook(
         "", format, n, n, PREC_DOUBLE | NUM_REAL, argc, argv);
 
@@ -316,7 +328,7 @@ static struct hook_data_env* known_initializer_init(
     double *real, *imag, *beta;
     init_supplementary_known_eigenvalues(n, &real, &imag, &beta, &pencil->supp);
 
-    // generate (generalized) Schur form and multiply with Householder
+    // generate (generalized) Schur form and apply random Householder
     // reflectors from both sides
 
     if (generalized) {
@@ -326,16 +338,17 @@ static struct hook_data_env* known_initializer_init(
         complex_distr->init(argc, argv, mat_s, mat_t);
         extract_eigenvalues(mat_s, mat_t, real, imag, beta);
 
-        matrix_t mat_q = generate_random_householder(n, helper);
-        matrix_t mat_z = generate_random_householder(n, helper);
+        random_orthogonal_t orth_q = init_random_orthogonal(n, reflectors);
+        random_orthogonal_t orth_z = init_random_orthogonal(n, reflectors);
+
+        transform_QAZT(orth_q, orth_z, mat_s);
+        transform_QAZT(orth_q, orth_z, mat_t);
 
-        mul_QAZT(mat_q, mat_s, mat_z, &pencil->mat_a);
-        mul_QAZT(mat_q, mat_t, mat_z, &pencil->mat_b);
+        pencil->mat_a = mat_s;
+        pencil->mat_b = mat_t;
 
-        free_matrix_descr(mat_s);
-        free_matrix_descr(mat_t);
-        free_matrix_descr(mat_q);
-        free_matrix_descr(mat_z);
+        free_random_orthogonal(orth_q);
+        free_random_orthogonal(orth_z);
     }
     else {
         matrix_t mat_s = generate_random_uptriag(n, n, helper);
@@ -343,12 +356,13 @@ static struct hook_data_env* known_initializer_init(
         complex_distr->init(argc, argv, mat_s, NULL);
         extract_eigenvalues(mat_s, NULL, real, imag, beta);
 
-        matrix_t mat_q = generate_random_householder(n, helper);
+        random_orthogonal_t orth_q = init_random_orthogonal(n, reflectors);
+
+        transform_QAZT(orth_q, orth_q, mat_s);
 
-        mul_QAZT(mat_q, mat_s, mat_q, &pencil->mat_a);
+        pencil->mat_a = mat_s;
 
-        free_matrix_descr(mat_s);
-        free_matrix_descr(mat_q);
+        free_random_orthogonal(orth_q);
     }
 
     // reduce the dense matrix (pencil) to Hessenberg(-triangular) form
@@ -914,6 +928,7 @@ const struct hook_experiment_descr schur_experiment = {
         &known_initializer,
         &mtx_initializer,
         &raw_initializer,
+        &tiled_initializer,
         0
     },
     .supplementers = (struct hook_supplementer_t const *[])
@@ -946,10 +961,14 @@ const struct hook_experiment_descr schur_experiment = {
         &default_known_eigenvalues_descr,
         &default_analysis_descr,
         &default_residual_test_descr,
+        &default_estimate_test_descr,
+        &default_select_test_descr,
         &default_print_pencil_descr,
         &default_print_input_pencil_descr,
         &default_store_raw_pencil_descr,
         &default_store_raw_input_pencil_descr,
+        &default_store_tiled_pencil_descr,
+        &default_store_tiled_input_pencil_descr,
         0
     }
 };
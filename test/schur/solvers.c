@@ -817,6 +817,17 @@ static void starpu_print_usage(int argc, char * const *argv)
         " side deflation threshold\n"
         "  --inf-threshold [default,norm,(num)] -- Infinite eigenvalue"
         " threshold\n"
+        "  --defer-transforms -- Defer Schur vector formation\n"
+        "  --checkpoint (filename) -- Checkpoint file\n"
+        "  --checkpoint-interval [default,(num)] -- Checkpoint interval"
+        " (iterations)\n"
+        "  --restart -- Resume from the checkpoint file\n"
+        "  --region-real-min (num) -- Compute only the eigenvalues whose"
+        " real parts are at least (num)\n"
+        "  --region-patience [default,(num)] -- Region patience (AED"
+        " steps)\n"
+        "  --region-check -- Verify that the unreduced diagonal blocks"
+        " contain no eigenvalues from the region\n"
     );
 }
 
@@ -962,6 +973,46 @@ static int starpu_check_args(int argc, char * const *argv, int *argr)
         return -1;
     }
 
+    read_opt("--defer-transforms", argc, argv, argr);
+
+    char const *checkpoint =
+        read_str("--checkpoint", argc, argv, argr, NULL);
+
+    struct multiarg_t checkpoint_interval = read_multiarg(
+        "--checkpoint-interval", argc, argv, argr, "default", NULL);
+    if (checkpoint_interval.type == MULTIARG_INVALID ||
+    (checkpoint_interval.type == MULTIARG_INT &&
+    checkpoint_interval.int_value < 1)) {
+        fprintf(stderr, "Invalid checkpoint interval.\n");
+        return -1;
+    }
+
+    if (read_opt("--restart", argc, argv, argr) && checkpoint == NULL) {
+        fprintf(stderr, "--restart requires --checkpoint.\n");
+        return -1;
+    }
+
+    if (read_str("--region-real-min", argc, argv, NULL, NULL) != NULL &&
+    isnan(read_double("--region-real-min", argc, argv, argr, NAN))) {
+        fprintf(stderr, "Invalid region.\n");
+        return -1;
+    }
+
+    if (read_opt("--region-check", argc, argv, argr) &&
+    read_str("--region-real-min", argc, argv, NULL, NULL) == NULL) {
+        fprintf(stderr, "--region-check requires --region-real-min.\n");
+        return -1;
+    }
+
+    struct multiarg_t region_patience = read_multiarg(
+        "--region-patience", argc, argv, argr, "default", NULL);
+    if (region_patience.type == MULTIARG_INVALID ||
+    (region_patience.type == MULTIARG_INT &&
+    region_patience.int_value < 1)) {
+        fprintf(stderr, "Invalid region patience.\n");
+        return -1;
+    }
+
     return 0;
 }
 
@@ -987,6 +1038,24 @@ static void starpu_print_args(int argc, char * const *argv)
         "default", "norm", "lapack", NULL);
     print_multiarg("--inf-threshold", argc, argv,
         "default", "norm", NULL);
+    if (read_opt("--defer-transforms", argc, argv, NULL))
+        printf(" --defer-transforms");
+
+    char const *checkpoint = read_str("--checkpoint", argc, argv, NULL, NULL);
+    if (checkpoint != NULL) {
+        printf(" --checkpoint %s", checkpoint);
+        print_multiarg("--checkpoint-interval", argc, argv, "default", NULL);
+        if (read_opt("--restart", argc, argv, NULL))
+            printf(" --restart");
+    }
+
+    if (read_str("--region-real-min", argc, argv, NULL, NULL) != NULL) {
+        printf(" --region-real-min %e",
+            read_double("--region-real-min", argc, argv, NULL, NAN));
+        print_multiarg("--region-patience", argc, argv, "default", NULL);
+        if (read_opt("--region-check", argc, argv, NULL))
+            printf(" --region-check");
+    }
 }
 
 static hook_solver_state_t starpu_prepare(
@@ -1034,6 +1103,123 @@ static int starpu_finalize(hook_solver_state_t state, struct hook_data_env *env)
     return 0;
 }
 
+static int region_real_min(double real, double imag, double beta, void *arg)
+{
+    return *((double *) arg) <= real;
+}
+
+static int region_real_min_disc(
+    double real, double imag, double radius, void *arg)
+{
+    return *((double *) arg) <= real + radius;
+}
+
+///
+/// @brief Checks that the unreduced diagonal blocks of a partial Schur form do
+/// not contain eigenvalues that satisfy the region predicate.
+///
+/// @param[in] n             matrix dimension
+/// @param[in] region_final  final diagonal entries
+/// @param[in] real_min      region predicate argument
+/// @param[in] pencil        partial Schur form
+///
+/// @return the number of in-region eigenvalues that were left unreduced
+///
+static int check_region_final(
+    int n, int const *region_final, double real_min, pencil_t pencil)
+{
+    extern void dhseqr_(char const *, char const *, int const *, int const *,
+        int const *, double *, int const *, double *, double *, double *,
+        int const *, double *, int const *, int *);
+
+    extern void dhgeqz_(char const *, char const *, char const *,
+        int const *, int const *, int const *, double *, int const *,
+        double *, int const *, double *, double *, double *, double *,
+        int const *, double *, int const *, double *, int const *, int *);
+
+    double *A = LOCAL_MATRIX_PTR(pencil->mat_a);
+    int ldA = LOCAL_MATRIX_LD(pencil->mat_a);
+    double *B = NULL;
+    int ldB = 0;
+    if (pencil->mat_b != NULL) {
+        B = LOCAL_MATRIX_PTR(pencil->mat_b);
+        ldB = LOCAL_MATRIX_LD(pencil->mat_b);
+    }
+
+    int missed = 0;
+
+    int begin = 0;
+    while (begin < n) {
+        if (region_final[begin]) {
+            begin++;
+            continue;
+        }
+
+        int end = begin;
+        while (end < n && !region_final[end])
+            end++;
+
+        // compute the eigenvalues of a copy of the unreduced diagonal block
+        int m = end - begin, ilo = 1, ihi = m, info, lwork = 3*m+1;
+        double *_A = malloc(m*m*sizeof(double));
+        double *_B = B != NULL ? malloc(m*m*sizeof(double)) : NULL;
+        double *real = malloc(m*sizeof(double));
+        double *imag = malloc(m*sizeof(double));
+        double *beta = malloc(m*sizeof(double));
+        double *work = malloc(lwork*sizeof(double));
+
+        for (int j = 0; j < m; j++) {
+            for (int i = 0; i < m; i++) {
+                _A[j*m+i] = A[(begin+j)*ldA+begin+i];
+                if (B != NULL)
+                    _B[j*m+i] = B[(begin+j)*ldB+begin+i];
+            }
+        }
+
+        if (B != NULL) {
+            dhgeqz_("E", "N", "N", &m, &ilo, &ihi, _A, &m, _B, &m,
+                real, imag, beta, NULL, &m, NULL, &m, work, &lwork, &info);
+        }
+        else {
+            dhseqr_("E", "N", &m, &ilo, &ihi, _A, &m, real, imag, NULL, &m,
+                work, &lwork, &info);
+            for (int i = 0; i < m; i++)
+                beta[i] = 1.0;
+        }
+
+        if (info != 0) {
+            fprintf(stderr,
+                "Failed to compute the eigenvalues of the block [%d,%d[.\n",
+                begin, end);
+            missed += m;
+        }
+        else {
+            for (int i = 0; i < m; i++) {
+                if (beta[i] != 0.0 &&
+                region_real_min(real[i]/beta[i], imag[i]/beta[i], 1.0,
+                &real_min)) {
+                    fprintf(stderr,
+                        "The unreduced block [%d,%d[ contains the in-region "
+                        "eigenvalue %e + %e i.\n",
+                        begin, end, real[i]/beta[i], imag[i]/beta[i]);
+                    missed++;
+                }
+            }
+        }
+
+        free(_A);
+        free(_B);
+        free(real);
+        free(imag);
+        free(beta);
+        free(work);
+
+        begin = end;
+    }
+
+    return missed;
+}
+
 static int starpu_run(hook_solver_state_t state)
 {
     int argc = ((struct starpu_state *) state)->argc;
@@ -1139,12 +1325,42 @@ static int starpu_run(hook_solver_state_t state)
     if (inf_threshold.type == MULTIARG_FLOAT)
         conf.inf_threshold = inf_threshold.double_value;
 
+    if (read_opt("--defer-transforms", argc, argv, NULL))
+        conf.defer_transforms = 1;
+
+    conf.checkpoint_file = read_str("--checkpoint", argc, argv, NULL, NULL);
+
+    struct multiarg_t checkpoint_interval = read_multiarg(
+        "--checkpoint-interval", argc, argv, NULL, "default", NULL);
+    if (checkpoint_interval.type == MULTIARG_INT)
+        conf.checkpoint_interval = checkpoint_interval.int_value;
+
+    if (read_opt("--restart", argc, argv, NULL))
+        conf.restart = 1;
+
+    double real_min = NAN;
+    if (read_str("--region-real-min", argc, argv, NULL, NULL) != NULL) {
+        real_min = read_double("--region-real-min", argc, argv, NULL, NAN);
+        conf.region = &region_real_min;
+        conf.region_disc = &region_real_min_disc;
+        conf.region_arg = &real_min;
+
+        struct multiarg_t region_patience = read_multiarg(
+            "--region-patience", argc, argv, NULL, "default", NULL);
+        if (region_patience.type == MULTIARG_INT)
+            conf.region_patience = region_patience.int_value;
+    }
+
     int ret = 0;
+    int n = 0;
 
     if (env->format == HOOK_DATA_FORMAT_PENCIL_LOCAL) {
         pencil_t pencil = (pencil_t) env->data;
 
-        int n = LOCAL_MATRIX_N(pencil->mat_a);
+        n = LOCAL_MATRIX_N(pencil->mat_a);
+        if (conf.region != NULL)
+            conf.region_final = malloc(n*sizeof(int));
+
         double *real, *imag, *beta;
         init_supplementary_eigenvalues(n, &real, &imag, &beta, &pencil->supp);
 
@@ -1168,7 +1384,10 @@ static int starpu_run(hook_solver_state_t state)
     env->format == HOOK_DATA_FORMAT_PENCIL_BLACS) {
         pencil_t pencil = (pencil_t) env->data;
 
-        int n = STARNEIG_MATRIX_N(pencil->mat_a);
+        n = STARNEIG_MATRIX_N(pencil->mat_a);
+        if (conf.region != NULL)
+            conf.region_final = malloc(n*sizeof(int));
+
         double *real, *imag, *beta;
         init_supplementary_eigenvalues(n, &real, &imag, &beta, &pencil->supp);
 
@@ -1189,6 +1408,31 @@ static int starpu_run(hook_solver_state_t state)
     }
 #endif
 
+    if (conf.region_final != NULL) {
+        int final = 0;
+        for (int i = 0; i < n; i++)
+            final += conf.region_final[i] != 0;
+        printf("REGION: %d / %d diagonal entries are final.\n", final, n);
+
+        if (env->format == HOOK_DATA_FORMAT_PENCIL_LOCAL &&
+        read_opt("--region-check", argc, argv, NULL)) {
+            int missed = check_region_final(
+                n, conf.region_final, real_min, (pencil_t) env->data);
+            printf("REGION: %d in-region eigenvalues were left unreduced.\n",
+                missed);
+            if (missed != 0) {
+                free(conf.region_final);
+                return -1;
+            }
+        }
+
+        free(conf.region_final);
+
+        // a partial Schur form is the expected outcome
+        if (ret == STARNEIG_PARTIAL_SCHUR)
+            ret = 0;
+    }
+
     return ret;
 }
 